@@ -838,7 +838,7 @@ int main(int argc, char* argv[]) {
                             permIdx, shaderName(mat.shader), cullName(mat.cull),
                             mat.blend ? "alpha" : "opaque", polyName(mat.poly),
                             depthCmpName(mat.depthCmp), ms);
-            } else {
+            } else if (result.error().is(vksdl::ErrorCode::CompileRequired)) {
                 // VK_PIPELINE_COMPILE_REQUIRED -- cache miss, would need compilation.
                 // Use default pipeline instead. This is the whole point: prove
                 // the render thread never compiles.
@@ -850,6 +850,10 @@ int main(int argc, char* argv[]) {
                     permIdx, shaderName(mat.shader), cullName(mat.cull),
                     mat.blend ? "alpha" : "opaque", polyName(mat.poly), depthCmpName(mat.depthCmp),
                     ms);
+            } else {
+                spawned[static_cast<std::size_t>(permIdx)] = true;
+                std::fprintf(stderr, "[nosurp %3d] BUILD FAILED: %s\n", permIdx,
+                             result.error().message.c_str());
             }
             return;
         }
@@ -33,6 +33,18 @@ struct HeapBudget {
     VkMemoryHeapFlags flags = 0;
 };
 
+// When the upload helpers (uploadBuffer(), uploadMesh(), ...) write data
+// straight into device-local, host-visible memory instead of copying it
+// through a staging buffer. Direct writes need a large BAR (Resizable BAR /
+// Smart Access Memory, or unified memory on integrated GPUs); the default
+// 256 MiB BAR window is too small to spend on static data.
+struct DirectUploadPolicy {
+    bool enabled = true;
+    VkDeviceSize maxBytes = 64ull << 20; // larger uploads always go through staging
+    float maxBudgetFraction = 0.8f;      // stop once the BAR heap would pass this share
+                                         // of its budget; fall back to staging
+};
+
 // Thread safety: thread-confined. VMA allocations require external
 // synchronization unless VMA_ALLOCATOR_CREATE_EXTERNALLY_SYNCHRONIZED_BIT
 // is NOT set (vksdl does not set it).
@@ -73,12 +85,36 @@ class Allocator {
     // systems where VRAM and host-visible BAR are separate device-local heaps).
     [[nodiscard]] float gpuMemoryUsagePercent() const;
 
+    // True when a DEVICE_LOCAL | HOST_VISIBLE heap larger than the classic
+    // 256 MiB BAR window exists (ReBAR/SAM enabled, or a UMA device).
+    [[nodiscard]] bool hasLargeBar() const {
+        return largeBarHeap_ != UINT32_MAX;
+    }
+    [[nodiscard]] VkDeviceSize largeBarHeapSize() const {
+        return largeBarHeapSize_;
+    }
+
+    void setDirectUploadPolicy(const DirectUploadPolicy& policy) {
+        directPolicy_ = policy;
+    }
+    [[nodiscard]] const DirectUploadPolicy& directUploadPolicy() const {
+        return directPolicy_;
+    }
+
+    // Whether an upload of `bytes` should be written directly into mapped
+    // device-local memory: large BAR present, policy enabled, size under the
+    // cap and the heap within budget. Cheap enough to call per upload.
+    [[nodiscard]] bool preferDirectUpload(VkDeviceSize bytes) const;
+
   private:
     Allocator() = default;
 
     VmaAllocator allocator_ = nullptr;
     VkDevice device_ = VK_NULL_HANDLE;
     bool hasMemoryBudget_ = false;
+    std::uint32_t largeBarHeap_ = UINT32_MAX;
+    VkDeviceSize largeBarHeapSize_ = 0;
+    DirectUploadPolicy directPolicy_;
 };
 
 } // namespace vksdl
@@ -15,7 +15,14 @@ class AppImpl;
 // SDL lifecycle owner. Create one App before any windows.
 // Pumps the global SDL event queue and routes events to per-window queues.
 //
-// Thread safety: thread-confined (main/UI thread).
+// Threaded input: SDL only pumps events on the thread that initialized video,
+// so the App thread is the input thread. After enableThreadedInput() it loops
+// on waitEvents()/pumpEvents() while a render thread drains each Window with
+// pollEvent() from a lock-free ring, without waiting for a frame boundary.
+//
+// Thread safety: thread-confined (main/UI thread). With threaded input, only
+// Window::pollEvent(), pixelSize(), consumeResize() and droppedEvents() may
+// be called from the (single) render thread.
 class App {
   public:
     [[nodiscard]] static Result<App> create();
@@ -31,12 +38,26 @@ class App {
 
     void pumpEvents();
 
+    // Blocks up to `timeoutMs` for the next event, then routes everything
+    // pending. The loop body of a dedicated input thread.
+    void waitEvents(std::uint32_t timeoutMs);
+
+    // Route events into a per-window SPSC ring of `capacity` events (rounded
+    // up to a power of two) instead of the frame-gated queue. Call before
+    // handing windows to the render thread. Events arriving while a ring is
+    // full are dropped and counted in Window::droppedEvents(), except Quit and
+    // CloseRequested, which are held until the ring drains. One-way.
+    void enableThreadedInput(std::uint32_t capacity = 1024);
+    [[nodiscard]] bool threadedInput() const;
+
   private:
     friend class Window;
     App() = default;
     void registerWindow(Window* w);
     void unregisterWindow(Window* w);
     void resetPump();
+    void attachThreadedQueue(Window* w);
+    void drainEvents(bool wait, std::uint32_t timeoutMs);
 
     std::unique_ptr<AppImpl> impl_;
 };
@@ -35,6 +35,23 @@ class Buffer {
         return mapped_;
     }
 
+    // True when the mapping is HOST_COHERENT: host writes need no flush.
+    // When false, flush written ranges (see MappedWrites) before the device
+    // reads them.
+    [[nodiscard]] bool hostCoherent() const {
+        return hostCoherent_;
+    }
+
+    // Flushes host writes to [offset, offset + size) of the mapping. No-op
+    // for HOST_COHERENT memory. Batch many ranges with MappedWrites instead.
+    [[nodiscard]] Result<void> flush(VkDeviceSize offset = 0,
+                                     VkDeviceSize size = VK_WHOLE_SIZE) const;
+
+    // Makes device writes to [offset, offset + size) visible to host reads
+    // through the mapping. No-op for HOST_COHERENT memory.
+    [[nodiscard]] Result<void> invalidate(VkDeviceSize offset = 0,
+                                          VkDeviceSize size = VK_WHOLE_SIZE) const;
+
     // Returns the device address of this buffer. Only valid when the buffer was
     // created with SHADER_DEVICE_ADDRESS_BIT (all vertex/index/scratch/AS/SBT
     // convenience methods include it).
@@ -42,6 +59,7 @@ class Buffer {
 
   private:
     friend class BufferBuilder;
+    friend class MappedWrites;
     friend Result<void> uploadToBuffer(const Allocator&, const Device&, const Buffer&, const void*,
                                        VkDeviceSize);
     Buffer() = default;
@@ -52,6 +70,7 @@ class Buffer {
     VmaAllocation allocation_ = nullptr;
     VkDeviceSize size_ = 0;
     void* mapped_ = nullptr;
+    bool hostCoherent_ = false;
 };
 
 class BufferBuilder {
@@ -83,6 +102,19 @@ class BufferBuilder {
     accelerationStructureInput(); // adds AS_BUILD_INPUT_READ_ONLY_BIT (requires VK_KHR_acceleration_structure)
     BufferBuilder& mapped();
 
+    // Prefer device-local memory the host can write directly (ReBAR/SAM or
+    // UMA), persistently mapped. VMA falls back to plain device-local memory
+    // when none is available; mappedData() is then null and uploads go
+    // through staging. The upload helpers set this when
+    // Allocator::preferDirectUpload() agrees.
+    BufferBuilder& directUpload();
+
+    // Persistently mapped for host reads of GPU results (feedback, queries,
+    // readback copies): cached memory where available, so reads are not
+    // uncached loads. Adds TRANSFER_DST. Call Buffer::invalidate() before
+    // reading.
+    BufferBuilder& readback();
+
     // Memory priority hint [0, 1]. Higher values are evicted last under pressure.
     // Effective only when the device reports hasMemoryPriority() == true.
     // Default 0.5 (mid-priority, VMA default).
@@ -97,16 +129,22 @@ class BufferBuilder {
     VkBufferUsageFlags usage_ = 0;
     float priority_ = 0.5f;
     bool mapped_ = false;
+    bool directUpload_ = false;
+    bool readback_ = false;
 };
 
 // Staged upload: creates a temporary staging buffer + command pool, copies data
 // to the destination buffer via the GPU, waits for completion, then cleans up.
+// When `dst` is host-mapped (directUpload(), mapped()), the data is written
+// straight into it instead and no GPU work is submitted.
 // Blocking -- suitable for init-time uploads only.
 [[nodiscard]] Result<void> uploadToBuffer(const Allocator& allocator, const Device& device,
                                           const Buffer& dst, const void* data, VkDeviceSize size);
 
 // One-liner: creates a device-local buffer and uploads data in a single call.
-// Combines BufferBuilder + uploadToBuffer. Blocking -- init-time only.
+// Combines BufferBuilder + uploadToBuffer. On large-BAR systems the buffer is
+// written directly when Allocator::preferDirectUpload() allows it, otherwise
+// it goes through staging. Blocking -- init-time only.
 // Usage flag selects the buffer type (vertex, index, storage).
 [[nodiscard]] Result<Buffer> uploadBuffer(const Allocator& allocator, const Device& device,
                                           VkBufferUsageFlags usage, const void* data,
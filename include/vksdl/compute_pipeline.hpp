@@ -63,6 +63,8 @@ class ComputePipelineBuilder {
     [[nodiscard]] Result<Pipeline> build();
 
   private:
+    friend class PipelineCompiler;
+
     [[nodiscard]] Result<VkShaderModule> createModule(const std::vector<std::uint32_t>& code) const;
 
     VkDevice device_ = VK_NULL_HANDLE;
@@ -6,6 +6,7 @@
 #include <vulkan/vulkan.h>
 
 #include <cstdint>
+#include <filesystem>
 #include <functional>
 #include <string>
 #include <string_view>
@@ -16,6 +17,10 @@ namespace vksdl {
 class Instance;
 class Surface;
 
+namespace detail {
+struct GpuCaps;
+} // namespace detail
+
 enum class GpuPrefer {
     Discrete,
     Integrated,
@@ -45,6 +50,24 @@ struct QueueFamilies {
     }
 };
 
+// VK_EXT_extended_dynamic_state3 states enabled on the device. Each flag is
+// the matching extendedDynamicState3* feature; all false when the extension
+// is absent.
+struct ExtendedDynamicState3 {
+    bool polygonMode = false;
+    bool sampleMask = false;
+    bool alphaToCoverageEnable = false;
+    bool depthClampEnable = false;
+    bool colorBlendEnable = false;
+    bool colorBlendEquation = false;
+    bool colorWriteMask = false;
+
+    [[nodiscard]] bool any() const {
+        return polygonMode || sampleMask || alphaToCoverageEnable || depthClampEnable ||
+               colorBlendEnable || colorBlendEquation || colorWriteMask;
+    }
+};
+
 // Thread safety: immutable after construction. VkQueue handles returned by
 // accessors follow Vulkan queue externally-synchronized rules.
 class Device {
@@ -100,6 +123,11 @@ class Device {
     [[nodiscard]] const char* gpuName() const {
         return gpuName_.c_str();
     }
+    // True when build() took this GPU's capabilities from the
+    // DeviceBuilder::capabilityCache() file instead of probing it.
+    [[nodiscard]] bool capabilitiesCached() const {
+        return capabilitiesCached_;
+    }
 
     // RT properties (0 when RT not requested)
     [[nodiscard]] std::uint32_t shaderGroupHandleSize() const {
@@ -201,6 +229,16 @@ class Device {
         return hasPipelineBinary_;
     }
 
+    // VK_EXT_extended_dynamic_state3 support (opportunistic detection).
+    // Only the states PipelineBuilder::maximalDynamicState() uses are
+    // enabled; extendedDynamicState3() reports which ones the driver accepted.
+    [[nodiscard]] bool hasExtendedDynamicState3() const {
+        return eds3_.any();
+    }
+    [[nodiscard]] const ExtendedDynamicState3& extendedDynamicState3() const {
+        return eds3_;
+    }
+
     // Present timing support (VK_EXT_present_timing or VK_GOOGLE_display_timing).
     // hasPresentTiming() returns true when either extension is available.
     // Swapchain uses VK_EXT_present_timing when present, else VK_GOOGLE_display_timing.
@@ -223,6 +261,23 @@ class Device {
         return pfnDrawMeshTasks_;
     }
 
+    // Sparse binding + sparseResidencyImage2D, enabled by
+    // DeviceBuilder::needSparseResidency(). The graphics queue then supports
+    // vkQueueBindSparse. hasShaderResourceResidency() adds the
+    // sparseTextureARB/residency query in shaders (opportunistic).
+    [[nodiscard]] bool hasSparseResidency() const {
+        return hasSparseResidency_;
+    }
+    [[nodiscard]] bool hasShaderResourceResidency() const {
+        return hasShaderResourceResidency_;
+    }
+
+    // Vulkan 1.1 multiview, enabled whenever supported. Required for a
+    // non-zero view mask (PassBuilder::setViewMask(), PipelineBuilder::viewMask()).
+    [[nodiscard]] bool hasMultiview() const {
+        return hasMultiview_;
+    }
+
     [[nodiscard]] std::string queryDeviceFault() const;
 
     // Error recovery: device lost handling.
@@ -252,6 +307,7 @@ class Device {
     VkSampleCountFlagBits maxMsaaSamples_ = VK_SAMPLE_COUNT_1_BIT;
     float timestampPeriod_ = 0.0f;
     std::string gpuName_;
+    bool capabilitiesCached_ = false;
 
     // Device fault
     bool hasDeviceFault_ = false;
@@ -274,8 +330,15 @@ class Device {
     bool hasInvocationReorder_ = false;
     // Pipeline binary (VK_KHR_pipeline_binary)
     bool hasPipelineBinary_ = false;
+    // Extended dynamic state 3 (VK_EXT_extended_dynamic_state3)
+    ExtendedDynamicState3 eds3_;
     // Mesh shaders (VK_EXT_mesh_shader)
     bool hasMeshShaders_ = false;
+    // Sparse residency (core sparseBinding + sparseResidencyImage2D)
+    bool hasSparseResidency_ = false;
+    bool hasShaderResourceResidency_ = false;
+    // Multiview (Vulkan 1.1 core feature)
+    bool hasMultiview_ = false;
     // Present timing (VK_EXT_present_timing or VK_GOOGLE_display_timing)
     bool hasPresentTiming_ = false;
     bool hasGoogleDisplayTiming_ = false;
@@ -309,6 +372,7 @@ class DeviceBuilder {
     DeviceBuilder& needGPL();
     DeviceBuilder& needMeshShaders();  // requires VK_EXT_mesh_shader
     DeviceBuilder& needAsyncCompute(); // preference, not requirement -- falls back to graphics
+    DeviceBuilder& needSparseResidency(); // sparse 2D images; graphics queue must bind sparse
     DeviceBuilder& preferDiscreteGpu();
     DeviceBuilder& preferIntegratedGpu();
 
@@ -325,6 +389,18 @@ class DeviceBuilder {
 
     DeviceBuilder& preferGpu(GpuPrefer pref);
 
+    // Persist the probed capabilities of every GPU (properties, memory
+    // heaps, queue families, extensions, feature support) in `file`. Later
+    // builds read them back instead of re-probing each GPU, which is slow
+    // on multi-GPU machines and under validation layers. Entries are keyed
+    // by device UUID, driver version and API version; a GPU whose entry
+    // does not match is probed again and the file rewritten. Present
+    // support is per surface and always queried live. A missing or corrupt
+    // file just means a full probe. If vkCreateDevice fails on cached
+    // capabilities, the file is deleted and build() retries once after a
+    // full probe.
+    DeviceBuilder& capabilityCache(std::filesystem::path file);
+
     [[nodiscard]] Result<Device> build();
 
   private:
@@ -338,9 +414,13 @@ class DeviceBuilder {
         std::function<void(VkPhysicalDeviceFeatures&)> configure;
     };
 
-    [[nodiscard]] QueueFamilies findQueueFamilies(VkPhysicalDevice gpu) const;
-    [[nodiscard]] bool supportsExtensions(VkPhysicalDevice gpu) const;
-    [[nodiscard]] int scoreDevice(VkPhysicalDevice gpu) const;
+    // build() body. Sets `staleCache` when vkCreateDevice failed on cached
+    // capabilities.
+    [[nodiscard]] Result<Device> buildDevice(bool readCache, bool& staleCache);
+    [[nodiscard]] QueueFamilies findQueueFamilies(VkPhysicalDevice gpu,
+                                                  const detail::GpuCaps& caps) const;
+    [[nodiscard]] bool supportsExtensions(const detail::GpuCaps& caps) const;
+    [[nodiscard]] int scoreDevice(VkPhysicalDevice gpu, const detail::GpuCaps& caps) const;
 
     VkInstance instance_ = VK_NULL_HANDLE;
     VkSurfaceKHR surface_ = VK_NULL_HANDLE;
@@ -350,12 +430,14 @@ class DeviceBuilder {
     std::vector<FeatureRequest12> featureRequests12_;
     std::vector<CoreFeatureRequest> coreFeatureRequests_;
     std::vector<void*> chainedFeatures_;
+    std::filesystem::path capabilityCache_;
     bool needRayTracingPipeline_ = false;
     bool needRayQuery_ = false;
     bool needAccelerationStructure_ = false;
     bool needGPL_ = false;
     bool needMeshShaders_ = false;
     bool needAsyncCompute_ = false;
+    bool needSparseResidency_ = false;
 };
 
 } // namespace vksdl
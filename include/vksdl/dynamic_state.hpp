@@ -0,0 +1,136 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+
+namespace vksdl {
+
+class Device;
+
+// Values of every state PipelineBuilder::maximalDynamicState() makes
+// dynamic. Defaults match PipelineBuilder's fixed-function defaults, so a
+// default-constructed value reproduces an unconfigured builder.
+struct DynamicStateValues {
+    // Input assembly
+    VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    bool primitiveRestart = false;
+
+    // Rasterization
+    VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL; // extended dynamic state 3
+    VkCullModeFlags cullMode = VK_CULL_MODE_NONE;
+    VkFrontFace frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    bool rasterizerDiscard = false;
+    bool depthClamp = false; // extended dynamic state 3
+    float lineWidth = 1.0f;
+    bool depthBias = false;
+    float depthBiasConstant = 0.0f;
+    float depthBiasClamp = 0.0f;
+    float depthBiasSlope = 0.0f;
+
+    // Multisample (extended dynamic state 3). `samples` must equal the
+    // pipeline's rasterization samples; it only sizes the mask.
+    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+    VkSampleMask sampleMask = ~0u;
+    bool alphaToCoverage = false;
+
+    // Depth / stencil
+    bool depthTest = false;
+    bool depthWrite = false;
+    VkCompareOp depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+    bool depthBoundsTest = false;
+    float minDepthBounds = 0.0f;
+    float maxDepthBounds = 1.0f;
+    bool stencilTest = false;
+    VkStencilOp stencilFailOp = VK_STENCIL_OP_KEEP;
+    VkStencilOp stencilPassOp = VK_STENCIL_OP_KEEP;
+    VkStencilOp stencilDepthFailOp = VK_STENCIL_OP_KEEP;
+    VkCompareOp stencilCompareOp = VK_COMPARE_OP_ALWAYS;
+    std::uint32_t stencilCompareMask = 0xFF;
+    std::uint32_t stencilWriteMask = 0xFF;
+    std::uint32_t stencilReference = 0;
+
+    // Color blend (attachment 0). Enable, equation and write mask are
+    // extended dynamic state 3.
+    bool blendEnable = false;
+    VkColorBlendEquationEXT blendEquation = {
+        VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD,
+        VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD,
+    };
+    VkColorComponentFlags colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                           VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    float blendConstants[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+};
+
+// Records dynamic state into a command buffer and skips every vkCmdSet* whose
+// value is already current. Pairs with PipelineBuilder::maximalDynamicState():
+// pipelines that differ only in dynamic state share one VkPipeline, and the
+// per-draw differences go through apply().
+//
+// Dynamic state survives a pipeline bind only when the new pipeline also
+// declares it dynamic. After binding a pipeline that bakes any of these
+// states (one not built with maximalDynamicState()), call invalidate().
+// Extended dynamic state 3 values are ignored on devices without the
+// matching feature; those states are baked into the pipeline instead.
+//
+// Thread safety: thread-confined (one tracker per recording command buffer).
+class DynamicStateTracker {
+  public:
+    explicit DynamicStateTracker(const Device& device);
+
+    // Starts recording into `cmd`. State is undefined in a new command
+    // buffer, so the next apply() writes everything.
+    void begin(VkCommandBuffer cmd);
+
+    // Forget the current values; the next apply() writes everything.
+    void invalidate();
+
+    // vkCmdBindPipeline, skipped when `pipeline` is already bound.
+    void bindPipeline(VkPipeline pipeline,
+                      VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS);
+
+    void setViewport(const VkViewport& viewport);
+    void setScissor(const VkRect2D& scissor);
+
+    // Writes the fields of `values` that differ from the current state.
+    void apply(const DynamicStateValues& values);
+
+    // Last applied values (meaningful after the first apply()).
+    [[nodiscard]] const DynamicStateValues& current() const {
+        return current_;
+    }
+
+    // vkCmd* calls recorded and avoided since construction.
+    [[nodiscard]] std::uint32_t issuedCount() const {
+        return issued_;
+    }
+    [[nodiscard]] std::uint32_t skippedCount() const {
+        return skipped_;
+    }
+
+  private:
+    bool dirty(bool differs);
+
+    VkCommandBuffer cmd_ = VK_NULL_HANDLE;
+    VkPipeline boundPipeline_ = VK_NULL_HANDLE;
+    DynamicStateValues current_;
+    VkViewport viewport_{};
+    VkRect2D scissor_{};
+    bool known_ = false;
+    bool viewportKnown_ = false;
+    bool scissorKnown_ = false;
+    std::uint32_t issued_ = 0;
+    std::uint32_t skipped_ = 0;
+
+    // Extended dynamic state 3 entry points; null when the device did not
+    // enable the matching feature.
+    PFN_vkCmdSetPolygonModeEXT pfnPolygonMode_ = nullptr;
+    PFN_vkCmdSetSampleMaskEXT pfnSampleMask_ = nullptr;
+    PFN_vkCmdSetAlphaToCoverageEnableEXT pfnAlphaToCoverage_ = nullptr;
+    PFN_vkCmdSetDepthClampEnableEXT pfnDepthClamp_ = nullptr;
+    PFN_vkCmdSetColorBlendEnableEXT pfnBlendEnable_ = nullptr;
+    PFN_vkCmdSetColorBlendEquationEXT pfnBlendEquation_ = nullptr;
+    PFN_vkCmdSetColorWriteMaskEXT pfnWriteMask_ = nullptr;
+};
+
+} // namespace vksdl
@@ -1,18 +1,188 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 
 namespace vksdl {
 
+// What kind of failure an Error is, for code that reacts to failures instead
+// of reporting them (retry on pool exhaustion, compile on a cache miss).
+enum class ErrorCode : std::uint8_t {
+    Unspecified = 0, // not set: Error::kind() derives the kind from vkResult
+    Failed,          // no more specific kind
+    Vulkan,          // a Vulkan call failed; vkResult says how
+    InvalidArgument,
+    NotSupported,
+    NotFound,
+    OutOfMemory,
+    PoolExhausted,   // descriptor pool out of memory or fragmented
+    CompileRequired, // cache-only pipeline creation missed the cache
+    DeviceLost,
+};
+
+// Message text of an Error. Building one never allocates unless the text is
+// a runtime string:
+//   - string literals are kept by pointer,
+//   - lazy() messages store a formatter and two integers and are formatted
+//     on first read (view(), c_str(), Error::format(), ...),
+//   - std::string and const char* text is copied.
+// Failures that are expected in hot loops use the first two forms so a
+// failing Result never touches the heap.
+//
+// The literal constructor is consteval, so only arrays with static storage
+// (string literals) are kept by pointer. A local `const char[N]` buffer does
+// not compile; pass it as std::string.
+//
+// Thread safety: reading a lazy message formats it in place, so concurrent
+// first reads of one ErrorMessage race. Errors are values owned by one
+// Result; copy the Error to share it.
+class ErrorMessage {
+  public:
+    using Formatter = std::string (*)(std::uint64_t a, std::uint64_t b);
+
+    ErrorMessage() = default;
+
+    template <std::size_t N>
+    consteval ErrorMessage(const char (&literal)[N]) // NOLINT implicit
+        : literal_(literal), size_(N - 1) {}
+
+    // A writable array is a runtime buffer, not a literal: copy it.
+    template <std::size_t N>
+    ErrorMessage(char (&buffer)[N]) // NOLINT implicit
+        : ErrorMessage(std::string(buffer)) {}
+
+    template <typename P>
+        requires(std::is_convertible_v<P, const char*> &&
+                 !std::is_array_v<std::remove_reference_t<P>>)
+    ErrorMessage(P&& text) // NOLINT implicit
+        : ErrorMessage(std::string(text != nullptr ? static_cast<const char*>(text) : "")) {}
+
+    ErrorMessage(std::string text) // NOLINT implicit
+        : owned_(std::make_unique<std::string>(std::move(text))) {}
+
+    ErrorMessage(const ErrorMessage& o)
+        : literal_(o.literal_), size_(o.size_), formatter_(o.formatter_),
+          args_{o.args_[0], o.args_[1]},
+          owned_(o.owned_ ? std::make_unique<std::string>(*o.owned_) : nullptr) {}
+    ErrorMessage(ErrorMessage&&) noexcept = default;
+    ErrorMessage& operator=(const ErrorMessage& o) {
+        if (this != &o)
+            *this = ErrorMessage(o);
+        return *this;
+    }
+    ErrorMessage& operator=(ErrorMessage&&) noexcept = default;
+
+    // `format(a, b)` runs on first read; a captureless lambda converts.
+    [[nodiscard]] static ErrorMessage lazy(Formatter format, std::uint64_t a = 0,
+                                           std::uint64_t b = 0) {
+        ErrorMessage m;
+        m.formatter_ = format;
+        m.args_[0] = a;
+        m.args_[1] = b;
+        return m;
+    }
+
+    [[nodiscard]] std::string_view view() const {
+        resolve();
+        return owned_ ? std::string_view(*owned_) : std::string_view(literal_, size_);
+    }
+    [[nodiscard]] const char* c_str() const {
+        resolve();
+        return owned_ ? owned_->c_str() : literal_;
+    }
+    [[nodiscard]] std::string str() const {
+        return std::string(view());
+    }
+    [[nodiscard]] bool empty() const {
+        return view().empty();
+    }
+    [[nodiscard]] std::size_t find(std::string_view s, std::size_t pos = 0) const {
+        return view().find(s, pos);
+    }
+
+    // True while the text lives outside this object (literal or not yet
+    // formatted), i.e. nothing has been allocated for it.
+    [[nodiscard]] bool isStatic() const {
+        return !owned_;
+    }
+
+    ErrorMessage& operator+=(std::string_view more) {
+        resolve();
+        if (!owned_)
+            owned_ = std::make_unique<std::string>(literal_, size_);
+        *owned_ += more;
+        return *this;
+    }
+
+    [[nodiscard]] friend bool operator==(const ErrorMessage& m, std::string_view s) {
+        return m.view() == s;
+    }
+
+  private:
+    void resolve() const {
+        if (formatter_ == nullptr)
+            return;
+        owned_ = std::make_unique<std::string>(formatter_(args_[0], args_[1]));
+        formatter_ = nullptr;
+    }
+
+    // Owned text lives behind a pointer so the literal constructor can be
+    // consteval: an inline std::string is not a constant expression.
+    const char* literal_ = "";
+    std::size_t size_ = 0;
+    mutable Formatter formatter_ = nullptr;
+    std::uint64_t args_[2] = {};
+    mutable std::unique_ptr<std::string> owned_;
+};
+
+// Operation name of an Error, e.g. "create device". Kept by pointer, so
+// only string literals convert: the constructor is consteval and rejects
+// std::string, runtime pointers and local buffers at compile time.
+class ErrorOperation {
+  public:
+    constexpr ErrorOperation() = default;
+
+    template <std::size_t N>
+    consteval ErrorOperation(const char (&literal)[N]) // NOLINT implicit
+        : text_(literal, N - 1) {}
+
+    [[nodiscard]] constexpr std::string_view view() const {
+        return text_;
+    }
+    constexpr operator std::string_view() const { // NOLINT implicit
+        return text_;
+    }
+
+    [[nodiscard]] friend constexpr bool operator==(ErrorOperation op, std::string_view s) {
+        return op.text_ == s;
+    }
+
+  private:
+    std::string_view text_;
+};
+
 // Thin error type that carries what we tried, what Vulkan said, and a human message.
 // VkResult is stored as int32_t to avoid pulling <vulkan/vulkan.h> into every header.
+// `operation` is a literal kept by pointer (ErrorOperation), so
+// `Error{"create device", vr, "..."}` allocates nothing.
 // NOLINTNEXTLINE(clang-analyzer-core.uninitialized.Assign) -- false positive, LLVM #59588
 struct Error {
-    std::string operation;     // e.g. "create device"
-    std::int32_t vkResult = 0; // 0 (VK_SUCCESS) when not a Vulkan error
-    std::string message;       // human-readable explanation + suggestion
+    ErrorOperation operation;                // e.g. "create device"
+    std::int32_t vkResult = 0;               // 0 (VK_SUCCESS) when not a Vulkan error
+    ErrorMessage message;                    // human-readable explanation + suggestion
+    ErrorCode code = ErrorCode::Unspecified; // set when vkResult alone does not say it
+
+    // `code` when set, otherwise the kind implied by vkResult: pool
+    // exhaustion, COMPILE_REQUIRED, out of memory, device lost, ...
+    [[nodiscard]] ErrorCode kind() const;
+    [[nodiscard]] bool is(ErrorCode c) const {
+        return kind() == c;
+    }
 
     // Format as a single readable string.
     [[nodiscard]] std::string format() const;
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <vksdl/buffer.hpp>
+#include <vksdl/error.hpp>
+#include <vksdl/mapped_writes.hpp>
+#include <vksdl/result.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace vksdl {
+
+class Allocator;
+
+// What one GpuSceneBuffer upload recorded.
+struct SceneUploadStats {
+    std::uint32_t dirtyElements = 0;    // dirty when upload() started
+    std::uint32_t copiedElements = 0;   // copied, including clean gaps merged into a run
+    std::uint32_t deferredElements = 0; // left dirty: the frame's staging slice was full
+    std::uint32_t regions = 0;          // VkBufferCopy regions of the one vkCmdCopyBuffer
+    VkDeviceSize bytes = 0;
+};
+
+// Untyped core of GpuSceneBuffer<T>: the device-local buffer, the staging
+// ring and the dirty bitset. Use GpuSceneBuffer<T> instead.
+//
+// Thread safety: thread-confined.
+class SceneBufferStorage {
+  public:
+    [[nodiscard]] static Result<SceneBufferStorage>
+    create(const Allocator& allocator, std::uint32_t elementSize, std::uint32_t count,
+           std::uint32_t framesInFlight, VkDeviceSize stagingBytesPerFrame);
+
+    SceneBufferStorage(SceneBufferStorage&&) noexcept = default;
+    SceneBufferStorage& operator=(SceneBufferStorage&&) noexcept = default;
+    SceneBufferStorage(const SceneBufferStorage&) = delete;
+    SceneBufferStorage& operator=(const SceneBufferStorage&) = delete;
+
+    void markDirty(std::uint32_t first, std::uint32_t count);
+    void markAllDirty();
+    [[nodiscard]] bool isDirty(std::uint32_t index) const {
+        return (dirty_[index / 64] >> (index % 64)) & 1u;
+    }
+    [[nodiscard]] std::uint32_t dirtyCount() const;
+
+    // Copies the dirty runs of `mirror` (count * elementSize bytes) through
+    // the staging slice of `frameIndex` and records the copy and barriers.
+    // If flushing the staging writes fails, records nothing, leaves every
+    // element dirty and returns the error.
+    [[nodiscard]] Result<SceneUploadStats> upload(VkCommandBuffer cmd, std::uint32_t frameIndex,
+                                                  const void* mirror,
+                                                  VkPipelineStageFlags2 dstStage,
+                                                  VkAccessFlags2 dstAccess);
+
+    void setMergeGap(std::uint32_t elements) {
+        mergeGap_ = elements;
+    }
+
+    [[nodiscard]] const Buffer& buffer() const {
+        return buffer_;
+    }
+    [[nodiscard]] VkDeviceAddress deviceAddress() const {
+        return address_;
+    }
+    [[nodiscard]] std::uint32_t count() const {
+        return count_;
+    }
+    [[nodiscard]] std::uint32_t elementSize() const {
+        return elementSize_;
+    }
+    [[nodiscard]] std::uint32_t framesInFlight() const {
+        return frames_;
+    }
+    [[nodiscard]] VkDeviceSize stagingBytesPerFrame() const {
+        return sliceBytes_;
+    }
+
+  private:
+    SceneBufferStorage(const Allocator& allocator, Buffer buffer, Buffer staging)
+        : buffer_(std::move(buffer)), staging_(std::move(staging)), stagingWrites_(allocator) {}
+
+    void clearDirty(std::uint32_t first, std::uint32_t count);
+    [[nodiscard]] std::uint32_t findDirty(std::uint32_t from) const;
+    [[nodiscard]] std::uint32_t findClean(std::uint32_t from) const;
+
+    Buffer buffer_;
+    Buffer staging_;
+    MappedWrites stagingWrites_; // flushes the staged slice when staging is non-coherent
+    VkDeviceAddress address_ = 0;
+    std::uint32_t elementSize_ = 0;
+    std::uint32_t count_ = 0;
+    std::uint32_t frames_ = 0;
+    std::uint32_t mergeGap_ = 0;
+    VkDeviceSize sliceBytes_ = 0;
+    std::vector<std::uint64_t> dirty_; // one bit per element
+    std::vector<VkBufferCopy> regions_;
+};
+
+// Persistent GPU scene data -- transforms, instance records, material
+// parameters -- kept in a device-local storage buffer with a CPU mirror.
+// Writes go to the mirror and mark their elements dirty; upload() then
+// coalesces the dirty runs into the regions of a single vkCmdCopyBuffer
+// from a per-frame staging slice, so upload bandwidth follows what changed
+// rather than the size of the scene:
+//
+//   auto objects = GpuSceneBuffer<ObjectData>::create(allocator, 100'000).value();
+//   objects.set(i, data);                   // or objects.edit(i).transform = m;
+//   // each frame, before the passes that read it:
+//   auto stats = objects.upload(cmd, frameIndex); // Result<SceneUploadStats>
+//   push.objects = objects.deviceAddress(); // or bind objects.vkBuffer()
+//
+// The buffer has STORAGE_BUFFER | TRANSFER_DST | SHADER_DEVICE_ADDRESS usage.
+// Elements are laid out as an array of T (std430 rules apply to T); for a
+// structure-of-arrays layout use one GpuSceneBuffer per field and pass each
+// address to the shader.
+//
+// Staging: framesInFlight slices of stagingBytesPerFrame each (0 = the whole
+// buffer, so one upload() can always copy everything). Slice `frameIndex`
+// is reused every framesInFlight frames; as with per-frame uniform buffers,
+// the caller's frame fence guarantees the GPU has finished reading it. When
+// a frame's dirty runs do not fit, the rest stays dirty for the next upload().
+// setMergeGap(n) copies up to n clean elements between two dirty runs to
+// save a region; the default 0 copies dirty elements only.
+//
+// upload() records a barrier from earlier `dstStage` reads to the copy and
+// one from the copy to `dstStage`/`dstAccess` (default: any shader stage,
+// storage read). It records nothing when no element is dirty, and nothing
+// when flushing non-coherent staging memory fails (the error is returned and
+// the elements stay dirty). Every element starts dirty, so the first
+// upload() initializes the whole buffer.
+//
+// Thread safety: thread-confined.
+template <typename T> class GpuSceneBuffer {
+    static_assert(std::is_trivially_copyable_v<T>, "GpuSceneBuffer elements are copied as bytes");
+
+  public:
+    [[nodiscard]] static Result<GpuSceneBuffer> create(const Allocator& allocator,
+                                                       std::uint32_t count,
+                                                       std::uint32_t framesInFlight = 2,
+                                                       VkDeviceSize stagingBytesPerFrame = 0) {
+        auto storage = SceneBufferStorage::create(allocator, static_cast<std::uint32_t>(sizeof(T)),
+                                                  count, framesInFlight, stagingBytesPerFrame);
+        if (!storage.ok())
+            return std::move(storage).error();
+        return GpuSceneBuffer(std::move(storage).value());
+    }
+
+    [[nodiscard]] const T& operator[](std::uint32_t index) const {
+        assert(index < mirror_.size());
+        return mirror_[index];
+    }
+    [[nodiscard]] std::span<const T> data() const {
+        return mirror_;
+    }
+
+    void set(std::uint32_t index, const T& value) {
+        assert(index < mirror_.size());
+        mirror_[index] = value;
+        storage_.markDirty(index, 1);
+    }
+
+    // Marks `index` dirty and returns it for in-place modification.
+    [[nodiscard]] T& edit(std::uint32_t index) {
+        assert(index < mirror_.size());
+        storage_.markDirty(index, 1);
+        return mirror_[index];
+    }
+
+    // Marks [first, first + count) dirty and returns it for modification.
+    [[nodiscard]] std::span<T> edit(std::uint32_t first, std::uint32_t count) {
+        assert(first <= mirror_.size() && count <= mirror_.size() - first);
+        storage_.markDirty(first, count);
+        return std::span<T>(mirror_).subspan(first, count);
+    }
+
+    void markDirty(std::uint32_t first, std::uint32_t count = 1) {
+        storage_.markDirty(first, count);
+    }
+    void markAllDirty() {
+        storage_.markAllDirty();
+    }
+    [[nodiscard]] bool isDirty(std::uint32_t index) const {
+        return storage_.isDirty(index);
+    }
+    [[nodiscard]] std::uint32_t dirtyCount() const {
+        return storage_.dirtyCount();
+    }
+
+    // Records this frame's upload into `cmd`, outside a render pass.
+    [[nodiscard]] Result<SceneUploadStats>
+    upload(VkCommandBuffer cmd, std::uint32_t frameIndex,
+           VkPipelineStageFlags2 dstStage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+           VkAccessFlags2 dstAccess = VK_ACCESS_2_SHADER_STORAGE_READ_BIT) {
+        return storage_.upload(cmd, frameIndex, mirror_.data(), dstStage, dstAccess);
+    }
+
+    void setMergeGap(std::uint32_t elements) {
+        storage_.setMergeGap(elements);
+    }
+
+    [[nodiscard]] const Buffer& buffer() const {
+        return storage_.buffer();
+    }
+    [[nodiscard]] VkBuffer vkBuffer() const {
+        return storage_.buffer().vkBuffer();
+    }
+    [[nodiscard]] VkDeviceAddress deviceAddress() const {
+        return storage_.deviceAddress();
+    }
+    [[nodiscard]] std::uint32_t count() const {
+        return storage_.count();
+    }
+    [[nodiscard]] VkDeviceSize sizeBytes() const {
+        return storage_.buffer().size();
+    }
+    [[nodiscard]] VkDeviceSize stagingBytesPerFrame() const {
+        return storage_.stagingBytesPerFrame();
+    }
+
+  private:
+    explicit GpuSceneBuffer(SceneBufferStorage storage)
+        : storage_(std::move(storage)), mirror_(storage_.count()) {}
+
+    SceneBufferStorage storage_;
+    std::vector<T> mirror_;
+};
+
+} // namespace vksdl
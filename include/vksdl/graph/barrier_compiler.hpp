@@ -25,6 +25,11 @@ struct BarrierBatch {
         return imageBarriers.empty() && bufferBarriers.empty() && memoryBarriers.empty();
     }
 
+    [[nodiscard]] std::uint32_t size() const {
+        return static_cast<std::uint32_t>(imageBarriers.size() + bufferBarriers.size() +
+                                          memoryBarriers.size());
+    }
+
     void clear();
 };
 
@@ -56,6 +61,32 @@ void appendImageBarrier(BarrierBatch& batch, const ImageBarrierRequest& req);
 // No-op when no barrier is needed.
 void appendBufferBarrier(BarrierBatch& batch, const BufferBarrierRequest& req);
 
+// Append a queue-family ownership transfer for this image transition. The
+// release half goes to `release` (recorded on the srcFamily queue), the
+// acquire half to `acquire` (recorded on the dstFamily queue); both carry the
+// same layout transition. Always emits, even when the same-queue case would
+// need no barrier, because exclusive resources must change owner explicitly.
+void appendImageOwnershipTransfer(BarrierBatch& release, BarrierBatch& acquire,
+                                  const ImageBarrierRequest& req, std::uint32_t srcFamily,
+                                  std::uint32_t dstFamily);
+
+// Buffer counterpart of appendImageOwnershipTransfer().
+void appendBufferOwnershipTransfer(BarrierBatch& release, BarrierBatch& acquire,
+                                   const BufferBarrierRequest& req, std::uint32_t srcFamily,
+                                   std::uint32_t dstFamily);
+
+// Shrink `batch` without weakening it:
+//  - image barriers that differ only in subresource range merge when the
+//    ranges are adjacent or overlapping along one axis (mips with equal
+//    layers, or layers with equal mips) -- a mip-by-mip producer's chain
+//    becomes one barrier;
+//  - buffer barriers without an ownership transfer fold into global memory
+//    barriers, one per distinct stage/access set, and identical memory
+//    barriers are deduplicated.
+// Ownership transfers are left untouched: release and acquire halves must
+// keep matching ranges. Returns the number of barriers removed.
+std::uint32_t coalesceBarriers(BarrierBatch& batch);
+
 // Check if an access mask contains any write operations.
 [[nodiscard]] bool isWriteAccess(VkAccessFlags2 access);
 
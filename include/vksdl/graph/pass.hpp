@@ -33,7 +33,7 @@ class PassContext;
 enum class PassType : std::uint8_t {
     Graphics, // Runs on graphics queue.
     Compute,  // Runs inline on graphics queue; reserved for future async compute.
-    Transfer, // Runs inline on graphics queue; reserved for future async DMA.
+    Transfer, // Graphics queue, or the async transfer queue (RenderGraph::enableAsyncTransfer).
 };
 
 enum class AccessType : std::uint8_t {
@@ -89,6 +89,7 @@ struct PassDecl {
 
     std::vector<ColorTargetDecl> colorTargets;
     std::optional<DepthTargetDecl> depthTarget;
+    std::uint32_t viewMask = 0; // 0 = single-view
 
     VkPipeline pipeline = VK_NULL_HANDLE;
     VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
@@ -121,6 +122,14 @@ class PassBuilder {
     PassBuilder& setDepthTarget(ResourceHandle h, LoadOp loadOp, DepthWrite depthWrite,
                                 float clearDepth, std::uint32_t clearStencil = 0);
 
+    // Multiview: render targets become 2D array views over layers
+    // [0, 32 - countl_zero(mask)) and every set bit renders one layer, so a
+    // whole cascade set, cube map or stereo pair is drawn in one pass.
+    // Attachment barriers cover the same layer range. Call before declaring
+    // render targets; pipelines drawn here need a matching
+    // PipelineBuilder::viewMask(). Requires Device::hasMultiview().
+    PassBuilder& setViewMask(std::uint32_t mask);
+
     // Through sampler, not storage.
     PassBuilder& sampleImage(ResourceHandle h,
                              SubresourceRange range = {0, VK_REMAINING_MIP_LEVELS, 0,
@@ -184,12 +193,16 @@ class PassBuilder {
     // Derive pipeline stage from PassType for shader-accessible resources.
     [[nodiscard]] VkPipelineStageFlags2 shaderStage() const;
 
+    // Subresource range touched by an attachment: the view mask's layers.
+    [[nodiscard]] SubresourceRange attachmentRange() const;
+
     PassType type_;
     std::vector<ResourceAccess> accesses_;
 
     // Layer 1 state, moved into PassDecl by addPass().
     std::vector<ColorTargetDecl> colorTargets_;
     std::optional<DepthTargetDecl> depthTarget_;
+    std::uint32_t viewMask_ = 0;
 
     // Layer 2 state, moved into PassDecl by addPass().
     VkSampler defaultSampler_ = VK_NULL_HANDLE;
@@ -2,6 +2,7 @@
 
 #include <vksdl/graph/resource.hpp>
 #include <vksdl/graph/resource_state.hpp>
+#include <vksdl/image_view_cache.hpp>
 
 #include <vulkan/vulkan.h>
 
@@ -39,6 +40,13 @@ class PassContext {
   public:
     [[nodiscard]] VkImage vkImage(ResourceHandle h) const;
     [[nodiscard]] VkImageView vkImageView(ResourceHandle h) const;
+
+    // View of a mip/layer range, view type, format or aspect of an image
+    // resource, e.g. imageView(h, ImageViewDesc::mip(level)). Created on first
+    // use and kept until the image is destroyed, so per-mip and per-layer
+    // passes need no view management. VK_NULL_HANDLE if the resource has no
+    // view cache (raw importImage() without one) or creation failed.
+    [[nodiscard]] VkImageView imageView(ResourceHandle h, const ImageViewDesc& desc) const;
     [[nodiscard]] VkBuffer vkBuffer(ResourceHandle h) const;
     [[nodiscard]] VkDeviceSize bufferSize(ResourceHandle h) const;
 
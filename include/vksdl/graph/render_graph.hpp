@@ -5,6 +5,7 @@
 #include <vksdl/graph/pass_context.hpp>
 #include <vksdl/graph/resource.hpp>
 #include <vksdl/graph/resource_state.hpp>
+#include <vksdl/image_view_cache.hpp>
 #include <vksdl/result.hpp>
 
 #include <vulkan/vulkan.h>
@@ -14,6 +15,7 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace vksdl {
@@ -23,6 +25,7 @@ class Image;
 class Buffer;
 struct ReflectedLayout;
 class DescriptorAllocator;
+class TransferQueue;
 } // namespace vksdl
 
 namespace vksdl::graph {
@@ -35,6 +38,8 @@ struct ResolvedRendering {
     VkRenderingAttachmentInfo depthAttachment{};
     bool hasDepth = false;
     VkExtent2D renderArea{};
+    std::uint32_t viewMask = 0;   // PassBuilder::setViewMask(); 0 = single-view
+    std::uint32_t layerCount = 1; // layers the attachment views span
 };
 
 // Pre-resolved descriptor state for one pass (Layer 2).
@@ -49,10 +54,18 @@ struct ResolvedDescriptors {
 
 // Compiled pass: sorted index + pre-computed barriers + optional rendering/descriptor state.
 struct CompiledPass {
-    std::uint32_t passIndex;         // index into passes_
-    BarrierBatch barriers;           // barriers to emit before this pass
-    ResolvedRendering rendering;     // Layer 1: pre-resolved VkRenderingInfo (empty if Layer 0)
-    ResolvedDescriptors descriptors; // Layer 2: auto-resolved descriptors (empty if Layer 0/1)
+    std::uint32_t passIndex;           // index into passes_
+    BarrierBatch barriers;             // barriers to emit before this pass
+    std::uint32_t emittedBarriers = 0; // barriers.size() before coalesceBarriers()
+    ResolvedRendering rendering;       // Layer 1: pre-resolved VkRenderingInfo (empty if Layer 0)
+    ResolvedDescriptors descriptors;   // Layer 2: auto-resolved descriptors (empty if Layer 0/1)
+
+    // Async transfer: the pass is recorded by executeAsyncTransfer() on the
+    // transfer queue instead of execute(). releaseBarriers hands resources
+    // over to the graphics family and is emitted after the pass (only the
+    // last async pass in execution order carries them).
+    bool asyncTransfer = false;
+    BarrierBatch releaseBarriers;
 };
 
 // Transient VMA-backed image created during compile().
@@ -75,7 +88,8 @@ struct TransientBuffer {
 struct GraphStats {
     std::uint32_t passCount = 0;
     std::uint32_t imageBarrierCount = 0;
-    std::uint32_t bufferBarrierCount = 0;
+    std::uint32_t bufferBarrierCount = 0; // ownership transfers; the rest fold into memory barriers
+    std::uint32_t memoryBarrierCount = 0;
     std::uint32_t transientCount = 0;
     double compileTimeUs = 0.0;
 
@@ -91,6 +105,24 @@ struct GraphStats {
     double renderTargetUs = 0.0;
     double descriptorUs = 0.0;
     double statsUs = 0.0;
+
+    // Incremental recompilation. When the structure changed but only a
+    // subgraph is affected, compile() re-sorts and re-barriers just that
+    // subgraph and reuses the previous frame's results for everything else.
+    bool incremental = false;              // this compile took the incremental path
+    std::uint32_t recompiledPassCount = 0; // passes whose barriers were recompiled
+    double lastFullCompileUs = 0.0;        // most recent full structural compile
+    double lastIncrementalCompileUs = 0.0; // most recent incremental compile
+
+    // Async transfer scheduling (see RenderGraph::enableAsyncTransfer).
+    std::uint32_t asyncTransferPassCount = 0; // passes moved to the transfer queue
+    std::uint32_t ownershipTransferCount = 0; // release/acquire barrier pairs
+
+    // Barrier coalescing (see coalesceBarriers()): barriers the compiler
+    // emitted, and what is left after merging sub-range image barriers and
+    // folding buffer barriers into memory barriers. Excludes release batches.
+    std::uint32_t barriersBeforeCoalescing = 0;
+    std::uint32_t barriersAfterCoalescing = 0;
 };
 
 // Render graph: declare passes with resource dependencies, compile to
@@ -116,15 +148,19 @@ class RenderGraph {
     RenderGraph(const RenderGraph&) = delete;
     RenderGraph& operator=(const RenderGraph&) = delete;
 
-    // Import an external image. Aspect auto-derived from format.
+    // Import an external image. Aspect auto-derived from format. `views`
+    // (optional, caller-owned, must outlive the frame) serves
+    // PassContext::imageView() for this resource.
     [[nodiscard]] ResourceHandle importImage(VkImage image, VkImageView view, VkFormat format,
                                              std::uint32_t width, std::uint32_t height,
                                              const ResourceState& initialState,
                                              std::uint32_t mipLevels = 1,
                                              std::uint32_t arrayLayers = 1,
-                                             std::string_view name = "");
+                                             std::string_view name = "",
+                                             ImageViewCache* views = nullptr);
 
-    // Import from a vksdl::Image.
+    // Import from a vksdl::Image. PassContext::imageView() uses the image's
+    // own view cache.
     [[nodiscard]] ResourceHandle importImage(const Image& image, const ResourceState& initialState,
                                              std::string_view name = "");
 
@@ -163,6 +199,43 @@ class RenderGraph {
     // Convenience: compile + execute.
     [[nodiscard]] Result<void> compileAndExecute(VkCommandBuffer cmd);
 
+    // Async transfer: run PassType::Transfer passes on a dedicated transfer
+    // queue family so large copies overlap rendering. A Transfer pass moves
+    // to the transfer queue when all of its producers also do, no
+    // graphics-queue pass touches its resources earlier in the frame, and
+    // its resources are not owned by another family at frame start.
+    // compile() then emits matching release (transfer side) and acquire
+    // (graphics side) ownership barriers. Per frame:
+    //   graph.compile();
+    //   if (graph.hasAsyncTransferWork()) {
+    //       graph.executeAsyncTransfer(transferCmd);
+    //       auto value = transferQueue.submit(transferCmd);      // signals timeline
+    //       wait = graph.asyncTransferWait(transferQueue.vkTimelineSemaphore(), value.value());
+    //   }
+    //   graph.execute(graphicsCmd); // submit with `wait` in pWaitSemaphoreInfos
+    // Resources written on the transfer queue and not read by a graphics
+    // pass in the same frame stay owned by the transfer family; declare that
+    // in their initialState.queueFamily when importing them next frame.
+    // No-op when both families are equal. Persists across reset().
+    void enableAsyncTransfer(std::uint32_t transferFamily, std::uint32_t graphicsFamily);
+    void enableAsyncTransfer(const TransferQueue& transferQueue);
+    void disableAsyncTransfer();
+
+    // True when the last compile() scheduled at least one pass onto the
+    // transfer queue, or a resource the transfer family owned at frame start
+    // must be released there for a graphics pass to acquire it.
+    [[nodiscard]] bool hasAsyncTransferWork() const;
+
+    // Record async transfer passes (and the trailing release barriers, even
+    // with no async pass) into a command buffer allocated from the transfer
+    // family. Call after compile().
+    void executeAsyncTransfer(VkCommandBuffer transferCmd);
+
+    // Timeline wait for the graphics submit: waits for `value` on `timeline`
+    // at the stages of the first acquiring passes.
+    [[nodiscard]] VkSemaphoreSubmitInfo asyncTransferWait(VkSemaphore timeline,
+                                                          std::uint64_t value) const;
+
     // Pre-warm the transient pool by compiling the current graph and
     // recycling allocations. Call after declaring the graph structure
     // (importImage/createImage/addPass) during init, before the main loop.
@@ -194,12 +267,26 @@ class RenderGraph {
     // and a one-line summary. Use for debugging synchronization issues.
     void dumpLog() const;
 
+    // Machine-readable export of the compiled graph. Call after compile().
+    // JSON carries passes in execution order, resources with lifetimes and
+    // aliasing groups, every barrier with stage/access/layout, and timings.
+    // Resources and passes are keyed by name so two exports can be diffed
+    // (see tools/graph_diff). Returns an empty string if not compiled.
+    [[nodiscard]] std::string exportJson() const;
+
+    // Graphviz digraph: pass nodes in execution order, resource nodes, and
+    // read/write edges. Pass labels carry their barrier counts.
+    [[nodiscard]] std::string exportDot() const;
+
   private:
     void destroy();
     void destroyTransients();
     void recycleTransients(); // move active transients to pool (no VMA calls)
     void destroyPool();       // destroy pooled allocations via VMA
 
+    // Diff of this frame's structure against the previous compile (defined in .cpp).
+    struct IncrementalPlan;
+
     // Compile steps.
     void resolveRemainingCounts();
     void accumulateTransientUsage();
@@ -209,12 +296,41 @@ class RenderGraph {
     [[nodiscard]] Result<void> allocateTransients();
     void initStateTrackers();
     [[nodiscard]] Result<void> compileBarriers(const std::vector<std::uint32_t>& order);
-    void resolveRenderTargets(const std::vector<std::uint32_t>& order);
+    [[nodiscard]] Result<void> compileAccess(const ResourceAccess& acc, BarrierBatch* out,
+                                             BarrierBatch* release = nullptr);
+    [[nodiscard]] bool markAsyncTransferPasses(const std::vector<std::uint32_t>& order,
+                                               std::vector<std::uint8_t>& async) const;
+    void recordPass(const CompiledPass& cp, VkCommandBuffer cmd);
+    [[nodiscard]] Result<void> validateViewMasks() const;
+    [[nodiscard]] Result<VkImageView> attachmentView(const ResourceEntry& res,
+                                                     std::uint32_t viewMask) const;
+    [[nodiscard]] Result<void> resolveRenderTargets(const std::vector<std::uint32_t>& order);
     [[nodiscard]] Result<void> resolveDescriptors();
 
+    // Incremental compile steps (used when planIncremental() succeeds).
+    [[nodiscard]] bool planIncremental(const std::vector<std::uint64_t>& passHashes,
+                                       const std::vector<std::uint64_t>& resourceHashes,
+                                       IncrementalPlan& plan) const;
+    void updateAdjacency(const IncrementalPlan& plan);
+    [[nodiscard]] bool incrementalSort(const IncrementalPlan& plan,
+                                       std::vector<std::uint32_t>& order) const;
+    [[nodiscard]] Result<std::uint32_t>
+    compileBarriersIncremental(const std::vector<std::uint32_t>& order,
+                               const IncrementalPlan& plan);
+
     VkDevice device_ = VK_NULL_HANDLE;
     void* allocator_ = nullptr; // VmaAllocator, stored as void*
     bool hasUnifiedLayouts_ = false;
+    bool hasMultiview_ = false;
+
+    // Async transfer configuration (VK_QUEUE_FAMILY_IGNORED = disabled) and
+    // the graphics-side wait stages computed by the last barrier compile.
+    std::uint32_t asyncTransferFamily_ = VK_QUEUE_FAMILY_IGNORED;
+    std::uint32_t asyncGraphicsFamily_ = VK_QUEUE_FAMILY_IGNORED;
+    VkPipelineStageFlags2 asyncWaitStages_ = VK_PIPELINE_STAGE_2_NONE;
+    // Releases of resources owned by the transfer family at frame start,
+    // when no async pass carries them.
+    BarrierBatch asyncReleases_;
 
     std::vector<PassDecl> passes_;
     std::vector<ResourceEntry> resources_;
@@ -238,6 +354,10 @@ class RenderGraph {
     std::vector<TransientImage> imagePool_;
     std::vector<TransientBuffer> bufferPool_;
 
+    // Per-subresource views of transient images, keyed by image. An entry
+    // lives exactly as long as its image, pooled frames included.
+    std::unordered_map<VkImage, ImageViewCache> transientViews_;
+
     // Graph structure cache: skip re-sorting on identical frames.
     std::uint64_t lastGraphHash_ = 0;
     std::vector<std::uint32_t> cachedOrder_; // topological sort from previous compile
@@ -249,6 +369,15 @@ class RenderGraph {
     std::vector<VkBuffer> cachedBufferHandles_;
     GraphStats cachedStats_;
 
+    // Incremental recompilation cache: per-pass and per-resource structural
+    // hashes from the last structural compile, plus the resources each pass
+    // touched (needed to dirty resources of passes that disappear).
+    std::vector<std::uint64_t> cachedPassHashes_;
+    std::vector<std::uint64_t> cachedResourceHashes_;
+    std::vector<std::vector<std::uint32_t>> cachedPassResources_;
+    double lastFullCompileUs_ = 0.0;
+    double lastIncrementalCompileUs_ = 0.0;
+
     // Layer 2: descriptor auto-bind state.
     std::unique_ptr<DescriptorAllocator> descAllocator_;
     std::vector<VkDescriptorSetLayout> dslCache_; // created per compile, destroyed on reset/destroy
@@ -7,6 +7,10 @@
 #include <cstdint>
 #include <string>
 
+namespace vksdl {
+class ImageViewCache;
+} // namespace vksdl
+
 namespace vksdl::graph {
 
 // Opaque handle to a graph resource. Index into the graph's resource table.
@@ -68,6 +72,10 @@ struct ResourceEntry {
     VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
     ResourceState initialState;
 
+    // Per-subresource views for PassContext::imageView(). Owned by the graph
+    // for transients, by the imported Image otherwise; null when unavailable.
+    ImageViewCache* views = nullptr;
+
     // Lifetime span (set during compile, indices into sorted pass order).
     std::uint32_t firstPass = UINT32_MAX;
     std::uint32_t lastPass = UINT32_MAX;
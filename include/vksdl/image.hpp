@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vksdl/error.hpp>
+#include <vksdl/image_view_cache.hpp>
 #include <vksdl/result.hpp>
 #include <vksdl/vma_fwd.hpp>
 
@@ -12,7 +13,8 @@ namespace vksdl {
 
 class Allocator;
 
-// Thread safety: immutable after construction.
+// Thread safety: immutable after construction, except view() and
+// viewCache(), which are thread-confined.
 class Image {
   public:
     ~Image();
@@ -43,6 +45,15 @@ class Image {
         return samples_;
     }
 
+    // Extra views of sub-ranges or reinterpreted formats, created on first
+    // use and destroyed with the image. vkImageView() stays the full view.
+    [[nodiscard]] Result<VkImageView> view(const ImageViewDesc& desc) const {
+        return views_.view(desc);
+    }
+    [[nodiscard]] ImageViewCache& viewCache() const {
+        return views_;
+    }
+
   private:
     friend class ImageBuilder;
     Image() = default;
@@ -56,6 +67,7 @@ class Image {
     VkExtent2D extent_ = {0, 0};
     std::uint32_t mipLevels_ = 1;
     VkSampleCountFlagBits samples_ = VK_SAMPLE_COUNT_1_BIT;
+    mutable ImageViewCache views_;
 };
 
 class ImageBuilder {
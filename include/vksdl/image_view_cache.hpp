@@ -0,0 +1,93 @@
+#pragma once
+
+#include <vksdl/error.hpp>
+#include <vksdl/result.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace vksdl {
+
+// Which view of an image to create. Defaults select the whole image with the
+// image's own format and aspect.
+struct ImageViewDesc {
+    std::uint32_t baseMipLevel = 0;
+    std::uint32_t levelCount = VK_REMAINING_MIP_LEVELS;
+    std::uint32_t baseArrayLayer = 0;
+    std::uint32_t layerCount = VK_REMAINING_ARRAY_LAYERS;
+    // VK_IMAGE_VIEW_TYPE_MAX_ENUM = 2D for one layer, 2D_ARRAY otherwise.
+    VkImageViewType viewType = VK_IMAGE_VIEW_TYPE_MAX_ENUM;
+    // VK_FORMAT_UNDEFINED = the image's format. A different format needs an
+    // image created with VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT.
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkImageAspectFlags aspect = 0; // 0 = the image's aspect
+
+    [[nodiscard]] bool operator==(const ImageViewDesc&) const = default;
+
+    // One mip level, every layer (mip generation, per-mip storage writes).
+    [[nodiscard]] static ImageViewDesc mip(std::uint32_t level) {
+        ImageViewDesc d;
+        d.baseMipLevel = level;
+        d.levelCount = 1;
+        return d;
+    }
+    // One array layer as a 2D view, every mip (cube faces, cascades).
+    [[nodiscard]] static ImageViewDesc layer(std::uint32_t layer) {
+        ImageViewDesc d;
+        d.baseArrayLayer = layer;
+        d.layerCount = 1;
+        return d;
+    }
+};
+
+// Lazily created views of one image. view() creates a VkImageView the first
+// time a description is requested and returns the same handle afterwards;
+// every view lives until clear() or destruction, which must happen before
+// the image is destroyed and after the GPU stops using the views.
+//
+// Lookups are a linear scan: images rarely carry more than a handful of
+// views, and the descriptions are compared after resolving defaults, so
+// `{}` and an explicit full range share one view.
+//
+// Thread safety: thread-confined.
+class ImageViewCache {
+  public:
+    ImageViewCache() = default;
+    ImageViewCache(VkDevice device, VkImage image, VkFormat format, VkImageAspectFlags aspect,
+                   std::uint32_t mipLevels, std::uint32_t arrayLayers);
+    ~ImageViewCache();
+    ImageViewCache(ImageViewCache&&) noexcept;
+    ImageViewCache& operator=(ImageViewCache&&) noexcept;
+    ImageViewCache(const ImageViewCache&) = delete;
+    ImageViewCache& operator=(const ImageViewCache&) = delete;
+
+    [[nodiscard]] Result<VkImageView> view(const ImageViewDesc& desc = {});
+
+    // Destroys every cached view.
+    void clear();
+
+    [[nodiscard]] std::size_t size() const {
+        return entries_.size();
+    }
+    [[nodiscard]] VkImage vkImage() const {
+        return image_;
+    }
+
+  private:
+    struct Entry {
+        ImageViewDesc desc;
+        VkImageView view = VK_NULL_HANDLE;
+    };
+
+    VkDevice device_ = VK_NULL_HANDLE;
+    VkImage image_ = VK_NULL_HANDLE;
+    VkFormat format_ = VK_FORMAT_UNDEFINED;
+    VkImageAspectFlags aspect_ = VK_IMAGE_ASPECT_COLOR_BIT;
+    std::uint32_t mipLevels_ = 1;
+    std::uint32_t arrayLayers_ = 1;
+    std::vector<Entry> entries_;
+};
+
+} // namespace vksdl
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vksdl/error.hpp>
+#include <vksdl/result.hpp>
+#include <vksdl/vma_fwd.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace vksdl {
+
+class Allocator;
+class Buffer;
+
+// Copies at or above this size use non-temporal stores in streamingCopy().
+inline constexpr std::size_t kStreamingCopyThreshold = 64 * 1024;
+
+// memcpy for uploads into mapped GPU memory. Large copies bypass the CPU
+// caches with SSE2 streaming stores: no read-for-ownership of the
+// destination, no eviction of the caller's working set, and full 64-byte
+// bursts into write-combined (BAR) memory. Small copies, and targets without
+// SSE2, use std::memcpy. Ends with a store fence, so the data is globally
+// visible before a following flush or queue submit.
+void streamingCopy(void* dst, const void* src, std::size_t bytes);
+
+// Collects host writes into persistently mapped buffers and makes them
+// visible to the device with one vmaFlushAllocations() call, typically once
+// per frame right before submit. Writes into HOST_COHERENT memory need no
+// flush and are not recorded, so on most desktop GPUs flush() is free.
+//
+//   MappedWrites writes(allocator);
+//   writes.write(uniforms, 0, &camera, sizeof(camera));
+//   std::memcpy(instances.mappedData(), data, bytes);
+//   writes.markWritten(instances, 0, bytes);
+//   writes.flush(); // one call for every non-coherent range
+//
+// Recorded buffers must outlive the next flush().
+//
+// Thread safety: thread-confined.
+class MappedWrites {
+  public:
+    explicit MappedWrites(const Allocator& allocator);
+
+    // Copies `size` bytes into dst's mapping at `offset` with
+    // streamingCopy() and records the range. `dst` must be mapped.
+    void write(const Buffer& dst, VkDeviceSize offset, const void* src, VkDeviceSize size);
+
+    // Records a range the caller wrote through dst.mappedData().
+    void markWritten(const Buffer& dst, VkDeviceSize offset, VkDeviceSize size);
+
+    // Flushes every recorded range in one call and clears them. Overlapping
+    // and adjacent ranges of one buffer are merged first.
+    [[nodiscard]] Result<void> flush();
+
+    // Ranges recorded since the last flush(), before merging.
+    [[nodiscard]] std::size_t pendingRanges() const {
+        return ranges_.size();
+    }
+
+    // Ranges the last flush() handed to VMA, after merging.
+    [[nodiscard]] std::size_t lastFlushRanges() const {
+        return lastFlushRanges_;
+    }
+
+  private:
+    struct Range {
+        VmaAllocation allocation = nullptr;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+    };
+
+    VmaAllocator allocator_ = nullptr;
+    std::vector<Range> ranges_;
+    std::size_t lastFlushRanges_ = 0;
+
+    // Scratch arrays for vmaFlushAllocations, kept to avoid per-frame allocation.
+    std::vector<VmaAllocation> flushAllocations_;
+    std::vector<VkDeviceSize> flushOffsets_;
+    std::vector<VkDeviceSize> flushSizes_;
+};
+
+} // namespace vksdl
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <vksdl/error.hpp>
+#include <vksdl/gpu_scene_buffer.hpp>
+#include <vksdl/image.hpp>
+#include <vksdl/mesh.hpp>
+#include <vksdl/result.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vksdl {
+
+class Allocator;
+class BindlessTable;
+class Device;
+
+// GpuMaterial::diffuseTexture when the material has no texture.
+inline constexpr std::uint32_t kNoMaterialTexture = UINT32_MAX;
+
+// One material as the shader sees it. std430 layout, 32 bytes:
+//
+//   struct Material { vec4 baseColor; float metallic; float roughness;
+//                     uint diffuseTexture; uint flags; };
+struct GpuMaterial {
+    float baseColor[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    float metallic = 0.0f;
+    float roughness = 1.0f;
+    std::uint32_t diffuseTexture = kNoMaterialTexture; // BindlessTable slot
+    std::uint32_t flags = 0;                           // free for the application
+};
+static_assert(sizeof(GpuMaterial) == 32, "GpuMaterial layout changed -- update shaders");
+
+// Bindless materials: registers Materials, loads their textures into
+// BindlessTable slots and packs their parameters into one storage buffer
+// indexed by material ID. A draw then needs only its material index:
+//
+//   auto materials = MaterialTable::create(allocator, device, bindless, sampler, 1024).value();
+//   for (const MeshData& m : model.meshes)
+//       drawMaterial.push_back(materials.add(m.material).value());
+//   // each frame, before the passes that read it:
+//   if (auto up = materials.upload(cmd, frameIndex); !up.ok()) { /* handle */ }
+//   push.materials = materials.deviceAddress();
+//   push.material = drawMaterial[i]; // per draw: one push constant, no binds
+//
+//   // GLSL
+//   Material m = materials.data[push.material];
+//   if (m.diffuseTexture != 0xFFFFFFFFu)
+//       color *= texture(textures[nonuniformEXT(m.diffuseTexture)], uv);
+//
+// Parameters live in a GpuSceneBuffer: add(), set() and edit() mark only
+// the touched records dirty, and upload() copies the dirty runs in one
+// vkCmdCopyBuffer. Textures are taken from slot `firstTextureSlot` of the
+// BindlessTable upward; the same path is loaded once and shared. The table
+// owns the images it loads; addTexture() registers an image the caller
+// keeps alive.
+//
+// Loading textures is blocking (uploadToImage()) -- load time only, and
+// only when built with loaders (VKSDL_HAS_LOADERS). Textures are sampled
+// in SHADER_READ_ONLY_OPTIMAL through `sampler`, with a single mip level.
+//
+// Requires a COMBINED_IMAGE_SAMPLER BindlessTable that outlives this table.
+//
+// Thread safety: thread-confined.
+class MaterialTable {
+  public:
+    [[nodiscard]] static Result<MaterialTable>
+    create(const Allocator& allocator, const Device& device, BindlessTable& textures,
+           VkSampler sampler, std::uint32_t capacity, std::uint32_t firstTextureSlot = 0,
+           std::uint32_t framesInFlight = 2);
+
+    // Registers `material` under the next ID, loading its diffuse texture
+    // if it names one.
+    [[nodiscard]] Result<std::uint32_t> add(const Material& material);
+
+    // Replaces material `id`, loading a newly named texture. An `id` not
+    // returned by add() is an InvalidArgument error.
+    [[nodiscard]] Result<void> set(std::uint32_t id, const Material& material);
+
+    // Marks material `id` dirty and returns its record for modification.
+    [[nodiscard]] GpuMaterial& edit(std::uint32_t id) {
+        assert(id < count_);
+        return params_.edit(id);
+    }
+    [[nodiscard]] const GpuMaterial& operator[](std::uint32_t id) const {
+        assert(id < count_);
+        return params_[id];
+    }
+
+#if VKSDL_HAS_LOADERS
+    // Loads an image file into the next bindless slot and returns the slot.
+    // A path loaded before returns its existing slot.
+    [[nodiscard]] Result<std::uint32_t> loadTexture(const std::filesystem::path& path);
+#endif
+
+    // Writes a caller-owned view into the next bindless slot.
+    [[nodiscard]] Result<std::uint32_t> addTexture(VkImageView view, VkImageLayout layout);
+
+    // Records this frame's parameter upload into `cmd`, outside a render pass.
+    [[nodiscard]] Result<SceneUploadStats>
+    upload(VkCommandBuffer cmd, std::uint32_t frameIndex,
+           VkPipelineStageFlags2 dstStage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+           VkAccessFlags2 dstAccess = VK_ACCESS_2_SHADER_STORAGE_READ_BIT) {
+        return params_.upload(cmd, frameIndex, dstStage, dstAccess);
+    }
+
+    [[nodiscard]] std::uint32_t count() const {
+        return count_;
+    }
+    [[nodiscard]] std::uint32_t capacity() const {
+        return params_.count();
+    }
+    [[nodiscard]] std::uint32_t textureCount() const {
+        return nextSlot_ - firstSlot_;
+    }
+    [[nodiscard]] const Buffer& buffer() const {
+        return params_.buffer();
+    }
+    [[nodiscard]] VkBuffer vkBuffer() const {
+        return params_.vkBuffer();
+    }
+    [[nodiscard]] VkDeviceAddress deviceAddress() const {
+        return params_.deviceAddress();
+    }
+
+  private:
+    explicit MaterialTable(GpuSceneBuffer<GpuMaterial> params) : params_(std::move(params)) {}
+
+    [[nodiscard]] Result<GpuMaterial> pack(const Material& material);
+
+    const Allocator* allocator_ = nullptr; // non-owning, for texture loads
+    const Device* device_ = nullptr;       // non-owning, for texture loads
+    BindlessTable* textures_ = nullptr;    // non-owning
+    VkSampler sampler_ = VK_NULL_HANDLE;
+    GpuSceneBuffer<GpuMaterial> params_;
+    std::uint32_t count_ = 0;
+    std::uint32_t firstSlot_ = 0;
+    std::uint32_t nextSlot_ = 0;
+    std::vector<Image> images_;
+    std::unordered_map<std::string, std::uint32_t> pathSlots_;
+};
+
+} // namespace vksdl
@@ -117,8 +117,9 @@ class Mesh {
 };
 
 // Staged upload: creates device-local vertex + index buffers from MeshData,
-// copies data via staging buffers, waits for completion.
-// Blocking -- suitable for init-time uploads only.
+// copies data via staging buffers, waits for completion. On large-BAR systems
+// the buffers are written directly when Allocator::preferDirectUpload()
+// allows it. Blocking -- suitable for init-time uploads only.
 [[nodiscard]] Result<Mesh> uploadMesh(const Allocator& allocator, const Device& device,
                                       const MeshData& meshData);
 
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <vksdl/dynamic_state.hpp>
 #include <vksdl/error.hpp>
+#include <vksdl/pipeline_key.hpp>
 #include <vksdl/result.hpp>
 #include <vksdl/shader_reflect.hpp>
 
@@ -17,6 +19,7 @@ namespace vksdl {
 
 class Device;
 class DescriptorSet;
+class PipelineBinaryStore;
 class PipelineCache;
 class PipelineCompiler;
 class Swapchain;
@@ -142,6 +145,10 @@ class PipelineBuilder {
     PipelineBuilder& colorFormat(const Swapchain& swapchain);
     PipelineBuilder& colorFormat(VkFormat format);
     PipelineBuilder& depthFormat(VkFormat format);
+    // Multiview: render every set bit of `mask` as one array layer, with
+    // gl_ViewIndex selecting the view. Must match the pass's view mask
+    // (PassBuilder::setViewMask()). Requires Device::hasMultiview().
+    PipelineBuilder& viewMask(std::uint32_t mask);
 
     // Vertex input -- default: none (geometry hardcoded in shader).
     PipelineBuilder& vertexBinding(std::uint32_t binding, std::uint32_t stride,
@@ -169,6 +176,22 @@ class PipelineBuilder {
     PipelineBuilder& dynamicTopology();
     PipelineBuilder& dynamicFrontFace();
 
+    // Make every state the device can set dynamically dynamic: all Vulkan 1.3
+    // core states (extended dynamic state 1 and 2, depth bias, stencil, depth
+    // bounds, line width, blend constants) plus the extended dynamic state 3
+    // states the device enabled (polygon mode, sample mask, alpha to
+    // coverage, depth clamp, blend enable/equation, color write mask).
+    // The values of those states leave the pipeline key and the create info
+    // is written in canonical form, so builders that differ only in them
+    // produce the same pipeline. Topology keeps its class (point, line,
+    // triangle, patch) as the core feature set requires.
+    // Every dynamic state must be set before drawing: apply dynamicValues()
+    // (or any DynamicStateValues) through a DynamicStateTracker.
+    PipelineBuilder& maximalDynamicState();
+
+    // The builder's fixed-function configuration as dynamic state values.
+    [[nodiscard]] DynamicStateValues dynamicValues() const;
+
     // Specialization constants shared across all stages (vertex + fragment).
     // For per-stage specialization, use specialize() with a manually built
     // VkSpecializationInfo.
@@ -192,6 +215,11 @@ class PipelineBuilder {
     PipelineBuilder& cache(const PipelineCache& c);
     PipelineBuilder& cache(VkPipelineCache c);
 
+    // Create from stored VK_KHR_pipeline_binary data when the store has this
+    // pipeline's key; otherwise compile and capture into the store. The
+    // store must outlive build(). No effect if the store is unsupported.
+    PipelineBuilder& binaryStore(PipelineBinaryStore& store);
+
     PipelineBuilder& pushConstantRange(VkPushConstantRange range);
     PipelineBuilder& descriptorSetLayout(VkDescriptorSetLayout layout);
     PipelineBuilder& pipelineLayout(VkPipelineLayout layout);
@@ -212,6 +240,18 @@ class PipelineBuilder {
 
     [[nodiscard]] Result<Pipeline> build();
 
+    // Canonical serialization of everything that decides the compiled
+    // pipeline: shader SPIR-V (read from disk for path shaders), formats,
+    // vertex input, fixed-function and dynamic state, layout inputs and
+    // specialization constants. Pre-created modules, set layouts and
+    // external layouts are written as handle values, so the key is a
+    // process-local identity (see PipelineKey). The cache and binary store
+    // are not part of the identity.
+    [[nodiscard]] Result<void> serialize(PipelineKeyWriter& writer) const;
+
+    // hash128() of serialize().
+    [[nodiscard]] Result<PipelineKey> key() const;
+
     // Build with extra VkPipelineCreateFlags. Escape hatch for cache-only
     // probes (FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT) and GPL library flags.
     // Const because it only reads builder state and fills stack-local create infos.
@@ -220,8 +260,19 @@ class PipelineBuilder {
   private:
     friend class PipelineCompiler;
 
+    // buildWithFlags() with an explicit binary store and pipeline cache
+    // (PipelineCompiler substitutes its own store when the builder has none,
+    // and a cache leased from its pool for the shared one).
+    [[nodiscard]] Result<Pipeline> buildImpl(VkPipelineCreateFlags flags,
+                                             PipelineBinaryStore* store,
+                                             VkPipelineCache cache) const;
+
     [[nodiscard]] Result<VkShaderModule> createModule(const std::vector<std::uint32_t>& code) const;
 
+    // Viewport, scissor, extra states and (with maximalDynamicState()) the
+    // maximal set, without duplicates.
+    [[nodiscard]] std::vector<VkDynamicState> dynamicStates() const;
+
     VkDevice device_ = VK_NULL_HANDLE;
 
     // Shaders: either a path (loaded in build) or a pre-created module.
@@ -233,6 +284,7 @@ class PipelineBuilder {
     // Dynamic rendering
     VkFormat colorFormat_ = VK_FORMAT_UNDEFINED;
     VkFormat depthFormat_ = VK_FORMAT_UNDEFINED;
+    std::uint32_t viewMask_ = 0;
 
     // Vertex input
     std::vector<VkVertexInputBindingDescription> vertexBindings_;
@@ -257,12 +309,16 @@ class PipelineBuilder {
 
     // Extra dynamic states (viewport + scissor are always included)
     std::vector<VkDynamicState> extraDynamicStates_;
+    bool maximalDynamic_ = false;
+    // Extended dynamic state 3 states the device enabled (from Device).
+    std::vector<VkDynamicState> eds3States_;
 
     // Pipeline layout config
     std::vector<VkPushConstantRange> pushConstantRanges_;
     std::vector<VkDescriptorSetLayout> descriptorSetLayouts_;
     VkPipelineLayout externalLayout_ = VK_NULL_HANDLE;
     VkPipelineCache cache_ = VK_NULL_HANDLE;
+    PipelineBinaryStore* binaryStore_ = nullptr;
     bool reflect_ = false;
 
     // Specialization constants
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vksdl/error.hpp>
+#include <vksdl/result.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace vksdl {
+
+class Device;
+
+// Per-pipeline driver binaries (VK_KHR_pipeline_binary) persisted on disk.
+//
+// Entries are keyed by the driver's pipeline key (vkGetPipelineKeyKHR over the
+// full create info), so a lookup is exact for one pipeline rather than a
+// whole-cache blob. Attach a store to PipelineBuilder::binaryStore() or
+// PipelineCompiler::setBinaryStore(): on a hit the pipeline is created from
+// the stored binaries without compiling; on a miss it is compiled with
+// CAPTURE_DATA and the binaries are appended to the store.
+//
+// On disk: `<path>` holds append-only records (header + checksummed payload),
+// `<path>.idx` holds one fixed-size entry per record. Both start with the
+// driver's global key; a driver update invalidates the store and it is
+// rewritten from scratch on the next capture. A torn tail from a crash is
+// truncated; records missing from the index are recovered by scanning.
+//
+// When the device lacks VK_KHR_pipeline_binary, supported() is false and the
+// store is a no-op (builders compile normally).
+//
+// Thread safety: internally synchronized. Lookups and captures may run
+// concurrently from multiple compile threads.
+class PipelineBinaryStore {
+  public:
+    // Missing or stale files yield an empty store, never an error.
+    [[nodiscard]] static Result<PipelineBinaryStore> open(const Device& device,
+                                                          const std::filesystem::path& path);
+
+    ~PipelineBinaryStore();
+    PipelineBinaryStore(PipelineBinaryStore&&) noexcept;
+    PipelineBinaryStore& operator=(PipelineBinaryStore&&) noexcept;
+    PipelineBinaryStore(const PipelineBinaryStore&) = delete;
+    PipelineBinaryStore& operator=(const PipelineBinaryStore&) = delete;
+
+    [[nodiscard]] bool supported() const;
+    [[nodiscard]] std::size_t entryCount() const;
+    [[nodiscard]] std::uint64_t hits() const;
+    [[nodiscard]] std::uint64_t misses() const;
+    [[nodiscard]] std::uint64_t captures() const;
+
+    // Driver key for a pipeline create info (VkGraphicsPipelineCreateInfo,
+    // VkComputePipelineCreateInfo, ...). False if unsupported or the query fails.
+    [[nodiscard]] bool pipelineKey(const void* pipelineCreateInfo,
+                                   VkPipelineBinaryKeyKHR& key) const;
+
+    // Creates binaries for a stored key. Empty on a miss or if the driver
+    // rejects the data. Caller destroys them with destroyBinaries().
+    [[nodiscard]] std::vector<VkPipelineBinaryKHR> loadBinaries(const VkPipelineBinaryKeyKHR& key);
+
+    void destroyBinaries(std::vector<VkPipelineBinaryKHR>& binaries) const;
+
+    // Extracts binaries from a pipeline created with CAPTURE_DATA, appends
+    // them under `key`, then releases the captured data. No-op if present.
+    [[nodiscard]] Result<void> capture(VkPipeline pipeline, const VkPipelineBinaryKeyKHR& key);
+
+    // Drops an entry whose binaries the driver rejected by appending a
+    // tombstone record, so a reload does not resurrect it. A later capture
+    // appends a replacement that shadows the tombstone.
+    void invalidate(const VkPipelineBinaryKeyKHR& key);
+
+  private:
+    PipelineBinaryStore() = default;
+
+    // Holds the file mirror, index, loaded entry points and the mutex.
+    struct Impl;
+
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace vksdl
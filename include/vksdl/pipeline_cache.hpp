@@ -27,10 +27,24 @@ class PipelineCache {
 
     [[nodiscard]] static Result<PipelineCache> create(const Device& device);
 
-    // Falls back to empty cache if the file does not exist or is unreadable.
+    // Memory-maps the file and seeds the cache from it. Falls back to an empty
+    // cache if the file does not exist, is unreadable or fails isCompatible().
     [[nodiscard]] static Result<PipelineCache> load(const Device& device,
                                                     const std::filesystem::path& path);
 
+    // Seeds the cache from an in-memory blob. An incompatible blob is ignored
+    // (empty cache), same as load().
+    [[nodiscard]] static Result<PipelineCache> fromData(const Device& device, const void* data,
+                                                        std::size_t size);
+
+    // True if `data` starts with a VkPipelineCacheHeaderVersionOne whose vendor
+    // ID, device ID and pipelineCacheUUID match `device`. Drivers are meant to
+    // reject foreign blobs themselves; not all of them do so safely.
+    [[nodiscard]] static bool isCompatible(const Device& device, const void* data,
+                                           std::size_t size);
+
+    // Writes to `<path>.tmp` and renames over `path`, so a crash mid-save
+    // leaves the previous file intact. Creates missing parent directories.
     [[nodiscard]] Result<void> save(const std::filesystem::path& path) const;
     [[nodiscard]] Result<void> merge(const PipelineCache& src);
     [[nodiscard]] Result<void> merge(VkPipelineCache src);
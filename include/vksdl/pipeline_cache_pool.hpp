@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vksdl/error.hpp>
+#include <vksdl/result.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace vksdl {
+
+class Device;
+
+// Bounded set of VkPipelineCaches that compiling threads lease, so parallel
+// compiles never contend on (or externally synchronize) one cache object.
+//
+// acquire() hands out an idle cache, creates one while fewer than `capacity`
+// exist, and otherwise blocks until another thread calls release(). Caches
+// are created on demand, each seeded with `seed` (e.g. a snapshot of the
+// main cache; empty for a cold cache), and reused across leases instead of
+// being tied to a thread. merge() folds every released cache that took new
+// compiles back into the main cache; a cache still leased is merged by the
+// next merge() after its release.
+//
+// Thread safety: acquire() and release() are internally synchronized.
+// merge() writes the main cache: no other thread may use it meanwhile.
+class PipelineCachePool {
+  public:
+    // `main` must outlive the pool. `capacity` must be at least 1.
+    [[nodiscard]] static Result<PipelineCachePool> create(const Device& device,
+                                                          VkPipelineCache main,
+                                                          std::uint32_t capacity,
+                                                          std::vector<std::uint8_t> seed = {});
+
+    ~PipelineCachePool();
+    PipelineCachePool(PipelineCachePool&&) noexcept;
+    PipelineCachePool& operator=(PipelineCachePool&&) noexcept;
+    PipelineCachePool(const PipelineCachePool&) = delete;
+    PipelineCachePool& operator=(const PipelineCachePool&) = delete;
+
+    // A cache no other thread holds. Blocks while `capacity` caches are
+    // leased. Fails only if vkCreatePipelineCache does.
+    [[nodiscard]] Result<VkPipelineCache> acquire();
+
+    // Returns a cache from acquire(). `dirty`: pipelines were created with it
+    // since acquire(), so the next merge() includes it.
+    void release(VkPipelineCache cache, bool dirty = true);
+
+    // Merges every released dirty cache into the main cache.
+    [[nodiscard]] Result<void> merge();
+
+    [[nodiscard]] std::uint32_t size() const; // caches created so far
+    [[nodiscard]] std::uint32_t capacity() const;
+    [[nodiscard]] std::uint64_t merges() const; // successful merge() calls with work
+
+  private:
+    PipelineCachePool() = default;
+
+    // Holds the caches, the idle list and the mutex leases wait on.
+    struct Impl;
+
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace vksdl
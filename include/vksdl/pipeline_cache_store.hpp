@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vksdl/error.hpp>
+#include <vksdl/pipeline_cache.hpp>
+#include <vksdl/pipeline_cache_pool.hpp>
+#include <vksdl/result.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+
+namespace vksdl {
+
+class Device;
+
+// Persistent VkPipelineCache keyed by device and driver.
+//
+// Layout under `root`:
+//   <vendorID>-<deviceID>/<driverVersion>-<pipelineCacheUUID>/pipeline.cache
+// One directory per device, one subdirectory per driver build, so switching
+// GPUs or drivers never feeds a foreign blob to the driver and never
+// overwrites the cache of the other configuration. Loads are memory-mapped
+// and header-validated (PipelineCache::isCompatible); saves are atomic
+// (temp file + rename).
+//
+// Worker threads that compile pipelines lease a cache from a bounded
+// PipelineCachePool (acquireThreadCache() / releaseThreadCache()) so they
+// never contend on (or externally synchronize) the main cache. save() merges
+// every released thread cache into cache() before writing.
+//
+// Thread safety: acquireThreadCache() and releaseThreadCache() are internally
+// synchronized. cache() follows PipelineCache rules. save() and
+// mergeThreadCaches() must not run while any thread is creating pipelines
+// with cache().
+class PipelineCacheStore {
+  public:
+    // Missing or stale files yield an empty cache, never an error.
+    [[nodiscard]] static Result<PipelineCacheStore> open(const Device& device,
+                                                         const std::filesystem::path& root);
+
+    ~PipelineCacheStore();
+    PipelineCacheStore(PipelineCacheStore&&) noexcept;
+    PipelineCacheStore& operator=(PipelineCacheStore&&) noexcept;
+    PipelineCacheStore(const PipelineCacheStore&) = delete;
+    PipelineCacheStore& operator=(const PipelineCacheStore&) = delete;
+
+    [[nodiscard]] PipelineCache& cache();
+    [[nodiscard]] const PipelineCache& cache() const;
+
+    // Full path of the cache file for this device + driver.
+    [[nodiscard]] const std::filesystem::path& path() const;
+
+    // True if open() found a compatible blob on disk.
+    [[nodiscard]] bool warm() const;
+
+    // Leases a cache owned by the store for one thread's compiles. At most
+    // one per hardware thread exist; further calls block until a release.
+    [[nodiscard]] Result<VkPipelineCache> acquireThreadCache();
+    // Returns a leased cache; its new entries go into the next merge.
+    void releaseThreadCache(VkPipelineCache cache);
+    [[nodiscard]] std::size_t threadCacheCount() const;
+
+    // Merges every released thread cache with new entries into cache().
+    // Caches still leased are merged after their release.
+    [[nodiscard]] Result<void> mergeThreadCaches();
+
+    // mergeThreadCaches(), then atomically writes cache() to path().
+    [[nodiscard]] Result<void> save();
+
+    // Deletes cache directories of other driver builds for this device.
+    // Returns the number removed.
+    std::size_t removeStaleDrivers();
+
+  private:
+    PipelineCacheStore() = default;
+
+    // Holds the main cache and the thread cache pool.
+    struct Impl;
+
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace vksdl
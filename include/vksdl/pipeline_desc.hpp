@@ -0,0 +1,295 @@
+#pragma once
+
+#include <vksdl/pipeline.hpp>
+#include <vksdl/pipeline_key.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace vksdl {
+
+class Device;
+
+// Vk*CreateInfo chain for a PipelineDesc, filled in place by
+// PipelineDesc::fill() without heap allocation. PipelineBuilder::build()
+// writes the same chain, so both produce identical create infos for the
+// same state. Pass `pipeline` to vkCreateGraphicsPipelines. Not copyable:
+// the structs point into each other.
+struct PipelineDescCreateInfo {
+    static constexpr std::uint32_t kMaxDynamicStates = 2 + 24;
+
+    PipelineDescCreateInfo() = default;
+    PipelineDescCreateInfo(const PipelineDescCreateInfo&) = delete;
+    PipelineDescCreateInfo& operator=(const PipelineDescCreateInfo&) = delete;
+
+    VkPipelineShaderStageCreateInfo stages[2]{};
+    VkPipelineVertexInputStateCreateInfo vertexInput{};
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    VkPipelineViewportStateCreateInfo viewport{};
+    VkPipelineRasterizationStateCreateInfo rasterization{};
+    VkPipelineMultisampleStateCreateInfo multisample{};
+    VkPipelineColorBlendAttachmentState blendAttachment{};
+    VkPipelineColorBlendStateCreateInfo colorBlend{};
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    VkDynamicState dynamicStates[kMaxDynamicStates]{};
+    VkPipelineDynamicStateCreateInfo dynamic{};
+    VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+    VkPipelineRenderingCreateInfo rendering{};
+    VkGraphicsPipelineCreateInfo pipeline{};
+};
+
+// Shader path kept by PipelineDesc. The constructor is consteval, so only
+// string literals (static storage) are accepted and the stored view cannot
+// dangle; a std::string or path.string() temporary does not compile. Paths
+// built at run time go to PipelineBuilder, or to builder()'s `shaderDir`.
+class ShaderPath {
+  public:
+    template <std::size_t N>
+    consteval ShaderPath(const char (&literal)[N]) // NOLINT implicit
+        : text_(literal, N - 1) {}
+
+    [[nodiscard]] constexpr std::string_view view() const {
+        return text_;
+    }
+
+  private:
+    std::string_view text_;
+};
+
+// Compile-time graphics pipeline description: the state a PipelineBuilder
+// chain sets, as a literal type with fixed-capacity storage. Declare engine
+// pipelines as constexpr values; validate() and key() then run during
+// compilation, so lookups use a constant PipelineKey and hash nothing at
+// run time:
+//
+//   constexpr auto kOpaque = vksdl::PipelineDesc{}
+//                                .vertexShader("mesh.vert.spv")
+//                                .fragmentShader("mesh.frag.spv")
+//                                .colorFormat(VK_FORMAT_B8G8R8A8_SRGB)
+//                                .depthFormat(VK_FORMAT_D32_SFLOAT)
+//                                .cullBack();
+//   constexpr vksdl::PipelineKey kOpaqueKey = kOpaque.key();
+//
+// Setters return a modified copy. key() identifies the description, with
+// shaders keyed by path; PipelineBuilder::key() keys them by SPIR-V content.
+// Like every PipelineKey, both are process-local identities.
+//
+// Thread safety: immutable value type.
+class PipelineDesc {
+  public:
+    static constexpr std::uint32_t kMaxVertexBindings = 4;
+    static constexpr std::uint32_t kMaxVertexAttributes = 16;
+    static constexpr std::uint32_t kMaxDynamicStates = 24; // besides viewport + scissor
+    static constexpr std::size_t kMaxPathLength = 256;
+
+    constexpr PipelineDesc vertexShader(ShaderPath spvPath) const {
+        PipelineDesc d = *this;
+        d.vertPath_ = spvPath.view();
+        return d;
+    }
+    constexpr PipelineDesc fragmentShader(ShaderPath spvPath) const {
+        PipelineDesc d = *this;
+        d.fragPath_ = spvPath.view();
+        return d;
+    }
+
+    constexpr PipelineDesc colorFormat(VkFormat format) const {
+        PipelineDesc d = *this;
+        d.colorFormat_ = format;
+        return d;
+    }
+    constexpr PipelineDesc depthFormat(VkFormat format) const {
+        PipelineDesc d = *this;
+        d.depthFormat_ = format;
+        return d;
+    }
+
+    // Multiview; see PipelineBuilder::viewMask().
+    constexpr PipelineDesc viewMask(std::uint32_t mask) const {
+        PipelineDesc d = *this;
+        d.viewMask_ = mask;
+        return d;
+    }
+
+    constexpr PipelineDesc
+    vertexBinding(std::uint32_t binding, std::uint32_t stride,
+                  VkVertexInputRate inputRate = VK_VERTEX_INPUT_RATE_VERTEX) const {
+        PipelineDesc d = *this;
+        if (d.bindingCount_ == kMaxVertexBindings) {
+            d.overflow_ = true;
+            return d;
+        }
+        d.bindings_[d.bindingCount_++] = {binding, stride, inputRate};
+        return d;
+    }
+    constexpr PipelineDesc vertexAttribute(std::uint32_t location, std::uint32_t binding,
+                                           VkFormat format, std::uint32_t offset) const {
+        PipelineDesc d = *this;
+        if (d.attributeCount_ == kMaxVertexAttributes) {
+            d.overflow_ = true;
+            return d;
+        }
+        d.attributes_[d.attributeCount_++] = {location, binding, format, offset};
+        return d;
+    }
+
+    constexpr PipelineDesc topology(VkPrimitiveTopology t) const {
+        PipelineDesc d = *this;
+        d.topology_ = t;
+        return d;
+    }
+    constexpr PipelineDesc polygonMode(VkPolygonMode m) const {
+        PipelineDesc d = *this;
+        d.polygonMode_ = m;
+        return d;
+    }
+    constexpr PipelineDesc cullMode(VkCullModeFlags m) const {
+        PipelineDesc d = *this;
+        d.cullMode_ = m;
+        return d;
+    }
+    constexpr PipelineDesc cullBack() const {
+        return cullMode(VK_CULL_MODE_BACK_BIT);
+    }
+    constexpr PipelineDesc frontFace(VkFrontFace f) const {
+        PipelineDesc d = *this;
+        d.frontFace_ = f;
+        return d;
+    }
+    constexpr PipelineDesc samples(VkSampleCountFlagBits s) const {
+        PipelineDesc d = *this;
+        d.samples_ = s;
+        return d;
+    }
+    constexpr PipelineDesc depthCompareOp(VkCompareOp op) const {
+        PipelineDesc d = *this;
+        d.depthCompareOp_ = op;
+        return d;
+    }
+    constexpr PipelineDesc enableBlending() const {
+        PipelineDesc d = *this;
+        d.enableBlending_ = true;
+        return d;
+    }
+    constexpr PipelineDesc dynamicState(VkDynamicState state) const {
+        PipelineDesc d = *this;
+        if (state == VK_DYNAMIC_STATE_VIEWPORT || state == VK_DYNAMIC_STATE_SCISSOR)
+            return d;
+        for (std::uint32_t i = 0; i < d.dynamicCount_; ++i) {
+            if (d.dynamic_[i] == state)
+                return d;
+        }
+        if (d.dynamicCount_ == kMaxDynamicStates) {
+            d.overflow_ = true;
+            return d;
+        }
+        d.dynamic_[d.dynamicCount_++] = state;
+        return d;
+    }
+
+    // Empty when the description is complete and consistent, else the
+    // first problem found.
+    [[nodiscard]] constexpr std::string_view validate() const {
+        if (overflow_)
+            return "too many vertex bindings, attributes or dynamic states";
+        if (vertPath_.empty())
+            return "vertexShader() is required";
+        if (vertPath_.size() > kMaxPathLength || fragPath_.size() > kMaxPathLength)
+            return "shader path longer than kMaxPathLength";
+        if (colorFormat_ == VK_FORMAT_UNDEFINED)
+            return "colorFormat() is required";
+        std::uint32_t s = static_cast<std::uint32_t>(samples_);
+        if (s == 0 || s > 64 || (s & (s - 1)) != 0)
+            return "samples must be a single VkSampleCountFlagBits value";
+        for (std::uint32_t i = 0; i < bindingCount_; ++i) {
+            for (std::uint32_t j = 0; j < i; ++j) {
+                if (bindings_[i].binding == bindings_[j].binding)
+                    return "duplicate vertex binding";
+            }
+        }
+        for (std::uint32_t i = 0; i < attributeCount_; ++i) {
+            bool bound = false;
+            for (std::uint32_t b = 0; b < bindingCount_; ++b)
+                bound = bound || bindings_[b].binding == attributes_[i].binding;
+            if (!bound)
+                return "vertex attribute references an undeclared binding";
+            for (std::uint32_t j = 0; j < i; ++j) {
+                if (attributes_[i].location == attributes_[j].location)
+                    return "duplicate vertex attribute location";
+            }
+        }
+        return {};
+    }
+
+    [[nodiscard]] constexpr bool valid() const {
+        return validate().empty();
+    }
+
+    // Identity of the description, evaluated during compilation. Using it on
+    // an invalid description is a compile error.
+    [[nodiscard]] consteval PipelineKey key() const {
+        if (!valid())
+            invalidDescription();
+        // Bump when the encoding below changes.
+        constexpr std::uint32_t kVersion = 2;
+        StaticPipelineKeyWriter<1024> w;
+        w.u32(kVersion).str(vertPath_).str(fragPath_);
+        w.e32(colorFormat_).e32(depthFormat_).u32(viewMask_);
+        w.u32(bindingCount_);
+        for (std::uint32_t i = 0; i < bindingCount_; ++i)
+            w.u32(bindings_[i].binding).u32(bindings_[i].stride).e32(bindings_[i].inputRate);
+        w.u32(attributeCount_);
+        for (std::uint32_t i = 0; i < attributeCount_; ++i) {
+            const auto& a = attributes_[i];
+            w.u32(a.location).u32(a.binding).e32(a.format).u32(a.offset);
+        }
+        w.e32(topology_).e32(polygonMode_).e32(cullMode_).e32(frontFace_);
+        w.e32(samples_).boolean(enableBlending_).e32(depthCompareOp_);
+        w.u32(dynamicCount_);
+        for (std::uint32_t i = 0; i < dynamicCount_; ++i)
+            w.e32(dynamic_[i]);
+        return w.finish();
+    }
+
+    // Writes the create-info chain for this description. Shader modules and
+    // the layout come from the caller; nothing is allocated. States made
+    // dynamic are written in canonical form, as PipelineBuilder does.
+    void fill(PipelineDescCreateInfo& out, VkShaderModule vertModule, VkShaderModule fragModule,
+              VkPipelineLayout layout) const;
+
+    // PipelineBuilder with the described state, for build() or
+    // PipelineCompiler::compile(). Shader paths resolve against `shaderDir`.
+    [[nodiscard]] PipelineBuilder builder(const Device& device,
+                                          const std::filesystem::path& shaderDir = {}) const;
+
+  private:
+    // Not constexpr: reaching it during constant evaluation is the error.
+    static void invalidDescription();
+
+    std::string_view vertPath_; // string literals, see ShaderPath
+    std::string_view fragPath_;
+    VkFormat colorFormat_ = VK_FORMAT_UNDEFINED;
+    VkFormat depthFormat_ = VK_FORMAT_UNDEFINED;
+    std::uint32_t viewMask_ = 0;
+    std::array<VkVertexInputBindingDescription, kMaxVertexBindings> bindings_{};
+    std::array<VkVertexInputAttributeDescription, kMaxVertexAttributes> attributes_{};
+    std::uint32_t bindingCount_ = 0;
+    std::uint32_t attributeCount_ = 0;
+    VkPrimitiveTopology topology_ = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    VkPolygonMode polygonMode_ = VK_POLYGON_MODE_FILL;
+    VkCullModeFlags cullMode_ = VK_CULL_MODE_NONE;
+    VkFrontFace frontFace_ = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    VkSampleCountFlagBits samples_ = VK_SAMPLE_COUNT_1_BIT;
+    VkCompareOp depthCompareOp_ = VK_COMPARE_OP_LESS_OR_EQUAL;
+    bool enableBlending_ = false;
+    std::array<VkDynamicState, kMaxDynamicStates> dynamic_{};
+    std::uint32_t dynamicCount_ = 0;
+    bool overflow_ = false;
+};
+
+} // namespace vksdl
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if defined(_MSC_VER) && defined(_M_X64) && !defined(__SIZEOF_INT128__)
+#include <intrin.h>
+#endif
+
+namespace vksdl {
+
+// 128-bit pipeline identity. Built from a canonical serialization (fixed
+// little-endian field encoding, no struct padding), so the same state yields
+// the same key on every compiler and platform. Keys are process-local:
+// PipelineBuilder and PipelineCompiler write pre-created shader modules and
+// layouts as handle values, so do not persist keys or index on-disk stores
+// with them (PipelineBinaryStore uses the driver's own pipeline keys).
+struct PipelineKey {
+    std::uint64_t lo = 0;
+    std::uint64_t hi = 0;
+
+    [[nodiscard]] constexpr bool operator==(const PipelineKey& o) const {
+        return lo == o.lo && hi == o.hi;
+    }
+    [[nodiscard]] constexpr bool operator!=(const PipelineKey& o) const {
+        return !(*this == o);
+    }
+    [[nodiscard]] constexpr bool operator<(const PipelineKey& o) const {
+        return hi != o.hi ? hi < o.hi : lo < o.lo;
+    }
+};
+
+// For unordered containers. Both halves are already well mixed.
+struct PipelineKeyHash {
+    [[nodiscard]] constexpr std::size_t operator()(const PipelineKey& k) const {
+        return static_cast<std::size_t>(k.lo ^ (k.hi * 0x9E3779B97F4A7C15ULL));
+    }
+};
+
+namespace detail {
+
+inline constexpr std::uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+inline constexpr std::uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+inline constexpr std::uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+inline constexpr std::uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+inline constexpr std::uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+// Little-endian load regardless of host byte order.
+constexpr std::uint64_t read64(const std::uint8_t* p) {
+    if (!std::is_constant_evaluated() && std::endian::native == std::endian::little) {
+        std::uint64_t v = 0;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    std::uint64_t v = 0;
+    for (int i = 7; i >= 0; --i)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+constexpr std::uint64_t rotl(std::uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+// 64x64 -> 128 multiply, folded to 64 bits by XOR of the halves.
+constexpr std::uint64_t mulFold64(std::uint64_t a, std::uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    __extension__ using U128 = unsigned __int128;
+    U128 r = static_cast<U128>(a) * b;
+    return static_cast<std::uint64_t>(r) ^ static_cast<std::uint64_t>(r >> 64);
+#else
+#if defined(_MSC_VER) && defined(_M_X64)
+    if (!std::is_constant_evaluated()) {
+        std::uint64_t hi = 0;
+        std::uint64_t lo = _umul128(a, b, &hi);
+        return lo ^ hi;
+    }
+#endif
+    std::uint64_t aLo = a & 0xFFFFFFFFu, aHi = a >> 32;
+    std::uint64_t bLo = b & 0xFFFFFFFFu, bHi = b >> 32;
+    std::uint64_t ll = aLo * bLo, lh = aLo * bHi, hl = aHi * bLo, hh = aHi * bHi;
+    std::uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFu) + (hl & 0xFFFFFFFFu);
+    std::uint64_t lo = (mid << 32) | (ll & 0xFFFFFFFFu);
+    std::uint64_t hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+    return lo ^ hi;
+#endif
+}
+
+// Multiply-fold of 16 bytes plus the raw input, as in XXH3's accumulate.
+// The product alone is zero for every second word once the first equals
+// its key, so without the raw words those inputs would all collide.
+constexpr std::uint64_t mix16(const std::uint8_t* p, std::uint64_t k0, std::uint64_t k1) {
+    std::uint64_t a = read64(p);
+    std::uint64_t b = read64(p + 8);
+    return mulFold64(a ^ k0, b ^ k1) + a + rotl(b, 32);
+}
+
+constexpr std::uint64_t avalanche(std::uint64_t h) {
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9ULL;
+    h ^= h >> 32;
+    return h;
+}
+
+// One 64-byte stripe into four independent lanes. The rotate-multiply after
+// each stripe makes the result depend on stripe order.
+constexpr void stripe(std::uint64_t (&acc)[4], const std::uint8_t* p, std::uint64_t seed) {
+    acc[0] = rotl(acc[0] + mix16(p, kPrime1 + seed, kPrime2 - seed), 27) * kPrime1;
+    acc[1] = rotl(acc[1] + mix16(p + 16, kPrime3 + seed, kPrime4 - seed), 31) * kPrime2;
+    acc[2] = rotl(acc[2] + mix16(p + 32, kPrime5 + seed, kPrime1 - seed), 29) * kPrime3;
+    acc[3] = rotl(acc[3] + mix16(p + 48, kPrime2 + seed, kPrime3 - seed), 33) * kPrime4;
+}
+
+// hash128() over typed bytes, usable in constant expressions. Runtime calls
+// take the same memcpy/intrinsic paths as hash128().
+constexpr PipelineKey hash128Bytes(const std::uint8_t* p, std::size_t size, std::uint64_t seed) {
+    auto len = static_cast<std::uint64_t>(size);
+
+    std::uint64_t acc[4] = {seed + len * kPrime1, (seed ^ kPrime5) - len * kPrime2,
+                            rotl(seed, 17) ^ kPrime3, rotl(seed, 41) + kPrime4};
+
+    std::size_t n = size;
+    for (; n >= 64; n -= 64, p += 64)
+        stripe(acc, p, seed);
+
+    // Zero-padded tail. The length is already in the lanes, so padding
+    // cannot alias a longer input.
+    if (n > 0) {
+        std::uint8_t tail[64] = {};
+        for (std::size_t i = 0; i < n; ++i)
+            tail[i] = p[i];
+        stripe(acc, tail, seed);
+    }
+
+    PipelineKey key;
+    key.lo = avalanche(mulFold64(acc[0] ^ kPrime2, acc[1] ^ kPrime3) +
+                       mulFold64(acc[2] ^ kPrime4, acc[3] ^ kPrime5) + len);
+    key.hi = avalanche(mulFold64(acc[0] ^ kPrime5, acc[3] ^ kPrime1) +
+                       mulFold64(acc[1] ^ kPrime2, acc[2] ^ kPrime4) - len);
+    return key;
+}
+
+} // namespace detail
+
+// Fast 128-bit non-cryptographic hash (XXH3-style multiply-fold over 64-byte
+// stripes plus avalanche; not bit-compatible with XXH3). Output is defined by
+// the input bytes alone, independent of host endianness.
+[[nodiscard]] PipelineKey hash128(const void* data, std::size_t size, std::uint64_t seed = 0);
+
+// Canonical serializer for key material. Every value is written field by
+// field in little-endian order at its declared width, so padding and host
+// layout never leak into a key. Variable-length fields carry their length.
+//
+// Thread safety: thread-confined.
+class PipelineKeyWriter {
+  public:
+    PipelineKeyWriter() {
+        buf_.reserve(256);
+    }
+
+    PipelineKeyWriter& u8(std::uint8_t v) {
+        buf_.push_back(v);
+        return *this;
+    }
+    PipelineKeyWriter& u32(std::uint32_t v) {
+        for (int i = 0; i < 4; ++i)
+            buf_.push_back(static_cast<std::uint8_t>(v >> (i * 8)));
+        return *this;
+    }
+    PipelineKeyWriter& u64(std::uint64_t v) {
+        for (int i = 0; i < 8; ++i)
+            buf_.push_back(static_cast<std::uint8_t>(v >> (i * 8)));
+        return *this;
+    }
+    PipelineKeyWriter& boolean(bool v) {
+        return u8(v ? 1 : 0);
+    }
+    PipelineKeyWriter& f32(float v) {
+        std::uint32_t bits = 0;
+        std::memcpy(&bits, &v, sizeof(bits));
+        return u32(bits);
+    }
+
+    // Enums and Vulkan flag types, written at 32 bits (their API width).
+    template <typename E> PipelineKeyWriter& e32(E v) {
+        static_assert(std::is_enum_v<E> || std::is_integral_v<E>);
+        return u32(static_cast<std::uint32_t>(v));
+    }
+
+    // Length-prefixed raw bytes, copied into the key material.
+    PipelineKeyWriter& bytes(const void* data, std::size_t size) {
+        u64(size);
+        auto* p = static_cast<const std::uint8_t*>(data);
+        buf_.insert(buf_.end(), p, p + size);
+        return *this;
+    }
+    PipelineKeyWriter& str(std::string_view s) {
+        return bytes(s.data(), s.size());
+    }
+
+    // Length plus a 128-bit digest of a large blob (SPIR-V, spec data),
+    // which avoids copying the blob itself into the key material.
+    PipelineKeyWriter& blob(const void* data, std::size_t size) {
+        PipelineKey d = hash128(data, size);
+        return u64(size).u64(d.lo).u64(d.hi);
+    }
+
+    [[nodiscard]] const std::vector<std::uint8_t>& data() const {
+        return buf_;
+    }
+    [[nodiscard]] PipelineKey finish(std::uint64_t seed = 0) const {
+        return hash128(buf_.data(), buf_.size(), seed);
+    }
+
+  private:
+    std::vector<std::uint8_t> buf_;
+};
+
+// PipelineKeyWriter over a fixed N-byte buffer, for keys computed in constant
+// expressions. Same encoding; writing past N fails constant evaluation.
+template <std::size_t N> class StaticPipelineKeyWriter {
+  public:
+    constexpr StaticPipelineKeyWriter& u8(std::uint8_t v) {
+        buf_[size_++] = v;
+        return *this;
+    }
+    constexpr StaticPipelineKeyWriter& u32(std::uint32_t v) {
+        for (int i = 0; i < 4; ++i)
+            u8(static_cast<std::uint8_t>(v >> (i * 8)));
+        return *this;
+    }
+    constexpr StaticPipelineKeyWriter& u64(std::uint64_t v) {
+        for (int i = 0; i < 8; ++i)
+            u8(static_cast<std::uint8_t>(v >> (i * 8)));
+        return *this;
+    }
+    constexpr StaticPipelineKeyWriter& boolean(bool v) {
+        return u8(v ? 1 : 0);
+    }
+    template <typename E> constexpr StaticPipelineKeyWriter& e32(E v) {
+        static_assert(std::is_enum_v<E> || std::is_integral_v<E>);
+        return u32(static_cast<std::uint32_t>(v));
+    }
+    constexpr StaticPipelineKeyWriter& str(std::string_view s) {
+        u64(s.size());
+        for (char c : s)
+            u8(static_cast<std::uint8_t>(c));
+        return *this;
+    }
+
+    [[nodiscard]] constexpr std::size_t size() const {
+        return size_;
+    }
+    [[nodiscard]] constexpr PipelineKey finish(std::uint64_t seed = 0) const {
+        return detail::hash128Bytes(buf_, size_, seed);
+    }
+
+  private:
+    std::uint8_t buf_[N] = {};
+    std::size_t size_ = 0;
+};
+
+} // namespace vksdl
@@ -7,14 +7,85 @@
 
 #include <vulkan/vulkan.h>
 
+#include <array>
+#include <chrono>
 #include <cstdint>
+#include <functional>
+#include <string>
 
 namespace vksdl {
 
+class ComputePipelineBuilder;
 class Device;
+class PermutationTable;
 class Pipeline;
+class PipelineBinaryStore;
 class PipelineBuilder;
 class PipelineCache;
+class SpecPermutations;
+
+// Log2 latency histogram: bucket i counts samples in [2^i, 2^(i+1))
+// microseconds. Bucket 0 also takes sub-microsecond samples and the last
+// bucket everything above its range (~8 s).
+struct LatencyHistogram {
+    static constexpr std::uint32_t kBuckets = 24;
+
+    std::array<std::uint64_t, kBuckets> buckets{};
+    std::uint64_t count = 0;
+    double totalMs = 0.0;
+    double maxMs = 0.0;
+
+    [[nodiscard]] double meanMs() const;
+    // Upper edge of the bucket holding the p-th percentile (p in [0, 100]),
+    // clamped to maxMs. 0 when empty.
+    [[nodiscard]] double percentileMs(double p) const;
+};
+
+// Creation feedback for every pipeline the compiler produced. Durations are
+// wall clock on the compiling thread, except the *Stage histograms, which hold
+// the driver-reported VkPipelineCreationFeedback of real (non-probe) builds.
+struct PipelineCompileTelemetry {
+    std::uint64_t requests = 0; // compile() calls
+    std::uint64_t failures = 0;
+    std::uint64_t probeHits = 0;   // step 1 served a finished pipeline
+    std::uint64_t probeMisses = 0; // step 1 returned VK_PIPELINE_COMPILE_REQUIRED
+    std::uint64_t driverCacheHits = 0; // builds the driver reports as cache hits
+    std::uint64_t monolithicBuilds = 0; // includes permutations
+    std::uint64_t fastLinks = 0;
+    std::uint64_t optimizedLinks = 0; // background GPL optimization
+
+    LatencyHistogram requestToUsable;    // compile() entry to a bindable handle
+    LatencyHistogram requestToOptimized; // compile() entry to the optimized swap (GPL)
+    LatencyHistogram probe;
+    LatencyHistogram monolithicBuild;
+    LatencyHistogram libraryParts; // acquiring the four GPL parts, waits included
+    LatencyHistogram fastLink;
+    LatencyHistogram optimizeQueueDelay; // optimize task queued to started
+    LatencyHistogram optimizedLink;
+    LatencyHistogram vertexStage;
+    LatencyHistogram fragmentStage;
+    LatencyHistogram computeStage;
+};
+
+// Lifetime statistics. Handle counts cover every PipelineHandle this compiler
+// produced that is still alive, even after the compiler is destroyed.
+struct PipelineCompilerStats {
+    std::uint32_t liveHandles = 0;
+    std::uint32_t livePipelines = 0;     // VkPipelines owned by live handles
+    std::uint32_t pendingRetirement = 0; // GPL baselines tracked for retirement
+    std::uint64_t retiredBaselines = 0;
+    std::uint32_t liveLibraries = 0; // GPL parts in the cache (incl. in-flight)
+    std::uint64_t evictedLibraries = 0;
+    std::uint32_t threadCaches = 0; // pooled VkPipelineCaches created so far
+    std::uint64_t cacheMerges = 0;  // merges into the main cache
+
+    // Recorded without locks; a snapshot taken during compiles may mix
+    // counters from adjacent moments.
+    PipelineCompileTelemetry telemetry;
+
+    // The statistics as a JSON object, histograms included.
+    [[nodiscard]] std::string toJson() const;
+};
 
 // Central async pipeline compilation engine.
 //
@@ -32,11 +103,30 @@ class PipelineCache;
 // PipelineBuilder must remain valid until waitIdle() returns or the
 // PipelineCompiler is destroyed.
 //
+// Long-running sessions can bound driver memory: setBaselineRetirement()
+// destroys fast-linked baselines a few frames after their optimized pipeline
+// was first bound, and setLibraryCacheLimit() evicts least recently used GPL
+// parts that no pending work references. Both run from advanceFrame().
+//
 // ~PipelineCompiler blocks until all background compilations complete.
 // Call waitIdle() first if you need predictable shutdown timing.
 //
-// Thread safety: thread-confined. compile() and waitIdle() must be called
-// from a single thread. Background optimization is internal.
+// GPL library parts are deduplicated in flight: concurrent compiles that need
+// the same part wait for a single build, different parts build in parallel.
+//
+// Each compile (on a worker or a compile() caller) leases a VkPipelineCache
+// from a PipelineCachePool seeded from the main cache, so parallel compiles
+// do not contend on one cache; the pool holds at most one cache per hardware
+// thread. Released caches are merged back into the main cache on a worker
+// every setCacheMergeInterval() compiles, by mergeCaches(), and on
+// destruction. The main PipelineCache must outlive the compiler and must not
+// be used by other threads while a merge can run; call waitIdle() and
+// mergeCaches() before PipelineCache::save().
+//
+// Thread safety: compile(), mergeCaches(), advanceFrame() and stats() may be
+// called concurrently from multiple threads. waitIdle(), move and destruction must
+// not race with compile().
+// Background optimization is internal.
 class PipelineCompiler {
   public:
     [[nodiscard]] static Result<PipelineCompiler>
@@ -51,12 +141,51 @@ class PipelineCompiler {
 
     // Blocks until a usable pipeline exists. Only optimization is async.
     // The builder is not modified -- the compiler reads its state.
+    // Every call is recorded in stats().telemetry.
     [[nodiscard]] Result<PipelineHandle> compile(const PipelineBuilder& builder);
 
+    // Compiles every permutation `perms` accepts of `builder` on the worker
+    // pool, each a fully optimized monolithic pipeline with the permutation's
+    // constants applied on top of the builder's own specConstant() values.
+    // Blocks until all are built; fails on the first failing permutation.
+    // The builder must not use specialize(). Do not call from a worker.
+    [[nodiscard]] Result<PermutationTable> compilePermutations(const PipelineBuilder& builder,
+                                                               const SpecPermutations& perms);
+    [[nodiscard]] Result<PermutationTable>
+    compilePermutations(const ComputePipelineBuilder& builder, const SpecPermutations& perms);
+
     void waitIdle();
 
     [[nodiscard]] std::uint32_t pendingCount() const;
 
+    // Binary store used when the builder has none. Monolithic compiles and
+    // the step-1 probe create from stored binaries on a hit and capture on a
+    // miss. Call before compile(); the store must outlive the compiler.
+    void setBinaryStore(PipelineBinaryStore* store);
+
+    // Number of compiles between background merges of the pooled caches
+    // into the main cache. Default 32; 0 = only mergeCaches() and destroy.
+    void setCacheMergeInterval(std::uint32_t compiles);
+
+    // Merges every released pooled cache into the main cache now.
+    [[nodiscard]] Result<void> mergeCaches();
+
+    // Retire a GPL handle's baseline once the optimized pipeline has been
+    // bound and `frames` further advanceFrame() calls have passed. `frames`
+    // must cover the frames in flight. 0 (default) keeps baselines until the
+    // handle is destroyed. Applies to handles compiled after the call.
+    void setBaselineRetirement(std::uint32_t frames);
+
+    // Cap on cached GPL library parts across all four part caches.
+    // 0 (default) = unbounded. Enforced by advanceFrame().
+    void setLibraryCacheLimit(std::uint32_t maxLibraries);
+
+    // Call once per frame after the frame's fence wait. Retires baselines
+    // and evicts library parts per the settings above.
+    void advanceFrame();
+
+    [[nodiscard]] PipelineCompilerStats stats() const;
+
     // The resolved pipeline model (stable after create()).
     [[nodiscard]] PipelineModel resolvedModel() const;
 
@@ -68,10 +197,21 @@ class PipelineCompiler {
     PipelineCompiler() = default;
     void destroy();
 
+    // compile() minus the request-level telemetry. `requested` is the
+    // compile() entry time, for the GPL optimize latency.
+    [[nodiscard]] Result<PipelineHandle>
+    compileImpl(const PipelineBuilder& builder,
+                std::chrono::steady_clock::time_point requested);
+
     // Transfer Pipeline ownership into a PipelineHandleImpl.
     // Must be a member (not a free function) so friend access to Pipeline works.
     static void* transferPipeline(VkDevice device, Pipeline& pipeline, bool markOptimized);
 
+    // Fans `buildOne(key, cache)` out over the workers for every valid key.
+    using PermutationBuildFn = std::function<Result<Pipeline>(std::uint32_t, VkPipelineCache)>;
+    [[nodiscard]] Result<PermutationTable> buildPermutations(const SpecPermutations& perms,
+                                                             const PermutationBuildFn& buildOne);
+
     // Opaque impl hides threading primitives from public header.
     void* impl_ = nullptr;
 };
@@ -11,9 +11,11 @@ namespace vksdl {
 // compiling a fully optimized monolithic pipeline. When that completes, bind()
 // automatically uses the optimized version via atomic swap.
 //
-// Both baseline and optimized pipelines are kept alive until ~PipelineHandle().
-// This wastes a small amount of driver memory (~kilobytes of metadata) but
-// eliminates frame-indexed retirement complexity.
+// By default both baseline and optimized pipelines are kept alive until
+// ~PipelineHandle(). With PipelineCompiler::setBaselineRetirement() enabled,
+// the baseline is destroyed by PipelineCompiler::advanceFrame() once the
+// optimized pipeline has been bound and the configured number of frames has
+// passed, so the GPU can no longer be using it.
 //
 // Thread safety: bind() and isOptimized() are safe to call from any thread
 // (atomic acquire on the optimized pipeline pointer). Destruction is not
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <vksdl/pipeline_model/pipeline_handle.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <optional>
+#include <vector>
+
+namespace vksdl {
+
+// Declares the specialization-constant domains of an uber-shader.
+//
+// Every domain occupies a fixed bit field of a packed permutation key, in
+// declaration order starting at bit 0: a boolean takes 1 bit, a value list
+// of n entries takes ceil(log2(n)) bits and stores the index into the list.
+// The key is therefore a dense array index that draw code can build with
+// shifts and ORs (see shift()) or with key().
+//
+// Thread safety: immutable after construction; the filter must be safe to
+// call from worker threads.
+class SpecPermutations {
+  public:
+    // At most 2^kMaxKeyBits table slots.
+    static constexpr std::uint32_t kMaxKeyBits = 20;
+
+    // VkBool32 constant: choice 0 = VK_FALSE, 1 = VK_TRUE.
+    SpecPermutations& boolean(std::uint32_t constantId);
+
+    // 32-bit constant (enum, int, uint) taking one of `values`.
+    SpecPermutations& values(std::uint32_t constantId, std::vector<std::uint32_t> values);
+
+    // Prunes the cross-product: only keys for which `accept` returns true
+    // are compiled. Called with in-range keys only.
+    SpecPermutations& filter(std::function<bool(std::uint32_t key)> accept);
+
+    [[nodiscard]] std::uint32_t domainCount() const {
+        return static_cast<std::uint32_t>(domains_.size());
+    }
+    [[nodiscard]] std::uint32_t keyBits() const {
+        return keyBits_;
+    }
+    // Slots in a PermutationTable (1 << keyBits()).
+    [[nodiscard]] std::uint32_t tableSize() const;
+
+    // Bit offset of `domain`'s field in the key.
+    [[nodiscard]] std::uint32_t shift(std::uint32_t domain) const;
+
+    // Packs one choice index per domain, in declaration order.
+    [[nodiscard]] std::uint32_t key(std::initializer_list<std::uint32_t> choices) const;
+
+    // Choice index of `domain` in `key`.
+    [[nodiscard]] std::uint32_t choice(std::uint32_t key, std::uint32_t domain) const;
+
+    // Every field in range and accepted by the filter.
+    [[nodiscard]] bool valid(std::uint32_t key) const;
+
+    // Number of keys valid() accepts.
+    [[nodiscard]] std::uint32_t permutationCount() const;
+
+    // Writes this key's constant values into a builder-style map/data pair.
+    // Entries for the same constant IDs already present are replaced.
+    void writeSpecialization(std::uint32_t key, std::vector<VkSpecializationMapEntry>& entries,
+                             std::vector<std::uint8_t>& data) const;
+
+  private:
+    struct Domain {
+        std::uint32_t constantId = 0;
+        std::vector<std::uint32_t> values;
+        std::uint32_t shift = 0;
+        std::uint32_t bits = 0;
+    };
+
+    SpecPermutations& add(std::uint32_t constantId, std::vector<std::uint32_t> values);
+
+    std::vector<Domain> domains_;
+    std::function<bool(std::uint32_t)> filter_;
+    std::uint32_t keyBits_ = 0;
+};
+
+// Compiled permutations, indexed by packed key. Produced by
+// PipelineCompiler::compilePermutations(). Move-only.
+//
+// Thread safety: immutable after construction; lookups may run from any thread.
+class PermutationTable {
+  public:
+    // Null for pruned keys and keys outside the table. One bounds check and
+    // one array index -- cheap enough for per-draw selection.
+    [[nodiscard]] const PipelineHandle* operator[](std::uint32_t key) const {
+        if (key >= slots_.size() || !slots_[key])
+            return nullptr;
+        return &*slots_[key];
+    }
+
+    [[nodiscard]] std::uint32_t size() const {
+        return static_cast<std::uint32_t>(slots_.size());
+    }
+    [[nodiscard]] std::uint32_t compiledCount() const {
+        return compiled_;
+    }
+
+  private:
+    friend class PipelineCompiler;
+    PermutationTable() = default;
+
+    std::vector<std::optional<PipelineHandle>> slots_;
+    std::uint32_t compiled_ = 0;
+};
+
+} // namespace vksdl
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <vksdl/error.hpp>
+#include <vksdl/result.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace vksdl {
+
+// One stage of a finished Startup::run(). Times are milliseconds since run()
+// began. `thread` is 0 for the thread that called run(), 1.. for workers.
+struct StartupStageTiming {
+    std::string name;
+    double startMs = 0.0;
+    double endMs = 0.0;
+    std::uint32_t thread = 0;
+    bool ran = false; // false when skipped after an earlier failure
+    bool ok = false;
+};
+
+struct StartupTimeline {
+    std::vector<StartupStageTiming> stages; // in add() order
+    double totalMs = 0.0;  // wall clock of the whole run()
+    double serialMs = 0.0; // sum of stage durations: the run() time without overlap
+
+    // Plain-text table, one line per stage, sorted by start time.
+    [[nodiscard]] std::string format() const;
+
+    // Chrome trace-event JSON (chrome://tracing, Perfetto), one complete
+    // event per stage and one track per thread.
+    [[nodiscard]] std::string toJson() const;
+};
+
+// Overlapped application startup. Stages form a dependency graph; each one
+// runs as soon as every stage it depends on has succeeded, so independent
+// work overlaps instead of running back to back:
+//
+//   vksdl::Startup startup;
+//   auto window = startup.addMainThread("window", [&]() -> vksdl::Result<void> { ... });
+//   auto device = startup.add("instance+device", [&]() { ... }, {window});
+//   auto files = startup.prefetch("pipeline cache + shaders", {cacheRoot, shaderDir});
+//   auto spv = startup.add("read shaders", [&]() { ... }, {files});
+//   auto mesh = startup.add("load model", [&]() { ... }); // no device needed
+//   startup.add("pipelines", [&]() { ... }, {device, spv});
+//   auto ok = startup.run();
+//   std::fputs(startup.timeline().format().c_str(), stdout);
+//
+// File reads, SPIR-V and asset decode therefore run while the instance and
+// device are created, and pipeline compiles start the moment the device and
+// the shaders they need exist. Stages communicate through state captured by
+// their functions; a dependency edge orders those accesses (everything a
+// stage wrote is visible to the stages that depend on it).
+//
+// Worker stages run on a pool owned by run(). addMainThread() stages (SDL
+// window creation, anything thread-confined to the main thread) run on the
+// thread that called run(). The first failing stage stops the run: stages
+// not yet started are skipped and run() returns that stage's error.
+//
+// Thread safety: add*(), prefetch() and run() are thread-confined. Stage
+// functions run concurrently with each other.
+class Startup {
+  public:
+    using StageId = std::uint32_t;
+    using StageFn = std::function<Result<void>()>;
+
+    // `workers` threads besides the caller; 0 = hardware concurrency - 1.
+    explicit Startup(std::uint32_t workers = 0);
+
+    // Adds a stage that runs on a worker after every stage in `after`.
+    // Dependencies must be stages added earlier.
+    StageId add(std::string name, StageFn fn, std::initializer_list<StageId> after = {});
+
+    // Same as add(), but the stage runs on the thread that calls run().
+    StageId addMainThread(std::string name, StageFn fn,
+                          std::initializer_list<StageId> after = {});
+
+    // Adds a worker stage that memory-maps every file (directories
+    // recursively) and touches each page, so later reads of them --
+    // PipelineCache::load(), readSpv(), loadModel(), loadImage() -- come from
+    // the OS page cache. Missing paths are ignored. Use it for files whose
+    // consumer needs the device: the disk work then overlaps device creation.
+    StageId prefetch(std::string name, std::vector<std::filesystem::path> paths,
+                     std::initializer_list<StageId> after = {});
+
+    // Runs every stage and blocks until all have finished or been skipped.
+    // Call once.
+    [[nodiscard]] Result<void> run();
+
+    // Timings of the last run().
+    [[nodiscard]] const StartupTimeline& timeline() const {
+        return timeline_;
+    }
+
+  private:
+    struct Stage {
+        std::string name;
+        StageFn fn;
+        std::vector<StageId> after;
+        bool mainThread = false;
+    };
+
+    StageId addStage(std::string name, StageFn fn, std::initializer_list<StageId> after,
+                     bool mainThread);
+
+    std::uint32_t workers_ = 0;
+    std::vector<Stage> stages_;
+    StartupTimeline timeline_;
+};
+
+} // namespace vksdl
@@ -41,9 +41,25 @@ class TransferQueue {
 
     // CPU-blocking: waits for the transfer to complete before returning.
     // The returned PendingTransfer is used for cross-family ownership transfer.
+    // A host-mapped `dst` (BufferBuilder::directUpload() on a large-BAR
+    // system) is written directly: nothing is submitted and no ownership
+    // transfer is needed.
     [[nodiscard]] Result<PendingTransfer> uploadAsync(const Buffer& dst, const void* data,
                                                       VkDeviceSize size);
 
+    // Submit a command buffer recorded by the caller (e.g. from
+    // RenderGraph::executeAsyncTransfer) on the transfer queue. Signals the
+    // next timeline value and returns it without waiting; have the consuming
+    // submit wait on vkTimelineSemaphore() at that value.
+    [[nodiscard]] Result<std::uint64_t> submit(VkCommandBuffer cmd);
+
+    // As above, but the copy first waits for `wait` to reach `waitValue` at
+    // `waitStage` -- e.g. a vkQueueBindSparse on another queue that binds the
+    // memory the copy writes.
+    [[nodiscard]] Result<std::uint64_t>
+    submit(VkCommandBuffer cmd, VkSemaphore wait, std::uint64_t waitValue,
+           VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_TRANSFER_BIT);
+
     void waitIdle();
 
     [[nodiscard]] bool isComplete(std::uint64_t value) const;
@@ -55,6 +71,18 @@ class TransferQueue {
         return counter_;
     }
 
+    // Family transfers run on, and the graphics family that consumes them.
+    // Equal (and isCrossFamily() false) when there is no dedicated family.
+    [[nodiscard]] std::uint32_t queueFamily() const {
+        return srcFamily_;
+    }
+    [[nodiscard]] std::uint32_t graphicsFamily() const {
+        return dstFamily_;
+    }
+    [[nodiscard]] bool isCrossFamily() const {
+        return crossFamily_;
+    }
+
     // Insert an acquire barrier in a graphics command buffer to take ownership
     // of a buffer transferred from the transfer queue.
     // No-op when needsOwnershipTransfer is false (same queue family).
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <vksdl/buffer.hpp>
+#include <vksdl/error.hpp>
+#include <vksdl/result.hpp>
+#include <vksdl/vma_fwd.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace vksdl {
+
+class Allocator;
+class Device;
+class TransferQueue;
+
+struct VirtualTextureDesc {
+    VkExtent2D extent{};                        // virtual size in texels, full mip chain
+    VkFormat format = VK_FORMAT_R8G8B8A8_UNORM; // uncompressed color formats only
+    std::uint32_t physicalPages = 1024;         // resident page budget (excluding the mip tail)
+    std::uint32_t framesInFlight = 2;           // feedback buffers and eviction delay
+    std::uint32_t maxUploadsPerUpdate = 32;     // pages staged by one update()
+};
+
+// Fills one page with tightly packed texels of the texture format. `width`
+// and `height` are the page extent, clipped at the right and bottom edges
+// of the mip level. Mip-tail levels are requested whole, as page (0, 0).
+using PageLoader = std::function<void(std::uint32_t mip, std::uint32_t pageX,
+                                      std::uint32_t pageY, std::uint32_t width,
+                                      std::uint32_t height, void* dst)>;
+
+struct VirtualTextureStats {
+    std::uint32_t requested = 0; // non-resident pages newly requested by processFeedback()
+    std::uint32_t pending = 0;   // requests waiting for a slot or staging space
+    std::uint32_t uploaded = 0;  // pages bound and staged by the last update()
+    std::uint32_t evicted = 0;   // pages evicted by the last update()
+    std::uint32_t bindCalls = 0; // vkQueueBindSparse calls by the last update() (0 or 1)
+    std::uint32_t residentPages = 0;
+};
+
+// Sparse-residency virtual texture: a full-mip-chain image whose pages are
+// bound to a fixed pool of physical memory pages on demand.
+//
+// Shaders report what they need through a per-frame feedback buffer and
+// sample through a page table:
+//
+//   feedback[pageIndex(uv)] = atomicMin(requested mip)   // one uint per mip-0 page
+//   lod = max(wantedLod, float(pageTable[pageIndex(uv)]));
+//   color = textureLod(vt, uv, lod);
+//
+// pageTableExtent() is the mip-0 page grid; entry (x, y) holds the finest
+// mip whose page covering that region is resident together with every
+// coarser page above it (the mip tail, mipTailFirstLevel(), is always
+// resident), so sampling at that LOD or coarser never touches unbound
+// memory. Pages are evicted only after their finer descendants.
+//
+// Per frame, once the frame's fence has signaled:
+//
+//   vt.processFeedback(frameIndex); // read + reset this frame's feedback
+//   vt.update(transfer);            // evict, bind, stage and upload pages
+//
+// processFeedback() turns feedback into page requests (each with its
+// coarser ancestors, coarse first) and refreshes the LRU order of resident
+// pages. update() takes up to maxUploadsPerUpdate requests, evicting least
+// recently used pages when the pool is full, issues one batched
+// vkQueueBindSparse on the graphics queue for all binds and unbinds, and
+// copies the pages from a staging ring through the TransferQueue; the copy
+// waits on the bind's timeline semaphore. A page enters the page table only
+// after a later update() sees its upload complete on the host. That gives
+// the graphics queue no visibility of the copy: every submit that samples
+// the texture or reads the page table must wait on the TransferQueue's
+// vkTimelineSemaphore() at publishedTransferValue(), at the sampling stage:
+//
+//   VkSemaphoreSubmitInfo wait{VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO};
+//   wait.semaphore = transfer.vkTimelineSemaphore();
+//   wait.value = vt.publishedTransferValue();
+//   wait.stageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+//
+// Evicted pages leave the
+// page table at once but stay bound for framesInFlight more updates, so
+// frames still in flight never sample memory that was rebound.
+//
+// The image is VK_SHARING_MODE_CONCURRENT across the graphics and transfer
+// families and stays in VK_IMAGE_LAYOUT_GENERAL; the page table and
+// feedback buffers are host-mapped storage buffers.
+//
+// Requires Device::hasSparseResidency() (DeviceBuilder::needSparseResidency()).
+//
+// Destroy it only once the TransferQueue is idle: the destructor waits for
+// pending binds but cannot see copies still in flight.
+//
+// Thread safety: thread-confined. update() uses the graphics queue for
+// vkQueueBindSparse; do not submit to it concurrently.
+class VirtualTexture {
+  public:
+    [[nodiscard]] static Result<VirtualTexture> create(const Device& device,
+                                                       const Allocator& allocator,
+                                                       const VirtualTextureDesc& desc,
+                                                       PageLoader loader);
+
+    ~VirtualTexture();
+    VirtualTexture(VirtualTexture&&) noexcept;
+    VirtualTexture& operator=(VirtualTexture&&) noexcept;
+    VirtualTexture(const VirtualTexture&) = delete;
+    VirtualTexture& operator=(const VirtualTexture&) = delete;
+
+    // Reads and resets feedback buffer `frameIndex % framesInFlight`. The
+    // frame that wrote it must have completed.
+    void processFeedback(std::uint32_t frameIndex);
+
+    // Requests one page (and its ancestors) directly, e.g. to prefetch.
+    void request(std::uint32_t mip, std::uint32_t pageX, std::uint32_t pageY);
+
+    // Publishes completed uploads, then evicts, binds and uploads pending
+    // pages. Never blocks on the GPU: with no free staging batch it only
+    // publishes. The first call also uploads the mip tail.
+    [[nodiscard]] Result<void> update(TransferQueue& transfer);
+
+    [[nodiscard]] bool isResident(std::uint32_t mip, std::uint32_t pageX,
+                                  std::uint32_t pageY) const;
+
+    // True once the mip tail upload has completed; sample only after that.
+    // Like isResident(), a host-side fact: the sampling submit must still
+    // wait on publishedTransferValue().
+    [[nodiscard]] bool ready() const {
+        return ready_;
+    }
+
+    // Highest TransferQueue timeline value whose pages update() has
+    // published (0 before the first). Wait on it before sampling.
+    [[nodiscard]] std::uint64_t publishedTransferValue() const {
+        return publishedTransferValue_;
+    }
+
+    [[nodiscard]] VkImage vkImage() const {
+        return image_;
+    }
+    [[nodiscard]] VkImageView vkImageView() const {
+        return view_;
+    }
+    [[nodiscard]] VkImageLayout layout() const {
+        return VK_IMAGE_LAYOUT_GENERAL;
+    }
+    [[nodiscard]] const Buffer& pageTable() const {
+        return pageTable_;
+    }
+    [[nodiscard]] const Buffer& feedbackBuffer(std::uint32_t frameIndex) const {
+        return feedback_[frameIndex % feedback_.size()];
+    }
+
+    [[nodiscard]] VkExtent2D extent() const {
+        return extent_;
+    }
+    [[nodiscard]] VkExtent2D pageExtent() const {
+        return pageExtent_;
+    }
+    [[nodiscard]] VkExtent2D pageTableExtent() const {
+        return {pagesX_[0], pagesY_[0]};
+    }
+    [[nodiscard]] std::uint32_t mipLevels() const {
+        return mipLevels_;
+    }
+    [[nodiscard]] std::uint32_t mipTailFirstLevel() const {
+        return tailMip_;
+    }
+    [[nodiscard]] std::uint32_t physicalPages() const {
+        return static_cast<std::uint32_t>(slots_.size());
+    }
+    // Timeline semaphore signaled by vkQueueBindSparse.
+    [[nodiscard]] VkSemaphore vkBindSemaphore() const {
+        return bindTimeline_;
+    }
+    [[nodiscard]] const VirtualTextureStats& stats() const {
+        return stats_;
+    }
+
+  private:
+    VirtualTexture(Buffer pageTable, Buffer staging)
+        : pageTable_(std::move(pageTable)), staging_(std::move(staging)) {}
+    void destroy();
+    void moveFrom(VirtualTexture& o) noexcept; // everything but the Buffer members
+
+    enum class PageState : std::uint8_t { Absent, Requested, Uploading, Resident };
+
+    struct Page {
+        std::uint32_t slot = UINT32_MAX;
+        std::uint32_t touched = 0; // frame_ of the last request
+        PageState state = PageState::Absent;
+    };
+
+    // One physical page. Resident slots form the LRU list (head = most
+    // recent); a retiring slot keeps its old binding until `retireAt`.
+    struct Slot {
+        VmaAllocation memory = nullptr;
+        VkDeviceMemory deviceMemory = VK_NULL_HANDLE;
+        VkDeviceSize memoryOffset = 0;
+        std::uint32_t page = UINT32_MAX; // bound page, UINT32_MAX = unbound
+        std::uint32_t prev = UINT32_MAX;
+        std::uint32_t next = UINT32_MAX;
+        std::uint32_t retireAt = 0;
+    };
+
+    struct StagingBatch {
+        std::uint64_t timelineValue = 0; // TransferQueue value, 0 = idle
+        VkCommandBuffer cmd = VK_NULL_HANDLE;
+        std::vector<std::uint32_t> pages;
+    };
+
+    [[nodiscard]] std::uint32_t pageIndex(std::uint32_t mip, std::uint32_t x,
+                                          std::uint32_t y) const {
+        return mipOffset_[mip] + y * pagesX_[mip] + x;
+    }
+    // Page of `mip` covering mip-0 page (x0, y0). Shifting alone can step
+    // past the last page of a coarser mip when the extent is not a power of
+    // two, so the result is clamped to the grid.
+    [[nodiscard]] std::uint32_t coveringPage(std::uint32_t mip, std::uint32_t x0,
+                                             std::uint32_t y0) const {
+        return pageIndex(mip, std::min(x0 >> mip, pagesX_[mip] - 1),
+                         std::min(y0 >> mip, pagesY_[mip] - 1));
+    }
+    void decodePage(std::uint32_t page, std::uint32_t& mip, std::uint32_t& x,
+                    std::uint32_t& y) const;
+    void touch(std::uint32_t page);
+    void lruUnlink(std::uint32_t slot);
+    void lruPushFront(std::uint32_t slot);
+    [[nodiscard]] bool hasResidentChildren(std::uint32_t page) const;
+    [[nodiscard]] std::uint32_t acquireSlot();
+    void refreshPageTable(std::uint32_t page);
+    [[nodiscard]] VkExtent3D pageTexels(std::uint32_t mip, std::uint32_t x,
+                                        std::uint32_t y) const;
+
+    VkDevice device_ = VK_NULL_HANDLE;
+    VmaAllocator allocator_ = nullptr;
+    VkQueue bindQueue_ = VK_NULL_HANDLE;
+    VkImage image_ = VK_NULL_HANDLE;
+    VkImageView view_ = VK_NULL_HANDLE;
+    VkSemaphore bindTimeline_ = VK_NULL_HANDLE;
+    std::uint64_t bindValue_ = 0;
+    VkCommandPool pool_ = VK_NULL_HANDLE;
+    PageLoader loader_;
+
+    VkExtent2D extent_{};
+    VkExtent2D pageExtent_{};
+    std::uint32_t texelBytes_ = 0;
+    VkDeviceSize pageBytes_ = 0; // staged bytes of one full page
+    std::uint32_t mipLevels_ = 0;
+    std::uint32_t tailMip_ = 0;
+    std::uint32_t framesInFlight_ = 0;
+    std::uint32_t maxUploads_ = 0;
+    std::vector<std::uint32_t> pagesX_;
+    std::vector<std::uint32_t> pagesY_;
+    std::vector<std::uint32_t> mipOffset_; // first pages_ index of each mip
+
+    std::vector<Page> pages_;
+    std::vector<Slot> slots_;
+    std::vector<std::uint32_t> freeSlots_;
+    std::vector<std::uint32_t> retiring_;
+    std::uint32_t lruHead_ = UINT32_MAX;
+    std::uint32_t lruTail_ = UINT32_MAX;
+    std::uint32_t frame_ = 0;
+    std::vector<std::uint32_t> requests_;
+
+    VmaAllocation tailMemory_ = nullptr;
+    VkDeviceSize tailStagingOffset_ = 0;
+    bool tailStaged_ = false;
+    bool ready_ = false;
+    std::uint64_t publishedTransferValue_ = 0;
+    bool pageTableDirty_ = false;
+
+    Buffer pageTable_;
+    std::vector<Buffer> feedback_;
+    Buffer staging_; // batches_.size() * maxUploads_ pages, then the mip tail
+    std::vector<StagingBatch> batches_;
+    std::uint32_t nextBatch_ = 0;
+
+    // Scratch for update(), kept to avoid per-frame allocation.
+    std::vector<VkSparseImageMemoryBind> imageBinds_;
+    std::vector<VkBufferImageCopy> copies_;
+
+    VirtualTextureStats stats_;
+};
+
+} // namespace vksdl
@@ -20,22 +20,33 @@
 #include <vksdl/descriptor_set.hpp>
 #include <vksdl/descriptor_writer.hpp>
 #include <vksdl/device.hpp>
+#include <vksdl/dynamic_state.hpp>
 #include <vksdl/error.hpp>
 #include <vksdl/event.hpp>
 #include <vksdl/fly_camera.hpp>
 #include <vksdl/frame_descriptor_allocator.hpp>
 #include <vksdl/frames.hpp>
+#include <vksdl/gpu_scene_buffer.hpp>
 #include <vksdl/image.hpp>
+#include <vksdl/image_view_cache.hpp>
 #include <vksdl/instance.hpp>
+#include <vksdl/mapped_writes.hpp>
+#include <vksdl/material_table.hpp>
 #include <vksdl/mesh.hpp>
 #include <vksdl/mesh_pipeline.hpp>
 #include <vksdl/orbit_camera.hpp>
 #include <vksdl/pipeline.hpp>
+#include <vksdl/pipeline_binary_store.hpp>
 #include <vksdl/pipeline_cache.hpp>
+#include <vksdl/pipeline_cache_pool.hpp>
+#include <vksdl/pipeline_cache_store.hpp>
+#include <vksdl/pipeline_desc.hpp>
+#include <vksdl/pipeline_key.hpp>
 #include <vksdl/pipeline_model/gpl_library.hpp>
 #include <vksdl/pipeline_model/pipeline_compiler.hpp>
 #include <vksdl/pipeline_model/pipeline_handle.hpp>
 #include <vksdl/pipeline_model/pipeline_policy.hpp>
+#include <vksdl/pipeline_model/spec_permutations.hpp>
 #include <vksdl/projection.hpp>
 #include <vksdl/push_descriptor_writer.hpp>
 #include <vksdl/query_pool.hpp>
@@ -45,6 +56,7 @@
 #include <vksdl/sampler_cache.hpp>
 #include <vksdl/sbt.hpp>
 #include <vksdl/shader_reflect.hpp>
+#include <vksdl/startup.hpp>
 #include <vksdl/surface.hpp>
 #include <vksdl/swapchain.hpp>
 #include <vksdl/texture.hpp>
@@ -54,5 +66,6 @@
 #include <vksdl/transform.hpp>
 #include <vksdl/util.hpp>
 #include <vksdl/version.hpp>
+#include <vksdl/virtual_texture.hpp>
 #include <vksdl/vulkan_wsi.hpp>
 #include <vksdl/window.hpp>
@@ -56,20 +56,28 @@ enum class EventType {
 
 struct Event {
     EventType type = EventType::None;
-    Size size = {};             // valid when type == Resized
-    int key = 0;                // raw scancode (escape hatch)
-    Key keyCode = Key::Unknown; // typed key mapping
-    float scroll = 0.0f;        // valid when type == MouseWheel (positive = up)
-    int button = 0;             // valid when type == MouseButtonDown (1=L, 2=M, 3=R)
-    int clicks = 0;             // valid when type == MouseButtonDown (2 = double-click)
-    float mouseX = 0.0f;        // valid when type == MouseButtonDown (pixel coords)
-    float mouseY = 0.0f;        // valid when type == MouseButtonDown (pixel coords)
+    Size size = {};                // valid when type == Resized
+    int key = 0;                   // raw scancode (escape hatch)
+    Key keyCode = Key::Unknown;    // typed key mapping
+    float scroll = 0.0f;           // valid when type == MouseWheel (positive = up)
+    int button = 0;                // valid when type == MouseButtonDown (1=L, 2=M, 3=R)
+    int clicks = 0;                // valid when type == MouseButtonDown (2 = double-click)
+    float mouseX = 0.0f;           // valid when type == MouseButtonDown (pixel coords)
+    float mouseY = 0.0f;           // valid when type == MouseButtonDown (pixel coords)
+    std::uint64_t timestampNs = 0; // when SDL saw the event, on the eventClockNs() clock
 };
 
+// Current time on the Event::timestampNs clock (nanoseconds since SDL init).
+// Subtract an event's timestamp to get its age when it is finally handled.
+[[nodiscard]] std::uint64_t eventClockNs();
+
 class App;
 class WindowImpl;
 
-// Thread safety: thread-confined (main/UI thread).
+// Thread safety: thread-confined (main/UI thread). With
+// App::enableThreadedInput(), pollEvent(), pixelSize(), consumeResize() and
+// droppedEvents() move to one consumer (render) thread; creation,
+// destruction, setTitle() and sdlWindow() stay on the App thread.
 class Window {
   public:
     ~Window();
@@ -81,14 +89,21 @@ class Window {
     // Drain one event from this window's queue.
     // Returns true if an event was written, false when queue is empty.
     // Calls App::pumpEvents() internally on the first call per frame.
+    // With threaded input it only pops from the ring the App thread fills
+    // and never touches SDL.
     bool pollEvent(Event& event);
 
     // Pixel size of the client area (accounts for DPI/HiDPI).
+    // With threaded input, the size last reported by the App thread.
     [[nodiscard]] Size pixelSize() const;
 
     // Returns true once if the window was resized since the last call.
     [[nodiscard]] bool consumeResize();
 
+    // Events lost because the threaded-input ring was full. Quit and
+    // CloseRequested are never lost: they are delivered once the ring drains.
+    [[nodiscard]] std::uint64_t droppedEvents() const;
+
     [[nodiscard]] Result<void> setTitle(std::string_view title);
 
     // Escape hatch -- typed pointer, forward-declared above.
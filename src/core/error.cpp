@@ -11,15 +11,61 @@ namespace vksdl {
 #define VKSDL_ENABLE_EXCEPTIONS 1
 #endif
 
+namespace {
+
+// VkResult values Error::kind() classifies, spelled out so core stays free
+// of <vulkan/vulkan.h>.
+constexpr std::int32_t kOutOfHostMemory = -1;          // VK_ERROR_OUT_OF_HOST_MEMORY
+constexpr std::int32_t kOutOfDeviceMemory = -2;        // VK_ERROR_OUT_OF_DEVICE_MEMORY
+constexpr std::int32_t kDeviceLost = -4;               // VK_ERROR_DEVICE_LOST
+constexpr std::int32_t kExtensionNotPresent = -7;      // VK_ERROR_EXTENSION_NOT_PRESENT
+constexpr std::int32_t kFeatureNotPresent = -8;        // VK_ERROR_FEATURE_NOT_PRESENT
+constexpr std::int32_t kIncompatibleDriver = -9;       // VK_ERROR_INCOMPATIBLE_DRIVER
+constexpr std::int32_t kFormatNotSupported = -11;      // VK_ERROR_FORMAT_NOT_SUPPORTED
+constexpr std::int32_t kFragmentedPool = -12;          // VK_ERROR_FRAGMENTED_POOL
+constexpr std::int32_t kOutOfPoolMemory = -1000069000; // VK_ERROR_OUT_OF_POOL_MEMORY
+constexpr std::int32_t kCompileRequired = 1000297000;  // VK_PIPELINE_COMPILE_REQUIRED
+
+} // namespace
+
+ErrorCode Error::kind() const {
+    if (code != ErrorCode::Unspecified)
+        return code;
+    switch (vkResult) {
+    case 0:
+        return ErrorCode::Failed;
+    case kOutOfHostMemory:
+    case kOutOfDeviceMemory:
+        return ErrorCode::OutOfMemory;
+    case kDeviceLost:
+        return ErrorCode::DeviceLost;
+    case kExtensionNotPresent:
+    case kFeatureNotPresent:
+    case kIncompatibleDriver:
+    case kFormatNotSupported:
+        return ErrorCode::NotSupported;
+    case kFragmentedPool:
+    case kOutOfPoolMemory:
+        return ErrorCode::PoolExhausted;
+    case kCompileRequired:
+        return ErrorCode::CompileRequired;
+    default:
+        return ErrorCode::Vulkan;
+    }
+}
+
 std::string Error::format() const {
-    std::string out = "vksdl: " + operation + " failed";
+    std::string out = "vksdl: ";
+    out += operation.view();
+    out += " failed";
 
     if (vkResult != 0) {
         out += " (VkResult " + std::to_string(vkResult) + ")";
     }
 
     if (!message.empty()) {
-        out += ": " + message;
+        out += ": ";
+        out += message.view();
     }
 
     return out;
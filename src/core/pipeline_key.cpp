@@ -0,0 +1,11 @@
+#include <vksdl/pipeline_key.hpp>
+
+#include <cstdint>
+
+namespace vksdl {
+
+PipelineKey hash128(const void* data, std::size_t size, std::uint64_t seed) {
+    return detail::hash128Bytes(static_cast<const std::uint8_t*>(data), size, seed);
+}
+
+} // namespace vksdl
@@ -1,5 +1,7 @@
 #include <vksdl/graph/barrier_compiler.hpp>
 
+#include <algorithm>
+
 namespace vksdl::graph {
 
 VkDependencyInfo BarrierBatch::dependencyInfo() const {
@@ -169,4 +171,187 @@ void appendBufferBarrier(BarrierBatch& batch, const BufferBarrierRequest& req) {
     batch.bufferBarriers.push_back(barrier);
 }
 
+// Release: make prior writes available and hand off ownership; the dst scope
+// is ignored on the source queue. Acquire: the src scope is ignored on the
+// destination queue; the semaphore wait provides the execution dependency.
+static BarrierParams ownershipParams(const ResourceState& src, const ResourceState& dst,
+                                     bool dstIsRead) {
+    auto p = computeBarrier(src, dst, dstIsRead);
+    if (!p.needed) {
+        // Read-after-read or no prior use: still order prior accesses before
+        // the release.
+        p.srcStage = src.lastWriteStage | src.readStagesSinceWrite;
+        p.srcAccess = VK_ACCESS_2_NONE;
+    }
+    return p;
+}
+
+void appendImageOwnershipTransfer(BarrierBatch& release, BarrierBatch& acquire,
+                                  const ImageBarrierRequest& req, std::uint32_t srcFamily,
+                                  std::uint32_t dstFamily) {
+    auto p = ownershipParams(req.src, req.dst, req.isRead);
+
+    VkImageMemoryBarrier2 barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+    barrier.oldLayout = p.oldLayout;
+    barrier.newLayout = p.newLayout;
+    barrier.srcQueueFamilyIndex = srcFamily;
+    barrier.dstQueueFamilyIndex = dstFamily;
+    barrier.image = req.image;
+    barrier.subresourceRange = VkImageSubresourceRange{
+        req.aspect,           req.range.baseMipLevel,
+        req.range.levelCount, req.range.baseArrayLayer,
+        req.range.layerCount,
+    };
+
+    VkImageMemoryBarrier2 rel = barrier;
+    rel.srcStageMask = p.srcStage;
+    rel.srcAccessMask = p.srcAccess;
+    rel.dstStageMask = VK_PIPELINE_STAGE_2_NONE;
+    rel.dstAccessMask = VK_ACCESS_2_NONE;
+    release.imageBarriers.push_back(rel);
+
+    VkImageMemoryBarrier2 acq = barrier;
+    acq.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+    acq.srcAccessMask = VK_ACCESS_2_NONE;
+    acq.dstStageMask = p.dstStage;
+    acq.dstAccessMask = p.dstAccess;
+    acquire.imageBarriers.push_back(acq);
+}
+
+void appendBufferOwnershipTransfer(BarrierBatch& release, BarrierBatch& acquire,
+                                   const BufferBarrierRequest& req, std::uint32_t srcFamily,
+                                   std::uint32_t dstFamily) {
+    auto p = ownershipParams(req.src, req.dst, req.isRead);
+
+    VkBufferMemoryBarrier2 barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+    barrier.srcQueueFamilyIndex = srcFamily;
+    barrier.dstQueueFamilyIndex = dstFamily;
+    barrier.buffer = req.buffer;
+    barrier.offset = req.offset;
+    barrier.size = req.size;
+
+    VkBufferMemoryBarrier2 rel = barrier;
+    rel.srcStageMask = p.srcStage;
+    rel.srcAccessMask = p.srcAccess;
+    rel.dstStageMask = VK_PIPELINE_STAGE_2_NONE;
+    rel.dstAccessMask = VK_ACCESS_2_NONE;
+    release.bufferBarriers.push_back(rel);
+
+    VkBufferMemoryBarrier2 acq = barrier;
+    acq.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+    acq.srcAccessMask = VK_ACCESS_2_NONE;
+    acq.dstStageMask = p.dstStage;
+    acq.dstAccessMask = p.dstAccess;
+    acquire.bufferBarriers.push_back(acq);
+}
+
+static bool sameDependency(const VkMemoryBarrier2& a, const VkMemoryBarrier2& b) {
+    return a.srcStageMask == b.srcStageMask && a.srcAccessMask == b.srcAccessMask &&
+           a.dstStageMask == b.dstStageMask && a.dstAccessMask == b.dstAccessMask;
+}
+
+// [base, base + count) ranges that touch or overlap. VK_REMAINING_* counts
+// never merge; the graph always records explicit counts.
+static bool rangesTouch(std::uint32_t baseA, std::uint32_t countA, std::uint32_t baseB,
+                        std::uint32_t countB) {
+    if (countA == VK_REMAINING_MIP_LEVELS || countB == VK_REMAINING_MIP_LEVELS)
+        return false;
+    return baseA <= baseB + countB && baseB <= baseA + countA;
+}
+
+// Merge `b` into `a` if the result covers exactly the union of both.
+static bool mergeImageBarrier(VkImageMemoryBarrier2& a, const VkImageMemoryBarrier2& b) {
+    if (a.image != b.image || a.oldLayout != b.oldLayout || a.newLayout != b.newLayout ||
+        a.srcStageMask != b.srcStageMask || a.srcAccessMask != b.srcAccessMask ||
+        a.dstStageMask != b.dstStageMask || a.dstAccessMask != b.dstAccessMask ||
+        a.srcQueueFamilyIndex != b.srcQueueFamilyIndex ||
+        a.dstQueueFamilyIndex != b.dstQueueFamilyIndex)
+        return false;
+
+    auto& ra = a.subresourceRange;
+    const auto& rb = b.subresourceRange;
+    if (ra.aspectMask != rb.aspectMask)
+        return false;
+
+    bool sameLayers = ra.baseArrayLayer == rb.baseArrayLayer && ra.layerCount == rb.layerCount;
+    bool sameMips = ra.baseMipLevel == rb.baseMipLevel && ra.levelCount == rb.levelCount;
+    if (sameLayers && rangesTouch(ra.baseMipLevel, ra.levelCount, rb.baseMipLevel, rb.levelCount)) {
+        std::uint32_t end =
+            std::max(ra.baseMipLevel + ra.levelCount, rb.baseMipLevel + rb.levelCount);
+        ra.baseMipLevel = std::min(ra.baseMipLevel, rb.baseMipLevel);
+        ra.levelCount = end - ra.baseMipLevel;
+        return true;
+    }
+    if (sameMips &&
+        rangesTouch(ra.baseArrayLayer, ra.layerCount, rb.baseArrayLayer, rb.layerCount)) {
+        std::uint32_t end =
+            std::max(ra.baseArrayLayer + ra.layerCount, rb.baseArrayLayer + rb.layerCount);
+        ra.baseArrayLayer = std::min(ra.baseArrayLayer, rb.baseArrayLayer);
+        ra.layerCount = end - ra.baseArrayLayer;
+        return true;
+    }
+    return false;
+}
+
+std::uint32_t coalesceBarriers(BarrierBatch& batch) {
+    std::uint32_t before = batch.size();
+
+    // Image barriers: merge until nothing changes. A merge can make two
+    // earlier survivors adjacent, so one pass is not always enough; batches
+    // are small and mip chains usually collapse on the first pass.
+    auto& images = batch.imageBarriers;
+    bool merged = images.size() > 1;
+    while (merged) {
+        merged = false;
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < images.size(); ++i) {
+            bool absorbed = false;
+            if (images[i].srcQueueFamilyIndex == images[i].dstQueueFamilyIndex) {
+                for (std::size_t j = 0; j < kept && !absorbed; ++j)
+                    absorbed = mergeImageBarrier(images[j], images[i]);
+            }
+            if (absorbed)
+                merged = true;
+            else
+                images[kept++] = images[i];
+        }
+        images.resize(kept);
+    }
+
+    // Buffer barriers without an ownership transfer become memory barriers.
+    auto& buffers = batch.bufferBarriers;
+    std::size_t keptBuffers = 0;
+    for (std::size_t i = 0; i < buffers.size(); ++i) {
+        const auto& b = buffers[i];
+        if (b.srcQueueFamilyIndex != b.dstQueueFamilyIndex) {
+            buffers[keptBuffers++] = b;
+            continue;
+        }
+        VkMemoryBarrier2 mem{};
+        mem.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+        mem.srcStageMask = b.srcStageMask;
+        mem.srcAccessMask = b.srcAccessMask;
+        mem.dstStageMask = b.dstStageMask;
+        mem.dstAccessMask = b.dstAccessMask;
+        batch.memoryBarriers.push_back(mem);
+    }
+    buffers.resize(keptBuffers);
+
+    // Dedupe memory barriers with identical stage/access sets.
+    auto& memory = batch.memoryBarriers;
+    std::size_t keptMemory = 0;
+    for (std::size_t i = 0; i < memory.size(); ++i) {
+        bool duplicate = false;
+        for (std::size_t j = 0; j < keptMemory && !duplicate; ++j)
+            duplicate = sameDependency(memory[j], memory[i]);
+        if (!duplicate)
+            memory[keptMemory++] = memory[i];
+    }
+    memory.resize(keptMemory);
+
+    return before - batch.size();
+}
+
 } // namespace vksdl::graph
@@ -1,5 +1,8 @@
 #include <vksdl/graph/pass.hpp>
 
+#include <bit>
+#include <cassert>
+
 namespace vksdl::graph {
 
 VkPipelineStageFlags2 PassBuilder::shaderStage() const {
@@ -14,6 +17,12 @@ VkPipelineStageFlags2 PassBuilder::shaderStage() const {
     return VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
 }
 
+SubresourceRange PassBuilder::attachmentRange() const {
+    if (viewMask_ == 0)
+        return {};
+    return {0, 1, 0, static_cast<std::uint32_t>(32 - std::countl_zero(viewMask_))};
+}
+
 PassBuilder& PassBuilder::sampleImage(ResourceHandle h, SubresourceRange range) {
     ResourceState state{};
     state.lastWriteStage = shaderStage();
@@ -46,7 +55,7 @@ PassBuilder& PassBuilder::readInputAttachment(ResourceHandle h) {
     state.lastWriteStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
     state.readAccessSinceWrite = VK_ACCESS_2_INPUT_ATTACHMENT_READ_BIT;
     state.currentLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    accesses_.push_back({h, AccessType::Read, state, {}});
+    accesses_.push_back({h, AccessType::Read, state, attachmentRange()});
     return *this;
 }
 
@@ -56,7 +65,7 @@ PassBuilder& PassBuilder::readDepthAttachment(ResourceHandle h) {
         VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
     state.readAccessSinceWrite = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
     state.currentLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
-    accesses_.push_back({h, AccessType::Read, state, {}});
+    accesses_.push_back({h, AccessType::Read, state, attachmentRange()});
     return *this;
 }
 
@@ -65,7 +74,7 @@ PassBuilder& PassBuilder::writeColorAttachment(ResourceHandle h) {
     state.lastWriteStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
     state.lastWriteAccess = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
     state.currentLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-    accesses_.push_back({h, AccessType::Write, state, {}});
+    accesses_.push_back({h, AccessType::Write, state, attachmentRange()});
     return *this;
 }
 
@@ -76,7 +85,7 @@ PassBuilder& PassBuilder::writeDepthAttachment(ResourceHandle h) {
     state.lastWriteAccess = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
                             VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
     state.currentLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-    accesses_.push_back({h, AccessType::ReadWrite, state, {}});
+    accesses_.push_back({h, AccessType::ReadWrite, state, attachmentRange()});
     return *this;
 }
 
@@ -194,6 +203,13 @@ PassBuilder& PassBuilder::setDepthTarget(ResourceHandle h, LoadOp loadOp, DepthW
     return *this;
 }
 
+PassBuilder& PassBuilder::setViewMask(std::uint32_t mask) {
+    assert(colorTargets_.empty() && !depthTarget_ &&
+           "setViewMask: call before declaring render targets");
+    viewMask_ = mask;
+    return *this;
+}
+
 PassBuilder& PassBuilder::setSampler(VkSampler sampler) {
     defaultSampler_ = sampler;
     return *this;
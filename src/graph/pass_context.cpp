@@ -2,6 +2,7 @@
 #include <vksdl/graph/render_graph.hpp> // ResolvedRendering
 
 #include <cassert>
+#include <cstdio>
 
 namespace vksdl::graph {
 
@@ -15,6 +16,23 @@ VkImageView PassContext::vkImageView(ResourceHandle h) const {
     return (*resources_)[h.index].vkImageView;
 }
 
+VkImageView PassContext::imageView(ResourceHandle h, const ImageViewDesc& desc) const {
+    assert(h.valid() && h.index < resources_->size());
+    const auto& res = (*resources_)[h.index];
+    assert(res.kind == ResourceKind::Image && "imageView() called on a buffer resource");
+    if (!res.views)
+        return VK_NULL_HANDLE;
+    auto view = res.views->view(desc);
+    if (!view.ok()) {
+#ifndef NDEBUG
+        std::fprintf(stderr, "[vksdl] PassContext::imageView: %s\n",
+                     view.error().format().c_str());
+#endif
+        return VK_NULL_HANDLE;
+    }
+    return view.value();
+}
+
 VkBuffer PassContext::vkBuffer(ResourceHandle h) const {
     assert(h.valid() && h.index < resources_->size());
     return (*resources_)[h.index].vkBuffer;
@@ -96,7 +114,8 @@ void PassContext::beginRendering(VkCommandBuffer cmd) {
     ri.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
     ri.renderArea.offset = {0, 0};
     ri.renderArea.extent = rendering_->renderArea;
-    ri.layerCount = 1;
+    ri.layerCount = 1; // ignored when viewMask != 0
+    ri.viewMask = rendering_->viewMask;
     ri.colorAttachmentCount = static_cast<std::uint32_t>(rendering_->colorAttachments.size());
     ri.pColorAttachments =
         rendering_->colorAttachments.empty() ? nullptr : rendering_->colorAttachments.data();
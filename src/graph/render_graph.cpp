@@ -6,10 +6,12 @@
 #include <vksdl/graph/render_graph.hpp>
 #include <vksdl/image.hpp>
 #include <vksdl/shader_reflect.hpp>
+#include <vksdl/transfer_queue.hpp>
 
 #include <vk_mem_alloc.h>
 
 #include <algorithm>
+#include <bit>
 #include <cassert>
 #include <chrono>
 #include <cinttypes>
@@ -26,7 +28,7 @@ static VmaAllocator toVma(void* p) {
 
 RenderGraph::RenderGraph(const Device& device, const Allocator& allocator)
     : device_(device.vkDevice()), allocator_(allocator.vmaAllocator()),
-      hasUnifiedLayouts_(device.hasUnifiedImageLayouts()) {
+      hasUnifiedLayouts_(device.hasUnifiedImageLayouts()), hasMultiview_(device.hasMultiview()) {
     auto alloc = DescriptorAllocator::create(device);
     if (alloc.ok()) {
         descAllocator_ = std::make_unique<DescriptorAllocator>(std::move(alloc).value());
@@ -46,19 +48,28 @@ RenderGraph::~RenderGraph() {
 
 RenderGraph::RenderGraph(RenderGraph&& o) noexcept
     : device_(o.device_), allocator_(o.allocator_), hasUnifiedLayouts_(o.hasUnifiedLayouts_),
-      passes_(std::move(o.passes_)), resources_(std::move(o.resources_)),
+      hasMultiview_(o.hasMultiview_),
+      asyncTransferFamily_(o.asyncTransferFamily_), asyncGraphicsFamily_(o.asyncGraphicsFamily_),
+      asyncWaitStages_(o.asyncWaitStages_), asyncReleases_(std::move(o.asyncReleases_)),
+      passes_(std::move(o.passes_)),
+      resources_(std::move(o.resources_)),
       imageMaps_(std::move(o.imageMaps_)), bufferStates_(std::move(o.bufferStates_)),
       adj_(std::move(o.adj_)), inDegree_(std::move(o.inDegree_)),
       compiledPasses_(std::move(o.compiledPasses_)), isCompiled_(o.isCompiled_),
       stats_(std::move(o.stats_)), transientImages_(std::move(o.transientImages_)),
       transientBuffers_(std::move(o.transientBuffers_)), imagePool_(std::move(o.imagePool_)),
-      bufferPool_(std::move(o.bufferPool_)), lastGraphHash_(o.lastGraphHash_),
+      bufferPool_(std::move(o.bufferPool_)), transientViews_(std::move(o.transientViews_)),
+      lastGraphHash_(o.lastGraphHash_),
       cachedOrder_(std::move(o.cachedOrder_)),
       cachedImageHandles_(std::move(o.cachedImageHandles_)),
       cachedViewHandles_(std::move(o.cachedViewHandles_)),
       cachedBufferHandles_(std::move(o.cachedBufferHandles_)),
-      cachedStats_(std::move(o.cachedStats_)), descAllocator_(std::move(o.descAllocator_)),
-      dslCache_(std::move(o.dslCache_)) {
+      cachedStats_(std::move(o.cachedStats_)), cachedPassHashes_(std::move(o.cachedPassHashes_)),
+      cachedResourceHashes_(std::move(o.cachedResourceHashes_)),
+      cachedPassResources_(std::move(o.cachedPassResources_)),
+      lastFullCompileUs_(o.lastFullCompileUs_),
+      lastIncrementalCompileUs_(o.lastIncrementalCompileUs_),
+      descAllocator_(std::move(o.descAllocator_)), dslCache_(std::move(o.dslCache_)) {
     o.device_ = VK_NULL_HANDLE;
     o.allocator_ = nullptr;
     o.isCompiled_ = false;
@@ -71,6 +82,11 @@ RenderGraph& RenderGraph::operator=(RenderGraph&& o) noexcept {
         device_ = o.device_;
         allocator_ = o.allocator_;
         hasUnifiedLayouts_ = o.hasUnifiedLayouts_;
+        hasMultiview_ = o.hasMultiview_;
+        asyncTransferFamily_ = o.asyncTransferFamily_;
+        asyncGraphicsFamily_ = o.asyncGraphicsFamily_;
+        asyncWaitStages_ = o.asyncWaitStages_;
+        asyncReleases_ = std::move(o.asyncReleases_);
         passes_ = std::move(o.passes_);
         resources_ = std::move(o.resources_);
         imageMaps_ = std::move(o.imageMaps_);
@@ -84,12 +100,18 @@ RenderGraph& RenderGraph::operator=(RenderGraph&& o) noexcept {
         transientBuffers_ = std::move(o.transientBuffers_);
         imagePool_ = std::move(o.imagePool_);
         bufferPool_ = std::move(o.bufferPool_);
+        transientViews_ = std::move(o.transientViews_);
         lastGraphHash_ = o.lastGraphHash_;
         cachedOrder_ = std::move(o.cachedOrder_);
         cachedImageHandles_ = std::move(o.cachedImageHandles_);
         cachedViewHandles_ = std::move(o.cachedViewHandles_);
         cachedBufferHandles_ = std::move(o.cachedBufferHandles_);
         cachedStats_ = std::move(o.cachedStats_);
+        cachedPassHashes_ = std::move(o.cachedPassHashes_);
+        cachedResourceHashes_ = std::move(o.cachedResourceHashes_);
+        cachedPassResources_ = std::move(o.cachedPassResources_);
+        lastFullCompileUs_ = o.lastFullCompileUs_;
+        lastIncrementalCompileUs_ = o.lastIncrementalCompileUs_;
         descAllocator_ = std::move(o.descAllocator_);
         dslCache_ = std::move(o.dslCache_);
         o.device_ = VK_NULL_HANDLE;
@@ -121,8 +143,10 @@ void RenderGraph::destroyTransients() {
     for (auto& t : transientImages_) {
         if (t.view != VK_NULL_HANDLE)
             vkDestroyImageView(device_, t.view, nullptr);
-        if (t.image != VK_NULL_HANDLE)
+        if (t.image != VK_NULL_HANDLE) {
+            transientViews_.erase(t.image);
             vmaDestroyImage(vma, t.image, static_cast<VmaAllocation>(t.allocation));
+        }
     }
     transientImages_.clear();
 
@@ -152,8 +176,10 @@ void RenderGraph::destroyPool() {
     for (auto& t : imagePool_) {
         if (t.view != VK_NULL_HANDLE)
             vkDestroyImageView(device_, t.view, nullptr);
-        if (t.image != VK_NULL_HANDLE)
+        if (t.image != VK_NULL_HANDLE) {
+            transientViews_.erase(t.image);
             vmaDestroyImage(vma, t.image, static_cast<VmaAllocation>(t.allocation));
+        }
     }
     imagePool_.clear();
 
@@ -167,7 +193,8 @@ void RenderGraph::destroyPool() {
 ResourceHandle RenderGraph::importImage(VkImage image, VkImageView view, VkFormat format,
                                         std::uint32_t width, std::uint32_t height,
                                         const ResourceState& initialState, std::uint32_t mipLevels,
-                                        std::uint32_t arrayLayers, std::string_view name) {
+                                        std::uint32_t arrayLayers, std::string_view name,
+                                        ImageViewCache* views) {
 
     ResourceHandle h{static_cast<std::uint32_t>(resources_.size())};
 
@@ -180,6 +207,7 @@ ResourceHandle RenderGraph::importImage(VkImage image, VkImageView view, VkForma
     entry.imageDesc = {width, height, format, 0, mipLevels, arrayLayers, VK_SAMPLE_COUNT_1_BIT};
     entry.aspect = aspectFromFormat(format);
     entry.initialState = initialState;
+    entry.views = views;
     resources_.push_back(entry);
 
     return h;
@@ -188,7 +216,8 @@ ResourceHandle RenderGraph::importImage(VkImage image, VkImageView view, VkForma
 ResourceHandle RenderGraph::importImage(const Image& image, const ResourceState& initialState,
                                         std::string_view name) {
     return importImage(image.vkImage(), image.vkImageView(), image.format(), image.extent().width,
-                       image.extent().height, initialState, image.mipLevels(), 1, name);
+                       image.extent().height, initialState, image.mipLevels(), 1, name,
+                       &image.viewCache());
 }
 
 ResourceHandle RenderGraph::importBuffer(VkBuffer buffer, VkDeviceSize size,
@@ -251,6 +280,7 @@ void RenderGraph::addPass(std::string_view name, PassType type, SetupFn setup, R
     decl.recordFn = std::move(record);
     decl.colorTargets = std::move(builder.colorTargets_);
     decl.depthTarget = std::move(builder.depthTarget_);
+    decl.viewMask = builder.viewMask_;
     passes_.push_back(std::move(decl));
 }
 
@@ -303,6 +333,7 @@ void RenderGraph::addPass(std::string_view name, PassType type, VkPipeline pipel
     decl.recordFn = std::move(record);
     decl.colorTargets = std::move(builder.colorTargets_);
     decl.depthTarget = std::move(builder.depthTarget_);
+    decl.viewMask = builder.viewMask_;
     decl.pipeline = pipeline;
     decl.pipelineLayout = pipelineLayout;
     decl.reflection = &reflection;
@@ -613,6 +644,12 @@ Result<void> RenderGraph::allocateTransients() {
                 transientImages_.push_back({res.imageDesc, image, view, allocation});
             }
 
+            const ImageDesc& d = res.imageDesc;
+            res.views = &transientViews_
+                             .try_emplace(res.vkImage, device_, res.vkImage, d.format, res.aspect,
+                                          d.mipLevels, d.arrayLayers)
+                             .first->second;
+
         } else {
             bool found = false;
 
@@ -712,142 +749,303 @@ static Result<void> validateQueueFamilyTransition(const ResourceState& src,
                  "queue-family ownership transfer requested for resource '" + resourceName +
                      "' (src=" + std::to_string(src.queueFamily) +
                      ", dst=" + std::to_string(dst.queueFamily) +
-                     "). RenderGraph executes on one queue family; explicit release/acquire"
-                     " ownership transfer (including maintenance9 caveats) is not modeled yet."};
+                     "). RenderGraph only models release/acquire ownership transfers from the"
+                     " async transfer family to the graphics family (enableAsyncTransfer);"
+                     " other transfers (including maintenance9 caveats) are not modeled yet."};
+}
+
+// Stages a resource may have been used at before it can be touched on a
+// transfer-only queue without a barrier naming an unsupported stage.
+static constexpr VkPipelineStageFlags2 kTransferQueueStages =
+    VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT | VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT |
+    VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT | VK_PIPELINE_STAGE_2_COPY_BIT |
+    VK_PIPELINE_STAGE_2_CLEAR_BIT | VK_PIPELINE_STAGE_2_HOST_BIT |
+    VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+// A Transfer pass runs on the async transfer queue when:
+//   - all of its producers do too (the transfer submit precedes graphics),
+//   - no graphics-queue pass touched its resources earlier in the frame,
+//   - its resources are not owned by another family at frame start, and
+//   - every stage involved is valid on a transfer-only queue.
+// Walks `order` once; returns true if any pass qualified.
+bool RenderGraph::markAsyncTransferPasses(const std::vector<std::uint32_t>& order,
+                                          std::vector<std::uint8_t>& async) const {
+    async.assign(passes_.size(), 0);
+    if (asyncTransferFamily_ == VK_QUEUE_FAMILY_IGNORED)
+        return false;
+
+    auto transferStages = [](VkPipelineStageFlags2 stages) {
+        return (stages & ~kTransferQueueStages) == 0;
+    };
+
+    std::vector<std::uint8_t> blocked(passes_.size(), 0);
+    std::vector<std::uint8_t> graphicsTouched(resources_.size(), 0);
+    bool any = false;
+
+    for (auto pi : order) {
+        const auto& pass = passes_[pi];
+        bool eligible = pass.type == PassType::Transfer && !blocked[pi];
+        for (const auto& acc : pass.accesses) {
+            if (!eligible)
+                break;
+            if (!acc.handle.valid())
+                continue;
+            const auto& init = resources_[acc.handle.index].initialState;
+            if (graphicsTouched[acc.handle.index] ||
+                (init.queueFamily != VK_QUEUE_FAMILY_IGNORED &&
+                 init.queueFamily != asyncTransferFamily_) ||
+                !transferStages(init.lastWriteStage | init.readStagesSinceWrite) ||
+                !transferStages(acc.desiredState.lastWriteStage))
+                eligible = false;
+        }
+
+        if (eligible) {
+            async[pi] = 1;
+            any = true;
+            continue;
+        }
+
+        if (pi < adj_.size()) {
+            for (auto succ : adj_[pi])
+                blocked[succ] = 1;
+        }
+        for (const auto& acc : pass.accesses)
+            if (acc.handle.valid())
+                graphicsTouched[acc.handle.index] = 1;
+    }
+    return any;
 }
 
 Result<void> RenderGraph::compileBarriers(const std::vector<std::uint32_t>& order) {
     compiledPasses_.clear();
     compiledPasses_.reserve(order.size());
 
+    std::vector<std::uint8_t> async;
+    bool anyAsync = markAsyncTransferPasses(order, async);
+    BarrierBatch releases;
+    asyncReleases_ = {};
+
+    // A resource another family owns at frame start (left on the transfer
+    // queue last frame, or uploaded through TransferQueue) still needs its
+    // acquire when no pass goes async this frame.
+    bool route = anyAsync;
+    if (!route && asyncTransferFamily_ != VK_QUEUE_FAMILY_IGNORED) {
+        for (auto passIdx : order) {
+            for (const auto& acc : passes_[passIdx].accesses) {
+                if (!acc.handle.valid())
+                    continue;
+                auto family = resources_[acc.handle.index].initialState.queueFamily;
+                if (family != VK_QUEUE_FAMILY_IGNORED && family != asyncGraphicsFamily_)
+                    route = true;
+            }
+        }
+    }
+
     for (auto passIdx : order) {
         CompiledPass cp;
         cp.passIndex = passIdx;
+        cp.asyncTransfer = async[passIdx] != 0;
         const auto& pass = passes_[passIdx];
 
         for (const auto& acc : pass.accesses) {
             if (!acc.handle.valid())
                 continue;
-            std::uint32_t ri = acc.handle.index;
-            const auto& res = resources_[ri];
+            if (!route) {
+                auto accResult = compileAccess(acc, &cp.barriers);
+                if (!accResult)
+                    return accResult;
+                continue;
+            }
 
-            bool isRead = (acc.access == AccessType::Read);
+            // Tag the access with the queue it runs on so compileAccess can
+            // spot transfer -> graphics hand-offs.
+            ResourceAccess routed = acc;
+            if (routed.desiredState.queueFamily == VK_QUEUE_FAMILY_IGNORED)
+                routed.desiredState.queueFamily =
+                    cp.asyncTransfer ? asyncTransferFamily_ : asyncGraphicsFamily_;
+            auto accResult = compileAccess(routed, &cp.barriers, &releases);
+            if (!accResult)
+                return accResult;
+        }
 
-            if (res.kind == ResourceKind::Image) {
-                // Walk actual slices from the ImageSubresourceMap that overlap
-                // this access's subresource range.
-                auto& map = imageMaps_[ri];
-                const auto& slices = map.slices();
+        cp.emittedBarriers = cp.barriers.size();
+        coalesceBarriers(cp.barriers);
+        compiledPasses_.push_back(std::move(cp));
+    }
 
-                for (const auto& slice : slices) {
-                    if (!slice.range.overlaps(acc.subresourceRange))
-                        continue;
+    // Releases run on the transfer queue after all async passes (on their
+    // own when there are none); the graphics submit waits at the stages of
+    // the matching acquires.
+    asyncWaitStages_ = VK_PIPELINE_STAGE_2_NONE;
+    if (route) {
+        auto last = std::find_if(compiledPasses_.rbegin(), compiledPasses_.rend(),
+                                 [](const CompiledPass& cp) { return cp.asyncTransfer; });
+        if (last != compiledPasses_.rend())
+            last->releaseBarriers = std::move(releases);
+        else
+            asyncReleases_ = std::move(releases);
+        for (const auto& cp : compiledPasses_) {
+            for (const auto& b : cp.barriers.imageBarriers)
+                if (b.srcQueueFamilyIndex != b.dstQueueFamilyIndex)
+                    asyncWaitStages_ |= b.dstStageMask;
+            for (const auto& b : cp.barriers.bufferBarriers)
+                if (b.srcQueueFamilyIndex != b.dstQueueFamilyIndex)
+                    asyncWaitStages_ |= b.dstStageMask;
+        }
+        // Nothing consumed on graphics this frame: still order the transfer
+        // work before the graphics submit.
+        if (asyncWaitStages_ == VK_PIPELINE_STAGE_2_NONE)
+            asyncWaitStages_ = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    }
+
+    return {};
+}
 
+// Emit barriers for one access into `out` and advance the tracked state.
+// With out == nullptr only the state is advanced (incremental path: the
+// pass keeps its previous barriers but later passes depend on its effect).
+// Transfer -> graphics hand-offs put the release half into `release`.
+Result<void> RenderGraph::compileAccess(const ResourceAccess& acc, BarrierBatch* out,
+                                        BarrierBatch* release) {
+    std::uint32_t ri = acc.handle.index;
+    const auto& res = resources_[ri];
+
+    bool isRead = (acc.access == AccessType::Read);
+    auto isHandOff = [&](const ResourceState& src) {
+        return release != nullptr && asyncTransferFamily_ != VK_QUEUE_FAMILY_IGNORED &&
+               src.queueFamily == asyncTransferFamily_ &&
+               acc.desiredState.queueFamily == asyncGraphicsFamily_;
+    };
+
+    if (res.kind == ResourceKind::Image) {
+        auto& map = imageMaps_[ri];
+
+        if (out) {
+            // Walk actual slices from the ImageSubresourceMap that overlap
+            // this access's subresource range.
+            const auto& slices = map.slices();
+
+            for (const auto& slice : slices) {
+                if (!slice.range.overlaps(acc.subresourceRange))
+                    continue;
+
+                bool handOff = isHandOff(slice.state);
+                if (!handOff) {
                     auto queueCheck =
                         validateQueueFamilyTransition(slice.state, acc.desiredState, res);
                     if (!queueCheck) {
                         return queueCheck.error();
                     }
-
-                    // Compute the overlap region.
-                    SubresourceRange overlap;
-                    overlap.baseMipLevel =
-                        std::max(slice.range.baseMipLevel, acc.subresourceRange.baseMipLevel);
-                    overlap.baseArrayLayer =
-                        std::max(slice.range.baseArrayLayer, acc.subresourceRange.baseArrayLayer);
-                    std::uint32_t mipEnd =
-                        std::min(slice.range.mipEnd(), acc.subresourceRange.mipEnd());
-                    std::uint32_t layerEnd =
-                        std::min(slice.range.layerEnd(), acc.subresourceRange.layerEnd());
-                    overlap.levelCount = mipEnd - overlap.baseMipLevel;
-                    overlap.layerCount = layerEnd - overlap.baseArrayLayer;
-
-                    // When unified layouts are active, suppress layout
-                    // transitions between known layouts. The initial
-                    // UNDEFINED -> X transition is preserved (spec requires it).
-                    ResourceState srcState = slice.state;
-                    ResourceState dstState = acc.desiredState;
-                    if (hasUnifiedLayouts_ && srcState.currentLayout != VK_IMAGE_LAYOUT_UNDEFINED) {
-                        srcState.currentLayout = VK_IMAGE_LAYOUT_GENERAL;
-                        dstState.currentLayout = VK_IMAGE_LAYOUT_GENERAL;
-                    }
-
-                    appendImageBarrier(cp.barriers, ImageBarrierRequest{
-                                                        .image = res.vkImage,
-                                                        .range = overlap,
-                                                        .aspect = res.aspect,
-                                                        .src = srcState,
-                                                        .dst = dstState,
-                                                        .isRead = isRead,
-                                                    });
                 }
 
-                // Update tracked state for the accessed range.
-                ResourceState newState = acc.desiredState;
-                if (hasUnifiedLayouts_) {
-                    newState.currentLayout = VK_IMAGE_LAYOUT_GENERAL;
-                }
-                if (isRead) {
-                    // Preserve writer info from current state, add this read.
-                    ResourceState merged = map.queryState(acc.subresourceRange);
-                    newState.lastWriteStage = merged.lastWriteStage;
-                    newState.lastWriteAccess = merged.lastWriteAccess;
-                    newState.readStagesSinceWrite =
-                        merged.readStagesSinceWrite | acc.desiredState.lastWriteStage;
-                    newState.readAccessSinceWrite =
-                        merged.readAccessSinceWrite | acc.desiredState.readAccessSinceWrite;
-                    newState.currentLayout = acc.desiredState.currentLayout;
-                    if (newState.queueFamily == VK_QUEUE_FAMILY_IGNORED) {
-                        newState.queueFamily = merged.queueFamily;
-                    }
-                } else {
-                    // Write: reset readers, set new writer.
-                    newState.readStagesSinceWrite = VK_PIPELINE_STAGE_2_NONE;
-                    newState.readAccessSinceWrite = VK_ACCESS_2_NONE;
-                    if (newState.queueFamily == VK_QUEUE_FAMILY_IGNORED) {
-                        newState.queueFamily = map.queryState(acc.subresourceRange).queueFamily;
-                    }
+                // Compute the overlap region.
+                SubresourceRange overlap;
+                overlap.baseMipLevel =
+                    std::max(slice.range.baseMipLevel, acc.subresourceRange.baseMipLevel);
+                overlap.baseArrayLayer =
+                    std::max(slice.range.baseArrayLayer, acc.subresourceRange.baseArrayLayer);
+                std::uint32_t mipEnd =
+                    std::min(slice.range.mipEnd(), acc.subresourceRange.mipEnd());
+                std::uint32_t layerEnd =
+                    std::min(slice.range.layerEnd(), acc.subresourceRange.layerEnd());
+                overlap.levelCount = mipEnd - overlap.baseMipLevel;
+                overlap.layerCount = layerEnd - overlap.baseArrayLayer;
+
+                // When unified layouts are active, suppress layout
+                // transitions between known layouts. The initial
+                // UNDEFINED -> X transition is preserved (spec requires it).
+                ResourceState srcState = slice.state;
+                ResourceState dstState = acc.desiredState;
+                if (hasUnifiedLayouts_ && srcState.currentLayout != VK_IMAGE_LAYOUT_UNDEFINED) {
+                    srcState.currentLayout = VK_IMAGE_LAYOUT_GENERAL;
+                    dstState.currentLayout = VK_IMAGE_LAYOUT_GENERAL;
                 }
-                map.setState(acc.subresourceRange, newState);
 
-            } else {
-                // Buffer: single state, no subresources.
-                auto& state = bufferStates_[ri];
+                ImageBarrierRequest req{
+                    .image = res.vkImage,
+                    .range = overlap,
+                    .aspect = res.aspect,
+                    .src = srcState,
+                    .dst = dstState,
+                    .isRead = isRead,
+                };
+                if (handOff)
+                    appendImageOwnershipTransfer(*release, *out, req, asyncTransferFamily_,
+                                                 asyncGraphicsFamily_);
+                else
+                    appendImageBarrier(*out, req);
+            }
+        }
 
+        // Update tracked state for the accessed range.
+        ResourceState newState = acc.desiredState;
+        if (hasUnifiedLayouts_) {
+            newState.currentLayout = VK_IMAGE_LAYOUT_GENERAL;
+        }
+        if (isRead) {
+            // Preserve writer info from current state, add this read.
+            ResourceState merged = map.queryState(acc.subresourceRange);
+            newState.lastWriteStage = merged.lastWriteStage;
+            newState.lastWriteAccess = merged.lastWriteAccess;
+            newState.readStagesSinceWrite =
+                merged.readStagesSinceWrite | acc.desiredState.lastWriteStage;
+            newState.readAccessSinceWrite =
+                merged.readAccessSinceWrite | acc.desiredState.readAccessSinceWrite;
+            newState.currentLayout = acc.desiredState.currentLayout;
+            if (newState.queueFamily == VK_QUEUE_FAMILY_IGNORED) {
+                newState.queueFamily = merged.queueFamily;
+            }
+        } else {
+            // Write: reset readers, set new writer.
+            newState.readStagesSinceWrite = VK_PIPELINE_STAGE_2_NONE;
+            newState.readAccessSinceWrite = VK_ACCESS_2_NONE;
+            if (newState.queueFamily == VK_QUEUE_FAMILY_IGNORED) {
+                newState.queueFamily = map.queryState(acc.subresourceRange).queueFamily;
+            }
+        }
+        map.setState(acc.subresourceRange, newState);
+
+    } else {
+        // Buffer: single state, no subresources.
+        auto& state = bufferStates_[ri];
+
+        if (out) {
+            BufferBarrierRequest req{
+                .buffer = res.vkBuffer,
+                .offset = 0,
+                .size = VK_WHOLE_SIZE,
+                .src = state,
+                .dst = acc.desiredState,
+                .isRead = isRead,
+            };
+            if (isHandOff(state)) {
+                appendBufferOwnershipTransfer(*release, *out, req, asyncTransferFamily_,
+                                              asyncGraphicsFamily_);
+            } else {
                 auto queueCheck = validateQueueFamilyTransition(state, acc.desiredState, res);
                 if (!queueCheck) {
                     return queueCheck.error();
                 }
-
-                appendBufferBarrier(cp.barriers, BufferBarrierRequest{
-                                                     .buffer = res.vkBuffer,
-                                                     .offset = 0,
-                                                     .size = VK_WHOLE_SIZE,
-                                                     .src = state,
-                                                     .dst = acc.desiredState,
-                                                     .isRead = isRead,
-                                                 });
-
-                // Update tracked state.
-                if (isRead) {
-                    state.readStagesSinceWrite |= acc.desiredState.lastWriteStage;
-                    state.readAccessSinceWrite |= acc.desiredState.readAccessSinceWrite;
-                    if (acc.desiredState.queueFamily != VK_QUEUE_FAMILY_IGNORED) {
-                        state.queueFamily = acc.desiredState.queueFamily;
-                    }
-                } else {
-                    std::uint32_t previousQueueFamily = state.queueFamily;
-                    state = acc.desiredState;
-                    state.readStagesSinceWrite = VK_PIPELINE_STAGE_2_NONE;
-                    state.readAccessSinceWrite = VK_ACCESS_2_NONE;
-                    if (state.queueFamily == VK_QUEUE_FAMILY_IGNORED) {
-                        state.queueFamily = previousQueueFamily;
-                    }
-                }
+                appendBufferBarrier(*out, req);
             }
         }
 
-        compiledPasses_.push_back(std::move(cp));
+        // Update tracked state.
+        if (isRead) {
+            state.readStagesSinceWrite |= acc.desiredState.lastWriteStage;
+            state.readAccessSinceWrite |= acc.desiredState.readAccessSinceWrite;
+            if (acc.desiredState.queueFamily != VK_QUEUE_FAMILY_IGNORED) {
+                state.queueFamily = acc.desiredState.queueFamily;
+            }
+        } else {
+            std::uint32_t previousQueueFamily = state.queueFamily;
+            state = acc.desiredState;
+            state.readStagesSinceWrite = VK_PIPELINE_STAGE_2_NONE;
+            state.readAccessSinceWrite = VK_ACCESS_2_NONE;
+            if (state.queueFamily == VK_QUEUE_FAMILY_IGNORED) {
+                state.queueFamily = previousQueueFamily;
+            }
+        }
     }
 
     return {};
@@ -865,7 +1063,59 @@ static VkAttachmentLoadOp toVkLoadOp(LoadOp op) {
     return VK_ATTACHMENT_LOAD_OP_DONT_CARE; // unreachable
 }
 
-void RenderGraph::resolveRenderTargets(const std::vector<std::uint32_t>& order) {
+// Array layers a view mask renders: up to and including its highest set bit.
+static std::uint32_t viewMaskLayers(std::uint32_t viewMask) {
+    return viewMask == 0 ? 1 : static_cast<std::uint32_t>(32 - std::countl_zero(viewMask));
+}
+
+Result<void> RenderGraph::validateViewMasks() const {
+    for (const auto& pass : passes_) {
+        if (pass.viewMask == 0)
+            continue;
+        if (!hasMultiview_) {
+            return Error{"compile render graph", 0,
+                         "pass '" + pass.name +
+                             "' sets a view mask but the device has no multiview support"};
+        }
+        std::uint32_t layers = viewMaskLayers(pass.viewMask);
+        auto checkTarget = [&](ResourceHandle h) -> Result<void> {
+            const auto& res = resources_[h.index];
+            if (res.imageDesc.arrayLayers >= layers)
+                return {};
+            return Error{"compile render graph", 0,
+                         "pass '" + pass.name + "' renders " + std::to_string(layers) +
+                             " views but target '" + res.name + "' has " +
+                             std::to_string(res.imageDesc.arrayLayers) + " array layers"};
+        };
+        for (const auto& ct : pass.colorTargets) {
+            auto r = checkTarget(ct.handle);
+            if (!r)
+                return r;
+        }
+        if (pass.depthTarget) {
+            auto r = checkTarget(pass.depthTarget->handle);
+            if (!r)
+                return r;
+        }
+    }
+    return {};
+}
+
+// Multiview targets render through a 2D array view of mip 0 spanning the
+// view mask's layers, taken from the resource's view cache. Without a cache
+// (raw importImage()) the imported view is used as is and must be that view.
+Result<VkImageView> RenderGraph::attachmentView(const ResourceEntry& res,
+                                                std::uint32_t viewMask) const {
+    if (viewMask == 0 || !res.views)
+        return res.vkImageView;
+    ImageViewDesc desc;
+    desc.levelCount = 1;
+    desc.layerCount = viewMaskLayers(viewMask);
+    desc.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    return res.views->view(desc);
+}
+
+Result<void> RenderGraph::resolveRenderTargets(const std::vector<std::uint32_t>& order) {
     // Build sorted position map (pass index -> position in execution order).
     std::vector<std::uint32_t> sortedPos(passes_.size());
     for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(order.size()); ++i)
@@ -880,6 +1130,8 @@ void RenderGraph::resolveRenderTargets(const std::vector<std::uint32_t>& order)
 
         auto& rr = cp.rendering;
         std::uint32_t myPos = sortedPos[cp.passIndex];
+        rr.viewMask = passDecl.viewMask;
+        rr.layerCount = viewMaskLayers(passDecl.viewMask);
 
         // Derive render area from the first declared target.
         ResourceHandle areaHandle;
@@ -909,10 +1161,13 @@ void RenderGraph::resolveRenderTargets(const std::vector<std::uint32_t>& order)
 
         for (const auto& ct : passDecl.colorTargets) {
             const auto& res = resources_[ct.handle.index];
+            auto view = attachmentView(res, passDecl.viewMask);
+            if (!view)
+                return view.error();
 
             auto& att = rr.colorAttachments[ct.index];
             att.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
-            att.imageView = res.vkImageView;
+            att.imageView = view.value();
             att.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
             att.loadOp = toVkLoadOp(ct.loadOp);
             att.clearValue.color = ct.clearValue;
@@ -928,11 +1183,14 @@ void RenderGraph::resolveRenderTargets(const std::vector<std::uint32_t>& order)
         if (passDecl.depthTarget) {
             const auto& dt = *passDecl.depthTarget;
             const auto& res = resources_[dt.handle.index];
+            auto view = attachmentView(res, passDecl.viewMask);
+            if (!view)
+                return view.error();
 
             rr.hasDepth = true;
             auto& att = rr.depthAttachment;
             att.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
-            att.imageView = res.vkImageView;
+            att.imageView = view.value();
             att.loadOp = toVkLoadOp(dt.loadOp);
             att.clearValue.depthStencil = {dt.clearDepth, dt.clearStencil};
 
@@ -949,6 +1207,7 @@ void RenderGraph::resolveRenderTargets(const std::vector<std::uint32_t>& order)
             }
         }
     }
+    return {};
 }
 
 Result<void> RenderGraph::resolveDescriptors() {
@@ -1077,71 +1336,437 @@ static std::uint64_t fnv1a(const void* data, std::size_t len,
     return h;
 }
 
-static std::uint64_t hashGraphStructure(const std::vector<PassDecl>& passes,
-                                        const std::vector<ResourceEntry>& resources) {
-    // Hash pass count + resource count.
-    auto passCount = static_cast<std::uint32_t>(passes.size());
-    auto resCount = static_cast<std::uint32_t>(resources.size());
+// Structural hash of one pass: type + access list + render target metadata.
+// Everything that affects edges, barriers or resolved rendering state.
+static std::uint64_t hashPassStructure(const PassDecl& pass) {
+    auto h = fnv1a(&pass.type, sizeof(pass.type));
+    auto accCount = static_cast<std::uint32_t>(pass.accesses.size());
+    h = fnv1a(&accCount, sizeof(accCount), h);
+    for (const auto& acc : pass.accesses) {
+        h = fnv1a(&acc.handle.index, sizeof(acc.handle.index), h);
+        h = fnv1a(&acc.access, sizeof(acc.access), h);
+        h = fnv1a(&acc.desiredState.currentLayout, sizeof(acc.desiredState.currentLayout), h);
+        h = fnv1a(&acc.subresourceRange, sizeof(acc.subresourceRange), h);
+    }
+    // Layer 1: color target count + indices + loadOps.
+    auto ctCount = static_cast<std::uint32_t>(pass.colorTargets.size());
+    h = fnv1a(&ctCount, sizeof(ctCount), h);
+    for (const auto& ct : pass.colorTargets) {
+        h = fnv1a(&ct.index, sizeof(ct.index), h);
+        h = fnv1a(&ct.loadOp, sizeof(ct.loadOp), h);
+        h = fnv1a(&ct.handle.index, sizeof(ct.handle.index), h);
+    }
+    // Layer 1: depth target presence + loadOp + depthWrite.
+    bool hasDT = pass.depthTarget.has_value();
+    h = fnv1a(&hasDT, sizeof(hasDT), h);
+    if (hasDT) {
+        h = fnv1a(&pass.depthTarget->loadOp, sizeof(pass.depthTarget->loadOp), h);
+        h = fnv1a(&pass.depthTarget->depthWrite, sizeof(pass.depthTarget->depthWrite), h);
+        h = fnv1a(&pass.depthTarget->handle.index, sizeof(pass.depthTarget->handle.index), h);
+    }
+    // Layer 1: multiview mask.
+    h = fnv1a(&pass.viewMask, sizeof(pass.viewMask), h);
+    // Layer 2: pipeline + reflection pointer + default sampler + bind count.
+    h = fnv1a(&pass.pipeline, sizeof(pass.pipeline), h);
+    h = fnv1a(&pass.pipelineLayout, sizeof(pass.pipelineLayout), h);
+    h = fnv1a(&pass.reflection, sizeof(pass.reflection), h);
+    h = fnv1a(&pass.defaultSampler, sizeof(pass.defaultSampler), h);
+    auto bindCount = static_cast<std::uint32_t>(pass.bindMap.size());
+    h = fnv1a(&bindCount, sizeof(bindCount), h);
+    // XOR-combine bind entries (order-independent).
+    std::uint64_t bindXor = 0;
+    for (const auto& [name, entry] : pass.bindMap) {
+        std::uint64_t entryH = fnv1a(name.data(), name.size());
+        entryH = fnv1a(&entry.handle.index, sizeof(entry.handle.index), entryH);
+        entryH = fnv1a(&entry.samplerOverride, sizeof(entry.samplerOverride), entryH);
+        bindXor ^= entryH;
+    }
+    h = fnv1a(&bindXor, sizeof(bindXor), h);
+    return h;
+}
+
+// Structural hash of one resource. Transient descs determine allocation;
+// imported handles are excluded (patched, not recompiled).
+static std::uint64_t hashResourceStructure(const ResourceEntry& res) {
+    auto h = fnv1a(&res.tag, sizeof(res.tag));
+    h = fnv1a(&res.kind, sizeof(res.kind), h);
+    if (res.kind == ResourceKind::Image) {
+        h = fnv1a(&res.aspect, sizeof(res.aspect), h);
+        h = fnv1a(&res.imageDesc.mipLevels, sizeof(res.imageDesc.mipLevels), h);
+        h = fnv1a(&res.imageDesc.arrayLayers, sizeof(res.imageDesc.arrayLayers), h);
+        if (res.tag == ResourceTag::Transient)
+            h = fnv1a(&res.imageDesc, sizeof(res.imageDesc), h);
+    } else if (res.tag == ResourceTag::Transient) {
+        h = fnv1a(&res.bufferDesc.size, sizeof(res.bufferDesc.size), h);
+        h = fnv1a(&res.bufferDesc.usage, sizeof(res.bufferDesc.usage), h);
+    }
+    return h;
+}
+
+static std::uint64_t hashGraphStructure(const std::vector<std::uint64_t>& passHashes,
+                                        const std::vector<std::uint64_t>& resourceHashes) {
+    // Hash pass count + resource count, then the per-element hashes.
+    auto passCount = static_cast<std::uint32_t>(passHashes.size());
+    auto resCount = static_cast<std::uint32_t>(resourceHashes.size());
     auto h = fnv1a(&passCount, sizeof(passCount));
     h = fnv1a(&resCount, sizeof(resCount), h);
+    h = fnv1a(passHashes.data(), passHashes.size() * sizeof(std::uint64_t), h);
+    h = fnv1a(resourceHashes.data(), resourceHashes.size() * sizeof(std::uint64_t), h);
+    return h;
+}
 
-    // Hash each pass: type + access list + render target metadata.
-    for (const auto& pass : passes) {
-        h = fnv1a(&pass.type, sizeof(pass.type), h);
-        auto accCount = static_cast<std::uint32_t>(pass.accesses.size());
-        h = fnv1a(&accCount, sizeof(accCount), h);
-        for (const auto& acc : pass.accesses) {
-            h = fnv1a(&acc.handle.index, sizeof(acc.handle.index), h);
-            h = fnv1a(&acc.access, sizeof(acc.access), h);
-            h = fnv1a(&acc.desiredState.currentLayout, sizeof(acc.desiredState.currentLayout), h);
-            h = fnv1a(&acc.subresourceRange, sizeof(acc.subresourceRange), h);
-        }
-        // Layer 1: color target count + indices + loadOps.
-        auto ctCount = static_cast<std::uint32_t>(pass.colorTargets.size());
-        h = fnv1a(&ctCount, sizeof(ctCount), h);
-        for (const auto& ct : pass.colorTargets) {
-            h = fnv1a(&ct.index, sizeof(ct.index), h);
-            h = fnv1a(&ct.loadOp, sizeof(ct.loadOp), h);
-            h = fnv1a(&ct.handle.index, sizeof(ct.handle.index), h);
-        }
-        // Layer 1: depth target presence + loadOp + depthWrite.
-        bool hasDT = pass.depthTarget.has_value();
-        h = fnv1a(&hasDT, sizeof(hasDT), h);
-        if (hasDT) {
-            h = fnv1a(&pass.depthTarget->loadOp, sizeof(pass.depthTarget->loadOp), h);
-            h = fnv1a(&pass.depthTarget->depthWrite, sizeof(pass.depthTarget->depthWrite), h);
-            h = fnv1a(&pass.depthTarget->handle.index, sizeof(pass.depthTarget->handle.index), h);
-        }
-        // Layer 2: pipeline + reflection pointer + default sampler + bind count.
-        h = fnv1a(&pass.pipeline, sizeof(pass.pipeline), h);
-        h = fnv1a(&pass.pipelineLayout, sizeof(pass.pipelineLayout), h);
-        h = fnv1a(&pass.reflection, sizeof(pass.reflection), h);
-        h = fnv1a(&pass.defaultSampler, sizeof(pass.defaultSampler), h);
-        auto bindCount = static_cast<std::uint32_t>(pass.bindMap.size());
-        h = fnv1a(&bindCount, sizeof(bindCount), h);
-        // XOR-combine bind entries (order-independent).
-        std::uint64_t bindXor = 0;
-        for (const auto& [name, entry] : pass.bindMap) {
-            std::uint64_t entryH = fnv1a(name.data(), name.size());
-            entryH = fnv1a(&entry.handle.index, sizeof(entry.handle.index), entryH);
-            entryH = fnv1a(&entry.samplerOverride, sizeof(entry.samplerOverride), entryH);
-            bindXor ^= entryH;
-        }
-        h = fnv1a(&bindXor, sizeof(bindXor), h);
-    }
-
-    // Hash each transient resource desc (dimensions determine alloc).
-    for (const auto& res : resources) {
-        if (res.tag != ResourceTag::Transient)
+// Diff of this frame's graph against the previous structural compile.
+// Passes in the common prefix/suffix of the per-pass hash lists are
+// unchanged; the window between them was edited, inserted or removed.
+// Affected passes are the edited ones plus every pass touching a dirty
+// resource -- only they can gain or lose edges.
+struct RenderGraph::IncrementalPlan {
+    std::vector<std::uint32_t> oldToNew; // previous pass index -> current (UINT32_MAX = gone)
+    std::vector<std::uint32_t> newToOld; // current pass index -> previous (UINT32_MAX = new)
+    std::vector<bool> affected;          // per current pass
+    std::vector<bool> dirtyResources;    // per current resource
+    std::uint32_t affectedCount = 0;
+};
+
+bool RenderGraph::planIncremental(const std::vector<std::uint64_t>& passHashes,
+                                  const std::vector<std::uint64_t>& resourceHashes,
+                                  IncrementalPlan& plan) const {
+    const auto oldCount = static_cast<std::uint32_t>(cachedPassHashes_.size());
+    const auto newCount = static_cast<std::uint32_t>(passHashes.size());
+    if (oldCount == 0 || newCount == 0 || cachedOrder_.size() != oldCount ||
+        compiledPasses_.size() != oldCount || adj_.size() != oldCount ||
+        cachedPassResources_.size() != oldCount)
+        return false;
+
+    // Align on the common prefix and suffix. A single toggled or edited pass
+    // leaves one contiguous changed window.
+    const std::uint32_t minCount = std::min(oldCount, newCount);
+    std::uint32_t prefix = 0;
+    while (prefix < minCount && cachedPassHashes_[prefix] == passHashes[prefix])
+        ++prefix;
+    std::uint32_t suffix = 0;
+    while (suffix < minCount - prefix &&
+           cachedPassHashes_[oldCount - 1 - suffix] == passHashes[newCount - 1 - suffix])
+        ++suffix;
+
+    plan.oldToNew.assign(oldCount, UINT32_MAX);
+    plan.newToOld.assign(newCount, UINT32_MAX);
+    for (std::uint32_t i = 0; i < prefix; ++i) {
+        plan.oldToNew[i] = i;
+        plan.newToOld[i] = i;
+    }
+    for (std::uint32_t i = 0; i < suffix; ++i) {
+        plan.oldToNew[oldCount - 1 - i] = newCount - 1 - i;
+        plan.newToOld[newCount - 1 - i] = oldCount - 1 - i;
+    }
+
+    // Dirty resources: changed or new slots, plus everything an edited or
+    // removed pass touched before or after the edit.
+    const auto resCount = static_cast<std::uint32_t>(resourceHashes.size());
+    plan.dirtyResources.assign(resCount, false);
+    for (std::uint32_t ri = 0; ri < resCount; ++ri) {
+        if (ri >= cachedResourceHashes_.size() || cachedResourceHashes_[ri] != resourceHashes[ri])
+            plan.dirtyResources[ri] = true;
+    }
+    for (std::uint32_t pi = prefix; pi < oldCount - suffix; ++pi) {
+        for (auto ri : cachedPassResources_[pi])
+            if (ri < resCount)
+                plan.dirtyResources[ri] = true;
+    }
+    for (std::uint32_t pi = prefix; pi < newCount - suffix; ++pi) {
+        for (const auto& acc : passes_[pi].accesses)
+            if (acc.handle.valid())
+                plan.dirtyResources[acc.handle.index] = true;
+    }
+
+    plan.affected.assign(newCount, false);
+    plan.affectedCount = 0;
+    for (std::uint32_t pi = 0; pi < newCount; ++pi) {
+        bool hit = (plan.newToOld[pi] == UINT32_MAX);
+        for (const auto& acc : passes_[pi].accesses) {
+            if (hit)
+                break;
+            if (acc.handle.valid() && plan.dirtyResources[acc.handle.index])
+                hit = true;
+        }
+        if (hit) {
+            plan.affected[pi] = true;
+            ++plan.affectedCount;
+        }
+    }
+
+    // Past half the graph the full path costs the same and keeps Kahn order.
+    return plan.affectedCount * 2 <= newCount;
+}
+
+void RenderGraph::updateAdjacency(const IncrementalPlan& plan) {
+    const auto passCount = static_cast<std::uint32_t>(passes_.size());
+    const auto resCount = static_cast<std::uint32_t>(resources_.size());
+
+    std::vector<std::vector<std::uint32_t>> adj(passCount);
+
+    // An edge with an unaffected endpoint comes from a clean resource, whose
+    // accessors and their declaration order are unchanged -- remap it.
+    for (std::uint32_t u = 0; u < static_cast<std::uint32_t>(adj_.size()); ++u) {
+        std::uint32_t nu = plan.oldToNew[u];
+        if (nu == UINT32_MAX)
             continue;
-        if (res.kind == ResourceKind::Image) {
-            h = fnv1a(&res.imageDesc, sizeof(res.imageDesc), h);
-        } else {
-            h = fnv1a(&res.bufferDesc, sizeof(res.bufferDesc), h);
+        for (auto v : adj_[u]) {
+            std::uint32_t nv = plan.oldToNew[v];
+            if (nv == UINT32_MAX || (plan.affected[nu] && plan.affected[nv]))
+                continue;
+            adj[nu].push_back(nv);
         }
     }
 
-    return h;
+    // Regenerate edges between affected pairs from every resource an
+    // affected pass touches (same rules as buildAdjacency()).
+    std::vector<bool> touched(resCount, false);
+    for (std::uint32_t pi = 0; pi < passCount; ++pi) {
+        if (!plan.affected[pi])
+            continue;
+        for (const auto& acc : passes_[pi].accesses)
+            if (acc.handle.valid())
+                touched[acc.handle.index] = true;
+    }
+
+    struct ResAccess {
+        std::vector<std::uint32_t> writers;
+        std::vector<std::uint32_t> readers;
+    };
+    std::vector<ResAccess> perResource(resCount);
+
+    for (std::uint32_t pi = 0; pi < passCount; ++pi) {
+        for (const auto& acc : passes_[pi].accesses) {
+            if (!acc.handle.valid() || !touched[acc.handle.index])
+                continue;
+            auto& ra = perResource[acc.handle.index];
+            if (acc.access == AccessType::Write || acc.access == AccessType::ReadWrite)
+                ra.writers.push_back(pi);
+            if (acc.access == AccessType::Read || acc.access == AccessType::ReadWrite)
+                ra.readers.push_back(pi);
+        }
+    }
+
+    for (std::uint32_t ri = 0; ri < resCount; ++ri) {
+        if (!touched[ri])
+            continue;
+        const auto& ra = perResource[ri];
+
+        for (auto w : ra.writers) {
+            if (!plan.affected[w])
+                continue;
+            for (auto r : ra.readers) {
+                if (!plan.affected[r])
+                    continue;
+                if (w < r)
+                    adj[w].push_back(r); // RAW
+                else if (r < w)
+                    adj[r].push_back(w); // WAR
+            }
+        }
+
+        for (std::size_t wi = 1; wi < ra.writers.size(); ++wi) {
+            auto a = ra.writers[wi - 1];
+            auto b = ra.writers[wi];
+            if (plan.affected[a] && plan.affected[b])
+                adj[a].push_back(b); // WAW
+        }
+    }
+
+    // Sorted, deduplicated successor lists match buildAdjacency() output.
+    inDegree_.assign(passCount, 0);
+    for (auto& succ : adj) {
+        std::sort(succ.begin(), succ.end());
+        succ.erase(std::unique(succ.begin(), succ.end()), succ.end());
+        for (auto v : succ)
+            inDegree_[v]++;
+    }
+    adj_ = std::move(adj);
+}
+
+bool RenderGraph::incrementalSort(const IncrementalPlan& plan,
+                                  std::vector<std::uint32_t>& order) const {
+    const auto passCount = static_cast<std::uint32_t>(passes_.size());
+
+    // Unaffected passes keep their previous relative order (the skeleton).
+    std::vector<std::uint32_t> skeleton;
+    std::vector<std::uint32_t> skeletonPos(passCount, UINT32_MAX);
+    skeleton.reserve(passCount);
+    for (auto oldIdx : cachedOrder_) {
+        std::uint32_t pi = plan.oldToNew[oldIdx];
+        if (pi == UINT32_MAX || plan.affected[pi])
+            continue;
+        skeletonPos[pi] = static_cast<std::uint32_t>(skeleton.size());
+        skeleton.push_back(pi);
+    }
+
+    std::vector<std::vector<std::uint32_t>> preds(passCount);
+    for (std::uint32_t u = 0; u < passCount; ++u) {
+        for (auto v : adj_[u])
+            if (plan.affected[v])
+                preds[v].push_back(u);
+    }
+
+    // Slot each affected pass right after its latest predecessor; slot s
+    // means "before skeleton[s]". Declaration order is topological (every
+    // edge points forward), so predecessors are always slotted first.
+    std::vector<std::uint32_t> slot(passCount, 0);
+    for (std::uint32_t pi = 0; pi < passCount; ++pi) {
+        if (!plan.affected[pi])
+            continue;
+        std::uint32_t s = 0;
+        for (auto p : preds[pi])
+            s = std::max(s, plan.affected[p] ? slot[p] : skeletonPos[p] + 1);
+        // A successor already placed earlier in the skeleton would require
+        // moving unaffected passes -- let the caller fall back to Kahn.
+        for (auto v : adj_[pi]) {
+            if (!plan.affected[v] && skeletonPos[v] < s)
+                return false;
+        }
+        slot[pi] = s;
+    }
+
+    std::vector<std::vector<std::uint32_t>> bySlot(skeleton.size() + 1);
+    for (std::uint32_t pi = 0; pi < passCount; ++pi)
+        if (plan.affected[pi])
+            bySlot[slot[pi]].push_back(pi);
+
+    order.clear();
+    order.reserve(passCount);
+    for (std::size_t s = 0; s < bySlot.size(); ++s) {
+        order.insert(order.end(), bySlot[s].begin(), bySlot[s].end());
+        if (s < skeleton.size())
+            order.push_back(skeleton[s]);
+    }
+    return true;
+}
+
+Result<std::uint32_t>
+RenderGraph::compileBarriersIncremental(const std::vector<std::uint32_t>& order,
+                                        const IncrementalPlan& plan) {
+    const auto passCount = static_cast<std::uint32_t>(passes_.size());
+    const auto resCount = static_cast<std::uint32_t>(resources_.size());
+
+    // Any resource an affected pass touches may see a different access
+    // sequence, so every pass touching one is recompiled. The state of the
+    // resources those passes touch is tracked through the whole order.
+    std::vector<bool> resChanged(resCount, false);
+    for (std::uint32_t pi = 0; pi < passCount; ++pi) {
+        if (!plan.affected[pi])
+            continue;
+        for (const auto& acc : passes_[pi].accesses)
+            if (acc.handle.valid())
+                resChanged[acc.handle.index] = true;
+    }
+
+    std::vector<bool> recompile(passCount, false);
+    std::vector<bool> tracked(resCount, false);
+    std::uint32_t recompileCount = 0;
+    for (std::uint32_t pi = 0; pi < passCount; ++pi) {
+        bool hit = plan.affected[pi];
+        for (const auto& acc : passes_[pi].accesses) {
+            if (hit)
+                break;
+            if (acc.handle.valid() && resChanged[acc.handle.index])
+                hit = true;
+        }
+        if (!hit)
+            continue;
+        recompile[pi] = true;
+        ++recompileCount;
+        for (const auto& acc : passes_[pi].accesses)
+            if (acc.handle.valid())
+                tracked[acc.handle.index] = true;
+    }
+
+    // Reused passes only touch unchanged resources; patch their handles.
+    struct ImgPatch {
+        VkImage oldImg;
+        VkImage newImg;
+    };
+    struct BufPatch {
+        VkBuffer oldBuf;
+        VkBuffer newBuf;
+    };
+    std::vector<ImgPatch> imgPatches;
+    std::vector<BufPatch> bufPatches;
+    const auto cachedCount = static_cast<std::uint32_t>(cachedImageHandles_.size());
+    for (std::uint32_t ri = 0; ri < std::min(resCount, cachedCount); ++ri) {
+        if (resChanged[ri])
+            continue;
+        const auto& res = resources_[ri];
+        if (res.kind == ResourceKind::Image && res.vkImage != cachedImageHandles_[ri])
+            imgPatches.push_back({cachedImageHandles_[ri], res.vkImage});
+        else if (res.kind == ResourceKind::Buffer && res.vkBuffer != cachedBufferHandles_[ri])
+            bufPatches.push_back({cachedBufferHandles_[ri], res.vkBuffer});
+    }
+
+    // Previous compiled passes, indexed by previous pass index.
+    std::vector<std::uint32_t> oldSlot(plan.oldToNew.size(), UINT32_MAX);
+    for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(compiledPasses_.size()); ++i)
+        oldSlot[compiledPasses_[i].passIndex] = i;
+
+    std::vector<CompiledPass> compiled;
+    compiled.reserve(order.size());
+
+    for (auto passIdx : order) {
+        const auto& pass = passes_[passIdx];
+
+        if (recompile[passIdx]) {
+            CompiledPass cp;
+            cp.passIndex = passIdx;
+            for (const auto& acc : pass.accesses) {
+                if (!acc.handle.valid())
+                    continue;
+                auto accResult = compileAccess(acc, &cp.barriers);
+                if (!accResult) {
+                    compiledPasses_.clear();
+                    return accResult.error();
+                }
+            }
+            cp.emittedBarriers = cp.barriers.size();
+            coalesceBarriers(cp.barriers);
+            compiled.push_back(std::move(cp));
+            continue;
+        }
+
+        CompiledPass cp = std::move(compiledPasses_[oldSlot[plan.newToOld[passIdx]]]);
+        cp.passIndex = passIdx;
+        cp.rendering = {};
+        cp.descriptors = {};
+        for (auto& ib : cp.barriers.imageBarriers) {
+            for (const auto& p : imgPatches) {
+                if (ib.image == p.oldImg) {
+                    ib.image = p.newImg;
+                    break;
+                }
+            }
+        }
+        for (auto& bb : cp.barriers.bufferBarriers) {
+            for (const auto& p : bufPatches) {
+                if (bb.buffer == p.oldBuf) {
+                    bb.buffer = p.newBuf;
+                    break;
+                }
+            }
+        }
+
+        // Advance shared state so later recompiled passes see this pass.
+        for (const auto& acc : pass.accesses) {
+            if (!acc.handle.valid() || !tracked[acc.handle.index])
+                continue;
+            auto accResult = compileAccess(acc, nullptr);
+            if (!accResult) {
+                compiledPasses_.clear();
+                return accResult.error();
+            }
+        }
+        compiled.push_back(std::move(cp));
+    }
+
+    compiledPasses_ = std::move(compiled);
+    return recompileCount;
 }
 
 Result<void> RenderGraph::compile() {
@@ -1154,27 +1779,56 @@ Result<void> RenderGraph::compile() {
     // Resolve VK_REMAINING_* sentinels before hashing so identical
     // subresource ranges produce the same hash regardless of declaration style.
     resolveRemainingCounts();
+    auto viewMaskResult = validateViewMasks();
+    if (!viewMaskResult)
+        return viewMaskResult;
     tResolve = Clock::now();
     accumulateTransientUsage();
     tUsage = Clock::now();
 
-    auto graphHash = hashGraphStructure(passes_, resources_);
+    std::vector<std::uint64_t> passHashes;
+    std::vector<std::uint64_t> resourceHashes;
+    passHashes.reserve(passes_.size());
+    resourceHashes.reserve(resources_.size());
+    for (const auto& pass : passes_)
+        passHashes.push_back(hashPassStructure(pass));
+    for (const auto& res : resources_)
+        resourceHashes.push_back(hashResourceStructure(res));
+
+    auto graphHash = hashGraphStructure(passHashes, resourceHashes);
     bool cacheHit = (graphHash == lastGraphHash_ && !cachedOrder_.empty());
+    bool incremental = false;
+    IncrementalPlan plan;
 
     if (cacheHit) {
         // Reuse cached topological order.
         order = &cachedOrder_;
         tAdj = tSort = tLifetime = Clock::now();
     } else {
-        // Full compile path.
-        buildAdjacency();
+        // Incremental path when only a subgraph changed, full path otherwise.
+        // Async transfer scheduling depends on the whole frame (ownership
+        // hand-offs, trailing releases), so it always takes the full path.
+        incremental = asyncTransferFamily_ == VK_QUEUE_FAMILY_IGNORED &&
+                      planIncremental(passHashes, resourceHashes, plan);
+        cachedPassHashes_.clear(); // re-published only if this compile succeeds
+        if (incremental)
+            updateAdjacency(plan);
+        else
+            buildAdjacency();
         tAdj = Clock::now();
 
-        // Topological sort.
-        auto sortResult = topologicalSort();
-        if (!sortResult)
-            return sortResult.error();
-        cachedOrder_ = std::move(sortResult).value();
+        // Topological sort. The incremental sort keeps unaffected passes in
+        // their previous order; when that is impossible, re-sort everything
+        // (and recompile all barriers, since relative order may change).
+        std::vector<std::uint32_t> newOrder;
+        if (!incremental || !incrementalSort(plan, newOrder)) {
+            incremental = false;
+            auto sortResult = topologicalSort();
+            if (!sortResult)
+                return sortResult.error();
+            newOrder = std::move(sortResult).value();
+        }
+        cachedOrder_ = std::move(newOrder);
         order = &cachedOrder_;
         tSort = Clock::now();
 
@@ -1199,7 +1853,8 @@ Result<void> RenderGraph::compile() {
     // frame (e.g. round-robin swapchain images) but barrier structure is
     // determined by format and usage, not by which specific handle is imported.
     bool handlesStable = false;
-    if (cacheHit && cachedImageHandles_.size() == resources_.size()) {
+    if (cacheHit && compiledPasses_.size() == order->size() &&
+        cachedImageHandles_.size() == resources_.size()) {
         handlesStable = true;
         for (std::uint32_t ri = 0; ri < static_cast<std::uint32_t>(resources_.size()); ++ri) {
             const auto& res = resources_[ri];
@@ -1258,8 +1913,8 @@ Result<void> RenderGraph::compile() {
             }
         }
         if (!imgPatches.empty() || !bufPatches.empty()) {
-            for (auto& cp : compiledPasses_) {
-                for (auto& ib : cp.barriers.imageBarriers) {
+            auto patchBatch = [&](BarrierBatch& batch) {
+                for (auto& ib : batch.imageBarriers) {
                     for (const auto& p : imgPatches) {
                         if (ib.image == p.oldImg) {
                             ib.image = p.newImg;
@@ -1267,7 +1922,7 @@ Result<void> RenderGraph::compile() {
                         }
                     }
                 }
-                for (auto& bb : cp.barriers.bufferBarriers) {
+                for (auto& bb : batch.bufferBarriers) {
                     for (const auto& p : bufPatches) {
                         if (bb.buffer == p.oldBuf) {
                             bb.buffer = p.newBuf;
@@ -1275,6 +1930,11 @@ Result<void> RenderGraph::compile() {
                         }
                     }
                 }
+            };
+            patchBatch(asyncReleases_);
+            for (auto& cp : compiledPasses_) {
+                patchBatch(cp.barriers);
+                patchBatch(cp.releaseBarriers);
                 // Patch Layer 1 resolved rendering views.
                 for (auto& att : cp.rendering.colorAttachments) {
                     for (const auto& p : imgPatches) {
@@ -1295,6 +1955,30 @@ Result<void> RenderGraph::compile() {
             }
         }
 
+        // Multiview attachments use cached array views the patch above cannot
+        // map from the imported view; look them up for the new images.
+        if (!imgPatches.empty()) {
+            for (auto& cp : compiledPasses_) {
+                const auto& passDecl = passes_[cp.passIndex];
+                if (passDecl.viewMask == 0)
+                    continue;
+                for (const auto& ct : passDecl.colorTargets) {
+                    auto view = attachmentView(resources_[ct.handle.index], passDecl.viewMask);
+                    if (!view)
+                        return view.error();
+                    cp.rendering.colorAttachments[ct.index].imageView = view.value();
+                }
+                if (passDecl.depthTarget && cp.rendering.hasDepth) {
+                    auto view =
+                        attachmentView(resources_[passDecl.depthTarget->handle.index],
+                                       passDecl.viewMask);
+                    if (!view)
+                        return view.error();
+                    cp.rendering.depthAttachment.imageView = view.value();
+                }
+            }
+        }
+
         // Patch clear values (may change frame-to-frame without structure change).
         for (auto& cp : compiledPasses_) {
             const auto& passDecl = passes_[cp.passIndex];
@@ -1327,6 +2011,10 @@ Result<void> RenderGraph::compile() {
         stats_.renderTargetUs = 0.0;
         stats_.descriptorUs = 0.0;
         stats_.statsUs = 0.0;
+        stats_.incremental = false;
+        stats_.recompiledPassCount = 0;
+        stats_.lastFullCompileUs = lastFullCompileUs_;
+        stats_.lastIncrementalCompileUs = lastIncrementalCompileUs_;
         auto tEnd = Clock::now();
         stats_.compileTimeUs = us(tStart, tEnd);
         isCompiled_ = true;
@@ -1334,7 +2022,7 @@ Result<void> RenderGraph::compile() {
     }
 
     // Initialize (or reset) state trackers.
-    if (cacheHit && imageMaps_.size() == resources_.size()) {
+    if ((cacheHit || incremental) && imageMaps_.size() == resources_.size()) {
         // Fast path: reset preserved maps in-place (no heap allocation).
         for (std::uint32_t ri = 0; ri < static_cast<std::uint32_t>(resources_.size()); ++ri) {
             const auto& res = resources_[ri];
@@ -1351,7 +2039,15 @@ Result<void> RenderGraph::compile() {
     tStateInit = Clock::now();
 
     // Compile barriers.
-    if (cacheHit && compiledPasses_.size() == order->size()) {
+    std::uint32_t recompiledPasses = static_cast<std::uint32_t>(order->size());
+    if (incremental) {
+        // Incremental: recompile passes sharing resources with the affected
+        // subgraph, reuse (and handle-patch) the rest.
+        auto barrierResult = compileBarriersIncremental(*order, plan);
+        if (!barrierResult)
+            return barrierResult.error();
+        recompiledPasses = barrierResult.value();
+    } else if (cacheHit && compiledPasses_.size() == order->size()) {
         // Fast path: clear barrier batches (keeps vector capacity), recompile.
         for (auto& cp : compiledPasses_)
             cp.barriers.clear();
@@ -1367,7 +2063,9 @@ Result<void> RenderGraph::compile() {
     tBarriers = Clock::now();
 
     // Resolve render targets.
-    resolveRenderTargets(*order);
+    auto renderTargetResult = resolveRenderTargets(*order);
+    if (!renderTargetResult)
+        return renderTargetResult;
     auto tRenderTargets = Clock::now();
 
     // Resolve descriptors.
@@ -1394,7 +2092,18 @@ Result<void> RenderGraph::compile() {
     for (const auto& cp : compiledPasses_) {
         stats_.imageBarrierCount += static_cast<std::uint32_t>(cp.barriers.imageBarriers.size());
         stats_.bufferBarrierCount += static_cast<std::uint32_t>(cp.barriers.bufferBarriers.size());
+        stats_.memoryBarrierCount += static_cast<std::uint32_t>(cp.barriers.memoryBarriers.size());
+        stats_.barriersBeforeCoalescing += cp.emittedBarriers;
+        stats_.barriersAfterCoalescing += cp.barriers.size();
+        if (cp.asyncTransfer) {
+            ++stats_.asyncTransferPassCount;
+            stats_.ownershipTransferCount +=
+                static_cast<std::uint32_t>(cp.releaseBarriers.imageBarriers.size() +
+                                           cp.releaseBarriers.bufferBarriers.size());
+        }
     }
+    stats_.ownershipTransferCount += static_cast<std::uint32_t>(
+        asyncReleases_.imageBarriers.size() + asyncReleases_.bufferBarriers.size());
 
     stats_.transientCount = 0;
     for (const auto& res : resources_)
@@ -1405,6 +2114,29 @@ Result<void> RenderGraph::compile() {
     stats_.statsUs = us(tDescriptors, tStatsEnd);
     stats_.compileTimeUs = us(tStart, tStatsEnd);
 
+    if (!cacheHit) {
+        stats_.incremental = incremental;
+        stats_.recompiledPassCount = recompiledPasses;
+        if (incremental)
+            lastIncrementalCompileUs_ = stats_.compileTimeUs;
+        else
+            lastFullCompileUs_ = stats_.compileTimeUs;
+
+        // Per-pass / per-resource hashes for the next incremental diff.
+        cachedPassHashes_ = std::move(passHashes);
+        cachedResourceHashes_ = std::move(resourceHashes);
+        cachedPassResources_.resize(passes_.size());
+        for (std::uint32_t pi = 0; pi < static_cast<std::uint32_t>(passes_.size()); ++pi) {
+            auto& touched = cachedPassResources_[pi];
+            touched.clear();
+            for (const auto& acc : passes_[pi].accesses)
+                if (acc.handle.valid())
+                    touched.push_back(acc.handle.index);
+        }
+    }
+    stats_.lastFullCompileUs = lastFullCompileUs_;
+    stats_.lastIncrementalCompileUs = lastIncrementalCompileUs_;
+
     // Cache handles and stats for next frame's stability check.
     cachedImageHandles_.resize(resources_.size());
     cachedViewHandles_.resize(resources_.size());
@@ -1421,67 +2153,130 @@ Result<void> RenderGraph::compile() {
     return {};
 }
 
-void RenderGraph::execute(VkCommandBuffer cmd) {
-    assert(isCompiled_ && "must call compile() before execute()");
-
-    for (auto& cp : compiledPasses_) {
-        // Emit barriers.
-        if (!cp.barriers.empty()) {
-            auto dep = cp.barriers.dependencyInfo();
-            vkCmdPipelineBarrier2(cmd, &dep);
-        }
+void RenderGraph::recordPass(const CompiledPass& cp, VkCommandBuffer cmd) {
+    // Emit barriers.
+    if (!cp.barriers.empty()) {
+        auto dep = cp.barriers.dependencyInfo();
+        vkCmdPipelineBarrier2(cmd, &dep);
+    }
 
-        // Collect image layouts for descriptor helpers.
-        std::vector<PassResourceLayout> layouts;
-        const auto& passDecl = passes_[cp.passIndex];
-        for (const auto& acc : passDecl.accesses) {
-            if (!acc.handle.valid())
-                continue;
-            if (resources_[acc.handle.index].kind == ResourceKind::Image) {
-                layouts.push_back({acc.handle, acc.desiredState.currentLayout});
-            }
+    // Collect image layouts for descriptor helpers.
+    std::vector<PassResourceLayout> layouts;
+    const auto& passDecl = passes_[cp.passIndex];
+    for (const auto& acc : passDecl.accesses) {
+        if (!acc.handle.valid())
+            continue;
+        if (resources_[acc.handle.index].kind == ResourceKind::Image) {
+            layouts.push_back({acc.handle, acc.desiredState.currentLayout});
         }
+    }
 
-        // Invoke the pass callback.
-        const ResolvedRendering* rendering = nullptr;
-        if (!cp.rendering.colorAttachments.empty() || cp.rendering.hasDepth)
-            rendering = &cp.rendering;
+    // Invoke the pass callback.
+    const ResolvedRendering* rendering = nullptr;
+    if (!cp.rendering.colorAttachments.empty() || cp.rendering.hasDepth)
+        rendering = &cp.rendering;
 
-        const ResolvedDescriptors* descriptors = nullptr;
-        if (passDecl.reflection != nullptr)
-            descriptors = &cp.descriptors;
+    const ResolvedDescriptors* descriptors = nullptr;
+    if (passDecl.reflection != nullptr)
+        descriptors = &cp.descriptors;
 
-        PassContext ctx(resources_, std::move(layouts), rendering, descriptors);
-        passDecl.recordFn(ctx, cmd);
+    PassContext ctx(resources_, std::move(layouts), rendering, descriptors);
+    passDecl.recordFn(ctx, cmd);
 
 #ifndef NDEBUG
-        if (ctx.renderingActive())
-            std::fprintf(stderr, "[vksdl::graph] pass '%s' did not call endRendering()\n",
-                         passDecl.name.c_str());
+    if (ctx.renderingActive())
+        std::fprintf(stderr, "[vksdl::graph] pass '%s' did not call endRendering()\n",
+                     passDecl.name.c_str());
 #endif
 
-        // Apply any state overrides from the callback.
-        for (const auto& ov : ctx.overrides()) {
-            if (!ov.handle.valid())
-                continue;
-            std::uint32_t ri = ov.handle.index;
-            const auto& res = resources_[ri];
+    // Apply any state overrides from the callback.
+    for (const auto& ov : ctx.overrides()) {
+        if (!ov.handle.valid())
+            continue;
+        std::uint32_t ri = ov.handle.index;
+        const auto& res = resources_[ri];
 
-            if (res.kind == ResourceKind::Image) {
-                if (ov.fullResource) {
-                    // Reset the entire map to the override state.
-                    imageMaps_[ri] = ImageSubresourceMap(res.imageDesc.mipLevels,
-                                                         res.imageDesc.arrayLayers, ov.state);
-                } else {
-                    imageMaps_[ri].setState(ov.range, ov.state);
-                }
+        if (res.kind == ResourceKind::Image) {
+            if (ov.fullResource) {
+                // Reset the entire map to the override state.
+                imageMaps_[ri] = ImageSubresourceMap(res.imageDesc.mipLevels,
+                                                     res.imageDesc.arrayLayers, ov.state);
             } else {
-                bufferStates_[ri] = ov.state;
+                imageMaps_[ri].setState(ov.range, ov.state);
             }
+        } else {
+            bufferStates_[ri] = ov.state;
         }
     }
 }
 
+void RenderGraph::execute(VkCommandBuffer cmd) {
+    assert(isCompiled_ && "must call compile() before execute()");
+
+    for (const auto& cp : compiledPasses_) {
+        if (cp.asyncTransfer)
+            continue; // recorded by executeAsyncTransfer()
+        recordPass(cp, cmd);
+    }
+}
+
+void RenderGraph::executeAsyncTransfer(VkCommandBuffer transferCmd) {
+    assert(isCompiled_ && "must call compile() before executeAsyncTransfer()");
+
+    for (const auto& cp : compiledPasses_) {
+        if (!cp.asyncTransfer)
+            continue;
+        recordPass(cp, transferCmd);
+        if (!cp.releaseBarriers.empty()) {
+            auto dep = cp.releaseBarriers.dependencyInfo();
+            vkCmdPipelineBarrier2(transferCmd, &dep);
+        }
+    }
+    if (!asyncReleases_.empty()) {
+        auto dep = asyncReleases_.dependencyInfo();
+        vkCmdPipelineBarrier2(transferCmd, &dep);
+    }
+}
+
+void RenderGraph::enableAsyncTransfer(std::uint32_t transferFamily, std::uint32_t graphicsFamily) {
+    if (transferFamily == graphicsFamily) {
+        disableAsyncTransfer();
+        return;
+    }
+    if (asyncTransferFamily_ == transferFamily && asyncGraphicsFamily_ == graphicsFamily)
+        return;
+    asyncTransferFamily_ = transferFamily;
+    asyncGraphicsFamily_ = graphicsFamily;
+    lastGraphHash_ = 0; // scheduling changed: force a full compile
+}
+
+void RenderGraph::enableAsyncTransfer(const TransferQueue& transferQueue) {
+    enableAsyncTransfer(transferQueue.queueFamily(), transferQueue.graphicsFamily());
+}
+
+void RenderGraph::disableAsyncTransfer() {
+    if (asyncTransferFamily_ == VK_QUEUE_FAMILY_IGNORED)
+        return;
+    asyncTransferFamily_ = VK_QUEUE_FAMILY_IGNORED;
+    asyncGraphicsFamily_ = VK_QUEUE_FAMILY_IGNORED;
+    asyncWaitStages_ = VK_PIPELINE_STAGE_2_NONE;
+    lastGraphHash_ = 0;
+}
+
+bool RenderGraph::hasAsyncTransferWork() const {
+    return isCompiled_ && (stats_.asyncTransferPassCount > 0 || !asyncReleases_.empty());
+}
+
+VkSemaphoreSubmitInfo RenderGraph::asyncTransferWait(VkSemaphore timeline,
+                                                     std::uint64_t value) const {
+    VkSemaphoreSubmitInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+    info.semaphore = timeline;
+    info.value = value;
+    info.stageMask = asyncWaitStages_;
+    return info;
+}
+
 Result<void> RenderGraph::compileAndExecute(VkCommandBuffer cmd) {
     auto result = compile();
     if (!result)
@@ -1503,7 +2298,8 @@ void RenderGraph::reset() {
     passes_.clear();
     resources_.clear();
     // imageMaps_, bufferStates_, compiledPasses_ preserved for cache-hit reuse.
-    // adj_, inDegree_ preserved (only used on cache miss).
+    // adj_, inDegree_ preserved (remapped by the incremental path on a miss).
+    // cachedPassHashes_ and friends preserved for incremental recompilation.
     // lastGraphHash_, cachedOrder_ preserved for structure cache.
 
     // Layer 2: reset descriptor allocator and destroy cached DSLs.
@@ -1688,7 +2484,8 @@ void RenderGraph::dumpLog() const {
     std::fprintf(stderr, "[vksdl::graph] Compiled %u passes:\n", stats_.passCount);
     for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(compiledPasses_.size()); ++i) {
         const auto& decl = passes_[compiledPasses_[i].passIndex];
-        std::fprintf(stderr, "  [%u] %-20s (%s)\n", i, decl.name.c_str(), passTypeName(decl.type));
+        std::fprintf(stderr, "  [%u] %-20s (%s)%s\n", i, decl.name.c_str(), passTypeName(decl.type),
+                     compiledPasses_[i].asyncTransfer ? " [async transfer queue]" : "");
     }
 
     for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(compiledPasses_.size()); ++i) {
@@ -1745,6 +2542,20 @@ void RenderGraph::dumpLog() const {
                          nameStr.c_str(), srcStage.c_str(), srcAccess.c_str(), dstStage.c_str(),
                          dstAccess.c_str());
         }
+
+        for (const auto& b : barriers.memoryBarriers) {
+            std::string srcStage, srcAccess, dstStage, dstAccess;
+            appendStageBits(srcStage, b.srcStageMask);
+            appendAccessBits(srcAccess, b.srcAccessMask);
+            appendStageBits(dstStage, b.dstStageMask);
+            appendAccessBits(dstAccess, b.dstAccessMask);
+
+            std::fprintf(stderr,
+                         "  MEM barrier: (global)\n"
+                         "               src: %s / %s\n"
+                         "               dst: %s / %s\n",
+                         srcStage.c_str(), srcAccess.c_str(), dstStage.c_str(), dstAccess.c_str());
+        }
     }
 
     if (stats_.transientCount > 0) {
@@ -1777,11 +2588,431 @@ void RenderGraph::dumpLog() const {
                  stats_.sortUs, stats_.lifetimeUs, stats_.allocUs, stats_.stateInitUs,
                  stats_.barriersUs, stats_.renderTargetUs, stats_.descriptorUs, stats_.statsUs);
 
+    if (stats_.incremental)
+        std::fprintf(stderr,
+                     "[vksdl::graph] incremental: %u/%u passes recompiled "
+                     "(last full compile %.0fus)\n",
+                     stats_.recompiledPassCount, stats_.passCount, stats_.lastFullCompileUs);
+
     std::fprintf(stderr,
-                 "[vksdl::graph] %u barriers (%u image, %u buffer), "
-                 "%u passes, %u transients\n",
-                 stats_.imageBarrierCount + stats_.bufferBarrierCount, stats_.imageBarrierCount,
-                 stats_.bufferBarrierCount, stats_.passCount, stats_.transientCount);
+                 "[vksdl::graph] %u barriers (%u image, %u buffer, %u memory; %u before "
+                 "coalescing), %u passes, %u transients\n",
+                 stats_.barriersAfterCoalescing, stats_.imageBarrierCount,
+                 stats_.bufferBarrierCount, stats_.memoryBarrierCount,
+                 stats_.barriersBeforeCoalescing, stats_.passCount, stats_.transientCount);
+}
+
+// --- Machine-readable export ---
+
+static void appendJsonString(std::string& out, std::string_view s) {
+    out += '"';
+    for (char c : s) {
+        switch (c) {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+                out += buf;
+            } else {
+                out += c;
+            }
+        }
+    }
+    out += '"';
+}
+
+static void appendJsonFlags(std::string& out, const char* key, std::uint64_t flags,
+                            bool isStage) {
+    std::string bits;
+    if (isStage)
+        appendStageBits(bits, flags);
+    else
+        appendAccessBits(bits, flags);
+    out += ",\"";
+    out += key;
+    out += "\":";
+    appendJsonString(out, bits);
+}
+
+static void appendUint(std::string& out, const char* key, std::uint64_t value) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), ",\"%s\":%" PRIu64, key, value);
+    out += buf;
+}
+
+static void appendDouble(std::string& out, const char* key, double value) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "\"%s\":%.3f", key, value);
+    out += buf;
+}
+
+// Stable display name: declared name, or "#<index>" for unnamed resources.
+static std::string resourceLabel(const std::vector<ResourceEntry>& resources,
+                                 std::uint32_t index) {
+    if (index >= resources.size())
+        return "(unknown)";
+    if (!resources[index].name.empty())
+        return resources[index].name;
+    return "#" + std::to_string(index);
+}
+
+static std::uint32_t findImageIndex(const std::vector<ResourceEntry>& resources, VkImage image) {
+    for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(resources.size()); ++i) {
+        if (resources[i].kind == ResourceKind::Image && resources[i].vkImage == image)
+            return i;
+    }
+    return UINT32_MAX;
+}
+
+static std::uint32_t findBufferIndex(const std::vector<ResourceEntry>& resources,
+                                     VkBuffer buffer) {
+    for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(resources.size()); ++i) {
+        if (resources[i].kind == ResourceKind::Buffer && resources[i].vkBuffer == buffer)
+            return i;
+    }
+    return UINT32_MAX;
+}
+
+// Resources sharing one VkImage/VkBuffer form an aliasing group. Returns the
+// group id per resource (UINT32_MAX = not aliased) and the group count.
+static std::uint32_t computeAliasGroups(const std::vector<ResourceEntry>& resources,
+                                        std::vector<std::uint32_t>& groupOf) {
+    groupOf.assign(resources.size(), UINT32_MAX);
+    std::uint32_t groups = 0;
+    for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(resources.size()); ++i) {
+        if (groupOf[i] != UINT32_MAX)
+            continue;
+        const auto& a = resources[i];
+        bool found = false;
+        for (std::uint32_t j = i + 1; j < static_cast<std::uint32_t>(resources.size()); ++j) {
+            const auto& b = resources[j];
+            if (a.kind != b.kind)
+                continue;
+            bool same = a.kind == ResourceKind::Image
+                            ? (a.vkImage != VK_NULL_HANDLE && a.vkImage == b.vkImage)
+                            : (a.vkBuffer != VK_NULL_HANDLE && a.vkBuffer == b.vkBuffer);
+            if (!same)
+                continue;
+            groupOf[j] = groups;
+            found = true;
+        }
+        if (found)
+            groupOf[i] = groups++;
+    }
+    return groups;
+}
+
+// Lifetimes from the compiled order. ResourceEntry::firstPass/lastPass are
+// only refreshed on structural compiles, so derive them here instead.
+static void computeExportLifetimes(const std::vector<PassDecl>& passes,
+                                   const std::vector<CompiledPass>& compiled,
+                                   std::size_t resourceCount,
+                                   std::vector<std::uint32_t>& first,
+                                   std::vector<std::uint32_t>& last) {
+    first.assign(resourceCount, UINT32_MAX);
+    last.assign(resourceCount, UINT32_MAX);
+    for (std::uint32_t pos = 0; pos < static_cast<std::uint32_t>(compiled.size()); ++pos) {
+        for (const auto& acc : passes[compiled[pos].passIndex].accesses) {
+            if (!acc.handle.valid() || acc.handle.index >= resourceCount)
+                continue;
+            if (first[acc.handle.index] == UINT32_MAX)
+                first[acc.handle.index] = pos;
+            last[acc.handle.index] = pos;
+        }
+    }
+}
+
+static const char* accessTypeName(AccessType a) {
+    switch (a) {
+    case AccessType::Read:
+        return "read";
+    case AccessType::Write:
+        return "write";
+    case AccessType::ReadWrite:
+        return "readwrite";
+    }
+    return "unknown";
+}
+
+std::string RenderGraph::exportJson() const {
+    if (!isCompiled_)
+        return {};
+
+    std::vector<std::uint32_t> firstUse;
+    std::vector<std::uint32_t> lastUse;
+    computeExportLifetimes(passes_, compiledPasses_, resources_.size(), firstUse, lastUse);
+    std::vector<std::uint32_t> aliasGroup;
+    std::uint32_t aliasGroupCount = computeAliasGroups(resources_, aliasGroup);
+
+    std::string out;
+    out.reserve(4096);
+    out += "{\n  \"version\":1,\n  \"passes\":[";
+
+    for (std::uint32_t pos = 0; pos < static_cast<std::uint32_t>(compiledPasses_.size()); ++pos) {
+        const auto& cp = compiledPasses_[pos];
+        const auto& decl = passes_[cp.passIndex];
+        out += pos == 0 ? "\n    {" : ",\n    {";
+        out += "\"name\":";
+        appendJsonString(out, decl.name);
+        out += ",\"type\":";
+        appendJsonString(out, passTypeName(decl.type));
+        appendUint(out, "order", pos);
+        appendUint(out, "declIndex", cp.passIndex);
+        if (cp.asyncTransfer)
+            out += ",\"queue\":\"transfer\"";
+        if (decl.viewMask != 0)
+            appendUint(out, "viewMask", decl.viewMask);
+
+        out += ",\"accesses\":[";
+        bool firstAcc = true;
+        for (const auto& acc : decl.accesses) {
+            if (!acc.handle.valid())
+                continue;
+            out += firstAcc ? "{" : ",{";
+            firstAcc = false;
+            out += "\"resource\":";
+            appendJsonString(out, resourceLabel(resources_, acc.handle.index));
+            out += ",\"access\":";
+            appendJsonString(out, accessTypeName(acc.access));
+            out += ",\"layout\":";
+            appendJsonString(out, layoutName(acc.desiredState.currentLayout));
+            out += '}';
+        }
+        out += ']';
+
+        out += ",\"imageBarriers\":[";
+        for (std::size_t i = 0; i < cp.barriers.imageBarriers.size(); ++i) {
+            const auto& b = cp.barriers.imageBarriers[i];
+            out += i == 0 ? "\n      {" : ",\n      {";
+            out += "\"resource\":";
+            appendJsonString(out, resourceLabel(resources_, findImageIndex(resources_, b.image)));
+            out += ",\"oldLayout\":";
+            appendJsonString(out, layoutName(b.oldLayout));
+            out += ",\"newLayout\":";
+            appendJsonString(out, layoutName(b.newLayout));
+            appendJsonFlags(out, "srcStage", b.srcStageMask, true);
+            appendJsonFlags(out, "srcAccess", b.srcAccessMask, false);
+            appendJsonFlags(out, "dstStage", b.dstStageMask, true);
+            appendJsonFlags(out, "dstAccess", b.dstAccessMask, false);
+            appendUint(out, "baseMip", b.subresourceRange.baseMipLevel);
+            appendUint(out, "mipCount", b.subresourceRange.levelCount);
+            appendUint(out, "baseLayer", b.subresourceRange.baseArrayLayer);
+            appendUint(out, "layerCount", b.subresourceRange.layerCount);
+            if (b.srcQueueFamilyIndex != b.dstQueueFamilyIndex) {
+                appendUint(out, "srcQueueFamily", b.srcQueueFamilyIndex);
+                appendUint(out, "dstQueueFamily", b.dstQueueFamilyIndex);
+            }
+            out += '}';
+        }
+        out += ']';
+
+        out += ",\"bufferBarriers\":[";
+        for (std::size_t i = 0; i < cp.barriers.bufferBarriers.size(); ++i) {
+            const auto& b = cp.barriers.bufferBarriers[i];
+            out += i == 0 ? "\n      {" : ",\n      {";
+            out += "\"resource\":";
+            appendJsonString(out,
+                             resourceLabel(resources_, findBufferIndex(resources_, b.buffer)));
+            appendJsonFlags(out, "srcStage", b.srcStageMask, true);
+            appendJsonFlags(out, "srcAccess", b.srcAccessMask, false);
+            appendJsonFlags(out, "dstStage", b.dstStageMask, true);
+            appendJsonFlags(out, "dstAccess", b.dstAccessMask, false);
+            appendUint(out, "offset", b.offset);
+            appendUint(out, "size", b.size);
+            if (b.srcQueueFamilyIndex != b.dstQueueFamilyIndex) {
+                appendUint(out, "srcQueueFamily", b.srcQueueFamilyIndex);
+                appendUint(out, "dstQueueFamily", b.dstQueueFamilyIndex);
+            }
+            out += '}';
+        }
+        out += ']';
+
+        out += ",\"memoryBarriers\":[";
+        for (std::size_t i = 0; i < cp.barriers.memoryBarriers.size(); ++i) {
+            const auto& b = cp.barriers.memoryBarriers[i];
+            out += i == 0 ? "{\"resource\":\"(global)\"" : ",{\"resource\":\"(global)\"";
+            appendJsonFlags(out, "srcStage", b.srcStageMask, true);
+            appendJsonFlags(out, "srcAccess", b.srcAccessMask, false);
+            appendJsonFlags(out, "dstStage", b.dstStageMask, true);
+            appendJsonFlags(out, "dstAccess", b.dstAccessMask, false);
+            out += '}';
+        }
+        out += "]}";
+    }
+    out += "\n  ],\n  \"resources\":[";
+
+    for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(resources_.size()); ++i) {
+        const auto& res = resources_[i];
+        out += i == 0 ? "\n    {" : ",\n    {";
+        out += "\"name\":";
+        appendJsonString(out, resourceLabel(resources_, i));
+        out += ",\"kind\":";
+        appendJsonString(out, res.kind == ResourceKind::Image ? "image" : "buffer");
+        out += ",\"tag\":";
+        appendJsonString(out, res.tag == ResourceTag::Transient ? "transient" : "external");
+        if (res.kind == ResourceKind::Image) {
+            appendUint(out, "width", res.imageDesc.width);
+            appendUint(out, "height", res.imageDesc.height);
+            appendUint(out, "mipLevels", res.imageDesc.mipLevels);
+            appendUint(out, "arrayLayers", res.imageDesc.arrayLayers);
+            out += ",\"format\":";
+            appendJsonString(out, formatName(res.imageDesc.format));
+        } else {
+            appendUint(out, "size",
+                       res.tag == ResourceTag::Transient ? res.bufferDesc.size : res.bufferSize);
+        }
+        // Lifetimes and alias groups use -1 for "none".
+        char buf[96];
+        std::snprintf(buf, sizeof(buf),
+                      ",\"firstPass\":%lld,\"lastPass\":%lld,\"aliasGroup\":%lld}",
+                      firstUse[i] == UINT32_MAX ? -1LL : static_cast<long long>(firstUse[i]),
+                      lastUse[i] == UINT32_MAX ? -1LL : static_cast<long long>(lastUse[i]),
+                      aliasGroup[i] == UINT32_MAX ? -1LL : static_cast<long long>(aliasGroup[i]));
+        out += buf;
+    }
+    out += "\n  ],\n  \"aliasing\":[";
+
+    for (std::uint32_t g = 0; g < aliasGroupCount; ++g) {
+        out += g == 0 ? "[" : ",[";
+        bool firstMember = true;
+        for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(resources_.size()); ++i) {
+            if (aliasGroup[i] != g)
+                continue;
+            if (!firstMember)
+                out += ',';
+            firstMember = false;
+            appendJsonString(out, resourceLabel(resources_, i));
+        }
+        out += ']';
+    }
+    out += "],\n  \"stats\":{";
+
+    char buf[128];
+    std::snprintf(buf, sizeof(buf),
+                  "\"passCount\":%u,\"imageBarrierCount\":%u,\"bufferBarrierCount\":%u,"
+                  "\"transientCount\":%u,",
+                  stats_.passCount, stats_.imageBarrierCount, stats_.bufferBarrierCount,
+                  stats_.transientCount);
+    out += buf;
+    std::snprintf(buf, sizeof(buf),
+                  "\"memoryBarrierCount\":%u,\"barriersBeforeCoalescing\":%u,"
+                  "\"barriersAfterCoalescing\":%u,",
+                  stats_.memoryBarrierCount, stats_.barriersBeforeCoalescing,
+                  stats_.barriersAfterCoalescing);
+    out += buf;
+    out += stats_.incremental ? "\"incremental\":true," : "\"incremental\":false,";
+    std::snprintf(buf, sizeof(buf), "\"recompiledPassCount\":%u,", stats_.recompiledPassCount);
+    out += buf;
+    out += "\n    \"timingsUs\":{";
+    appendDouble(out, "compile", stats_.compileTimeUs);
+    out += ',';
+    appendDouble(out, "resolve", stats_.resolveUs);
+    out += ',';
+    appendDouble(out, "usage", stats_.usageUs);
+    out += ',';
+    appendDouble(out, "adjacency", stats_.adjacencyUs);
+    out += ',';
+    appendDouble(out, "sort", stats_.sortUs);
+    out += ',';
+    appendDouble(out, "lifetime", stats_.lifetimeUs);
+    out += ',';
+    appendDouble(out, "alloc", stats_.allocUs);
+    out += ',';
+    appendDouble(out, "stateInit", stats_.stateInitUs);
+    out += ',';
+    appendDouble(out, "barriers", stats_.barriersUs);
+    out += ',';
+    appendDouble(out, "renderTargets", stats_.renderTargetUs);
+    out += ',';
+    appendDouble(out, "descriptors", stats_.descriptorUs);
+    out += ',';
+    appendDouble(out, "stats", stats_.statsUs);
+    out += "}}\n}\n";
+    return out;
+}
+
+static void appendDotId(std::string& out, char prefix, std::uint32_t index) {
+    out += prefix;
+    out += std::to_string(index);
+}
+
+std::string RenderGraph::exportDot() const {
+    if (!isCompiled_)
+        return {};
+
+    std::string out;
+    out.reserve(2048);
+    out += "digraph render_graph {\n  rankdir=LR;\n  node [fontname=\"monospace\"];\n";
+
+    for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(resources_.size()); ++i) {
+        const auto& res = resources_[i];
+        out += "  ";
+        appendDotId(out, 'r', i);
+        out += " [shape=";
+        out += res.kind == ResourceKind::Image ? "ellipse" : "cylinder";
+        if (res.tag == ResourceTag::Transient)
+            out += ",style=dashed";
+        out += ",label=";
+        appendJsonString(out, resourceLabel(resources_, i));
+        out += "];\n";
+    }
+
+    for (std::uint32_t pos = 0; pos < static_cast<std::uint32_t>(compiledPasses_.size()); ++pos) {
+        const auto& cp = compiledPasses_[pos];
+        const auto& decl = passes_[cp.passIndex];
+        char buf[96];
+        std::snprintf(buf, sizeof(buf), "#%u %s\\n%zu img / %zu buf / %zu mem barriers", pos,
+                      passTypeName(decl.type), cp.barriers.imageBarriers.size(),
+                      cp.barriers.bufferBarriers.size(), cp.barriers.memoryBarriers.size());
+        out += "  ";
+        appendDotId(out, 'p', cp.passIndex);
+        out += " [shape=box,label=";
+        // DOT accepts JSON-style escaping; keep the literal \n line break.
+        std::string label;
+        appendJsonString(label, decl.name);
+        label.pop_back();
+        label += "\\n";
+        label += buf;
+        label += '"';
+        out += label;
+        out += "];\n";
+    }
+
+    for (const auto& cp : compiledPasses_) {
+        for (const auto& acc : passes_[cp.passIndex].accesses) {
+            if (!acc.handle.valid())
+                continue;
+            if (acc.access != AccessType::Write) {
+                out += "  ";
+                appendDotId(out, 'r', acc.handle.index);
+                out += " -> ";
+                appendDotId(out, 'p', cp.passIndex);
+                out += ";\n";
+            }
+            if (acc.access != AccessType::Read) {
+                out += "  ";
+                appendDotId(out, 'p', cp.passIndex);
+                out += " -> ";
+                appendDotId(out, 'r', acc.handle.index);
+                out += " [color=red];\n";
+            }
+        }
+    }
+
+    out += "}\n";
+    return out;
 }
 
 } // namespace vksdl::graph
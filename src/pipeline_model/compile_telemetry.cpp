@@ -0,0 +1,196 @@
+#include <vksdl/pipeline.hpp>
+#include <vksdl/pipeline_model/pipeline_compiler.hpp>
+
+#include "compile_telemetry.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cinttypes>
+#include <cstdio>
+#include <string>
+
+namespace vksdl {
+
+double LatencyHistogram::meanMs() const {
+    return count == 0 ? 0.0 : totalMs / static_cast<double>(count);
+}
+
+double LatencyHistogram::percentileMs(double p) const {
+    if (count == 0)
+        return 0.0;
+    p = std::clamp(p, 0.0, 100.0);
+    auto rank = static_cast<std::uint64_t>(p / 100.0 * static_cast<double>(count - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (std::uint32_t i = 0; i < kBuckets; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            double upperMs = static_cast<double>(std::uint64_t{2} << i) / 1000.0;
+            return std::min(upperMs, maxMs);
+        }
+    }
+    return maxMs;
+}
+
+namespace {
+
+void appendUint(std::string& out, const char* key, std::uint64_t value, bool first = false) {
+    char buf[96];
+    std::snprintf(buf, sizeof(buf), "%s\"%s\":%" PRIu64, first ? "" : ",", key, value);
+    out += buf;
+}
+
+void appendDouble(std::string& out, const char* key, double value) {
+    char buf[96];
+    std::snprintf(buf, sizeof(buf), ",\"%s\":%.3f", key, value);
+    out += buf;
+}
+
+void appendHistogram(std::string& out, const char* key, const LatencyHistogram& h, bool first) {
+    out += first ? "\n      \"" : ",\n      \"";
+    out += key;
+    out += "\":{";
+    appendUint(out, "count", h.count, true);
+    appendDouble(out, "meanMs", h.meanMs());
+    appendDouble(out, "p50Ms", h.percentileMs(50.0));
+    appendDouble(out, "p95Ms", h.percentileMs(95.0));
+    appendDouble(out, "p99Ms", h.percentileMs(99.0));
+    appendDouble(out, "maxMs", h.maxMs);
+    // bucketsLog2Us[i] counts samples in [2^i, 2^(i+1)) microseconds.
+    out += ",\"bucketsLog2Us\":[";
+    for (std::uint32_t i = 0; i < LatencyHistogram::kBuckets; ++i) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%s%" PRIu64, i == 0 ? "" : ",", h.buckets[i]);
+        out += buf;
+    }
+    out += "]}";
+}
+
+} // namespace
+
+std::string PipelineCompilerStats::toJson() const {
+    std::string out;
+    out.reserve(4096);
+    out += "{\n  ";
+    appendUint(out, "liveHandles", liveHandles, true);
+    appendUint(out, "livePipelines", livePipelines);
+    appendUint(out, "pendingRetirement", pendingRetirement);
+    appendUint(out, "retiredBaselines", retiredBaselines);
+    appendUint(out, "liveLibraries", liveLibraries);
+    appendUint(out, "evictedLibraries", evictedLibraries);
+    appendUint(out, "threadCaches", threadCaches);
+    appendUint(out, "cacheMerges", cacheMerges);
+
+    const PipelineCompileTelemetry& t = telemetry;
+    out += ",\n  \"telemetry\":{\n    ";
+    appendUint(out, "requests", t.requests, true);
+    appendUint(out, "failures", t.failures);
+    appendUint(out, "probeHits", t.probeHits);
+    appendUint(out, "probeMisses", t.probeMisses);
+    appendUint(out, "driverCacheHits", t.driverCacheHits);
+    appendUint(out, "monolithicBuilds", t.monolithicBuilds);
+    appendUint(out, "fastLinks", t.fastLinks);
+    appendUint(out, "optimizedLinks", t.optimizedLinks);
+    out += ",\n    \"histograms\":{";
+    appendHistogram(out, "requestToUsable", t.requestToUsable, true);
+    appendHistogram(out, "requestToOptimized", t.requestToOptimized, false);
+    appendHistogram(out, "probe", t.probe, false);
+    appendHistogram(out, "monolithicBuild", t.monolithicBuild, false);
+    appendHistogram(out, "libraryParts", t.libraryParts, false);
+    appendHistogram(out, "fastLink", t.fastLink, false);
+    appendHistogram(out, "optimizeQueueDelay", t.optimizeQueueDelay, false);
+    appendHistogram(out, "optimizedLink", t.optimizedLink, false);
+    appendHistogram(out, "vertexStage", t.vertexStage, false);
+    appendHistogram(out, "fragmentStage", t.fragmentStage, false);
+    appendHistogram(out, "computeStage", t.computeStage, false);
+    out += "\n    }\n  }\n}\n";
+    return out;
+}
+
+namespace detail {
+
+void AtomicHistogram::record(TelemetryClock::duration d) {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+    recordNs(ns > 0 ? static_cast<std::uint64_t>(ns) : 0);
+}
+
+void AtomicHistogram::recordMs(double ms) {
+    recordNs(ms > 0.0 ? static_cast<std::uint64_t>(ms * 1e6) : 0);
+}
+
+void AtomicHistogram::recordNs(std::uint64_t ns) {
+    std::uint64_t us = ns / 1000;
+    std::uint32_t bucket = us < 2 ? 0 : static_cast<std::uint32_t>(std::bit_width(us) - 1);
+    bucket = std::min(bucket, LatencyHistogram::kBuckets - 1);
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    totalNs_.fetch_add(ns, std::memory_order_relaxed);
+    std::uint64_t prev = maxNs_.load(std::memory_order_relaxed);
+    while (ns > prev && !maxNs_.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {
+    }
+}
+
+LatencyHistogram AtomicHistogram::snapshot() const {
+    LatencyHistogram h;
+    for (std::uint32_t i = 0; i < LatencyHistogram::kBuckets; ++i) {
+        h.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+        h.count += h.buckets[i];
+    }
+    h.totalMs = static_cast<double>(totalNs_.load(std::memory_order_relaxed)) / 1e6;
+    h.maxMs = static_cast<double>(maxNs_.load(std::memory_order_relaxed)) / 1e6;
+    return h;
+}
+
+void CompileTelemetry::recordBuild(const Pipeline& pipeline, TelemetryClock::duration elapsed) {
+    monolithicBuilds.fetch_add(1, std::memory_order_relaxed);
+    monolithicBuild.record(elapsed);
+
+    const PipelineStats* fb = pipeline.feedback();
+    if (!fb || !fb->valid)
+        return;
+    if (fb->cacheHit)
+        driverCacheHits.fetch_add(1, std::memory_order_relaxed);
+    for (const auto& stage : fb->stages) {
+        if (!stage.valid)
+            continue;
+        switch (stage.stage) {
+        case VK_SHADER_STAGE_VERTEX_BIT:
+            vertexStage.recordMs(stage.durationMs);
+            break;
+        case VK_SHADER_STAGE_FRAGMENT_BIT:
+            fragmentStage.recordMs(stage.durationMs);
+            break;
+        case VK_SHADER_STAGE_COMPUTE_BIT:
+            computeStage.recordMs(stage.durationMs);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+PipelineCompileTelemetry CompileTelemetry::snapshot() const {
+    PipelineCompileTelemetry t;
+    t.requests = requests.load(std::memory_order_relaxed);
+    t.failures = failures.load(std::memory_order_relaxed);
+    t.probeHits = probeHits.load(std::memory_order_relaxed);
+    t.probeMisses = probeMisses.load(std::memory_order_relaxed);
+    t.driverCacheHits = driverCacheHits.load(std::memory_order_relaxed);
+    t.monolithicBuilds = monolithicBuilds.load(std::memory_order_relaxed);
+    t.fastLinks = fastLinks.load(std::memory_order_relaxed);
+    t.optimizedLinks = optimizedLinks.load(std::memory_order_relaxed);
+    t.requestToUsable = requestToUsable.snapshot();
+    t.requestToOptimized = requestToOptimized.snapshot();
+    t.probe = probe.snapshot();
+    t.monolithicBuild = monolithicBuild.snapshot();
+    t.libraryParts = libraryParts.snapshot();
+    t.fastLink = fastLink.snapshot();
+    t.optimizeQueueDelay = optimizeQueueDelay.snapshot();
+    t.optimizedLink = optimizedLink.snapshot();
+    t.vertexStage = vertexStage.snapshot();
+    t.fragmentStage = fragmentStage.snapshot();
+    t.computeStage = computeStage.snapshot();
+    return t;
+}
+
+} // namespace detail
+
+} // namespace vksdl
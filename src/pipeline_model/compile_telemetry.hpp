@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vksdl/pipeline.hpp>
+#include <vksdl/pipeline_model/pipeline_compiler.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace vksdl::detail {
+
+using TelemetryClock = std::chrono::steady_clock;
+
+// Lock-free counterpart of LatencyHistogram. record() is a handful of relaxed
+// atomic adds plus a CAS loop that only spins while the maximum is raced.
+class AtomicHistogram {
+  public:
+    void record(TelemetryClock::duration d);
+    void recordMs(double ms);
+
+    [[nodiscard]] LatencyHistogram snapshot() const;
+
+  private:
+    void recordNs(std::uint64_t ns);
+
+    std::array<std::atomic<std::uint64_t>, LatencyHistogram::kBuckets> buckets_{};
+    std::atomic<std::uint64_t> totalNs_{0};
+    std::atomic<std::uint64_t> maxNs_{0};
+};
+
+// Everything PipelineCompileTelemetry reports, written concurrently by
+// compile() callers and workers.
+struct CompileTelemetry {
+    std::atomic<std::uint64_t> requests{0};
+    std::atomic<std::uint64_t> failures{0};
+    std::atomic<std::uint64_t> probeHits{0};
+    std::atomic<std::uint64_t> probeMisses{0};
+    std::atomic<std::uint64_t> driverCacheHits{0};
+    std::atomic<std::uint64_t> monolithicBuilds{0};
+    std::atomic<std::uint64_t> fastLinks{0};
+    std::atomic<std::uint64_t> optimizedLinks{0};
+
+    AtomicHistogram requestToUsable;
+    AtomicHistogram requestToOptimized;
+    AtomicHistogram probe;
+    AtomicHistogram monolithicBuild;
+    AtomicHistogram libraryParts;
+    AtomicHistogram fastLink;
+    AtomicHistogram optimizeQueueDelay;
+    AtomicHistogram optimizedLink;
+    AtomicHistogram vertexStage;
+    AtomicHistogram fragmentStage;
+    AtomicHistogram computeStage;
+
+    // A real build finished: counts it and files the driver's feedback.
+    void recordBuild(const Pipeline& pipeline, TelemetryClock::duration elapsed);
+
+    [[nodiscard]] PipelineCompileTelemetry snapshot() const;
+};
+
+} // namespace vksdl::detail
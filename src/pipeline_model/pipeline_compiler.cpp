@@ -1,23 +1,35 @@
+#include <vksdl/compute_pipeline.hpp>
 #include <vksdl/device.hpp>
 #include <vksdl/pipeline.hpp>
 #include <vksdl/pipeline_cache.hpp>
+#include <vksdl/pipeline_cache_pool.hpp>
+#include <vksdl/pipeline_key.hpp>
 #include <vksdl/pipeline_model/gpl_library.hpp>
 #include <vksdl/pipeline_model/pipeline_compiler.hpp>
+#include <vksdl/pipeline_model/spec_permutations.hpp>
 
+#include "compile_telemetry.hpp"
 #include "pipeline_handle_impl.hpp"
 
 #include <vulkan/vulkan.h>
 
 #include <algorithm>
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstdint>
 #include <cstdio>
+#include <exception>
 #include <functional>
+#include <initializer_list>
+#include <future>
 #include <memory>
+#include <optional>
 #include <mutex>
 #include <queue>
 #include <shared_mutex>
+#include <string>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -30,29 +42,6 @@ struct CompileTask {
     std::function<void()> work;
 };
 
-// FNV-1a hash for pipeline identity. Not cryptographic, just collision-avoidance.
-class HashBuilder {
-  public:
-    void feed(const void* data, std::size_t size) {
-        auto* bytes = static_cast<const unsigned char*>(data);
-        for (std::size_t i = 0; i < size; ++i) {
-            hash_ ^= bytes[i];
-            hash_ *= 0x100000001b3ULL;
-        }
-    }
-
-    template <typename T> void feed(const T& value) {
-        feed(&value, sizeof(T));
-    }
-
-    [[nodiscard]] std::uint64_t finish() const {
-        return hash_;
-    }
-
-  private:
-    std::uint64_t hash_ = 0xcbf29ce484222325ULL; // FNV offset basis
-};
-
 struct PipelineCompilerImpl {
     VkDevice device = VK_NULL_HANDLE;
     const Device* devicePtr = nullptr; // non-owning, valid for lifetime of compiler
@@ -60,6 +49,7 @@ struct PipelineCompilerImpl {
     PipelinePolicy policy = PipelinePolicy::Auto;
     PipelineModel resolvedModel = PipelineModel::Monolithic;
     PipelineModelInfo info;
+    PipelineBinaryStore* binaryStore = nullptr; // non-owning, optional
 
     // Worker thread pool.
     std::vector<std::thread> workers;
@@ -69,12 +59,242 @@ struct PipelineCompilerImpl {
     std::atomic<bool> running{true};
     std::atomic<std::uint32_t> pending{0};
 
-    // GPL library caches (keyed by content hash).
+    // GPL library caches (keyed by 128-bit content key). Each entry is inserted once
+    // as a shared_future placeholder before the part is built, so the map lock
+    // is never held across a driver compile and concurrent requests for the
+    // same part wait on the in-flight build instead of duplicating it.
+    using GplPartResult = Result<std::shared_ptr<GplLibrary>>;
+    using GplPartFuture = std::shared_future<GplPartResult>;
+
+    struct GplPartEntry {
+        GplPartFuture future;
+        std::atomic<std::uint64_t> lastUse{0}; // useClock tick, for LRU eviction
+    };
+    using GplPartCache = std::unordered_map<PipelineKey, GplPartEntry, PipelineKeyHash>;
+
     std::shared_mutex viCacheMutex, prCacheMutex, fsCacheMutex, foCacheMutex;
-    std::unordered_map<std::uint64_t, std::shared_ptr<GplLibrary>> vertexInputCache;
-    std::unordered_map<std::uint64_t, std::shared_ptr<GplLibrary>> preRasterCache;
-    std::unordered_map<std::uint64_t, std::shared_ptr<GplLibrary>> fragmentShaderCache;
-    std::unordered_map<std::uint64_t, std::shared_ptr<GplLibrary>> fragmentOutputCache;
+    GplPartCache vertexInputCache;
+    GplPartCache preRasterCache;
+    GplPartCache fragmentShaderCache;
+    GplPartCache fragmentOutputCache;
+    std::atomic<std::uint64_t> useClock{0};
+    std::atomic<std::uint32_t> maxLibraries{0}; // 0 = unbounded
+    std::atomic<std::uint64_t> evictedLibraries{0};
+
+    // Shared with every handle so live counts survive the compiler.
+    std::shared_ptr<PipelineLiveCounters> counters = std::make_shared<PipelineLiveCounters>();
+
+    // GPL handles whose baseline can be retired once the optimized pipeline
+    // has been bound. Each entry holds a handle reference.
+    struct RetireEntry {
+        PipelineHandleImpl* handle = nullptr;
+        std::uint64_t boundFrame = 0; // first frame the optimized bind was seen
+        bool bound = false;
+    };
+    std::atomic<std::uint32_t> retireFrames{0}; // 0 = keep baselines
+    std::mutex retireMutex;
+    std::vector<RetireEntry> retireList;
+    std::uint64_t frame = 0; // guarded by retireMutex
+    std::atomic<std::uint64_t> retiredBaselines{0};
+
+    // Leased pipeline caches. Every compile through this compiler (on a
+    // worker or a compile() caller) leases a VkPipelineCache from a bounded
+    // pool, seeded from a snapshot of the main cache taken at create(), so
+    // parallel compiles never contend on one cache object. A worker merges
+    // released caches back into the main cache once mergeInterval new
+    // compiles have landed, and destroy() merges a final time.
+    std::optional<PipelineCachePool> cachePool;
+    // Shared for cache-only probes and fallback compiles on the main cache,
+    // exclusive for merges (vkMergePipelineCaches externally synchronizes
+    // dstCache).
+    std::shared_mutex mainCacheMutex;
+    std::atomic<std::uint32_t> mergeInterval{32}; // 0 = merge only on request
+    std::atomic<std::uint32_t> unmergedCompiles{0};
+    std::atomic<bool> mergeQueued{false};
+    std::atomic<std::uint64_t> cacheMerges{0};
+
+    CompileTelemetry telemetry;
+
+    VkResult mergeThreadCaches() {
+        std::unique_lock mainLock(mainCacheMutex);
+        // Compiles landing during the merge count toward the next one.
+        unmergedCompiles.store(0, std::memory_order_relaxed);
+        if (!cachePool || cache == VK_NULL_HANDLE)
+            return VK_SUCCESS;
+        std::uint64_t before = cachePool->merges();
+        auto merged = cachePool->merge();
+        if (!merged.ok())
+            return static_cast<VkResult>(merged.error().vkResult);
+        if (cachePool->merges() != before)
+            cacheMerges.fetch_add(1, std::memory_order_relaxed);
+        return VK_SUCCESS;
+    }
+
+    // Called after each real compile. Queues one merge on a worker once
+    // enough compiles are pending, so callers never pay for it inline.
+    void noteCompile() {
+        std::uint32_t interval = mergeInterval.load(std::memory_order_relaxed);
+        if (interval == 0 || cache == VK_NULL_HANDLE)
+            return;
+        if (unmergedCompiles.fetch_add(1, std::memory_order_relaxed) + 1 < interval)
+            return;
+        bool expected = false;
+        if (!mergeQueued.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+            return;
+        enqueue({[this] {
+            VkResult vr = mergeThreadCaches();
+            (void) vr;
+#ifndef NDEBUG
+            if (vr != VK_SUCCESS)
+                std::fprintf(stderr, "[vksdl] pipeline cache merge failed (non-fatal): %d\n",
+                             static_cast<int>(vr));
+#endif
+            mergeQueued.store(false, std::memory_order_release);
+        }});
+    }
+
+    void destroyThreadCaches() {
+        cachePool.reset();
+    }
+
+    void track(PipelineHandleImpl* h, std::uint32_t pipelineCount) {
+        h->counters = counters;
+        counters->handles.fetch_add(1, std::memory_order_relaxed);
+        counters->pipelines.fetch_add(pipelineCount, std::memory_order_relaxed);
+    }
+
+    void registerForRetirement(PipelineHandleImpl* h) {
+        retainHandle(h);
+        std::lock_guard lock(retireMutex);
+        retireList.push_back({h});
+    }
+
+    void releaseRetireList() {
+        std::lock_guard lock(retireMutex);
+        for (auto& e : retireList)
+            releaseHandle(e.handle);
+        retireList.clear();
+    }
+
+    // Destroy baselines whose optimized replacement was first seen bound at
+    // least retireFrames frames ago. The window must cover the frames in
+    // flight so the GPU is no longer executing commands that bind the baseline.
+    void retireBaselines() {
+        std::uint32_t window = retireFrames.load(std::memory_order_relaxed);
+        if (window == 0) {
+            releaseRetireList();
+            return;
+        }
+
+        std::lock_guard lock(retireMutex);
+        ++frame;
+        std::size_t keep = 0;
+        for (std::size_t i = 0; i < retireList.size(); ++i) {
+            RetireEntry e = retireList[i];
+            PipelineHandleImpl* h = e.handle;
+            bool done = h->destroyed.load(std::memory_order_acquire);
+            if (!done && !e.bound) {
+                if (h->optimizedBound.load(std::memory_order_acquire)) {
+                    e.bound = true;
+                    e.boundFrame = frame;
+                }
+            } else if (!done && frame >= e.boundFrame + window) {
+                // Exchange so a concurrent PipelineHandle::destroy() cannot
+                // destroy the same baseline.
+                VkPipeline base = h->baseline.exchange(VK_NULL_HANDLE, std::memory_order_acq_rel);
+                if (base != VK_NULL_HANDLE) {
+                    vkDestroyPipeline(device, base, nullptr);
+                    countPipelines(h, -1);
+                    retiredBaselines.fetch_add(1, std::memory_order_relaxed);
+                }
+                done = true;
+            }
+            if (done) {
+                releaseHandle(h);
+                continue;
+            }
+            retireList[keep++] = e;
+        }
+        retireList.resize(keep);
+    }
+
+    struct PartCacheRef {
+        std::shared_mutex* mtx;
+        GplPartCache* cache;
+    };
+    std::array<PartCacheRef, 4> partCaches() {
+        return {{{&viCacheMutex, &vertexInputCache},
+                 {&prCacheMutex, &preRasterCache},
+                 {&fsCacheMutex, &fragmentShaderCache},
+                 {&foCacheMutex, &fragmentOutputCache}}};
+    }
+
+    // A part is evictable once built and referenced only by the cache:
+    // linked pipelines do not need their libraries, and compile() and
+    // optimize tasks hold their own shared_ptr while they use one.
+    static bool isUnreferenced(const GplPartEntry& e) {
+        if (e.future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return false;
+        const auto& r = e.future.get();
+        return r.ok() && r.value().use_count() == 1;
+    }
+
+    // Evict least recently used unreferenced parts until the total part count
+    // is within maxLibraries. In-flight and in-use parts are never evicted, so
+    // the cap is soft while they exceed it.
+    void evictLibraries() {
+        std::uint32_t cap = maxLibraries.load(std::memory_order_relaxed);
+        if (cap == 0)
+            return;
+
+        auto parts = partCaches();
+        struct Candidate {
+            std::uint64_t lastUse;
+            PipelineKey key;
+            std::size_t part;
+        };
+        std::vector<Candidate> candidates;
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < parts.size(); ++i) {
+            std::shared_lock lock(*parts[i].mtx);
+            total += parts[i].cache->size();
+            for (const auto& [key, entry] : *parts[i].cache) {
+                if (isUnreferenced(entry))
+                    candidates.push_back({entry.lastUse.load(std::memory_order_relaxed), key, i});
+            }
+        }
+        if (total <= cap)
+            return;
+
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const Candidate& a, const Candidate& b) { return a.lastUse < b.lastUse; });
+
+        // Futures are moved out and destroyed after the cache locks drop.
+        std::vector<GplPartFuture> evicted;
+        std::size_t excess = total - cap;
+        for (const auto& c : candidates) {
+            if (excess == 0)
+                break;
+            std::unique_lock lock(*parts[c.part].mtx);
+            auto it = parts[c.part].cache->find(c.key);
+            if (it == parts[c.part].cache->end() || !isUnreferenced(it->second) ||
+                it->second.lastUse.load(std::memory_order_relaxed) != c.lastUse)
+                continue;
+            evicted.push_back(std::move(it->second.future));
+            parts[c.part].cache->erase(it);
+            --excess;
+        }
+        evictedLibraries.fetch_add(evicted.size(), std::memory_order_relaxed);
+    }
+
+    std::uint32_t libraryCount() {
+        std::size_t n = 0;
+        for (const auto& p : partCaches()) {
+            std::shared_lock lock(*p.mtx);
+            n += p.cache->size();
+        }
+        return static_cast<std::uint32_t>(n);
+    }
 
     void workerLoop() {
         while (true) {
@@ -90,6 +310,8 @@ struct PipelineCompilerImpl {
                 tasks.pop();
             }
             task.work();
+            // Drop captured library references before waitIdle() can return.
+            task.work = nullptr;
             pending.fetch_sub(1, std::memory_order_release);
         }
     }
@@ -114,6 +336,53 @@ struct PipelineCompilerImpl {
     }
 };
 
+// One compile's lease on a pooled cache, returned on destruction. Falls back
+// to the main cache, under a shared lock against merges, if the pool cannot
+// create a cache.
+class CacheLease {
+  public:
+    explicit CacheLease(PipelineCompilerImpl& impl) : impl_(impl) {
+        auto leased = impl.cachePool->acquire();
+        if (leased.ok()) {
+            cache_ = leased.value();
+            pooled_ = true;
+        } else {
+            mainLock_ = std::shared_lock(impl.mainCacheMutex);
+            cache_ = impl.cache;
+        }
+    }
+    ~CacheLease() {
+        release();
+    }
+    CacheLease(const CacheLease&) = delete;
+    CacheLease& operator=(const CacheLease&) = delete;
+
+    [[nodiscard]] VkPipelineCache get() const {
+        return cache_;
+    }
+
+    // Marks the cache as holding new compiles for the next merge.
+    void compiled() {
+        dirty_ = true;
+    }
+
+    // Returns the cache early, e.g. before noteCompile() queues a merge.
+    void release() {
+        if (pooled_)
+            impl_.cachePool->release(cache_, dirty_);
+        pooled_ = false;
+        if (mainLock_.owns_lock())
+            mainLock_.unlock();
+    }
+
+  private:
+    PipelineCompilerImpl& impl_;
+    VkPipelineCache cache_ = VK_NULL_HANDLE;
+    std::shared_lock<std::shared_mutex> mainLock_;
+    bool pooled_ = false;
+    bool dirty_ = false;
+};
+
 } // namespace detail
 
 PipelineCompiler::~PipelineCompiler() {
@@ -138,6 +407,16 @@ void PipelineCompiler::destroy() {
         return;
     auto* impl = static_cast<detail::PipelineCompilerImpl*>(impl_);
     impl->shutdown();
+    // Workers are joined: no thread cache is in use any more.
+    VkResult vr = impl->mergeThreadCaches();
+    (void) vr;
+#ifndef NDEBUG
+    if (vr != VK_SUCCESS)
+        std::fprintf(stderr, "[vksdl] final pipeline cache merge failed: %d\n",
+                     static_cast<int>(vr));
+#endif
+    impl->destroyThreadCaches();
+    impl->releaseRetireList();
     delete impl;
     impl_ = nullptr;
 }
@@ -155,6 +434,21 @@ Result<PipelineCompiler> PipelineCompiler::create(const Device& device, Pipeline
     impl->cache = cache.vkPipelineCache();
     impl->policy = policy;
 
+    // Snapshot once; pooled caches are seeded from it so they start warm
+    // without ever reading the main cache concurrently with a merge.
+    std::vector<std::uint8_t> cacheSeed;
+    std::size_t seedSize = 0;
+    if (vkGetPipelineCacheData(impl->device, impl->cache, &seedSize, nullptr) == VK_SUCCESS &&
+        seedSize > 0) {
+        cacheSeed.resize(seedSize);
+        VkResult vr =
+            vkGetPipelineCacheData(impl->device, impl->cache, &seedSize, cacheSeed.data());
+        if (vr == VK_SUCCESS || vr == VK_INCOMPLETE)
+            cacheSeed.resize(seedSize);
+        else
+            cacheSeed.clear();
+    }
+
     impl->info.hasPCCC = device.hasPipelineCreationCacheControl();
     impl->info.hasGPL = device.hasGPL();
     impl->info.fastLink = device.hasGplFastLinking();
@@ -198,11 +492,21 @@ Result<PipelineCompiler> PipelineCompiler::create(const Device& device, Pipeline
         break;
     }
 
-    std::uint32_t threadCount = 1;
-    if (impl->resolvedModel == PipelineModel::GPL) {
-        auto hw = std::thread::hardware_concurrency();
-        threadCount = std::max(1u, hw / 2);
+    // Sized for GPL background optimization and permutation batches; idle
+    // workers just sleep on the queue.
+    std::uint32_t threadCount = std::max(1u, std::thread::hardware_concurrency() / 2);
+
+    // One cache per hardware thread: workers take half, compile() callers
+    // the rest. More parallel compiles would only contend for cores.
+    auto pool = PipelineCachePool::create(
+        device, impl->cache, std::max(threadCount + 1, std::thread::hardware_concurrency()),
+        std::move(cacheSeed));
+    if (!pool.ok()) {
+        delete impl;
+        return std::move(pool).error();
     }
+    impl->cachePool.emplace(std::move(pool).value());
+
     for (std::uint32_t i = 0; i < threadCount; ++i) {
         impl->workers.emplace_back(&detail::PipelineCompilerImpl::workerLoop, impl);
     }
@@ -216,14 +520,14 @@ Result<PipelineCompiler> PipelineCompiler::create(const Device& device, Pipeline
 void* PipelineCompiler::transferPipeline(VkDevice device, Pipeline& pipeline, bool markOptimized) {
     auto* hi = new detail::PipelineHandleImpl;
     hi->device = device;
-    hi->baseline = pipeline.pipeline_;
+    hi->baseline.store(pipeline.pipeline_, std::memory_order_relaxed);
     hi->optimized.store(VK_NULL_HANDLE, std::memory_order_relaxed);
     hi->layout = pipeline.layout_;
     hi->ownsLayout = pipeline.ownsLayout_;
     hi->bindPoint = pipeline.bindPoint_;
 
     if (markOptimized) {
-        hi->optimized.store(hi->baseline, std::memory_order_release);
+        hi->optimized.store(pipeline.pipeline_, std::memory_order_release);
     }
 
     // Prevent Pipeline destructor from destroying transferred handles.
@@ -235,37 +539,95 @@ void* PipelineCompiler::transferPipeline(VkDevice device, Pipeline& pipeline, bo
 
 Result<PipelineHandle> PipelineCompiler::compile(const PipelineBuilder& builder) {
     auto* impl = static_cast<detail::PipelineCompilerImpl*>(impl_);
+    auto requested = detail::TelemetryClock::now();
+    auto result = compileImpl(builder, requested);
+
+    auto& t = impl->telemetry;
+    t.requests.fetch_add(1, std::memory_order_relaxed);
+    if (result.ok())
+        t.requestToUsable.record(detail::TelemetryClock::now() - requested);
+    else
+        t.failures.fetch_add(1, std::memory_order_relaxed);
+    return result;
+}
+
+Result<PipelineHandle> PipelineCompiler::compileImpl(const PipelineBuilder& builder,
+                                                     detail::TelemetryClock::time_point requested) {
+    auto* impl = static_cast<detail::PipelineCompilerImpl*>(impl_);
+    auto& telemetry = impl->telemetry;
+    PipelineBinaryStore* store = builder.binaryStore_ ? builder.binaryStore_ : impl->binaryStore;
+
+    // A builder pointing at the compiler's main cache (or at none) probes
+    // the main cache and compiles into this thread's cache. A builder with a
+    // cache of its own keeps it for both.
+    bool sharedCache = builder.cache_ == VK_NULL_HANDLE || builder.cache_ == impl->cache;
+    auto probe = [&]() -> Result<Pipeline> {
+        constexpr VkPipelineCreateFlags kProbe =
+            VK_PIPELINE_CREATE_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT;
+        auto start = detail::TelemetryClock::now();
+        auto result = [&] {
+            if (!sharedCache)
+                return builder.buildImpl(kProbe, store, builder.cache_);
+            std::shared_lock lock(impl->mainCacheMutex);
+            return builder.buildImpl(kProbe, store, impl->cache);
+        }();
+        telemetry.probe.record(detail::TelemetryClock::now() - start);
+        if (result.ok())
+            telemetry.probeHits.fetch_add(1, std::memory_order_relaxed);
+        else if (result.error().is(ErrorCode::CompileRequired))
+            telemetry.probeMisses.fetch_add(1, std::memory_order_relaxed);
+        return result;
+    };
 
     // Monolithic path: synchronous compilation with optional cache probe.
-    if (impl->resolvedModel == PipelineModel::Monolithic) {
+    // GPL library parts carry no specialization constants, so specialized
+    // builders take this path too. So do maximal-dynamic-state builders: their
+    // variants share one create info, so once the first compile is merged
+    // into the main cache the probe hits and fast-linked parts buy nothing.
+    // Multiview builders too: the parts below are keyed and built single-view.
+    bool specialized = !builder.specEntries_.empty() || builder.externalSpecInfo_.has_value();
+    if (impl->resolvedModel == PipelineModel::Monolithic || specialized ||
+        builder.maximalDynamic_ || builder.viewMask_ != 0) {
 
         // Step 1: Cache probe (zero-cost if cached).
         if (impl->info.hasPCCC) {
-            auto probeResult =
-                builder.buildWithFlags(VK_PIPELINE_CREATE_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT);
+            auto probeResult = probe();
             if (probeResult.ok()) {
                 Pipeline pipeline = std::move(probeResult).value();
                 auto* hi = transferPipeline(impl->device, pipeline, true);
+                impl->track(static_cast<detail::PipelineHandleImpl*>(hi), 1);
 
                 PipelineHandle handle;
                 handle.impl_ = hi;
                 return handle;
             }
             // VK_PIPELINE_COMPILE_REQUIRED is expected -- fall through.
-            auto vr = static_cast<VkResult>(probeResult.error().vkResult);
-            if (vr != VK_PIPELINE_COMPILE_REQUIRED) {
+            if (!probeResult.error().is(ErrorCode::CompileRequired)) {
                 return std::move(probeResult).error();
             }
         }
 
         // Step 2 (monolithic): Build synchronously.
-        auto buildResult = builder.buildWithFlags(0);
+        auto buildStart = detail::TelemetryClock::now();
+        // The lease is returned before noteCompile() can queue a merge.
+        auto buildResult = [&]() -> Result<Pipeline> {
+            if (!sharedCache)
+                return builder.buildImpl(0, store, builder.cache_);
+            detail::CacheLease lease(*impl);
+            auto built = builder.buildImpl(0, store, lease.get());
+            if (built.ok())
+                lease.compiled();
+            return built;
+        }();
         if (!buildResult.ok()) {
             return std::move(buildResult).error();
         }
+        impl->noteCompile();
 
         Pipeline pipeline = std::move(buildResult).value();
+        telemetry.recordBuild(pipeline, detail::TelemetryClock::now() - buildStart);
         auto* hi = transferPipeline(impl->device, pipeline, true);
+        impl->track(static_cast<detail::PipelineHandleImpl*>(hi), 1);
 
         PipelineHandle handle;
         handle.impl_ = hi;
@@ -276,18 +638,17 @@ Result<PipelineHandle> PipelineCompiler::compile(const PipelineBuilder& builder)
 
     // Step 1: Cache probe (if PCCC available).
     if (impl->info.hasPCCC) {
-        auto probeResult =
-            builder.buildWithFlags(VK_PIPELINE_CREATE_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT);
+        auto probeResult = probe();
         if (probeResult.ok()) {
             Pipeline pipeline = std::move(probeResult).value();
             auto* hi = transferPipeline(impl->device, pipeline, true);
+            impl->track(static_cast<detail::PipelineHandleImpl*>(hi), 1);
 
             PipelineHandle handle;
             handle.impl_ = hi;
             return handle;
         }
-        auto vr = static_cast<VkResult>(probeResult.error().vkResult);
-        if (vr != VK_PIPELINE_COMPILE_REQUIRED) {
+        if (!probeResult.error().is(ErrorCode::CompileRequired)) {
             return std::move(probeResult).error();
         }
     }
@@ -383,71 +744,146 @@ Result<PipelineHandle> PipelineCompiler::compile(const PipelineBuilder& builder)
         ownsLayout = true;
     }
 
-    auto computeHash = [](auto feedFn) -> std::uint64_t {
-        detail::HashBuilder h;
-        feedFn(h);
-        return h.finish();
+    detail::CacheLease lease(*impl);
+    VkPipelineCache threadCache = lease.get();
+
+    // Part keys: canonical field-wise encoding of exactly the state each
+    // library part is built from (see the builders below), hashed to 128
+    // bits. Path shaders are keyed by content; modules and layouts by handle
+    // value, so the keys (like the cache they index) are process-local.
+    auto writeShader = [](PipelineKeyWriter& w, const std::vector<std::uint32_t>& code,
+                          VkShaderModule module) {
+        if (!code.empty())
+            w.u8(1).blob(code.data(), code.size() * sizeof(std::uint32_t));
+        else
+            w.u8(0).u64(reinterpret_cast<std::uint64_t>(module));
+    };
+    // Parts are linked with the final layout, so the layout inputs (not the
+    // per-compile VkPipelineLayout) are part of the shader-stage keys.
+    auto writeLayout = [&](PipelineKeyWriter& w) {
+        w.u64(reinterpret_cast<std::uint64_t>(externalLayout));
+        w.u32(static_cast<std::uint32_t>(dsLayouts.size()));
+        for (auto dsl : dsLayouts)
+            w.u64(reinterpret_cast<std::uint64_t>(dsl));
+        w.u32(static_cast<std::uint32_t>(pcRanges.size()));
+        for (const auto& r : pcRanges)
+            w.e32(r.stageFlags).u32(r.offset).u32(r.size);
+    };
+    auto writeDynamic = [&](PipelineKeyWriter& w, std::initializer_list<VkDynamicState> relevant) {
+        for (auto ds : extraDynamicStates) {
+            if (std::find(relevant.begin(), relevant.end(), ds) != relevant.end())
+                w.e32(ds);
+        }
+        w.u32(0xFFFFFFFFu); // terminator
     };
 
-    auto viHash = computeHash([&](detail::HashBuilder& h) {
+    PipelineKey viKey;
+    {
+        PipelineKeyWriter w;
+        w.u32(static_cast<std::uint32_t>(vertBindings.size()));
         for (const auto& vb : vertBindings)
-            h.feed(vb);
+            w.u32(vb.binding).u32(vb.stride).e32(vb.inputRate);
+        w.u32(static_cast<std::uint32_t>(vertAttributes.size()));
         for (const auto& va : vertAttributes)
-            h.feed(va);
-        h.feed(topology);
-    });
-    auto prHash = computeHash([&](detail::HashBuilder& h) {
-        if (!vertCode.empty()) {
-            h.feed(vertCode.data(), vertCode.size() * sizeof(std::uint32_t));
-        } else {
-            h.feed(vertMod);
-        }
-        h.feed(polygonMode);
-        h.feed(cullMode);
-        h.feed(frontFace);
-    });
-    auto fsHash = computeHash([&](detail::HashBuilder& h) {
-        if (!fragCode.empty()) {
-            h.feed(fragCode.data(), fragCode.size() * sizeof(std::uint32_t));
-        } else {
-            h.feed(fragMod);
-        }
-        h.feed(depthFormat);
-        h.feed(depthCompareOp);
-    });
-    auto foHash = computeHash([&](detail::HashBuilder& h) {
-        h.feed(colorFormat);
-        h.feed(depthFormat);
-        h.feed(samples);
-        h.feed(enableBlending);
-    });
+            w.u32(va.location).u32(va.binding).e32(va.format).u32(va.offset);
+        w.e32(topology);
+        viKey = w.finish();
+    }
+    PipelineKey prKey;
+    {
+        PipelineKeyWriter w;
+        writeShader(w, vertCode, vertMod);
+        w.e32(polygonMode).e32(cullMode).e32(frontFace);
+        writeDynamic(w, {VK_DYNAMIC_STATE_CULL_MODE, VK_DYNAMIC_STATE_FRONT_FACE,
+                         VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY});
+        writeLayout(w);
+        prKey = w.finish();
+    }
+    PipelineKey fsKey;
+    {
+        PipelineKeyWriter w;
+        writeShader(w, fragCode, fragMod);
+        w.e32(depthFormat).e32(depthCompareOp);
+        writeDynamic(w, {VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE, VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE,
+                         VK_DYNAMIC_STATE_DEPTH_COMPARE_OP});
+        writeLayout(w);
+        fsKey = w.finish();
+    }
+    PipelineKey foKey;
+    {
+        PipelineKeyWriter w;
+        w.e32(colorFormat).e32(depthFormat).e32(samples).boolean(enableBlending);
+        foKey = w.finish();
+    }
 
-    // Helper: lookup-or-create a cached library part.
-    auto getOrCreate = [](std::shared_mutex& mtx,
-                          std::unordered_map<std::uint64_t, std::shared_ptr<GplLibrary>>& theCache,
-                          std::uint64_t hash, auto buildFn) -> Result<std::shared_ptr<GplLibrary>> {
+    // Helper: lookup-or-create a cached library part. The first caller for a
+    // key publishes a placeholder future under a short exclusive lock, builds
+    // outside the lock, then fulfils the promise. Later callers for the same
+    // key block on that future; callers for other keys are not serialized.
+    // A failed (or throwing) build is removed from the map so the next
+    // request retries it.
+    using PartResult = detail::PipelineCompilerImpl::GplPartResult;
+    using PartFuture = detail::PipelineCompilerImpl::GplPartFuture;
+    auto getOrCreate = [&useClock = impl->useClock](
+                           std::shared_mutex& mtx,
+                           detail::PipelineCompilerImpl::GplPartCache& theCache,
+                           const PipelineKey& key, auto buildFn) -> PartResult {
+        std::uint64_t tick = useClock.fetch_add(1, std::memory_order_relaxed) + 1;
         {
             std::shared_lock rlock(mtx);
-            auto it = theCache.find(hash);
-            if (it != theCache.end())
-                return it->second;
+            auto it = theCache.find(key);
+            if (it != theCache.end()) {
+                it->second.lastUse.store(tick, std::memory_order_relaxed);
+                auto inFlight = it->second.future;
+                rlock.unlock();
+                return inFlight.get();
+            }
+        }
+
+        std::promise<PartResult> promise;
+        PartFuture future;
+        bool owner = false;
+        {
+            std::unique_lock wlock(mtx);
+            auto [it, inserted] = theCache.try_emplace(key);
+            if (inserted) {
+                it->second.future = promise.get_future().share();
+                owner = true;
+            }
+            it->second.lastUse.store(tick, std::memory_order_relaxed);
+            future = it->second.future;
+        }
+        if (!owner)
+            return future.get();
+
+        auto unpublish = [&] {
+            std::unique_lock wlock(mtx);
+            theCache.erase(key);
+        };
+        // The promise must be fulfilled on every path: an exception (e.g.
+        // bad_alloc) reaches the waiters and leaves no placeholder behind.
+        try {
+            auto result = buildFn();
+            if (!result.ok()) {
+                unpublish();
+                PartResult failed = std::move(result).error();
+                promise.set_value(failed);
+                return failed;
+            }
+
+            auto ptr = std::make_shared<GplLibrary>(std::move(result).value());
+            promise.set_value(PartResult{ptr});
+            return ptr;
+        } catch (...) {
+            unpublish();
+            promise.set_exception(std::current_exception());
+            throw;
         }
-        std::unique_lock wlock(mtx);
-        auto it = theCache.find(hash);
-        if (it != theCache.end())
-            return it->second;
-
-        auto result = buildFn();
-        if (!result.ok())
-            return std::move(result).error();
-
-        auto ptr = std::make_shared<GplLibrary>(std::move(result).value());
-        theCache.emplace(hash, ptr);
-        return ptr;
     };
 
+    auto partsStart = detail::TelemetryClock::now();
     auto viResult = getOrCreate(
-        impl->viCacheMutex, impl->vertexInputCache, viHash, [&]() -> Result<GplLibrary> {
+        impl->viCacheMutex, impl->vertexInputCache, viKey, [&]() -> Result<GplLibrary> {
             GplVertexInputBuilder vib(*impl->devicePtr);
             for (const auto& vb : vertBindings) {
                 vib.vertexBinding(vb.binding, vb.stride, vb.inputRate);
@@ -456,7 +892,7 @@ Result<PipelineHandle> PipelineCompiler::compile(const PipelineBuilder& builder)
                 vib.vertexAttribute(va.location, va.binding, va.format, va.offset);
             }
             vib.topology(topology);
-            vib.cache(impl->cache);
+            vib.cache(threadCache);
             return vib.build();
         });
     if (!viResult.ok()) {
@@ -467,14 +903,14 @@ Result<PipelineHandle> PipelineCompiler::compile(const PipelineBuilder& builder)
     }
 
     auto prResult =
-        getOrCreate(impl->prCacheMutex, impl->preRasterCache, prHash, [&]() -> Result<GplLibrary> {
+        getOrCreate(impl->prCacheMutex, impl->preRasterCache, prKey, [&]() -> Result<GplLibrary> {
             GplPreRasterizationBuilder prb(*impl->devicePtr);
             prb.vertexModule(vertMod);
             prb.polygonMode(polygonMode);
             prb.cullMode(cullMode);
             prb.frontFace(frontFace);
             prb.pipelineLayout(pipelineLayout);
-            prb.cache(impl->cache);
+            prb.cache(threadCache);
             for (auto ds : extraDynamicStates) {
                 if (ds == VK_DYNAMIC_STATE_CULL_MODE || ds == VK_DYNAMIC_STATE_FRONT_FACE ||
                     ds == VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY) {
@@ -490,7 +926,7 @@ Result<PipelineHandle> PipelineCompiler::compile(const PipelineBuilder& builder)
         return std::move(prResult).error();
     }
 
-    auto fsResult = getOrCreate(impl->fsCacheMutex, impl->fragmentShaderCache, fsHash,
+    auto fsResult = getOrCreate(impl->fsCacheMutex, impl->fragmentShaderCache, fsKey,
                                 [&]() -> Result<GplLibrary> {
                                     GplFragmentShaderBuilder fsb(*impl->devicePtr);
                                     fsb.fragmentModule(fragMod);
@@ -498,7 +934,7 @@ Result<PipelineHandle> PipelineCompiler::compile(const PipelineBuilder& builder)
                                         fsb.depthTest(true, true, depthCompareOp);
                                     }
                                     fsb.pipelineLayout(pipelineLayout);
-                                    fsb.cache(impl->cache);
+                                    fsb.cache(threadCache);
                                     for (auto ds : extraDynamicStates) {
                                         if (ds == VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE ||
                                             ds == VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE ||
@@ -515,7 +951,7 @@ Result<PipelineHandle> PipelineCompiler::compile(const PipelineBuilder& builder)
         return std::move(fsResult).error();
     }
 
-    auto foResult = getOrCreate(impl->foCacheMutex, impl->fragmentOutputCache, foHash,
+    auto foResult = getOrCreate(impl->foCacheMutex, impl->fragmentOutputCache, foKey,
                                 [&]() -> Result<GplLibrary> {
                                     GplFragmentOutputBuilder fob(*impl->devicePtr);
                                     fob.colorFormat(colorFormat);
@@ -525,7 +961,7 @@ Result<PipelineHandle> PipelineCompiler::compile(const PipelineBuilder& builder)
                                     fob.samples(samples);
                                     if (enableBlending)
                                         fob.enableBlending();
-                                    fob.cache(impl->cache);
+                                    fob.cache(threadCache);
                                     return fob.build();
                                 });
     if (!foResult.ok()) {
@@ -539,10 +975,13 @@ Result<PipelineHandle> PipelineCompiler::compile(const PipelineBuilder& builder)
     auto prLib = prResult.value();
     auto fsLib = fsResult.value();
     auto foLib = foResult.value();
+    auto linkStart = detail::TelemetryClock::now();
+    telemetry.libraryParts.record(linkStart - partsStart);
 
     // Fast-link (no optimization).
     auto linkResult = linkGplPipeline(*impl->devicePtr, *viLib, *prLib, *fsLib, *foLib,
-                                      pipelineLayout, impl->cache, false);
+                                      pipelineLayout, threadCache, false);
+    telemetry.fastLink.record(detail::TelemetryClock::now() - linkStart);
     if (!linkResult.ok()) {
         destroyModules();
         if (ownsLayout)
@@ -551,14 +990,21 @@ Result<PipelineHandle> PipelineCompiler::compile(const PipelineBuilder& builder)
     }
 
     VkPipeline fastLinked = linkResult.value();
+    telemetry.fastLinks.fetch_add(1, std::memory_order_relaxed);
+    lease.compiled();
+    lease.release();
+    impl->noteCompile();
 
     auto* handleImpl = new detail::PipelineHandleImpl;
     handleImpl->device = impl->device;
-    handleImpl->baseline = fastLinked;
+    handleImpl->baseline.store(fastLinked, std::memory_order_relaxed);
     handleImpl->optimized.store(VK_NULL_HANDLE, std::memory_order_relaxed);
     handleImpl->layout = pipelineLayout;
     handleImpl->ownsLayout = ownsLayout;
     handleImpl->bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    impl->track(handleImpl, 1);
+    if (impl->retireFrames.load(std::memory_order_relaxed) > 0)
+        impl->registerForRetirement(handleImpl);
 
     PipelineHandle handle;
     handle.impl_ = handleImpl;
@@ -567,27 +1013,56 @@ Result<PipelineHandle> PipelineCompiler::compile(const PipelineBuilder& builder)
     auto* rawHandle = handleImpl;
     VkDevice capturedDevice = impl->device;
     const Device* capturedDevicePtr = impl->devicePtr;
-    VkPipelineCache capturedCache = impl->cache;
 
+    // The task holds a handle reference so the impl (and its layout) stay
+    // valid even if the PipelineHandle is destroyed mid-link.
+    detail::retainHandle(rawHandle);
+    auto enqueued = detail::TelemetryClock::now();
     impl->enqueue({[=]() {
+        auto started = detail::TelemetryClock::now();
+        impl->telemetry.optimizeQueueDelay.record(started - enqueued);
         // Check if handle was destroyed before we got scheduled.
-        if (rawHandle->destroyed.load(std::memory_order_acquire))
+        if (rawHandle->destroyed.load(std::memory_order_acquire)) {
+            detail::releaseHandle(rawHandle);
             return;
+        }
+        detail::CacheLease optLease(*impl);
         auto optResult = linkGplPipeline(*capturedDevicePtr, *viLib, *prLib, *fsLib, *foLib,
-                                         rawHandle->layout, capturedCache, true);
+                                         rawHandle->layout, optLease.get(), true);
+        if (optResult.ok())
+            optLease.compiled();
+        optLease.release();
+        auto linked = detail::TelemetryClock::now();
+        impl->telemetry.optimizedLink.record(linked - started);
         if (optResult.ok()) {
+            impl->telemetry.optimizedLinks.fetch_add(1, std::memory_order_relaxed);
+            impl->telemetry.requestToOptimized.record(linked - requested);
+            impl->noteCompile();
             // Try to publish the optimized pipeline. CAS ensures we don't
             // store into a handle that destroy() already exchanged away.
             VkPipeline expected = VK_NULL_HANDLE;
             if (!rawHandle->optimized.compare_exchange_strong(expected, optResult.value(),
-                                                              std::memory_order_acq_rel))
+                                                              std::memory_order_acq_rel)) {
                 vkDestroyPipeline(capturedDevice, optResult.value(), nullptr);
+            } else {
+                detail::countPipelines(rawHandle, 1);
+                // destroy() ran between our check and the CAS: take it back.
+                if (rawHandle->destroyed.load(std::memory_order_acquire)) {
+                    VkPipeline p =
+                        rawHandle->optimized.exchange(VK_NULL_HANDLE, std::memory_order_acq_rel);
+                    if (p != VK_NULL_HANDLE) {
+                        vkDestroyPipeline(capturedDevice, p, nullptr);
+                        detail::countPipelines(rawHandle, -1);
+                    }
+                }
+            }
         } else {
 #ifndef NDEBUG
             std::fprintf(stderr, "[vksdl] background GPL optimization failed (non-fatal): %s\n",
                          optResult.error().message.c_str());
 #endif
         }
+        detail::releaseHandle(rawHandle);
     }});
 
     destroyModules();
@@ -595,6 +1070,116 @@ Result<PipelineHandle> PipelineCompiler::compile(const PipelineBuilder& builder)
     return handle;
 }
 
+Result<PermutationTable> PipelineCompiler::compilePermutations(const PipelineBuilder& builder,
+                                                              const SpecPermutations& perms) {
+    if (builder.externalSpecInfo_) {
+        return Error{"compile permutations", 0,
+                     "builder uses specialize(); permutations need specConstant() values"};
+    }
+    auto* impl = static_cast<detail::PipelineCompilerImpl*>(impl_);
+    PipelineBinaryStore* store = builder.binaryStore_ ? builder.binaryStore_ : impl->binaryStore;
+    bool sharedCache = builder.cache_ == VK_NULL_HANDLE || builder.cache_ == impl->cache;
+
+    return buildPermutations(perms, [&](std::uint32_t key, VkPipelineCache threadCache) {
+        PipelineBuilder b = builder;
+        perms.writeSpecialization(key, b.specEntries_, b.specData_);
+        return b.buildImpl(0, store, sharedCache ? threadCache : builder.cache_);
+    });
+}
+
+Result<PermutationTable>
+PipelineCompiler::compilePermutations(const ComputePipelineBuilder& builder,
+                                      const SpecPermutations& perms) {
+    if (builder.externalSpecInfo_) {
+        return Error{"compile permutations", 0,
+                     "builder uses specialize(); permutations need specConstant() values"};
+    }
+    auto* impl = static_cast<detail::PipelineCompilerImpl*>(impl_);
+    bool sharedCache = builder.cache_ == VK_NULL_HANDLE || builder.cache_ == impl->cache;
+
+    return buildPermutations(perms, [&](std::uint32_t key, VkPipelineCache threadCache) {
+        ComputePipelineBuilder b = builder;
+        perms.writeSpecialization(key, b.specEntries_, b.specData_);
+        if (sharedCache)
+            b.cache_ = threadCache;
+        return b.build();
+    });
+}
+
+Result<PermutationTable> PipelineCompiler::buildPermutations(const SpecPermutations& perms,
+                                                             const PermutationBuildFn& buildOne) {
+    if (perms.keyBits() > SpecPermutations::kMaxKeyBits) {
+        return Error{"compile permutations", 0,
+                     "permutation key needs " + std::to_string(perms.keyBits()) +
+                         " bits; the table is capped at " +
+                         std::to_string(SpecPermutations::kMaxKeyBits)};
+    }
+    auto* impl = static_cast<detail::PipelineCompilerImpl*>(impl_);
+
+    PermutationTable table;
+    table.slots_.resize(perms.tableSize());
+
+    std::vector<std::uint32_t> keys;
+    for (std::uint32_t k = 0; k < perms.tableSize(); ++k) {
+        if (perms.valid(k))
+            keys.push_back(k);
+    }
+
+    // Each task writes only its own slot; the batch state is the only
+    // shared write and is guarded by its mutex.
+    struct Batch {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::size_t remaining = 0;
+        std::optional<Error> error;
+    } batch;
+    batch.remaining = keys.size();
+
+    for (std::uint32_t key : keys) {
+        impl->enqueue({[&, key] {
+            auto start = detail::TelemetryClock::now();
+            detail::CacheLease lease(*impl);
+            auto built = buildOne(key, lease.get());
+            if (built.ok())
+                lease.compiled();
+            lease.release();
+            std::optional<Error> failure;
+            if (built.ok()) {
+                Pipeline pipeline = std::move(built).value();
+                impl->telemetry.recordBuild(pipeline, detail::TelemetryClock::now() - start);
+                auto* hi = static_cast<detail::PipelineHandleImpl*>(
+                    transferPipeline(impl->device, pipeline, true));
+                impl->track(hi, 1);
+                PipelineHandle handle;
+                handle.impl_ = hi;
+                table.slots_[key].emplace(std::move(handle));
+                impl->noteCompile();
+            } else {
+                failure = std::move(built).error();
+                failure->message += " (permutation key " + std::to_string(key) + ")";
+            }
+
+            std::lock_guard lock(batch.mutex);
+            if (failure && !batch.error)
+                batch.error = std::move(failure);
+            if (--batch.remaining == 0)
+                batch.cv.notify_one();
+        }});
+    }
+
+    {
+        // Blocks by design: permutation batches are a load-time operation.
+        std::unique_lock lock(batch.mutex);
+        batch.cv.wait(lock, [&] { return batch.remaining == 0; });
+    }
+
+    if (batch.error)
+        return std::move(*batch.error);
+
+    table.compiled_ = static_cast<std::uint32_t>(keys.size());
+    return table;
+}
+
 void PipelineCompiler::waitIdle() {
     if (!impl_)
         return;
@@ -611,6 +1196,73 @@ std::uint32_t PipelineCompiler::pendingCount() const {
     return impl->pending.load(std::memory_order_acquire);
 }
 
+void PipelineCompiler::setBinaryStore(PipelineBinaryStore* store) {
+    if (!impl_)
+        return;
+    static_cast<detail::PipelineCompilerImpl*>(impl_)->binaryStore = store;
+}
+
+void PipelineCompiler::setCacheMergeInterval(std::uint32_t compiles) {
+    if (!impl_)
+        return;
+    auto* impl = static_cast<detail::PipelineCompilerImpl*>(impl_);
+    impl->mergeInterval.store(compiles, std::memory_order_relaxed);
+}
+
+Result<void> PipelineCompiler::mergeCaches() {
+    if (!impl_)
+        return {};
+    auto* impl = static_cast<detail::PipelineCompilerImpl*>(impl_);
+    VkResult vr = impl->mergeThreadCaches();
+    if (vr != VK_SUCCESS) {
+        return Error{"merge pipeline cache", static_cast<std::int32_t>(vr),
+                     "vkMergePipelineCaches failed"};
+    }
+    return {};
+}
+
+void PipelineCompiler::setBaselineRetirement(std::uint32_t frames) {
+    if (!impl_)
+        return;
+    auto* impl = static_cast<detail::PipelineCompilerImpl*>(impl_);
+    impl->retireFrames.store(frames, std::memory_order_relaxed);
+}
+
+void PipelineCompiler::setLibraryCacheLimit(std::uint32_t maxLibraries) {
+    if (!impl_)
+        return;
+    auto* impl = static_cast<detail::PipelineCompilerImpl*>(impl_);
+    impl->maxLibraries.store(maxLibraries, std::memory_order_relaxed);
+}
+
+void PipelineCompiler::advanceFrame() {
+    if (!impl_)
+        return;
+    auto* impl = static_cast<detail::PipelineCompilerImpl*>(impl_);
+    impl->retireBaselines();
+    impl->evictLibraries();
+}
+
+PipelineCompilerStats PipelineCompiler::stats() const {
+    if (!impl_)
+        return {};
+    auto* impl = static_cast<detail::PipelineCompilerImpl*>(impl_);
+    PipelineCompilerStats s;
+    s.liveHandles = impl->counters->handles.load(std::memory_order_relaxed);
+    s.livePipelines = impl->counters->pipelines.load(std::memory_order_relaxed);
+    {
+        std::lock_guard lock(impl->retireMutex);
+        s.pendingRetirement = static_cast<std::uint32_t>(impl->retireList.size());
+    }
+    s.retiredBaselines = impl->retiredBaselines.load(std::memory_order_relaxed);
+    s.liveLibraries = impl->libraryCount();
+    s.evictedLibraries = impl->evictedLibraries.load(std::memory_order_relaxed);
+    s.threadCaches = impl->cachePool->size();
+    s.cacheMerges = impl->cacheMerges.load(std::memory_order_relaxed);
+    s.telemetry = impl->telemetry.snapshot();
+    return s;
+}
+
 PipelineModel PipelineCompiler::resolvedModel() const {
     if (!impl_)
         return PipelineModel::Monolithic;
@@ -31,21 +31,27 @@ void PipelineHandle::destroy() {
     // Signal background thread to not store into this handle, then
     // atomically grab whatever optimized pipeline was stored. This
     // closes the race where the worker stores between our flag set
-    // and our read.
+    // and our read. The baseline is exchanged too because the compiler
+    // may retire it concurrently.
     impl->destroyed.store(true, std::memory_order_release);
 
     VkPipeline opt = impl->optimized.exchange(VK_NULL_HANDLE, std::memory_order_acq_rel);
-    if (opt != VK_NULL_HANDLE && opt != impl->baseline) {
+    VkPipeline base = impl->baseline.exchange(VK_NULL_HANDLE, std::memory_order_acq_rel);
+    int destroyedCount = 0;
+    if (opt != VK_NULL_HANDLE && opt != base) {
         vkDestroyPipeline(impl->device, opt, nullptr);
+        ++destroyedCount;
     }
-    if (impl->baseline != VK_NULL_HANDLE) {
-        vkDestroyPipeline(impl->device, impl->baseline, nullptr);
-    }
-    if (impl->layout != VK_NULL_HANDLE && impl->ownsLayout) {
-        vkDestroyPipelineLayout(impl->device, impl->layout, nullptr);
+    if (base != VK_NULL_HANDLE) {
+        vkDestroyPipeline(impl->device, base, nullptr);
+        ++destroyedCount;
     }
+    detail::countPipelines(impl, -destroyedCount);
+    if (impl->counters)
+        impl->counters->handles.fetch_sub(1, std::memory_order_relaxed);
 
-    delete impl;
+    // Layout goes with the last reference (see PipelineHandleImpl).
+    detail::releaseHandle(impl);
     impl_ = nullptr;
 }
 
@@ -54,8 +60,12 @@ void PipelineHandle::bind(VkCommandBuffer cmd) const {
         return;
     auto* impl = static_cast<detail::PipelineHandleImpl*>(impl_);
     VkPipeline p = impl->optimized.load(std::memory_order_acquire);
-    if (p == VK_NULL_HANDLE)
-        p = impl->baseline;
+    if (p == VK_NULL_HANDLE) {
+        p = impl->baseline.load(std::memory_order_acquire);
+    } else if (!impl->optimizedBound.load(std::memory_order_relaxed)) {
+        // Starts the baseline's retirement window (PipelineCompiler::advanceFrame).
+        impl->optimizedBound.store(true, std::memory_order_release);
+    }
     vkCmdBindPipeline(cmd, impl->bindPoint, p);
 }
 
@@ -70,7 +80,8 @@ bool PipelineHandle::isReady() const {
     if (!impl_)
         return false;
     auto* impl = static_cast<detail::PipelineHandleImpl*>(impl_);
-    return impl->baseline != VK_NULL_HANDLE;
+    return impl->optimized.load(std::memory_order_acquire) != VK_NULL_HANDLE ||
+           impl->baseline.load(std::memory_order_acquire) != VK_NULL_HANDLE;
 }
 
 VkPipeline PipelineHandle::vkPipeline() const {
@@ -78,7 +89,7 @@ VkPipeline PipelineHandle::vkPipeline() const {
         return VK_NULL_HANDLE;
     auto* impl = static_cast<detail::PipelineHandleImpl*>(impl_);
     VkPipeline p = impl->optimized.load(std::memory_order_acquire);
-    return (p != VK_NULL_HANDLE) ? p : impl->baseline;
+    return (p != VK_NULL_HANDLE) ? p : impl->baseline.load(std::memory_order_acquire);
 }
 
 VkPipelineLayout PipelineHandle::vkPipelineLayout() const {
@@ -3,17 +3,58 @@
 #include <vulkan/vulkan.h>
 
 #include <atomic>
+#include <cstdint>
+#include <memory>
 
 namespace vksdl::detail {
 
+// Shared between a PipelineCompiler and every handle it produced, so handle
+// statistics stay valid when handles outlive the compiler.
+struct PipelineLiveCounters {
+    std::atomic<std::uint32_t> handles{0};
+    std::atomic<std::uint32_t> pipelines{0}; // VkPipelines owned by live handles
+};
+
+// Reference counted: the PipelineHandle owns one reference, background
+// optimization tasks and the compiler's retirement list hold one each while
+// they need the impl. Pipelines are destroyed by PipelineHandle::destroy() or
+// retirement; the layout is destroyed with the last reference because an
+// in-flight optimize task may still be linking against it.
 struct PipelineHandleImpl {
     VkDevice device = VK_NULL_HANDLE;
-    VkPipeline baseline = VK_NULL_HANDLE;
+    std::atomic<VkPipeline> baseline = VK_NULL_HANDLE; // null once retired
     std::atomic<VkPipeline> optimized = VK_NULL_HANDLE;
     VkPipelineLayout layout = VK_NULL_HANDLE;
     bool ownsLayout = true;
     VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-    std::atomic<bool> destroyed = false; // set before delete, checked by bg thread
+    std::atomic<bool> destroyed = false;      // set before release, checked by bg thread
+    std::atomic<bool> optimizedBound = false; // bind() has used the optimized pipeline
+    std::atomic<std::uint32_t> refs{1};
+    std::shared_ptr<PipelineLiveCounters> counters; // null for untracked handles
 };
 
+inline void retainHandle(PipelineHandleImpl* h) {
+    h->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void releaseHandle(PipelineHandleImpl* h) {
+    if (h->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+    if (h->layout != VK_NULL_HANDLE && h->ownsLayout)
+        vkDestroyPipelineLayout(h->device, h->layout, nullptr);
+    delete h;
+}
+
+// Adjust the owned-pipeline count after creating (+n) or destroying (-n).
+inline void countPipelines(PipelineHandleImpl* h, int delta) {
+    if (!h->counters)
+        return;
+    if (delta >= 0)
+        h->counters->pipelines.fetch_add(static_cast<std::uint32_t>(delta),
+                                         std::memory_order_relaxed);
+    else
+        h->counters->pipelines.fetch_sub(static_cast<std::uint32_t>(-delta),
+                                         std::memory_order_relaxed);
+}
+
 } // namespace vksdl::detail
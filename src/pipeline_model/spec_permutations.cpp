@@ -0,0 +1,112 @@
+#include <vksdl/pipeline_model/spec_permutations.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace vksdl {
+
+SpecPermutations& SpecPermutations::boolean(std::uint32_t constantId) {
+    return add(constantId, {VK_FALSE, VK_TRUE});
+}
+
+SpecPermutations& SpecPermutations::values(std::uint32_t constantId,
+                                           std::vector<std::uint32_t> values) {
+    return add(constantId, std::move(values));
+}
+
+SpecPermutations& SpecPermutations::add(std::uint32_t constantId,
+                                        std::vector<std::uint32_t> values) {
+    Domain d;
+    d.constantId = constantId;
+    d.values = std::move(values);
+    d.shift = keyBits_;
+    while ((std::size_t{1} << d.bits) < d.values.size())
+        ++d.bits;
+    keyBits_ += d.bits;
+    domains_.push_back(std::move(d));
+    return *this;
+}
+
+SpecPermutations& SpecPermutations::filter(std::function<bool(std::uint32_t key)> accept) {
+    filter_ = std::move(accept);
+    return *this;
+}
+
+std::uint32_t SpecPermutations::tableSize() const {
+    if (keyBits_ > kMaxKeyBits)
+        return 0;
+    return 1u << keyBits_;
+}
+
+std::uint32_t SpecPermutations::shift(std::uint32_t domain) const {
+    return domain < domains_.size() ? domains_[domain].shift : 0;
+}
+
+std::uint32_t SpecPermutations::key(std::initializer_list<std::uint32_t> choices) const {
+    std::uint32_t k = 0;
+    std::uint32_t i = 0;
+    for (std::uint32_t c : choices) {
+        if (i >= domains_.size())
+            break;
+        k |= c << domains_[i].shift;
+        ++i;
+    }
+    return k;
+}
+
+std::uint32_t SpecPermutations::choice(std::uint32_t key, std::uint32_t domain) const {
+    if (domain >= domains_.size())
+        return 0;
+    const Domain& d = domains_[domain];
+    return (key >> d.shift) & ((1u << d.bits) - 1u);
+}
+
+bool SpecPermutations::valid(std::uint32_t key) const {
+    if (key >= tableSize())
+        return false;
+    for (std::uint32_t i = 0; i < domains_.size(); ++i) {
+        if (domains_[i].values.empty() || choice(key, i) >= domains_[i].values.size())
+            return false;
+    }
+    return !filter_ || filter_(key);
+}
+
+std::uint32_t SpecPermutations::permutationCount() const {
+    std::uint32_t n = 0;
+    for (std::uint32_t k = 0; k < tableSize(); ++k) {
+        if (valid(k))
+            ++n;
+    }
+    return n;
+}
+
+void SpecPermutations::writeSpecialization(std::uint32_t key,
+                                           std::vector<VkSpecializationMapEntry>& entries,
+                                           std::vector<std::uint8_t>& data) const {
+    // Duplicate constant IDs in one VkSpecializationInfo are invalid, so
+    // permutation constants replace same-ID entries from the base builder.
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [&](const VkSpecializationMapEntry& e) {
+                                     for (const auto& d : domains_) {
+                                         if (d.constantId == e.constantID)
+                                             return true;
+                                     }
+                                     return false;
+                                 }),
+                  entries.end());
+
+    for (std::uint32_t i = 0; i < domains_.size(); ++i) {
+        std::uint32_t value = domains_[i].values[choice(key, i)];
+        VkSpecializationMapEntry e{};
+        e.constantID = domains_[i].constantId;
+        e.offset = static_cast<std::uint32_t>(data.size());
+        e.size = sizeof(value);
+        entries.push_back(e);
+        std::uint8_t bytes[sizeof(value)];
+        std::memcpy(bytes, &value, sizeof(value));
+        data.insert(data.end(), bytes, bytes + sizeof(value));
+    }
+}
+
+} // namespace vksdl
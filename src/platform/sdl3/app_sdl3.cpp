@@ -9,8 +9,9 @@ namespace vksdl {
 
 class AppImpl {
   public:
-    std::vector<Window*> windows; // non-owning, for event routing
-    bool pumped = false;          // true after pumpEvents(), reset by resetPump()
+    std::vector<Window*> windows;       // non-owning, for event routing
+    bool pumped = false;                // true after pumpEvents(), reset by resetPump()
+    std::uint32_t threadedCapacity = 0; // per-window ring size; 0 = threaded input off
 };
 
 Result<App> App::create() {
@@ -48,106 +49,141 @@ Result<Window> App::createWindow(std::string_view title, std::uint32_t width,
     impl->sdlWindow = sdlWin;
     impl->windowId = SDL_GetWindowID(sdlWin);
 
+    int pw = 0, ph = 0;
+    SDL_GetWindowSizeInPixels(sdlWin, &pw, &ph);
+    impl->storePixelSize(static_cast<std::uint32_t>(pw), static_cast<std::uint32_t>(ph));
+
     return Window(std::move(impl), this);
 }
 
 void App::pumpEvents() {
-    if (impl_->pumped)
+    // Threaded input drains continuously; the once-per-frame gate only
+    // exists for the pollEvent()-driven path.
+    if (impl_->threadedCapacity == 0) {
+        if (impl_->pumped)
+            return;
+        impl_->pumped = true;
+    }
+    drainEvents(false, 0);
+}
+
+void App::waitEvents(std::uint32_t timeoutMs) {
+    drainEvents(true, timeoutMs);
+}
+
+void App::enableThreadedInput(std::uint32_t capacity) {
+    if (impl_->threadedCapacity != 0)
         return;
-    impl_->pumped = true;
+    impl_->threadedCapacity = capacity == 0 ? 1 : capacity;
+    for (auto* w : impl_->windows)
+        attachThreadedQueue(w);
+}
+
+bool App::threadedInput() const {
+    return impl_ && impl_->threadedCapacity != 0;
+}
 
+void App::attachThreadedQueue(Window* w) {
+    auto& wi = *w->impl_;
+    if (wi.threadedEvents)
+        return;
+    wi.threadedEvents = std::make_unique<detail::SpscQueue<Event>>(impl_->threadedCapacity);
+    // Events queued before the switch move over so none are lost.
+    while (!wi.events.empty()) {
+        wi.push(wi.events.front());
+        wi.events.pop();
+    }
+}
+
+void App::drainEvents(bool wait, std::uint32_t timeoutMs) {
     SDL_Event sdlEvent;
-    while (SDL_PollEvent(&sdlEvent)) {
+
+    auto deliver = [&](SDL_WindowID id, Event e) {
+        e.timestampNs = sdlEvent.common.timestamp;
+        for (auto* w : impl_->windows) {
+            if (w->windowId() == id)
+                w->impl_->push(e);
+        }
+    };
+
+    auto route = [&] {
         switch (sdlEvent.type) {
         case SDL_EVENT_QUIT:
             for (auto* w : impl_->windows) {
                 Event e{};
                 e.type = EventType::Quit;
-                w->impl_->events.push(e);
+                e.timestampNs = sdlEvent.common.timestamp;
+                w->impl_->push(e);
             }
             break;
 
-        case SDL_EVENT_WINDOW_CLOSE_REQUESTED:
-            for (auto* w : impl_->windows) {
-                if (w->windowId() == sdlEvent.window.windowID) {
-                    Event e{};
-                    e.type = EventType::CloseRequested;
-                    w->impl_->events.push(e);
-                }
-            }
+        case SDL_EVENT_WINDOW_CLOSE_REQUESTED: {
+            Event e{};
+            e.type = EventType::CloseRequested;
+            deliver(sdlEvent.window.windowID, e);
             break;
+        }
 
         case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED:
-            for (auto* w : impl_->windows) {
-                if (w->windowId() == sdlEvent.window.windowID && sdlEvent.window.data1 > 0 &&
-                    sdlEvent.window.data2 > 0) {
-                    Event e{};
-                    e.type = EventType::Resized;
-                    e.size.width = static_cast<std::uint32_t>(sdlEvent.window.data1);
-                    e.size.height = static_cast<std::uint32_t>(sdlEvent.window.data2);
-                    w->impl_->events.push(e);
-                    w->impl_->resized = true;
+            if (sdlEvent.window.data1 > 0 && sdlEvent.window.data2 > 0) {
+                Event e{};
+                e.type = EventType::Resized;
+                e.size.width = static_cast<std::uint32_t>(sdlEvent.window.data1);
+                e.size.height = static_cast<std::uint32_t>(sdlEvent.window.data2);
+                for (auto* w : impl_->windows) {
+                    if (w->windowId() == sdlEvent.window.windowID) {
+                        w->impl_->storePixelSize(e.size.width, e.size.height);
+                        w->impl_->resized.store(true, std::memory_order_release);
+                    }
                 }
+                deliver(sdlEvent.window.windowID, e);
             }
             break;
 
         case SDL_EVENT_KEY_DOWN:
-            for (auto* w : impl_->windows) {
-                if (w->windowId() == sdlEvent.key.windowID) {
-                    Event e{};
-                    e.type = EventType::KeyDown;
-                    e.key = static_cast<int>(sdlEvent.key.scancode);
-                    e.keyCode = keyFromScancode(e.key);
-                    w->impl_->events.push(e);
-                }
-            }
-            break;
-
-        case SDL_EVENT_KEY_UP:
-            for (auto* w : impl_->windows) {
-                if (w->windowId() == sdlEvent.key.windowID) {
-                    Event e{};
-                    e.type = EventType::KeyUp;
-                    e.key = static_cast<int>(sdlEvent.key.scancode);
-                    e.keyCode = keyFromScancode(e.key);
-                    w->impl_->events.push(e);
-                }
-            }
+        case SDL_EVENT_KEY_UP: {
+            Event e{};
+            e.type = sdlEvent.type == SDL_EVENT_KEY_DOWN ? EventType::KeyDown : EventType::KeyUp;
+            e.key = static_cast<int>(sdlEvent.key.scancode);
+            e.keyCode = keyFromScancode(e.key);
+            deliver(sdlEvent.key.windowID, e);
             break;
+        }
 
-        case SDL_EVENT_MOUSE_WHEEL:
-            for (auto* w : impl_->windows) {
-                if (w->windowId() == sdlEvent.wheel.windowID) {
-                    Event e{};
-                    e.type = EventType::MouseWheel;
-                    e.scroll = sdlEvent.wheel.y;
-                    w->impl_->events.push(e);
-                }
-            }
+        case SDL_EVENT_MOUSE_WHEEL: {
+            Event e{};
+            e.type = EventType::MouseWheel;
+            e.scroll = sdlEvent.wheel.y;
+            deliver(sdlEvent.wheel.windowID, e);
             break;
+        }
 
-        case SDL_EVENT_MOUSE_BUTTON_DOWN:
-            for (auto* w : impl_->windows) {
-                if (w->windowId() == sdlEvent.button.windowID) {
-                    Event e{};
-                    e.type = EventType::MouseButtonDown;
-                    e.button = static_cast<int>(sdlEvent.button.button);
-                    e.clicks = static_cast<int>(sdlEvent.button.clicks);
-                    e.mouseX = sdlEvent.button.x;
-                    e.mouseY = sdlEvent.button.y;
-                    w->impl_->events.push(e);
-                }
-            }
+        case SDL_EVENT_MOUSE_BUTTON_DOWN: {
+            Event e{};
+            e.type = EventType::MouseButtonDown;
+            e.button = static_cast<int>(sdlEvent.button.button);
+            e.clicks = static_cast<int>(sdlEvent.button.clicks);
+            e.mouseX = sdlEvent.button.x;
+            e.mouseY = sdlEvent.button.y;
+            deliver(sdlEvent.button.windowID, e);
             break;
+        }
 
         default:
             break;
         }
-    }
+    };
+
+    if (wait && SDL_WaitEventTimeout(&sdlEvent, static_cast<Sint32>(timeoutMs)))
+        route();
+    while (SDL_PollEvent(&sdlEvent))
+        route();
 }
 
 void App::registerWindow(Window* w) {
     impl_->windows.push_back(w);
+    if (impl_->threadedCapacity != 0)
+        attachThreadedQueue(w);
 }
 
 void App::unregisterWindow(Window* w) {
@@ -0,0 +1,67 @@
+#pragma once
+
+// Internal header -- bounded lock-free queue behind threaded input.
+// Not part of the public API.
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace vksdl::detail {
+
+// Bounded single-producer / single-consumer ring. tryPush() is called from
+// one thread and tryPop() from one (other) thread; neither blocks or
+// allocates. Indices grow monotonically and wrap through the power-of-two
+// mask. Each side caches the other side's index so the common case touches
+// only its own cache line.
+template <typename T> class SpscQueue {
+  public:
+    explicit SpscQueue(std::uint32_t capacity)
+        : slots_(std::bit_ceil(std::max<std::uint32_t>(capacity, 2))), mask_(slots_.size() - 1) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side. False when the ring is full.
+    bool tryPush(const T& value) {
+        std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - headCache_ == slots_.size()) {
+            headCache_ = head_.load(std::memory_order_acquire);
+            if (tail - headCache_ == slots_.size())
+                return false;
+        }
+        slots_[tail & mask_] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. False when the ring is empty.
+    bool tryPop(T& out) {
+        std::uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head == tailCache_) {
+            tailCache_ = tail_.load(std::memory_order_acquire);
+            if (head == tailCache_)
+                return false;
+        }
+        out = slots_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]] std::size_t capacity() const {
+        return slots_.size();
+    }
+
+  private:
+    std::vector<T> slots_;
+    std::size_t mask_;
+
+    alignas(64) std::atomic<std::uint64_t> head_{0}; // written by the consumer
+    std::uint64_t tailCache_ = 0;                    // consumer's view of tail_
+    alignas(64) std::atomic<std::uint64_t> tail_{0}; // written by the producer
+    std::uint64_t headCache_ = 0;                    // producer's view of head_
+};
+
+} // namespace vksdl::detail
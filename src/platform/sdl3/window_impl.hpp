@@ -3,11 +3,16 @@
 // Internal header -- shared between app_sdl3.cpp and window_sdl3.cpp.
 // Not part of the public API.
 
+#include "spsc_queue.hpp"
 #include <vksdl/window.hpp>
 
 #include <SDL3/SDL.h>
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <queue>
+#include <utility>
 
 namespace vksdl {
 
@@ -15,8 +20,63 @@ class WindowImpl {
   public:
     SDL_Window* sdlWindow = nullptr;
     SDL_WindowID windowId = 0;
-    bool resized = false;
+    std::atomic<bool> resized{false};
     std::queue<Event> events;
+
+    // Threaded input (App::enableThreadedInput()): the App thread produces,
+    // the thread calling Window::pollEvent() consumes. Null otherwise.
+    std::unique_ptr<detail::SpscQueue<Event>> threadedEvents;
+    std::atomic<std::uint64_t> dropped{0};
+    // Quit and CloseRequested are never dropped: one that finds the ring
+    // full parks its timestamp here (0 = none, so stored as at least 1) and
+    // pollEvent() delivers it once the ring is drained.
+    std::atomic<std::uint64_t> pendingQuitNs{0};
+    std::atomic<std::uint64_t> pendingCloseNs{0};
+
+    // Last known pixel size, kept current by the App thread so pixelSize()
+    // does not call into SDL from a render thread. Width and height share one
+    // word so a reader never pairs the width of one resize with the height of
+    // another.
+    std::atomic<std::uint64_t> pixelSize{0};
+
+    void storePixelSize(std::uint32_t width, std::uint32_t height) {
+        pixelSize.store((static_cast<std::uint64_t>(width) << 32) | height,
+                        std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] Size loadPixelSize() const {
+        const std::uint64_t packed = pixelSize.load(std::memory_order_relaxed);
+        return Size{static_cast<std::uint32_t>(packed >> 32),
+                    static_cast<std::uint32_t>(packed)};
+    }
+
+    void push(const Event& e) {
+        if (!threadedEvents) {
+            events.push(e);
+        } else if (!threadedEvents->tryPush(e)) {
+            const std::uint64_t ts = e.timestampNs != 0 ? e.timestampNs : 1;
+            if (e.type == EventType::Quit)
+                pendingQuitNs.store(ts, std::memory_order_release);
+            else if (e.type == EventType::CloseRequested)
+                pendingCloseNs.store(ts, std::memory_order_release);
+            else
+                dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Consumer side: a parked Quit/CloseRequested, if any.
+    bool popPending(Event& event) {
+        for (auto [slot, type] : {std::pair{&pendingQuitNs, EventType::Quit},
+                                  std::pair{&pendingCloseNs, EventType::CloseRequested}}) {
+            if (std::uint64_t ts = slot->exchange(0, std::memory_order_acquire); ts != 0) {
+                event = Event{};
+                event.type = type;
+                event.timestampNs = ts;
+                return true;
+            }
+        }
+        return false;
+    }
 };
 
 } // namespace vksdl
@@ -100,6 +100,10 @@ int scancodeFromKey(Key key) {
     return 0;
 }
 
+std::uint64_t eventClockNs() {
+    return SDL_GetTicksNS();
+}
+
 Window::Window(std::unique_ptr<WindowImpl> impl, App* app) : impl_(std::move(impl)), app_(app) {
     if (app_)
         app_->registerWindow(this);
@@ -147,6 +151,14 @@ bool Window::pollEvent(Event& event) {
         return false;
     }
 
+    // Threaded input: the App thread is the only producer; never pump here.
+    if (impl_->threadedEvents) {
+        if (impl_->threadedEvents->tryPop(event) || impl_->popPending(event))
+            return true;
+        event.type = EventType::None;
+        return false;
+    }
+
     // Pump once when the queue is empty (start of a new frame).
     // While draining queued events, skip re-pumping.
     if (impl_->events.empty() && app_) {
@@ -167,15 +179,20 @@ bool Window::pollEvent(Event& event) {
 }
 
 Size Window::pixelSize() const {
+    if (impl_->threadedEvents) {
+        return impl_->loadPixelSize();
+    }
     int w = 0, h = 0;
     SDL_GetWindowSizeInPixels(impl_->sdlWindow, &w, &h);
     return Size{static_cast<std::uint32_t>(w), static_cast<std::uint32_t>(h)};
 }
 
 bool Window::consumeResize() {
-    bool r = impl_->resized;
-    impl_->resized = false;
-    return r;
+    return impl_->resized.exchange(false, std::memory_order_acquire);
+}
+
+std::uint64_t Window::droppedEvents() const {
+    return impl_->dropped.load(std::memory_order_relaxed);
 }
 
 Result<void> Window::setTitle(std::string_view title) {
@@ -32,10 +32,14 @@ Allocator::~Allocator() {
 }
 
 Allocator::Allocator(Allocator&& o) noexcept
-    : allocator_(o.allocator_), device_(o.device_), hasMemoryBudget_(o.hasMemoryBudget_) {
+    : allocator_(o.allocator_), device_(o.device_), hasMemoryBudget_(o.hasMemoryBudget_),
+      largeBarHeap_(o.largeBarHeap_), largeBarHeapSize_(o.largeBarHeapSize_),
+      directPolicy_(o.directPolicy_) {
     o.allocator_ = nullptr;
     o.device_ = VK_NULL_HANDLE;
     o.hasMemoryBudget_ = false;
+    o.largeBarHeap_ = UINT32_MAX;
+    o.largeBarHeapSize_ = 0;
 }
 
 Allocator& Allocator::operator=(Allocator&& o) noexcept {
@@ -46,9 +50,14 @@ Allocator& Allocator::operator=(Allocator&& o) noexcept {
         allocator_ = o.allocator_;
         device_ = o.device_;
         hasMemoryBudget_ = o.hasMemoryBudget_;
+        largeBarHeap_ = o.largeBarHeap_;
+        largeBarHeapSize_ = o.largeBarHeapSize_;
+        directPolicy_ = o.directPolicy_;
         o.allocator_ = nullptr;
         o.device_ = VK_NULL_HANDLE;
         o.hasMemoryBudget_ = false;
+        o.largeBarHeap_ = UINT32_MAX;
+        o.largeBarHeapSize_ = 0;
     }
     return *this;
 }
@@ -82,9 +91,37 @@ Result<Allocator> Allocator::create(const Instance& instance, const Device& devi
                      "vmaCreateAllocator failed"};
     }
 
+    // Largest heap with a DEVICE_LOCAL | HOST_VISIBLE type. Without ReBAR it
+    // is the 256 MiB BAR window, which is not worth spending on uploads.
+    constexpr VkMemoryPropertyFlags kBarFlags =
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+    constexpr VkDeviceSize kBarWindow = 256ull << 20;
+    VkPhysicalDeviceMemoryProperties memProps{};
+    vkGetPhysicalDeviceMemoryProperties(device.vkPhysicalDevice(), &memProps);
+    for (std::uint32_t t = 0; t < memProps.memoryTypeCount; ++t) {
+        if ((memProps.memoryTypes[t].propertyFlags & kBarFlags) != kBarFlags)
+            continue;
+        std::uint32_t heap = memProps.memoryTypes[t].heapIndex;
+        VkDeviceSize size = memProps.memoryHeaps[heap].size;
+        if (size > kBarWindow && size > a.largeBarHeapSize_) {
+            a.largeBarHeap_ = heap;
+            a.largeBarHeapSize_ = size;
+        }
+    }
+
     return a;
 }
 
+bool Allocator::preferDirectUpload(VkDeviceSize bytes) const {
+    if (!directPolicy_.enabled || largeBarHeap_ == UINT32_MAX || bytes > directPolicy_.maxBytes)
+        return false;
+    VmaBudget budgets[VK_MAX_MEMORY_HEAPS] = {};
+    vmaGetHeapBudgets(allocator_, budgets);
+    const VmaBudget& heap = budgets[largeBarHeap_];
+    auto limit = static_cast<double>(heap.budget) * directPolicy_.maxBudgetFraction;
+    return static_cast<double>(heap.usage + bytes) <= limit;
+}
+
 std::vector<HeapBudget> Allocator::queryBudget() const {
     VkPhysicalDeviceMemoryProperties memProps{};
     vkGetPhysicalDeviceMemoryProperties(
@@ -1,6 +1,7 @@
 #include <vksdl/allocator.hpp>
 #include <vksdl/buffer.hpp>
 #include <vksdl/device.hpp>
+#include <vksdl/mapped_writes.hpp>
 
 #if defined(_MSC_VER)
 #pragma warning(push)
@@ -20,8 +21,6 @@
 #pragma GCC diagnostic pop
 #endif
 
-#include <cstring>
-
 namespace vksdl {
 
 Buffer::~Buffer() {
@@ -32,13 +31,14 @@ Buffer::~Buffer() {
 
 Buffer::Buffer(Buffer&& o) noexcept
     : device_(o.device_), allocator_(o.allocator_), buffer_(o.buffer_), allocation_(o.allocation_),
-      size_(o.size_), mapped_(o.mapped_) {
+      size_(o.size_), mapped_(o.mapped_), hostCoherent_(o.hostCoherent_) {
     o.device_ = VK_NULL_HANDLE;
     o.allocator_ = nullptr;
     o.buffer_ = VK_NULL_HANDLE;
     o.allocation_ = nullptr;
     o.size_ = 0;
     o.mapped_ = nullptr;
+    o.hostCoherent_ = false;
 }
 
 Buffer& Buffer::operator=(Buffer&& o) noexcept {
@@ -52,12 +52,14 @@ Buffer& Buffer::operator=(Buffer&& o) noexcept {
         allocation_ = o.allocation_;
         size_ = o.size_;
         mapped_ = o.mapped_;
+        hostCoherent_ = o.hostCoherent_;
         o.device_ = VK_NULL_HANDLE;
         o.allocator_ = nullptr;
         o.buffer_ = VK_NULL_HANDLE;
         o.allocation_ = nullptr;
         o.size_ = 0;
         o.mapped_ = nullptr;
+        o.hostCoherent_ = false;
     }
     return *this;
 }
@@ -69,6 +71,27 @@ VkDeviceAddress Buffer::deviceAddress() const {
     return vkGetBufferDeviceAddress(device_, &info);
 }
 
+Result<void> Buffer::flush(VkDeviceSize offset, VkDeviceSize size) const {
+    if (mapped_ == nullptr || hostCoherent_)
+        return {};
+    VkResult vr = vmaFlushAllocation(allocator_, allocation_, offset, size);
+    if (vr != VK_SUCCESS) {
+        return Error{"flush buffer", static_cast<std::int32_t>(vr), "vmaFlushAllocation failed"};
+    }
+    return {};
+}
+
+Result<void> Buffer::invalidate(VkDeviceSize offset, VkDeviceSize size) const {
+    if (mapped_ == nullptr || hostCoherent_)
+        return {};
+    VkResult vr = vmaInvalidateAllocation(allocator_, allocation_, offset, size);
+    if (vr != VK_SUCCESS) {
+        return Error{"invalidate buffer", static_cast<std::int32_t>(vr),
+                     "vmaInvalidateAllocation failed"};
+    }
+    return {};
+}
+
 BufferBuilder::BufferBuilder(const Allocator& allocator)
     : allocator_(allocator.vmaAllocator()), device_(allocator.vkDevice()) {}
 
@@ -153,6 +176,16 @@ BufferBuilder& BufferBuilder::mapped() {
     return *this;
 }
 
+BufferBuilder& BufferBuilder::directUpload() {
+    directUpload_ = true;
+    return *this;
+}
+
+BufferBuilder& BufferBuilder::readback() {
+    readback_ = true;
+    return *this;
+}
+
 BufferBuilder& BufferBuilder::memoryPriority(float p) {
     priority_ = p;
     return *this;
@@ -179,6 +212,17 @@ Result<Buffer> BufferBuilder::build() {
     if (mapped_) {
         allocCI.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
                         VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    } else if (directUpload_) {
+        // VMA's "advanced data uploading" pattern: host-visible device-local
+        // memory when it exists, plain device-local (unmapped) otherwise.
+        allocCI.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+                        VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT |
+                        VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        bufCI.usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    } else if (readback_) {
+        allocCI.flags =
+            VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        bufCI.usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
     }
 
     Buffer buf;
@@ -193,8 +237,11 @@ Result<Buffer> BufferBuilder::build() {
         return Error{"create buffer", static_cast<std::int32_t>(vr), "vmaCreateBuffer failed"};
     }
 
-    if (mapped_) {
+    if ((mapped_ || directUpload_ || readback_) && allocInfo.pMappedData != nullptr) {
         buf.mapped_ = allocInfo.pMappedData;
+        VkMemoryPropertyFlags props = 0;
+        vmaGetAllocationMemoryProperties(allocator_, buf.allocation_, &props);
+        buf.hostCoherent_ = (props & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
     }
 
     return buf;
@@ -203,6 +250,12 @@ Result<Buffer> BufferBuilder::build() {
 Result<void> uploadToBuffer(const Allocator& allocator, const Device& device, const Buffer& dst,
                             const void* data, VkDeviceSize size) {
 
+    // Host-mapped destination (ReBAR, UMA, mapped()): no staging, no GPU copy.
+    if (dst.mappedData() != nullptr) {
+        streamingCopy(dst.mappedData(), data, static_cast<std::size_t>(size));
+        return dst.flush(0, size);
+    }
+
     VkBufferCreateInfo stagingCI{};
     stagingCI.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
     stagingCI.size = size;
@@ -224,7 +277,14 @@ Result<void> uploadToBuffer(const Allocator& allocator, const Device& device, co
                      "failed to create staging buffer"};
     }
 
-    std::memcpy(stagingInfo.pMappedData, data, static_cast<std::size_t>(size));
+    streamingCopy(stagingInfo.pMappedData, data, static_cast<std::size_t>(size));
+    // No-op for HOST_COHERENT memory.
+    vr = vmaFlushAllocation(allocator.vmaAllocator(), stagingAlloc, 0, VK_WHOLE_SIZE);
+    if (vr != VK_SUCCESS) {
+        vmaDestroyBuffer(allocator.vmaAllocator(), stagingBuf, stagingAlloc);
+        return Error{"upload to buffer", static_cast<std::int32_t>(vr),
+                     "failed to flush staging buffer"};
+    }
 
     VkCommandPoolCreateInfo poolCI{};
     poolCI.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -286,66 +346,56 @@ Result<void> uploadToBuffer(const Allocator& allocator, const Device& device, co
     return {};
 }
 
-Result<Buffer> uploadBuffer(const Allocator& allocator, const Device& device,
-                            VkBufferUsageFlags usage, const void* data, VkDeviceSize size) {
-
-    // Ensure the buffer can receive a transfer.
-    usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-
-    auto buf = BufferBuilder(allocator).usage(usage).size(size).build();
-
+// Builds the buffer `builder` describes -- directly writable when the
+// allocator's policy allows it -- and fills it.
+static Result<Buffer> buildAndUpload(const Allocator& allocator, const Device& device,
+                                     BufferBuilder& builder, const void* data,
+                                     VkDeviceSize size) {
+    if (allocator.preferDirectUpload(size))
+        builder.directUpload();
+    auto buf = builder.size(size).build();
     if (!buf.ok())
         return buf.error();
-
-    auto uploadRes = uploadToBuffer(allocator, device, buf.value(), data, size);
-    if (!uploadRes.ok())
-        return uploadRes.error();
-
+    auto r = uploadToBuffer(allocator, device, buf.value(), data, size);
+    if (!r.ok())
+        return r.error();
     return buf;
 }
 
+Result<Buffer> uploadBuffer(const Allocator& allocator, const Device& device,
+                            VkBufferUsageFlags usage, const void* data, VkDeviceSize size) {
+    BufferBuilder builder(allocator);
+    // Ensure the buffer can receive a transfer.
+    builder.usage(usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    return buildAndUpload(allocator, device, builder, data, size);
+}
+
 Result<Buffer> uploadVertexBuffer(const Allocator& allocator, const Device& device,
                                   const void* data, VkDeviceSize size) {
-    auto buf = BufferBuilder(allocator).vertexBuffer().size(size).build();
-    if (!buf.ok())
-        return buf.error();
-    auto r = uploadToBuffer(allocator, device, buf.value(), data, size);
-    if (!r.ok())
-        return r.error();
-    return buf;
+    BufferBuilder builder(allocator);
+    builder.vertexBuffer();
+    return buildAndUpload(allocator, device, builder, data, size);
 }
 
 Result<Buffer> uploadIndexBuffer(const Allocator& allocator, const Device& device, const void* data,
                                  VkDeviceSize size) {
-    auto buf = BufferBuilder(allocator).indexBuffer().size(size).build();
-    if (!buf.ok())
-        return buf.error();
-    auto r = uploadToBuffer(allocator, device, buf.value(), data, size);
-    if (!r.ok())
-        return r.error();
-    return buf;
+    BufferBuilder builder(allocator);
+    builder.indexBuffer();
+    return buildAndUpload(allocator, device, builder, data, size);
 }
 
 Result<Buffer> uploadStorageBuffer(const Allocator& allocator, const Device& device,
                                    const void* data, VkDeviceSize size) {
-    auto buf = BufferBuilder(allocator).storageBuffer().size(size).build();
-    if (!buf.ok())
-        return buf.error();
-    auto r = uploadToBuffer(allocator, device, buf.value(), data, size);
-    if (!r.ok())
-        return r.error();
-    return buf;
+    BufferBuilder builder(allocator);
+    builder.storageBuffer();
+    return buildAndUpload(allocator, device, builder, data, size);
 }
 
 Result<Buffer> uploadIndirectBuffer(const Allocator& allocator, const Device& device,
                                     const void* data, VkDeviceSize size) {
-    auto buf = BufferBuilder(allocator).indirectBuffer().size(size).build();
-    if (!buf.ok())
-        return buf.error();
-    auto r = uploadToBuffer(allocator, device, buf.value(), data, size);
-    if (!r.ok())
-        return r.error();
-    return buf;
+    BufferBuilder builder(allocator);
+    builder.indirectBuffer();
+    return buildAndUpload(allocator, device, builder, data, size);
 }
 
 } // namespace vksdl
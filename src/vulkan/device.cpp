@@ -2,12 +2,15 @@
 #include <vksdl/instance.hpp>
 #include <vksdl/surface.hpp>
 
+#include "device_caps.hpp"
+
 #include <algorithm>
 #include <cinttypes>
 #include <cstdio>
 #include <cstring>
 #include <set>
 #include <string>
+#include <system_error>
 #include <vector>
 
 namespace vksdl {
@@ -23,13 +26,16 @@ Device::Device(Device&& o) noexcept
       presentQueue_(o.presentQueue_), transferQueue_(o.transferQueue_),
       computeQueue_(o.computeQueue_), families_(o.families_), minUboAlignment_(o.minUboAlignment_),
       maxMsaaSamples_(o.maxMsaaSamples_), timestampPeriod_(o.timestampPeriod_),
-      gpuName_(std::move(o.gpuName_)), hasDeviceFault_(o.hasDeviceFault_),
+      gpuName_(std::move(o.gpuName_)), capabilitiesCached_(o.capabilitiesCached_),
+      hasDeviceFault_(o.hasDeviceFault_),
       hasMemoryBudget_(o.hasMemoryBudget_), hasMemoryPriority_(o.hasMemoryPriority_),
       hasUnifiedLayouts_(o.hasUnifiedLayouts_), hasGPL_(o.hasGPL_),
       hasGplFastLinking_(o.hasGplFastLinking_), hasGplIndepInterp_(o.hasGplIndepInterp_),
       hasPCCC_(o.hasPCCC_), hasPushDescriptors_(o.hasPushDescriptors_),
       hasBindless_(o.hasBindless_), hasInvocationReorder_(o.hasInvocationReorder_),
-      hasPipelineBinary_(o.hasPipelineBinary_), hasMeshShaders_(o.hasMeshShaders_),
+      hasPipelineBinary_(o.hasPipelineBinary_), eds3_(o.eds3_), hasMeshShaders_(o.hasMeshShaders_),
+      hasSparseResidency_(o.hasSparseResidency_),
+      hasShaderResourceResidency_(o.hasShaderResourceResidency_), hasMultiview_(o.hasMultiview_),
       hasPresentTiming_(o.hasPresentTiming_), hasGoogleDisplayTiming_(o.hasGoogleDisplayTiming_),
       hasExtPresentTiming_(o.hasExtPresentTiming_), deviceLost_(o.deviceLost_),
       deviceLostCallback_(std::move(o.deviceLostCallback_)), pfnTraceRays_(o.pfnTraceRays_),
@@ -63,6 +69,7 @@ Device& Device::operator=(Device&& o) noexcept {
         maxMsaaSamples_ = o.maxMsaaSamples_;
         timestampPeriod_ = o.timestampPeriod_;
         gpuName_ = std::move(o.gpuName_);
+        capabilitiesCached_ = o.capabilitiesCached_;
         hasDeviceFault_ = o.hasDeviceFault_;
         hasMemoryBudget_ = o.hasMemoryBudget_;
         hasMemoryPriority_ = o.hasMemoryPriority_;
@@ -75,7 +82,11 @@ Device& Device::operator=(Device&& o) noexcept {
         hasBindless_ = o.hasBindless_;
         hasInvocationReorder_ = o.hasInvocationReorder_;
         hasPipelineBinary_ = o.hasPipelineBinary_;
+        eds3_ = o.eds3_;
         hasMeshShaders_ = o.hasMeshShaders_;
+        hasSparseResidency_ = o.hasSparseResidency_;
+        hasShaderResourceResidency_ = o.hasShaderResourceResidency_;
+        hasMultiview_ = o.hasMultiview_;
         hasPresentTiming_ = o.hasPresentTiming_;
         hasGoogleDisplayTiming_ = o.hasGoogleDisplayTiming_;
         hasExtPresentTiming_ = o.hasExtPresentTiming_;
@@ -220,6 +231,13 @@ DeviceBuilder& DeviceBuilder::needAsyncCompute() {
     return *this;
 }
 
+DeviceBuilder& DeviceBuilder::needSparseResidency() {
+    // Core features, enabled in build(); scoreDevice() rejects GPUs without
+    // them or whose graphics family cannot run vkQueueBindSparse.
+    needSparseResidency_ = true;
+    return *this;
+}
+
 DeviceBuilder& DeviceBuilder::needRayTracingPipeline() {
     requireExtension(VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME);
     requireExtension(VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME);
@@ -253,6 +271,11 @@ DeviceBuilder& DeviceBuilder::preferGpu(GpuPrefer pref) {
     return *this;
 }
 
+DeviceBuilder& DeviceBuilder::capabilityCache(std::filesystem::path file) {
+    capabilityCache_ = std::move(file);
+    return *this;
+}
+
 DeviceBuilder& DeviceBuilder::requireExtension(const char* name) {
     extensions_.push_back(name);
     return *this;
@@ -281,18 +304,15 @@ DeviceBuilder& DeviceBuilder::chainFeatures(void* featureStruct) {
     return *this;
 }
 
-QueueFamilies DeviceBuilder::findQueueFamilies(VkPhysicalDevice gpu) const {
+QueueFamilies DeviceBuilder::findQueueFamilies(VkPhysicalDevice gpu,
+                                               const detail::GpuCaps& caps) const {
     QueueFamilies result;
 
-    std::uint32_t count = 0;
-    vkGetPhysicalDeviceQueueFamilyProperties(gpu, &count, nullptr);
-    std::vector<VkQueueFamilyProperties> families(count);
-    vkGetPhysicalDeviceQueueFamilyProperties(gpu, &count, families.data());
-
+    auto count = static_cast<std::uint32_t>(caps.queueFamilies.size());
     for (std::uint32_t i = 0; i < count; ++i) {
-        bool hasGraphics = (families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
-        bool hasTransfer = (families[i].queueFlags & VK_QUEUE_TRANSFER_BIT) != 0;
-        bool hasCompute = (families[i].queueFlags & VK_QUEUE_COMPUTE_BIT) != 0;
+        bool hasGraphics = (caps.queueFamilies[i] & VK_QUEUE_GRAPHICS_BIT) != 0;
+        bool hasTransfer = (caps.queueFamilies[i] & VK_QUEUE_TRANSFER_BIT) != 0;
+        bool hasCompute = (caps.queueFamilies[i] & VK_QUEUE_COMPUTE_BIT) != 0;
 
         VkBool32 presentSupport = VK_FALSE;
         vkGetPhysicalDeviceSurfaceSupportKHR(gpu, i, surface_, &presentSupport);
@@ -331,45 +351,35 @@ QueueFamilies DeviceBuilder::findQueueFamilies(VkPhysicalDevice gpu) const {
     return result;
 }
 
-bool DeviceBuilder::supportsExtensions(VkPhysicalDevice gpu) const {
-    std::uint32_t count = 0;
-    vkEnumerateDeviceExtensionProperties(gpu, nullptr, &count, nullptr);
-    std::vector<VkExtensionProperties> available(count);
-    vkEnumerateDeviceExtensionProperties(gpu, nullptr, &count, available.data());
-
+bool DeviceBuilder::supportsExtensions(const detail::GpuCaps& caps) const {
     for (auto* required : extensions_) {
-        bool found = false;
-        for (auto& ext : available) {
-            if (std::strcmp(ext.extensionName, required) == 0) {
-                found = true;
-                break;
-            }
-        }
-        if (!found)
+        if (!caps.hasExtension(required))
             return false;
     }
     return true;
 }
 
-int DeviceBuilder::scoreDevice(VkPhysicalDevice gpu) const {
-    auto families = findQueueFamilies(gpu);
+int DeviceBuilder::scoreDevice(VkPhysicalDevice gpu, const detail::GpuCaps& caps) const {
+    auto families = findQueueFamilies(gpu, caps);
     if (!families.valid())
         return -1;
-    if (!supportsExtensions(gpu))
+    if (!supportsExtensions(caps))
         return -1;
-
-    VkPhysicalDeviceProperties props;
-    vkGetPhysicalDeviceProperties(gpu, &props);
+    if (needSparseResidency_ &&
+        (!caps.sparseBinding || !caps.sparseResidencyImage2D ||
+         !(caps.queueFamilies[families.graphics] & VK_QUEUE_SPARSE_BINDING_BIT))) {
+        return -1;
+    }
 
     int score = 0;
 
     switch (gpuPref_) {
     case GpuPrefer::Discrete:
-        if (props.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
+        if (caps.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
             score += 100000;
         break;
     case GpuPrefer::Integrated:
-        if (props.deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU)
+        if (caps.deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU)
             score += 100000;
         break;
     case GpuPrefer::Any:
@@ -388,34 +398,27 @@ int DeviceBuilder::scoreDevice(VkPhysicalDevice gpu) const {
     }
 
     // VRAM scoring: only count dedicated VRAM (DEVICE_LOCAL without HOST_VISIBLE).
-    // Integrated GPUs report shared system RAM as DEVICE_LOCAL, but those heaps
-    // have all memory types marked HOST_VISIBLE. Counting shared RAM inflates
-    // integrated GPU scores above discrete GPUs with smaller dedicated VRAM.
-    VkPhysicalDeviceMemoryProperties mem;
-    vkGetPhysicalDeviceMemoryProperties(gpu, &mem);
-    for (std::uint32_t i = 0; i < mem.memoryHeapCount; ++i) {
-        if (!(mem.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT))
-            continue;
-        // A dedicated VRAM heap has at least one memory type that is NOT
-        // host-visible. Shared system RAM heaps are fully host-visible.
-        bool hasDedicatedType = false;
-        for (std::uint32_t t = 0; t < mem.memoryTypeCount; ++t) {
-            if (mem.memoryTypes[t].heapIndex == i &&
-                !(mem.memoryTypes[t].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) {
-                hasDedicatedType = true;
-                break;
-            }
-        }
-        if (hasDedicatedType) {
-            score += static_cast<int>(mem.memoryHeaps[i].size / (1024ULL * 1024ULL));
-            break;
-        }
-    }
+    // Counting shared RAM would inflate integrated GPU scores above discrete
+    // GPUs with smaller dedicated VRAM.
+    score += static_cast<int>(caps.dedicatedVram / (1024ULL * 1024ULL));
 
     return score;
 }
 
 Result<Device> DeviceBuilder::build() {
+    bool staleCache = false;
+    auto device = buildDevice(true, staleCache);
+    if (device.ok() || !staleCache)
+        return device;
+    // The cache key misses implicit layers and loader changes, so a cached
+    // extension or feature list can be stale. Drop the file, re-probe every
+    // GPU and retry once.
+    std::error_code ec;
+    std::filesystem::remove(capabilityCache_, ec);
+    return buildDevice(false, staleCache);
+}
+
+Result<Device> DeviceBuilder::buildDevice(bool readCache, bool& staleCache) {
     std::uint32_t gpuCount = 0;
     vkEnumeratePhysicalDevices(instance_, &gpuCount, nullptr);
     if (gpuCount == 0) {
@@ -427,18 +430,52 @@ Result<Device> DeviceBuilder::build() {
     std::vector<VkPhysicalDevice> gpus(gpuCount);
     vkEnumeratePhysicalDevices(instance_, &gpuCount, gpus.data());
 
-    VkPhysicalDevice bestGpu = VK_NULL_HANDLE;
+    // Capabilities of every GPU: from the cache file when its entry still
+    // matches the device UUID and driver version, probed otherwise.
+    std::vector<detail::GpuCaps> cached;
+    if (readCache && !capabilityCache_.empty())
+        cached = detail::loadGpuCaps(capabilityCache_);
+    std::vector<detail::GpuCaps> caps;
+    caps.reserve(gpus.size());
+    std::vector<bool> fromCache;
+    bool probed = false;
+    for (auto gpu : gpus) {
+        auto id = detail::queryGpuIdentity(gpu);
+        auto hit = std::find_if(cached.begin(), cached.end(),
+                                [&](const detail::GpuCaps& c) { return c.id == id; });
+        if (hit != cached.end()) {
+            caps.push_back(std::move(*hit));
+            fromCache.push_back(true);
+        } else {
+            caps.push_back(detail::probeGpuCaps(gpu, id));
+            fromCache.push_back(false);
+            probed = true;
+        }
+    }
+    // Rewrite on any miss and when GPUs disappeared, so stale entries go.
+    if (!capabilityCache_.empty() && (probed || cached.size() != caps.size())) {
+        bool saved = detail::saveGpuCaps(capabilityCache_, caps);
+        (void) saved;
+#ifndef NDEBUG
+        if (!saved) {
+            std::fprintf(stderr, "[vksdl] could not write device capability cache %s\n",
+                         capabilityCache_.string().c_str());
+        }
+#endif
+    }
+
+    std::size_t best = gpus.size();
     int bestScore = -1;
 
-    for (auto gpu : gpus) {
-        int score = scoreDevice(gpu);
+    for (std::size_t i = 0; i < gpus.size(); ++i) {
+        int score = scoreDevice(gpus[i], caps[i]);
         if (score > bestScore) {
             bestScore = score;
-            bestGpu = gpu;
+            best = i;
         }
     }
 
-    if (bestGpu == VK_NULL_HANDLE) {
+    if (best == gpus.size()) {
         std::string msg = "No suitable GPU found. Requirements:\n";
         for (auto* ext : extensions_) {
             msg += "  - extension: ";
@@ -447,19 +484,19 @@ Result<Device> DeviceBuilder::build() {
         }
         msg += "  - graphics + present queue support\n";
         msg += "Available GPUs:\n";
-        for (auto gpu : gpus) {
-            VkPhysicalDeviceProperties props;
-            vkGetPhysicalDeviceProperties(gpu, &props);
+        for (std::size_t i = 0; i < gpus.size(); ++i) {
             msg += "  - ";
-            msg += props.deviceName;
+            msg += caps[i].deviceName;
             msg += " (score: ";
-            msg += std::to_string(scoreDevice(gpu));
+            msg += std::to_string(scoreDevice(gpus[i], caps[i]));
             msg += ")\n";
         }
         return Error{"select GPU", 0, msg};
     }
 
-    auto families = findQueueFamilies(bestGpu);
+    VkPhysicalDevice bestGpu = gpus[best];
+    const detail::GpuCaps& gpuCaps = caps[best];
+    auto families = findQueueFamilies(bestGpu, gpuCaps);
 
     std::set<std::uint32_t> uniqueFamilies = {families.graphics, families.present};
     if (families.transfer != UINT32_MAX) {
@@ -480,8 +517,8 @@ Result<Device> DeviceBuilder::build() {
         queueCIs.push_back(qci);
     }
 
-    // pNext chain order: Features2 -> Vulkan12 -> Vulkan13 -> extension feature structs
-    // -> user-chained structs. Core structs first, then extensions in request
+    // pNext chain order: Features2 -> [Vulkan11] -> Vulkan12 -> Vulkan13 -> extension
+    // feature structs -> user-chained structs. Core structs first, then extensions in request
     // order to ensure consistency for future extensions.
 
     // pipelineCreationCacheControl is always requested (Vulkan 1.3 core).
@@ -498,6 +535,47 @@ Result<Device> DeviceBuilder::build() {
     // Required by TimelineSync and TransferQueue.
     features12.timelineSemaphore = VK_TRUE;
 
+    // Multiview is core in 1.1 but its feature bit must still be enabled. Turn
+    // it on whenever supported so graph passes and pipelines can set a view mask.
+    // VkPhysicalDeviceVulkan11Features must not be chained next to any 1.1
+    // feature struct (VUID-VkDeviceCreateInfo-pNext-02829): when the caller
+    // chained one, set the bit on their Vulkan11/Multiview struct, or chain
+    // VkPhysicalDeviceMultiviewFeatures instead.
+    bool haveMultiview = gpuCaps.multiview;
+    VkPhysicalDeviceVulkan11Features features11{};
+    features11.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
+    features11.multiview = VK_TRUE;
+    VkPhysicalDeviceMultiviewFeatures multiviewFeatures{};
+    multiviewFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES;
+    multiviewFeatures.multiview = VK_TRUE;
+    bool chainedMultiviewBit = false; // caller's Vulkan11/Multiview struct
+    bool chained11 = false;           // any other 1.1 feature struct
+    for (void* chained : chainedFeatures_) {
+        switch (static_cast<VkBaseOutStructure*>(chained)->sType) {
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES:
+            if (haveMultiview)
+                static_cast<VkPhysicalDeviceVulkan11Features*>(chained)->multiview = VK_TRUE;
+            chainedMultiviewBit = true;
+            break;
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES:
+            if (haveMultiview)
+                static_cast<VkPhysicalDeviceMultiviewFeatures*>(chained)->multiview = VK_TRUE;
+            chainedMultiviewBit = true;
+            break;
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES:
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VARIABLE_POINTERS_FEATURES:
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROTECTED_MEMORY_FEATURES:
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SAMPLER_YCBCR_CONVERSION_FEATURES:
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_DRAW_PARAMETERS_FEATURES:
+            chained11 = true;
+            break;
+        default:
+            break;
+        }
+    }
+    bool chainFeatures11 = haveMultiview && !chainedMultiviewBit && !chained11;
+    bool chainMultiview = haveMultiview && !chainedMultiviewBit && chained11;
+
     VkPhysicalDeviceVulkan13Features features13{};
     features13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
 
@@ -508,43 +586,32 @@ Result<Device> DeviceBuilder::build() {
         req.configure(features13);
     }
 
-    // Query physical device features for opportunistic feature detection.
-    VkPhysicalDeviceVulkan12Features supported12{};
-    supported12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
-    VkPhysicalDeviceVulkan13Features supported13{};
-    supported13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
-    supported12.pNext = &supported13;
-    VkPhysicalDeviceFeatures2 query{};
-    query.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
-    query.pNext = &supported12;
-    vkGetPhysicalDeviceFeatures2(bestGpu, &query);
-
-    bool havePCCC = (supported13.pipelineCreationCacheControl == VK_TRUE);
+    // Opportunistic feature detection uses the probed (or cached) support.
+    bool havePCCC = gpuCaps.pipelineCreationCacheControl;
     if (havePCCC) {
         features13.pipelineCreationCacheControl = VK_TRUE;
     }
 
     // Bindless descriptor indexing (Vulkan 1.2 core features).
     // Enable opportunistically when the two essential features are supported.
-    bool haveBindless = supported12.descriptorBindingPartiallyBound == VK_TRUE &&
-                        supported12.runtimeDescriptorArray == VK_TRUE;
+    bool haveBindless = gpuCaps.descriptorBindingPartiallyBound && gpuCaps.runtimeDescriptorArray;
     if (haveBindless) {
         features12.descriptorBindingPartiallyBound = VK_TRUE;
         features12.runtimeDescriptorArray = VK_TRUE;
         // Enable per-type updateAfterBind and nonUniformIndexing when supported.
-        if (supported12.descriptorBindingSampledImageUpdateAfterBind) {
+        if (gpuCaps.sampledImageUpdateAfterBind) {
             features12.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
             features12.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
         }
-        if (supported12.descriptorBindingStorageImageUpdateAfterBind) {
+        if (gpuCaps.storageImageUpdateAfterBind) {
             features12.descriptorBindingStorageImageUpdateAfterBind = VK_TRUE;
             features12.shaderStorageImageArrayNonUniformIndexing = VK_TRUE;
         }
-        if (supported12.descriptorBindingStorageBufferUpdateAfterBind) {
+        if (gpuCaps.storageBufferUpdateAfterBind) {
             features12.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
             features12.shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
         }
-        if (supported12.descriptorBindingUniformBufferUpdateAfterBind) {
+        if (gpuCaps.uniformBufferUpdateAfterBind) {
             features12.descriptorBindingUniformBufferUpdateAfterBind = VK_TRUE;
             features12.shaderUniformBufferArrayNonUniformIndexing = VK_TRUE;
         }
@@ -571,19 +638,7 @@ Result<Device> DeviceBuilder::build() {
     // level to allow task shaders to be used in any pipeline on this device.
     meshFeatures.taskShader = VK_TRUE;
 
-    // Enumerate available extensions for opportunistic feature detection.
-    std::uint32_t availExtCount = 0;
-    vkEnumerateDeviceExtensionProperties(bestGpu, nullptr, &availExtCount, nullptr);
-    std::vector<VkExtensionProperties> availExts(availExtCount);
-    vkEnumerateDeviceExtensionProperties(bestGpu, nullptr, &availExtCount, availExts.data());
-
-    auto hasExtension = [&](const char* name) {
-        for (auto& ext : availExts) {
-            if (std::strcmp(ext.extensionName, name) == 0)
-                return true;
-        }
-        return false;
-    };
+    auto hasExtension = [&](const char* name) { return gpuCaps.hasExtension(name); };
 
     // SER: enable opportunistically when the GPU supports it. Zero behavioral
     // impact -- the driver reorders shader invocations for better coherence.
@@ -597,12 +652,18 @@ Result<Device> DeviceBuilder::build() {
 
     // Pipeline binary: detect opportunistically. Allows pipelines to be
     // captured as driver-opaque blobs and reloaded to skip compilation.
-    bool havePipelineBinary = hasExtension(VK_KHR_PIPELINE_BINARY_EXTENSION_NAME);
+    // Depends on VK_KHR_maintenance5 (pipeline create flags 2 for capture).
+    bool havePipelineBinary = hasExtension(VK_KHR_PIPELINE_BINARY_EXTENSION_NAME) &&
+                              hasExtension(VK_KHR_MAINTENANCE_5_EXTENSION_NAME);
 
     VkPhysicalDevicePipelineBinaryFeaturesKHR pipelineBinaryFeatures{};
     pipelineBinaryFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_BINARY_FEATURES_KHR;
     pipelineBinaryFeatures.pipelineBinaries = VK_TRUE;
 
+    VkPhysicalDeviceMaintenance5FeaturesKHR maintenance5Features{};
+    maintenance5Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MAINTENANCE_5_FEATURES_KHR;
+    maintenance5Features.maintenance5 = VK_TRUE;
+
     // Device fault: enable opportunistically for better VK_ERROR_DEVICE_LOST
     // diagnostics. No behavioral impact when no fault occurs.
     bool haveDeviceFault = hasExtension(VK_EXT_DEVICE_FAULT_EXTENSION_NAME);
@@ -639,6 +700,32 @@ Result<Device> DeviceBuilder::build() {
     gplFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
     gplFeatures.graphicsPipelineLibrary = VK_TRUE;
 
+    // Extended dynamic state 3: detect opportunistically and enable only the
+    // states PipelineBuilder::maximalDynamicState() makes dynamic. Each one is
+    // a separate feature bit, so query support and enable the intersection.
+    bool haveEds3 = hasExtension(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+
+    VkPhysicalDeviceExtendedDynamicState3FeaturesEXT eds3Features{};
+    eds3Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
+    if (haveEds3) {
+        eds3Features.extendedDynamicState3PolygonMode = gpuCaps.eds3PolygonMode;
+        eds3Features.extendedDynamicState3SampleMask = gpuCaps.eds3SampleMask;
+        eds3Features.extendedDynamicState3AlphaToCoverageEnable =
+            gpuCaps.eds3AlphaToCoverageEnable;
+        eds3Features.extendedDynamicState3DepthClampEnable = gpuCaps.eds3DepthClampEnable;
+        eds3Features.extendedDynamicState3ColorBlendEnable = gpuCaps.eds3ColorBlendEnable;
+        eds3Features.extendedDynamicState3ColorBlendEquation = gpuCaps.eds3ColorBlendEquation;
+        eds3Features.extendedDynamicState3ColorWriteMask = gpuCaps.eds3ColorWriteMask;
+
+        haveEds3 = eds3Features.extendedDynamicState3PolygonMode ||
+                   eds3Features.extendedDynamicState3SampleMask ||
+                   eds3Features.extendedDynamicState3AlphaToCoverageEnable ||
+                   eds3Features.extendedDynamicState3DepthClampEnable ||
+                   eds3Features.extendedDynamicState3ColorBlendEnable ||
+                   eds3Features.extendedDynamicState3ColorBlendEquation ||
+                   eds3Features.extendedDynamicState3ColorWriteMask;
+    }
+
     VkPhysicalDeviceFaultFeaturesEXT faultFeatures{};
     faultFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FAULT_FEATURES_EXT;
     faultFeatures.deviceFault = VK_TRUE;
@@ -665,6 +752,11 @@ Result<Device> DeviceBuilder::build() {
         pNextChain = &gplFeatures;
     }
 
+    if (haveEds3) {
+        eds3Features.pNext = pNextChain;
+        pNextChain = &eds3Features;
+    }
+
     if (haveDeviceFault) {
         faultFeatures.pNext = pNextChain;
         pNextChain = &faultFeatures;
@@ -678,6 +770,8 @@ Result<Device> DeviceBuilder::build() {
     if (havePipelineBinary) {
         pipelineBinaryFeatures.pNext = pNextChain;
         pNextChain = &pipelineBinaryFeatures;
+        maintenance5Features.pNext = pNextChain;
+        pNextChain = &maintenance5Features;
     }
 
     if (needMeshShaders_) {
@@ -705,6 +799,13 @@ Result<Device> DeviceBuilder::build() {
     // features12 always chained (bufferDeviceAddress is always enabled).
     features12.pNext = pNextChain;
     pNextChain = &features12;
+    if (chainFeatures11) {
+        features11.pNext = pNextChain;
+        pNextChain = &features11;
+    } else if (chainMultiview) {
+        multiviewFeatures.pNext = pNextChain;
+        pNextChain = &multiviewFeatures;
+    }
 
     VkPhysicalDeviceFeatures2 features2{};
     features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
@@ -713,6 +814,12 @@ Result<Device> DeviceBuilder::build() {
     for (auto& req : coreFeatureRequests_) {
         req.configure(features2.features);
     }
+    if (needSparseResidency_) {
+        features2.features.sparseBinding = VK_TRUE;
+        features2.features.sparseResidencyImage2D = VK_TRUE;
+        if (gpuCaps.shaderResourceResidency)
+            features2.features.shaderResourceResidency = VK_TRUE;
+    }
 
     // Add opportunistic extensions to the extension list
     std::vector<const char*> allExtensions = extensions_;
@@ -734,6 +841,9 @@ Result<Device> DeviceBuilder::build() {
     if (havePipelineBinary) {
         allExtensions.push_back(VK_KHR_PIPELINE_BINARY_EXTENSION_NAME);
     }
+    if (haveEds3) {
+        allExtensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+    }
     if (haveGoogleDisplayTiming) {
         allExtensions.push_back(VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME);
     }
@@ -768,6 +878,20 @@ Result<Device> DeviceBuilder::build() {
         }
     }
 
+    if (havePipelineBinary) {
+        // VK_KHR_maintenance5 is a required dependency of VK_KHR_pipeline_binary.
+        bool haveMaintenance5 = false;
+        for (auto* ext : allExtensions) {
+            if (std::strcmp(ext, VK_KHR_MAINTENANCE_5_EXTENSION_NAME) == 0) {
+                haveMaintenance5 = true;
+                break;
+            }
+        }
+        if (!haveMaintenance5) {
+            allExtensions.push_back(VK_KHR_MAINTENANCE_5_EXTENSION_NAME);
+        }
+    }
+
     VkDeviceCreateInfo ci{};
     ci.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
     ci.pNext = &features2;
@@ -782,10 +906,9 @@ Result<Device> DeviceBuilder::build() {
 
     VkResult vr = vkCreateDevice(bestGpu, &ci, nullptr, &dev.device_);
     if (vr != VK_SUCCESS) {
-        VkPhysicalDeviceProperties props;
-        vkGetPhysicalDeviceProperties(bestGpu, &props);
+        staleCache = fromCache[best];
         std::string msg = "vkCreateDevice failed for '";
-        msg += props.deviceName;
+        msg += gpuCaps.deviceName;
         msg += "'";
         if (vr == VK_ERROR_FEATURE_NOT_PRESENT) {
             msg += ".\nA requested Vulkan feature is not supported by this GPU.\n"
@@ -817,32 +940,34 @@ Result<Device> DeviceBuilder::build() {
     dev.hasInvocationReorder_ = haveSer;
     dev.hasPipelineBinary_ = havePipelineBinary;
     dev.hasMeshShaders_ = needMeshShaders_;
+    dev.hasSparseResidency_ = needSparseResidency_;
+    dev.hasShaderResourceResidency_ = needSparseResidency_ && gpuCaps.shaderResourceResidency;
+    dev.hasMultiview_ = haveMultiview;
+    if (haveEds3) {
+        dev.eds3_.polygonMode = eds3Features.extendedDynamicState3PolygonMode == VK_TRUE;
+        dev.eds3_.sampleMask = eds3Features.extendedDynamicState3SampleMask == VK_TRUE;
+        dev.eds3_.alphaToCoverageEnable =
+            eds3Features.extendedDynamicState3AlphaToCoverageEnable == VK_TRUE;
+        dev.eds3_.depthClampEnable = eds3Features.extendedDynamicState3DepthClampEnable == VK_TRUE;
+        dev.eds3_.colorBlendEnable = eds3Features.extendedDynamicState3ColorBlendEnable == VK_TRUE;
+        dev.eds3_.colorBlendEquation =
+            eds3Features.extendedDynamicState3ColorBlendEquation == VK_TRUE;
+        dev.eds3_.colorWriteMask = eds3Features.extendedDynamicState3ColorWriteMask == VK_TRUE;
+    }
     dev.hasPresentTiming_ = havePresentTiming;
     dev.hasGoogleDisplayTiming_ = haveGoogleDisplayTiming;
     dev.hasExtPresentTiming_ = haveExtPresentTiming;
 
-    // Query GPL properties when the extension is enabled.
     if (haveGPL) {
         dev.hasGPL_ = true;
-
-        VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT gplProps{};
-        gplProps.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT;
-
-        VkPhysicalDeviceProperties2 gplProps2{};
-        gplProps2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
-        gplProps2.pNext = &gplProps;
-        vkGetPhysicalDeviceProperties2(bestGpu, &gplProps2);
-
-        dev.hasGplFastLinking_ = (gplProps.graphicsPipelineLibraryFastLinking == VK_TRUE);
-        dev.hasGplIndepInterp_ =
-            (gplProps.graphicsPipelineLibraryIndependentInterpolationDecoration == VK_TRUE);
+        dev.hasGplFastLinking_ = gpuCaps.gplFastLinking;
+        dev.hasGplIndepInterp_ = gpuCaps.gplIndependentInterpolation;
     }
 
-    VkPhysicalDeviceProperties devProps;
-    vkGetPhysicalDeviceProperties(bestGpu, &devProps);
-    dev.minUboAlignment_ = devProps.limits.minUniformBufferOffsetAlignment;
-    dev.timestampPeriod_ = devProps.limits.timestampPeriod;
-    dev.gpuName_ = devProps.deviceName;
+    dev.minUboAlignment_ = gpuCaps.minUniformBufferOffsetAlignment;
+    dev.timestampPeriod_ = gpuCaps.timestampPeriod;
+    dev.gpuName_ = gpuCaps.deviceName;
+    dev.capabilitiesCached_ = fromCache[best];
 
     if (needRayTracingPipeline_) {
         dev.pfnTraceRays_ = reinterpret_cast<PFN_vkCmdTraceRaysKHR>(
@@ -854,8 +979,7 @@ Result<Device> DeviceBuilder::build() {
             vkGetDeviceProcAddr(dev.device_, "vkCmdDrawMeshTasksEXT"));
     }
 
-    VkSampleCountFlags combined =
-        devProps.limits.framebufferColorSampleCounts & devProps.limits.framebufferDepthSampleCounts;
+    VkSampleCountFlags combined = gpuCaps.framebufferSampleCounts;
     for (VkSampleCountFlagBits bit :
          {VK_SAMPLE_COUNT_64_BIT, VK_SAMPLE_COUNT_32_BIT, VK_SAMPLE_COUNT_16_BIT,
           VK_SAMPLE_COUNT_8_BIT, VK_SAMPLE_COUNT_4_BIT, VK_SAMPLE_COUNT_2_BIT}) {
@@ -0,0 +1,341 @@
+#include "device_caps.hpp"
+
+#include "file_io.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace vksdl::detail {
+
+namespace {
+
+constexpr char kMagic[8] = {'V', 'K', 'S', 'D', 'L', 'D', 'C', 'C'};
+constexpr std::uint32_t kFormatVersion = 3;
+
+// Feature flags in file order. Any change to kFeatureBits needs a new
+// kFormatVersion: an appended bit would read as 0 (unsupported) from older
+// files with a matching GpuIdentity until the next re-probe.
+constexpr bool GpuCaps::*kFeatureBits[] = {
+    &GpuCaps::pipelineCreationCacheControl,
+    &GpuCaps::descriptorBindingPartiallyBound,
+    &GpuCaps::runtimeDescriptorArray,
+    &GpuCaps::sampledImageUpdateAfterBind,
+    &GpuCaps::storageImageUpdateAfterBind,
+    &GpuCaps::storageBufferUpdateAfterBind,
+    &GpuCaps::uniformBufferUpdateAfterBind,
+    &GpuCaps::eds3PolygonMode,
+    &GpuCaps::eds3SampleMask,
+    &GpuCaps::eds3AlphaToCoverageEnable,
+    &GpuCaps::eds3DepthClampEnable,
+    &GpuCaps::eds3ColorBlendEnable,
+    &GpuCaps::eds3ColorBlendEquation,
+    &GpuCaps::eds3ColorWriteMask,
+    &GpuCaps::gplFastLinking,
+    &GpuCaps::gplIndependentInterpolation,
+    &GpuCaps::sparseBinding,
+    &GpuCaps::sparseResidencyImage2D,
+    &GpuCaps::shaderResourceResidency,
+    &GpuCaps::multiview,
+};
+static_assert(std::size(kFeatureBits) <= 32);
+
+// Sanity caps on counts read from the file, well above any real device.
+constexpr std::uint32_t kMaxDevices = 64;
+constexpr std::uint32_t kMaxQueueFamilies = 64;
+constexpr std::uint32_t kMaxExtensions = 4096;
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t count;
+};
+
+// Followed by queueFamilyCount VkQueueFlags, the device name and
+// extensionCount extension names, each name as a u32 length + bytes.
+struct RecordHeader {
+    GpuIdentity id;
+    std::uint32_t deviceType;
+    std::uint32_t features; // kFeatureBits
+    std::uint64_t dedicatedVram;
+    std::uint64_t minUniformBufferOffsetAlignment;
+    float timestampPeriod;
+    std::uint32_t framebufferSampleCounts;
+    std::uint32_t queueFamilyCount;
+    std::uint32_t extensionCount;
+};
+
+static_assert(sizeof(GpuIdentity) == 32);
+static_assert(sizeof(FileHeader) == 16);
+static_assert(sizeof(RecordHeader) == 72);
+
+std::uint64_t fnv1a(const std::uint8_t* data, std::size_t size) {
+    std::uint64_t h = 0xcbf29ce484222325ULL;
+    for (std::size_t i = 0; i < size; ++i) {
+        h ^= data[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+template <typename T> void appendPod(std::vector<std::uint8_t>& out, const T& value) {
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+void appendString(std::vector<std::uint8_t>& out, const std::string& s) {
+    appendPod(out, static_cast<std::uint32_t>(s.size()));
+    out.insert(out.end(), s.begin(), s.end());
+}
+
+// Bounds-checked reads from a byte span; false once past the end.
+class Reader {
+  public:
+    Reader(const std::uint8_t* data, std::size_t size) : data_(data), size_(size) {}
+
+    template <typename T> bool pod(T& out) {
+        if (size_ - pos_ < sizeof(T))
+            return false;
+        std::memcpy(&out, data_ + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return true;
+    }
+
+    // True if `count` items of at least `minBytes` each can still follow.
+    [[nodiscard]] bool fits(std::uint32_t count, std::size_t minBytes) const {
+        return count <= (size_ - pos_) / minBytes;
+    }
+
+    bool string(std::string& out) {
+        std::uint32_t n = 0;
+        if (!pod(n) || size_ - pos_ < n)
+            return false;
+        out.assign(reinterpret_cast<const char*>(data_ + pos_), n);
+        pos_ += n;
+        return true;
+    }
+
+  private:
+    const std::uint8_t* data_;
+    std::size_t size_;
+    std::size_t pos_ = 0;
+};
+
+} // namespace
+
+bool GpuCaps::hasExtension(const char* name) const {
+    return std::binary_search(extensions.begin(), extensions.end(), std::string_view(name));
+}
+
+GpuIdentity queryGpuIdentity(VkPhysicalDevice gpu) {
+    VkPhysicalDeviceIDProperties idProps{};
+    idProps.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+    VkPhysicalDeviceProperties2 props2{};
+    props2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    props2.pNext = &idProps;
+    vkGetPhysicalDeviceProperties2(gpu, &props2);
+
+    GpuIdentity id;
+    std::memcpy(id.deviceUUID, idProps.deviceUUID, VK_UUID_SIZE);
+    id.driverVersion = props2.properties.driverVersion;
+    id.apiVersion = props2.properties.apiVersion;
+    id.vendorID = props2.properties.vendorID;
+    id.deviceID = props2.properties.deviceID;
+    return id;
+}
+
+GpuCaps probeGpuCaps(VkPhysicalDevice gpu, const GpuIdentity& id) {
+    GpuCaps caps;
+    caps.id = id;
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(gpu, &props);
+    caps.deviceType = props.deviceType;
+    caps.deviceName = props.deviceName;
+    caps.minUniformBufferOffsetAlignment = props.limits.minUniformBufferOffsetAlignment;
+    caps.timestampPeriod = props.limits.timestampPeriod;
+    caps.framebufferSampleCounts =
+        props.limits.framebufferColorSampleCounts & props.limits.framebufferDepthSampleCounts;
+
+    // Dedicated VRAM: a DEVICE_LOCAL heap with at least one memory type that
+    // is NOT host-visible. Integrated GPUs report shared system RAM as
+    // DEVICE_LOCAL, but every type of those heaps is HOST_VISIBLE.
+    VkPhysicalDeviceMemoryProperties mem;
+    vkGetPhysicalDeviceMemoryProperties(gpu, &mem);
+    for (std::uint32_t i = 0; i < mem.memoryHeapCount && caps.dedicatedVram == 0; ++i) {
+        if (!(mem.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT))
+            continue;
+        for (std::uint32_t t = 0; t < mem.memoryTypeCount; ++t) {
+            if (mem.memoryTypes[t].heapIndex == i &&
+                !(mem.memoryTypes[t].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) {
+                caps.dedicatedVram = mem.memoryHeaps[i].size;
+                break;
+            }
+        }
+    }
+
+    std::uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(gpu, &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(gpu, &familyCount, families.data());
+    for (const auto& f : families)
+        caps.queueFamilies.push_back(f.queueFlags);
+
+    std::uint32_t extCount = 0;
+    vkEnumerateDeviceExtensionProperties(gpu, nullptr, &extCount, nullptr);
+    std::vector<VkExtensionProperties> exts(extCount);
+    vkEnumerateDeviceExtensionProperties(gpu, nullptr, &extCount, exts.data());
+    caps.extensions.reserve(extCount);
+    for (const auto& e : exts)
+        caps.extensions.emplace_back(e.extensionName);
+    std::sort(caps.extensions.begin(), caps.extensions.end());
+
+    VkPhysicalDeviceVulkan11Features supported11{};
+    supported11.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
+    VkPhysicalDeviceVulkan12Features supported12{};
+    supported12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    supported11.pNext = &supported12;
+    VkPhysicalDeviceVulkan13Features supported13{};
+    supported13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+    supported12.pNext = &supported13;
+    VkPhysicalDeviceExtendedDynamicState3FeaturesEXT supportedEds3{};
+    supportedEds3.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
+    if (caps.hasExtension(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME))
+        supported13.pNext = &supportedEds3;
+    VkPhysicalDeviceFeatures2 query{};
+    query.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    query.pNext = &supported11;
+    vkGetPhysicalDeviceFeatures2(gpu, &query);
+
+    caps.pipelineCreationCacheControl = supported13.pipelineCreationCacheControl == VK_TRUE;
+    caps.descriptorBindingPartiallyBound = supported12.descriptorBindingPartiallyBound == VK_TRUE;
+    caps.runtimeDescriptorArray = supported12.runtimeDescriptorArray == VK_TRUE;
+    caps.sampledImageUpdateAfterBind =
+        supported12.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE;
+    caps.storageImageUpdateAfterBind =
+        supported12.descriptorBindingStorageImageUpdateAfterBind == VK_TRUE;
+    caps.storageBufferUpdateAfterBind =
+        supported12.descriptorBindingStorageBufferUpdateAfterBind == VK_TRUE;
+    caps.uniformBufferUpdateAfterBind =
+        supported12.descriptorBindingUniformBufferUpdateAfterBind == VK_TRUE;
+    caps.eds3PolygonMode = supportedEds3.extendedDynamicState3PolygonMode == VK_TRUE;
+    caps.eds3SampleMask = supportedEds3.extendedDynamicState3SampleMask == VK_TRUE;
+    caps.eds3AlphaToCoverageEnable =
+        supportedEds3.extendedDynamicState3AlphaToCoverageEnable == VK_TRUE;
+    caps.eds3DepthClampEnable = supportedEds3.extendedDynamicState3DepthClampEnable == VK_TRUE;
+    caps.eds3ColorBlendEnable = supportedEds3.extendedDynamicState3ColorBlendEnable == VK_TRUE;
+    caps.eds3ColorBlendEquation = supportedEds3.extendedDynamicState3ColorBlendEquation == VK_TRUE;
+    caps.eds3ColorWriteMask = supportedEds3.extendedDynamicState3ColorWriteMask == VK_TRUE;
+    caps.sparseBinding = query.features.sparseBinding == VK_TRUE;
+    caps.sparseResidencyImage2D = query.features.sparseResidencyImage2D == VK_TRUE;
+    caps.shaderResourceResidency = query.features.shaderResourceResidency == VK_TRUE;
+    caps.multiview = supported11.multiview == VK_TRUE;
+
+    if (caps.hasExtension(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME)) {
+        VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT gplProps{};
+        gplProps.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT;
+        VkPhysicalDeviceProperties2 gplProps2{};
+        gplProps2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        gplProps2.pNext = &gplProps;
+        vkGetPhysicalDeviceProperties2(gpu, &gplProps2);
+        caps.gplFastLinking = gplProps.graphicsPipelineLibraryFastLinking == VK_TRUE;
+        caps.gplIndependentInterpolation =
+            gplProps.graphicsPipelineLibraryIndependentInterpolationDecoration == VK_TRUE;
+    }
+
+    return caps;
+}
+
+std::vector<GpuCaps> loadGpuCaps(const std::filesystem::path& path) {
+    MappedFile file(path);
+    // Payload followed by an FNV-1a checksum of the payload.
+    if (file.size() < sizeof(FileHeader) + sizeof(std::uint64_t))
+        return {};
+    std::size_t payloadSize = file.size() - sizeof(std::uint64_t);
+    std::uint64_t checksum = 0;
+    std::memcpy(&checksum, file.data() + payloadSize, sizeof(checksum));
+    if (checksum != fnv1a(file.data(), payloadSize))
+        return {};
+
+    Reader in(file.data(), payloadSize);
+    FileHeader header{};
+    if (!in.pod(header) || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+        header.version != kFormatVersion || header.count > kMaxDevices ||
+        !in.fits(header.count, sizeof(RecordHeader))) {
+        return {};
+    }
+
+    std::vector<GpuCaps> out;
+    for (std::uint32_t r = 0; r < header.count; ++r) {
+        RecordHeader rh{};
+        // Counts are validated before any resize: a corrupt count that passes
+        // the checksum must not turn into a huge allocation.
+        if (!in.pod(rh) || rh.queueFamilyCount > kMaxQueueFamilies ||
+            rh.extensionCount > kMaxExtensions ||
+            !in.fits(rh.queueFamilyCount, sizeof(VkQueueFlags)) ||
+            !in.fits(rh.extensionCount, sizeof(std::uint32_t)))
+            return {};
+        GpuCaps caps;
+        caps.id = rh.id;
+        caps.deviceType = static_cast<VkPhysicalDeviceType>(rh.deviceType);
+        caps.dedicatedVram = rh.dedicatedVram;
+        caps.minUniformBufferOffsetAlignment = rh.minUniformBufferOffsetAlignment;
+        caps.timestampPeriod = rh.timestampPeriod;
+        caps.framebufferSampleCounts = rh.framebufferSampleCounts;
+        for (std::size_t b = 0; b < std::size(kFeatureBits); ++b)
+            caps.*kFeatureBits[b] = (rh.features >> b) & 1u;
+
+        caps.queueFamilies.resize(rh.queueFamilyCount);
+        for (auto& flags : caps.queueFamilies) {
+            if (!in.pod(flags))
+                return {};
+        }
+        if (!in.string(caps.deviceName))
+            return {};
+        caps.extensions.resize(rh.extensionCount);
+        for (auto& ext : caps.extensions) {
+            if (!in.string(ext))
+                return {};
+        }
+        if (!std::is_sorted(caps.extensions.begin(), caps.extensions.end()))
+            return {};
+        out.push_back(std::move(caps));
+    }
+    return out;
+}
+
+bool saveGpuCaps(const std::filesystem::path& path, const std::vector<GpuCaps>& caps) {
+    std::vector<std::uint8_t> bytes;
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kFormatVersion;
+    header.count = static_cast<std::uint32_t>(caps.size());
+    appendPod(bytes, header);
+
+    for (const auto& c : caps) {
+        RecordHeader rh{};
+        rh.id = c.id;
+        rh.deviceType = static_cast<std::uint32_t>(c.deviceType);
+        for (std::size_t b = 0; b < std::size(kFeatureBits); ++b) {
+            if (c.*kFeatureBits[b])
+                rh.features |= 1u << b;
+        }
+        rh.dedicatedVram = c.dedicatedVram;
+        rh.minUniformBufferOffsetAlignment = c.minUniformBufferOffsetAlignment;
+        rh.timestampPeriod = c.timestampPeriod;
+        rh.framebufferSampleCounts = c.framebufferSampleCounts;
+        rh.queueFamilyCount = static_cast<std::uint32_t>(c.queueFamilies.size());
+        rh.extensionCount = static_cast<std::uint32_t>(c.extensions.size());
+        appendPod(bytes, rh);
+        for (VkQueueFlags flags : c.queueFamilies)
+            appendPod(bytes, flags);
+        appendString(bytes, c.deviceName);
+        for (const auto& ext : c.extensions)
+            appendString(bytes, ext);
+    }
+
+    appendPod(bytes, fnv1a(bytes.data(), bytes.size()));
+    return writeFileAtomic(path, bytes.data(), bytes.size());
+}
+
+} // namespace vksdl::detail
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace vksdl::detail {
+
+// Identifies one physical device on one driver build. A cached GpuCaps is
+// reused only when every field matches the live device.
+struct GpuIdentity {
+    std::uint8_t deviceUUID[VK_UUID_SIZE] = {};
+    std::uint32_t driverVersion = 0;
+    std::uint32_t apiVersion = 0;
+    std::uint32_t vendorID = 0;
+    std::uint32_t deviceID = 0;
+
+    [[nodiscard]] bool operator==(const GpuIdentity&) const = default;
+};
+
+// Everything DeviceBuilder reads from a physical device to score it and to
+// pick opportunistic features, except per-surface present support, which
+// depends on the surface and is always queried live.
+struct GpuCaps {
+    GpuIdentity id;
+    VkPhysicalDeviceType deviceType = VK_PHYSICAL_DEVICE_TYPE_OTHER;
+    std::string deviceName;
+    VkDeviceSize dedicatedVram = 0; // first DEVICE_LOCAL heap with a non-host-visible type
+    std::vector<VkQueueFlags> queueFamilies;
+    std::vector<std::string> extensions; // sorted
+
+    // Supported features that build() enables when present.
+    bool pipelineCreationCacheControl = false;
+    bool descriptorBindingPartiallyBound = false;
+    bool runtimeDescriptorArray = false;
+    bool sampledImageUpdateAfterBind = false;
+    bool storageImageUpdateAfterBind = false;
+    bool storageBufferUpdateAfterBind = false;
+    bool uniformBufferUpdateAfterBind = false;
+    bool eds3PolygonMode = false;
+    bool eds3SampleMask = false;
+    bool eds3AlphaToCoverageEnable = false;
+    bool eds3DepthClampEnable = false;
+    bool eds3ColorBlendEnable = false;
+    bool eds3ColorBlendEquation = false;
+    bool eds3ColorWriteMask = false;
+    bool gplFastLinking = false;
+    bool gplIndependentInterpolation = false;
+    bool sparseBinding = false;
+    bool sparseResidencyImage2D = false;
+    bool shaderResourceResidency = false;
+    bool multiview = false;
+
+    // Limits Device exposes.
+    VkDeviceSize minUniformBufferOffsetAlignment = 0;
+    float timestampPeriod = 0.0f;
+    VkSampleCountFlags framebufferSampleCounts = 0; // color & depth
+
+    [[nodiscard]] bool hasExtension(const char* name) const;
+};
+
+// One vkGetPhysicalDeviceProperties2 call: the cache key of `gpu`.
+[[nodiscard]] GpuIdentity queryGpuIdentity(VkPhysicalDevice gpu);
+
+// Full probe: properties, memory, queue families, extensions, features.
+[[nodiscard]] GpuCaps probeGpuCaps(VkPhysicalDevice gpu, const GpuIdentity& id);
+
+// Capability cache file. load() yields nothing for a missing, foreign or
+// corrupt file; save() is atomic (temp file + rename).
+[[nodiscard]] std::vector<GpuCaps> loadGpuCaps(const std::filesystem::path& path);
+[[nodiscard]] bool saveGpuCaps(const std::filesystem::path& path,
+                               const std::vector<GpuCaps>& caps);
+
+} // namespace vksdl::detail
@@ -0,0 +1,171 @@
+#include <vksdl/device.hpp>
+#include <vksdl/dynamic_state.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <cstring>
+
+namespace vksdl {
+
+namespace {
+
+template <typename Fn> Fn loadCmd(const Device& device, bool enabled, const char* name) {
+    if (!enabled)
+        return nullptr;
+    return reinterpret_cast<Fn>(vkGetDeviceProcAddr(device.vkDevice(), name));
+}
+
+bool sameEquation(const VkColorBlendEquationEXT& a, const VkColorBlendEquationEXT& b) {
+    return a.srcColorBlendFactor == b.srcColorBlendFactor &&
+           a.dstColorBlendFactor == b.dstColorBlendFactor && a.colorBlendOp == b.colorBlendOp &&
+           a.srcAlphaBlendFactor == b.srcAlphaBlendFactor &&
+           a.dstAlphaBlendFactor == b.dstAlphaBlendFactor && a.alphaBlendOp == b.alphaBlendOp;
+}
+
+} // namespace
+
+DynamicStateTracker::DynamicStateTracker(const Device& device) {
+    const auto& eds3 = device.extendedDynamicState3();
+    pfnPolygonMode_ = loadCmd<PFN_vkCmdSetPolygonModeEXT>(device, eds3.polygonMode,
+                                                          "vkCmdSetPolygonModeEXT");
+    pfnSampleMask_ =
+        loadCmd<PFN_vkCmdSetSampleMaskEXT>(device, eds3.sampleMask, "vkCmdSetSampleMaskEXT");
+    pfnAlphaToCoverage_ = loadCmd<PFN_vkCmdSetAlphaToCoverageEnableEXT>(
+        device, eds3.alphaToCoverageEnable, "vkCmdSetAlphaToCoverageEnableEXT");
+    pfnDepthClamp_ = loadCmd<PFN_vkCmdSetDepthClampEnableEXT>(device, eds3.depthClampEnable,
+                                                              "vkCmdSetDepthClampEnableEXT");
+    pfnBlendEnable_ = loadCmd<PFN_vkCmdSetColorBlendEnableEXT>(device, eds3.colorBlendEnable,
+                                                               "vkCmdSetColorBlendEnableEXT");
+    pfnBlendEquation_ = loadCmd<PFN_vkCmdSetColorBlendEquationEXT>(
+        device, eds3.colorBlendEquation, "vkCmdSetColorBlendEquationEXT");
+    pfnWriteMask_ = loadCmd<PFN_vkCmdSetColorWriteMaskEXT>(device, eds3.colorWriteMask,
+                                                           "vkCmdSetColorWriteMaskEXT");
+}
+
+void DynamicStateTracker::begin(VkCommandBuffer cmd) {
+    cmd_ = cmd;
+    boundPipeline_ = VK_NULL_HANDLE;
+    viewportKnown_ = false;
+    scissorKnown_ = false;
+    invalidate();
+}
+
+void DynamicStateTracker::invalidate() {
+    known_ = false;
+}
+
+bool DynamicStateTracker::dirty(bool differs) {
+    if (known_ && !differs) {
+        ++skipped_;
+        return false;
+    }
+    ++issued_;
+    return true;
+}
+
+void DynamicStateTracker::bindPipeline(VkPipeline pipeline, VkPipelineBindPoint bindPoint) {
+    if (pipeline == boundPipeline_) {
+        ++skipped_;
+        return;
+    }
+    vkCmdBindPipeline(cmd_, bindPoint, pipeline);
+    boundPipeline_ = pipeline;
+    ++issued_;
+}
+
+void DynamicStateTracker::setViewport(const VkViewport& viewport) {
+    if (viewportKnown_ && std::memcmp(&viewport, &viewport_, sizeof(viewport)) == 0) {
+        ++skipped_;
+        return;
+    }
+    vkCmdSetViewport(cmd_, 0, 1, &viewport);
+    viewport_ = viewport;
+    viewportKnown_ = true;
+    ++issued_;
+}
+
+void DynamicStateTracker::setScissor(const VkRect2D& scissor) {
+    if (scissorKnown_ && std::memcmp(&scissor, &scissor_, sizeof(scissor)) == 0) {
+        ++skipped_;
+        return;
+    }
+    vkCmdSetScissor(cmd_, 0, 1, &scissor);
+    scissor_ = scissor;
+    scissorKnown_ = true;
+    ++issued_;
+}
+
+void DynamicStateTracker::apply(const DynamicStateValues& v) {
+    const DynamicStateValues& c = current_;
+
+    // Vulkan 1.3 core (extended dynamic state 1 and 2).
+    if (dirty(v.topology != c.topology))
+        vkCmdSetPrimitiveTopology(cmd_, v.topology);
+    if (dirty(v.primitiveRestart != c.primitiveRestart))
+        vkCmdSetPrimitiveRestartEnable(cmd_, v.primitiveRestart ? VK_TRUE : VK_FALSE);
+    if (dirty(v.cullMode != c.cullMode))
+        vkCmdSetCullMode(cmd_, v.cullMode);
+    if (dirty(v.frontFace != c.frontFace))
+        vkCmdSetFrontFace(cmd_, v.frontFace);
+    if (dirty(v.rasterizerDiscard != c.rasterizerDiscard))
+        vkCmdSetRasterizerDiscardEnable(cmd_, v.rasterizerDiscard ? VK_TRUE : VK_FALSE);
+    if (dirty(v.lineWidth != c.lineWidth))
+        vkCmdSetLineWidth(cmd_, v.lineWidth);
+    if (dirty(v.depthBias != c.depthBias))
+        vkCmdSetDepthBiasEnable(cmd_, v.depthBias ? VK_TRUE : VK_FALSE);
+    if (dirty(v.depthBiasConstant != c.depthBiasConstant || v.depthBiasClamp != c.depthBiasClamp ||
+              v.depthBiasSlope != c.depthBiasSlope))
+        vkCmdSetDepthBias(cmd_, v.depthBiasConstant, v.depthBiasClamp, v.depthBiasSlope);
+    if (dirty(v.depthTest != c.depthTest))
+        vkCmdSetDepthTestEnable(cmd_, v.depthTest ? VK_TRUE : VK_FALSE);
+    if (dirty(v.depthWrite != c.depthWrite))
+        vkCmdSetDepthWriteEnable(cmd_, v.depthWrite ? VK_TRUE : VK_FALSE);
+    if (dirty(v.depthCompareOp != c.depthCompareOp))
+        vkCmdSetDepthCompareOp(cmd_, v.depthCompareOp);
+    if (dirty(v.depthBoundsTest != c.depthBoundsTest))
+        vkCmdSetDepthBoundsTestEnable(cmd_, v.depthBoundsTest ? VK_TRUE : VK_FALSE);
+    if (dirty(v.minDepthBounds != c.minDepthBounds || v.maxDepthBounds != c.maxDepthBounds))
+        vkCmdSetDepthBounds(cmd_, v.minDepthBounds, v.maxDepthBounds);
+    if (dirty(v.stencilTest != c.stencilTest))
+        vkCmdSetStencilTestEnable(cmd_, v.stencilTest ? VK_TRUE : VK_FALSE);
+    if (dirty(v.stencilFailOp != c.stencilFailOp || v.stencilPassOp != c.stencilPassOp ||
+              v.stencilDepthFailOp != c.stencilDepthFailOp ||
+              v.stencilCompareOp != c.stencilCompareOp))
+        vkCmdSetStencilOp(cmd_, VK_STENCIL_FACE_FRONT_AND_BACK, v.stencilFailOp, v.stencilPassOp,
+                          v.stencilDepthFailOp, v.stencilCompareOp);
+    if (dirty(v.stencilCompareMask != c.stencilCompareMask))
+        vkCmdSetStencilCompareMask(cmd_, VK_STENCIL_FACE_FRONT_AND_BACK, v.stencilCompareMask);
+    if (dirty(v.stencilWriteMask != c.stencilWriteMask))
+        vkCmdSetStencilWriteMask(cmd_, VK_STENCIL_FACE_FRONT_AND_BACK, v.stencilWriteMask);
+    if (dirty(v.stencilReference != c.stencilReference))
+        vkCmdSetStencilReference(cmd_, VK_STENCIL_FACE_FRONT_AND_BACK, v.stencilReference);
+    if (dirty(std::memcmp(v.blendConstants, c.blendConstants, sizeof(v.blendConstants)) != 0))
+        vkCmdSetBlendConstants(cmd_, v.blendConstants);
+
+    // Extended dynamic state 3: only what the device enabled. The rest is
+    // baked into the pipeline by PipelineBuilder.
+    if (pfnPolygonMode_ && dirty(v.polygonMode != c.polygonMode))
+        pfnPolygonMode_(cmd_, v.polygonMode);
+    if (pfnDepthClamp_ && dirty(v.depthClamp != c.depthClamp))
+        pfnDepthClamp_(cmd_, v.depthClamp ? VK_TRUE : VK_FALSE);
+    if (pfnSampleMask_ && dirty(v.sampleMask != c.sampleMask || v.samples != c.samples)) {
+        // One mask word per 32 samples.
+        VkSampleMask masks[2] = {v.sampleMask, v.sampleMask};
+        pfnSampleMask_(cmd_, v.samples, masks);
+    }
+    if (pfnAlphaToCoverage_ && dirty(v.alphaToCoverage != c.alphaToCoverage))
+        pfnAlphaToCoverage_(cmd_, v.alphaToCoverage ? VK_TRUE : VK_FALSE);
+    if (pfnBlendEnable_ && dirty(v.blendEnable != c.blendEnable)) {
+        VkBool32 enable = v.blendEnable ? VK_TRUE : VK_FALSE;
+        pfnBlendEnable_(cmd_, 0, 1, &enable);
+    }
+    if (pfnBlendEquation_ && dirty(!sameEquation(v.blendEquation, c.blendEquation)))
+        pfnBlendEquation_(cmd_, 0, 1, &v.blendEquation);
+    if (pfnWriteMask_ && dirty(v.colorWriteMask != c.colorWriteMask))
+        pfnWriteMask_(cmd_, 0, 1, &v.colorWriteMask);
+
+    current_ = v;
+    known_ = true;
+}
+
+} // namespace vksdl
@@ -0,0 +1,156 @@
+#include "file_io.hpp"
+
+#include <cstdio>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vksdl::detail {
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+        CloseHandle(file);
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file); // the mapping keeps the file open
+    if (mapping == nullptr)
+        return;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        return;
+    }
+
+    mapping_ = mapping;
+    data_ = static_cast<const std::uint8_t*>(view);
+    size_ = static_cast<std::size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return;
+    }
+
+    auto size = static_cast<std::size_t>(st.st_size);
+    void* view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping keeps the file open
+    if (view == MAP_FAILED)
+        return;
+
+    data_ = static_cast<const std::uint8_t*>(view);
+    size_ = size;
+#endif
+}
+
+MappedFile::~MappedFile() {
+    reset();
+}
+
+MappedFile::MappedFile(MappedFile&& o) noexcept : data_(o.data_), size_(o.size_) {
+#ifdef _WIN32
+    mapping_ = o.mapping_;
+    o.mapping_ = nullptr;
+#endif
+    o.data_ = nullptr;
+    o.size_ = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& o) noexcept {
+    if (this != &o) {
+        reset();
+        data_ = o.data_;
+        size_ = o.size_;
+#ifdef _WIN32
+        mapping_ = o.mapping_;
+        o.mapping_ = nullptr;
+#endif
+        o.data_ = nullptr;
+        o.size_ = 0;
+    }
+    return *this;
+}
+
+void MappedFile::reset() {
+    if (data_ != nullptr) {
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+#else
+        ::munmap(const_cast<std::uint8_t*>(data_), size_);
+#endif
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+
+bool writeFileAtomic(const std::filesystem::path& path, const void* data, std::size_t size) {
+    std::error_code ec;
+    if (path.has_parent_path())
+        std::filesystem::create_directories(path.parent_path(), ec);
+
+    std::filesystem::path tmp = path;
+    tmp += ".tmp";
+
+#ifdef _WIN32
+    std::FILE* file = _wfopen(tmp.c_str(), L"wb");
+#else
+    std::FILE* file = std::fopen(tmp.c_str(), "wb");
+#endif
+    if (file == nullptr)
+        return false;
+
+    bool ok = size == 0 || std::fwrite(data, 1, size, file) == size;
+    ok = std::fflush(file) == 0 && ok;
+    // Data must be durable before the rename publishes it, or a crash can
+    // leave a renamed-but-empty file behind.
+#ifdef _WIN32
+    ok = ok && _commit(_fileno(file)) == 0;
+#else
+    ok = ok && ::fsync(fileno(file)) == 0;
+#endif
+    ok = std::fclose(file) == 0 && ok;
+
+    if (ok) {
+#ifdef _WIN32
+        ok = MoveFileExW(tmp.c_str(), path.c_str(),
+                         MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        ok = std::rename(tmp.c_str(), path.c_str()) == 0;
+#endif
+    }
+
+    if (!ok)
+        std::filesystem::remove(tmp, ec);
+    return ok;
+}
+
+} // namespace vksdl::detail
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace vksdl::detail {
+
+// Read-only memory mapping of a whole file. Empty (data() == nullptr) when the
+// file is missing, empty or cannot be mapped. Move-only; unmaps on destruction.
+class MappedFile {
+  public:
+    MappedFile() = default;
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+    MappedFile(MappedFile&&) noexcept;
+    MappedFile& operator=(MappedFile&&) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] const std::uint8_t* data() const {
+        return data_;
+    }
+    [[nodiscard]] std::size_t size() const {
+        return size_;
+    }
+    [[nodiscard]] bool empty() const {
+        return size_ == 0;
+    }
+
+  private:
+    void reset();
+
+    const std::uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+#ifdef _WIN32
+    void* mapping_ = nullptr;
+#endif
+};
+
+// Writes `size` bytes to `<path>.tmp`, flushes them to disk, then renames over
+// `path`. Readers see either the old file or the complete new one, never a
+// partial write. Creates missing parent directories. False on any failure
+// (the temp file is removed and `path` is left untouched).
+[[nodiscard]] bool writeFileAtomic(const std::filesystem::path& path, const void* data,
+                                   std::size_t size);
+
+} // namespace vksdl::detail
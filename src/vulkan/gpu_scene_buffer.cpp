@@ -0,0 +1,224 @@
+#include <vksdl/allocator.hpp>
+#include <vksdl/gpu_scene_buffer.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <bit>
+
+namespace vksdl {
+
+Result<SceneBufferStorage> SceneBufferStorage::create(const Allocator& allocator,
+                                                      std::uint32_t elementSize,
+                                                      std::uint32_t count,
+                                                      std::uint32_t framesInFlight,
+                                                      VkDeviceSize stagingBytesPerFrame) {
+    if (elementSize == 0 || count == 0) {
+        return Error{"create GpuSceneBuffer", 0, "element size and count must be non-zero"};
+    }
+    if (framesInFlight == 0) {
+        return Error{"create GpuSceneBuffer", 0, "framesInFlight must be at least 1"};
+    }
+
+    VkDeviceSize total = static_cast<VkDeviceSize>(elementSize) * count;
+    if (stagingBytesPerFrame == 0 || stagingBytesPerFrame > total)
+        stagingBytesPerFrame = total;
+    if (stagingBytesPerFrame < elementSize) {
+        return Error{"create GpuSceneBuffer", 0,
+                     "stagingBytesPerFrame is smaller than one element"};
+    }
+    // Whole elements only, so a slice never splits one.
+    stagingBytesPerFrame -= stagingBytesPerFrame % elementSize;
+
+    auto buffer = BufferBuilder(allocator).storageBuffer().deviceAddressable().size(total).build();
+    if (!buffer.ok())
+        return std::move(buffer).error();
+
+    auto staging = BufferBuilder(allocator)
+                       .stagingBuffer()
+                       .size(stagingBytesPerFrame * framesInFlight)
+                       .build();
+    if (!staging.ok())
+        return std::move(staging).error();
+
+    SceneBufferStorage s(allocator, std::move(buffer).value(), std::move(staging).value());
+    s.address_ = s.buffer_.deviceAddress();
+    s.elementSize_ = elementSize;
+    s.count_ = count;
+    s.frames_ = framesInFlight;
+    s.sliceBytes_ = stagingBytesPerFrame;
+    s.dirty_.resize((count + 63) / 64, 0);
+    s.markAllDirty();
+    return s;
+}
+
+void SceneBufferStorage::markDirty(std::uint32_t first, std::uint32_t count) {
+    if (first >= count_)
+        return;
+    std::uint32_t end = first + std::min(count, count_ - first);
+    while (first < end) {
+        std::uint32_t bit = first % 64;
+        std::uint32_t n = std::min(64 - bit, end - first);
+        std::uint64_t mask = n == 64 ? ~0ull : ((1ull << n) - 1) << bit;
+        dirty_[first / 64] |= mask;
+        first += n;
+    }
+}
+
+void SceneBufferStorage::markAllDirty() {
+    markDirty(0, count_);
+}
+
+void SceneBufferStorage::clearDirty(std::uint32_t first, std::uint32_t count) {
+    std::uint32_t end = first + count;
+    while (first < end) {
+        std::uint32_t bit = first % 64;
+        std::uint32_t n = std::min(64 - bit, end - first);
+        std::uint64_t mask = n == 64 ? ~0ull : ((1ull << n) - 1) << bit;
+        dirty_[first / 64] &= ~mask;
+        first += n;
+    }
+}
+
+std::uint32_t SceneBufferStorage::dirtyCount() const {
+    std::uint32_t n = 0;
+    for (std::uint64_t w : dirty_)
+        n += static_cast<std::uint32_t>(std::popcount(w));
+    return n;
+}
+
+// First dirty element at or after `from`, or count_.
+std::uint32_t SceneBufferStorage::findDirty(std::uint32_t from) const {
+    std::size_t word = from / 64;
+    if (word >= dirty_.size())
+        return count_;
+    std::uint64_t bits = dirty_[word] & (~0ull << (from % 64));
+    while (bits == 0) {
+        if (++word == dirty_.size())
+            return count_;
+        bits = dirty_[word];
+    }
+    auto i = static_cast<std::uint32_t>(word * 64 + std::countr_zero(bits));
+    return std::min(i, count_);
+}
+
+// First clean element at or after `from`, or count_. Bits past count_ are
+// never set, so the scan always stops inside the last word.
+std::uint32_t SceneBufferStorage::findClean(std::uint32_t from) const {
+    std::size_t word = from / 64;
+    if (word >= dirty_.size())
+        return count_;
+    std::uint64_t bits = ~dirty_[word] & (~0ull << (from % 64));
+    while (bits == 0) {
+        if (++word == dirty_.size())
+            return count_;
+        bits = ~dirty_[word];
+    }
+    auto i = static_cast<std::uint32_t>(word * 64 + std::countr_zero(bits));
+    return std::min(i, count_);
+}
+
+Result<SceneUploadStats> SceneBufferStorage::upload(VkCommandBuffer cmd, std::uint32_t frameIndex,
+                                                    const void* mirror,
+                                                    VkPipelineStageFlags2 dstStage,
+                                                    VkAccessFlags2 dstAccess) {
+    SceneUploadStats stats;
+    stats.dirtyElements = dirtyCount();
+    if (stats.dirtyElements == 0)
+        return stats;
+
+    const auto* src = static_cast<const std::uint8_t*>(mirror);
+    VkDeviceSize sliceOffset = (frameIndex % frames_) * sliceBytes_;
+    auto* slice = static_cast<std::uint8_t*>(staging_.mappedData()) + sliceOffset;
+    auto capacity = static_cast<std::uint32_t>(sliceBytes_ / elementSize_);
+    std::uint32_t staged = 0;
+
+    // Walk the dirty runs in order. A run that starts within mergeGap_ clean
+    // elements of the previous one extends it instead of opening a region.
+    regions_.clear();
+    std::uint32_t runFirst = 0;
+    std::uint32_t runEnd = 0;
+    bool open = false;
+    auto flush = [&] {
+        std::uint32_t n = std::min(runEnd - runFirst, capacity - staged);
+        if (n == 0)
+            return;
+        VkDeviceSize bytes = static_cast<VkDeviceSize>(n) * elementSize_;
+        VkDeviceSize srcOffset = static_cast<VkDeviceSize>(runFirst) * elementSize_;
+        streamingCopy(slice + static_cast<std::size_t>(staged) * elementSize_, src + srcOffset,
+                      static_cast<std::size_t>(bytes));
+        regions_.push_back(
+            {sliceOffset + static_cast<VkDeviceSize>(staged) * elementSize_, srcOffset, bytes});
+        clearDirty(runFirst, n);
+        staged += n;
+        stats.copiedElements += n;
+        stats.bytes += bytes;
+    };
+
+    for (std::uint32_t i = findDirty(0); i < count_ && staged < capacity; i = findDirty(i)) {
+        std::uint32_t end = findClean(i);
+        if (open && i - runEnd <= mergeGap_) {
+            runEnd = end;
+        } else {
+            if (open)
+                flush();
+            runFirst = i;
+            runEnd = end;
+            open = true;
+        }
+        i = end;
+    }
+    if (open)
+        flush();
+
+    stats.regions = static_cast<std::uint32_t>(regions_.size());
+    stats.deferredElements = dirtyCount();
+    if (regions_.empty())
+        return stats;
+
+    stagingWrites_.markWritten(staging_, sliceOffset,
+                               static_cast<VkDeviceSize>(staged) * elementSize_);
+    auto flushed = stagingWrites_.flush();
+    if (!flushed.ok()) {
+        // Nothing recorded: the staged runs stay dirty for the next upload().
+        for (const auto& r : regions_) {
+            markDirty(static_cast<std::uint32_t>(r.dstOffset / elementSize_),
+                      static_cast<std::uint32_t>(r.size / elementSize_));
+        }
+        regions_.clear();
+        return std::move(flushed).error();
+    }
+
+    // Earlier reads of the buffer (previous frames still in flight) finish
+    // before the copy overwrites it; the copy is visible to this frame's reads.
+    VkBufferMemoryBarrier2 barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+    barrier.srcStageMask = dstStage;
+    barrier.srcAccessMask = VK_ACCESS_2_NONE;
+    barrier.dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+    barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = buffer_.vkBuffer();
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+
+    VkDependencyInfo dep{};
+    dep.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dep.bufferMemoryBarrierCount = 1;
+    dep.pBufferMemoryBarriers = &barrier;
+    vkCmdPipelineBarrier2(cmd, &dep);
+
+    vkCmdCopyBuffer(cmd, staging_.vkBuffer(), buffer_.vkBuffer(),
+                    static_cast<std::uint32_t>(regions_.size()), regions_.data());
+
+    barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+    barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    barrier.dstStageMask = dstStage;
+    barrier.dstAccessMask = dstAccess;
+    vkCmdPipelineBarrier2(cmd, &dep);
+
+    return stats;
+}
+
+} // namespace vksdl
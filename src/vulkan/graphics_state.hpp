@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vksdl/pipeline_desc.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+
+namespace vksdl::detail {
+
+// Fixed-function state of a graphics pipeline, borrowed from a PipelineDesc
+// or a PipelineBuilder for the duration of fillGraphicsCreateInfo().
+struct GraphicsState {
+    const VkVertexInputBindingDescription* bindings = nullptr;
+    std::uint32_t bindingCount = 0;
+    const VkVertexInputAttributeDescription* attributes = nullptr;
+    std::uint32_t attributeCount = 0;
+    VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+    std::uint32_t viewMask = 0;
+    VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;
+    VkCullModeFlags cullMode = VK_CULL_MODE_NONE;
+    VkFrontFace frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+    VkCompareOp depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+    bool enableBlending = false;
+    // Complete list, viewport and scissor included; must outlive `out`.
+    const VkDynamicState* dynamicStates = nullptr;
+    std::uint32_t dynamicStateCount = 0;
+};
+
+// With dynamic topology the pipeline still fixes the topology class unless
+// dynamicPrimitiveTopologyUnrestricted is set; one representative per class.
+VkPrimitiveTopology topologyClass(VkPrimitiveTopology t);
+
+// Writes the create-info chain for `state`: the one place PipelineDesc::fill()
+// and PipelineBuilder::build() get their Vk*CreateInfo structs from. States
+// set dynamically are written in canonical form, so states that differ only
+// in those values produce identical create infos. A null `frag` leaves the
+// fragment stage out.
+void fillGraphicsCreateInfo(PipelineDescCreateInfo& out, const GraphicsState& state,
+                            VkShaderModule vert, VkShaderModule frag,
+                            const VkSpecializationInfo* spec, VkPipelineLayout layout);
+
+} // namespace vksdl::detail
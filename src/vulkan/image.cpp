@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <utility>
 
 #if defined(_MSC_VER)
 #pragma warning(push)
@@ -25,6 +26,7 @@
 namespace vksdl {
 
 Image::~Image() {
+    views_.clear();
     if (view_ != VK_NULL_HANDLE) {
         vkDestroyImageView(device_, view_, nullptr);
     }
@@ -36,7 +38,7 @@ Image::~Image() {
 Image::Image(Image&& o) noexcept
     : allocator_(o.allocator_), device_(o.device_), image_(o.image_), view_(o.view_),
       allocation_(o.allocation_), format_(o.format_), extent_(o.extent_), mipLevels_(o.mipLevels_),
-      samples_(o.samples_) {
+      samples_(o.samples_), views_(std::move(o.views_)) {
     o.allocator_ = nullptr;
     o.device_ = VK_NULL_HANDLE;
     o.image_ = VK_NULL_HANDLE;
@@ -46,6 +48,7 @@ Image::Image(Image&& o) noexcept
 
 Image& Image::operator=(Image&& o) noexcept {
     if (this != &o) {
+        views_.clear();
         if (view_ != VK_NULL_HANDLE) {
             vkDestroyImageView(device_, view_, nullptr);
         }
@@ -61,6 +64,7 @@ Image& Image::operator=(Image&& o) noexcept {
         extent_ = o.extent_;
         mipLevels_ = o.mipLevels_;
         samples_ = o.samples_;
+        views_ = std::move(o.views_);
         o.allocator_ = nullptr;
         o.device_ = VK_NULL_HANDLE;
         o.image_ = VK_NULL_HANDLE;
@@ -221,6 +225,7 @@ Result<Image> ImageBuilder::build() {
                      "vkCreateImageView failed for VMA-allocated image"};
     }
 
+    img.views_ = ImageViewCache(device_, img.image_, format_, aspect_, mipLevels_, 1);
     return img;
 }
 
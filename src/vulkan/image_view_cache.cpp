@@ -0,0 +1,100 @@
+#include <vksdl/image_view_cache.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <string>
+#include <utility>
+
+namespace vksdl {
+
+ImageViewCache::ImageViewCache(VkDevice device, VkImage image, VkFormat format,
+                               VkImageAspectFlags aspect, std::uint32_t mipLevels,
+                               std::uint32_t arrayLayers)
+    : device_(device), image_(image), format_(format), aspect_(aspect), mipLevels_(mipLevels),
+      arrayLayers_(arrayLayers) {}
+
+ImageViewCache::~ImageViewCache() {
+    clear();
+}
+
+ImageViewCache::ImageViewCache(ImageViewCache&& o) noexcept
+    : device_(o.device_), image_(o.image_), format_(o.format_), aspect_(o.aspect_),
+      mipLevels_(o.mipLevels_), arrayLayers_(o.arrayLayers_), entries_(std::move(o.entries_)) {
+    o.entries_.clear();
+    o.image_ = VK_NULL_HANDLE;
+}
+
+ImageViewCache& ImageViewCache::operator=(ImageViewCache&& o) noexcept {
+    if (this != &o) {
+        clear();
+        device_ = o.device_;
+        image_ = o.image_;
+        format_ = o.format_;
+        aspect_ = o.aspect_;
+        mipLevels_ = o.mipLevels_;
+        arrayLayers_ = o.arrayLayers_;
+        entries_ = std::move(o.entries_);
+        o.entries_.clear();
+        o.image_ = VK_NULL_HANDLE;
+    }
+    return *this;
+}
+
+void ImageViewCache::clear() {
+    for (const auto& e : entries_)
+        vkDestroyImageView(device_, e.view, nullptr);
+    entries_.clear();
+}
+
+Result<VkImageView> ImageViewCache::view(const ImageViewDesc& desc) {
+    if (image_ == VK_NULL_HANDLE)
+        return Error{"create cached image view", 0, "view cache has no image"};
+
+    // Resolve defaults so equivalent descriptions share one view.
+    ImageViewDesc d = desc;
+    if (d.baseMipLevel >= mipLevels_ || d.baseArrayLayer >= arrayLayers_) {
+        return Error{"create cached image view", 0,
+                     "base mip " + std::to_string(d.baseMipLevel) + " / layer " +
+                         std::to_string(d.baseArrayLayer) + " outside an image with " +
+                         std::to_string(mipLevels_) + " mips and " +
+                         std::to_string(arrayLayers_) + " layers"};
+    }
+    if (d.levelCount == VK_REMAINING_MIP_LEVELS)
+        d.levelCount = mipLevels_ - d.baseMipLevel;
+    if (d.layerCount == VK_REMAINING_ARRAY_LAYERS)
+        d.layerCount = arrayLayers_ - d.baseArrayLayer;
+    if (d.levelCount == 0 || d.layerCount == 0 || d.levelCount > mipLevels_ - d.baseMipLevel ||
+        d.layerCount > arrayLayers_ - d.baseArrayLayer) {
+        return Error{"create cached image view", 0, "subresource range exceeds the image"};
+    }
+    if (d.viewType == VK_IMAGE_VIEW_TYPE_MAX_ENUM)
+        d.viewType = d.layerCount == 1 ? VK_IMAGE_VIEW_TYPE_2D : VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    if (d.format == VK_FORMAT_UNDEFINED)
+        d.format = format_;
+    if (d.aspect == 0)
+        d.aspect = aspect_;
+
+    for (const auto& e : entries_) {
+        if (e.desc == d)
+            return e.view;
+    }
+
+    VkImageViewCreateInfo ci{};
+    ci.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    ci.image = image_;
+    ci.viewType = d.viewType;
+    ci.format = d.format;
+    ci.subresourceRange = {d.aspect, d.baseMipLevel, d.levelCount, d.baseArrayLayer,
+                           d.layerCount};
+
+    VkImageView view = VK_NULL_HANDLE;
+    VkResult vr = vkCreateImageView(device_, &ci, nullptr, &view);
+    if (vr != VK_SUCCESS) {
+        return Error{"create cached image view", static_cast<std::int32_t>(vr),
+                     "vkCreateImageView failed"};
+    }
+    entries_.push_back({d, view});
+    return view;
+}
+
+} // namespace vksdl
@@ -0,0 +1,123 @@
+#include <vksdl/allocator.hpp>
+#include <vksdl/buffer.hpp>
+#include <vksdl/mapped_writes.hpp>
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable : 4100) // unreferenced formal parameter
+#pragma warning(disable : 4189) // local variable initialized but not referenced
+#pragma warning(disable : 4244) // conversion, possible loss of data
+#elif defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+#include <vk_mem_alloc.h>
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#elif defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VKSDL_STREAMING_STORES 1
+#endif
+
+namespace vksdl {
+
+void streamingCopy(void* dst, const void* src, std::size_t bytes) {
+#ifdef VKSDL_STREAMING_STORES
+    if (bytes >= kStreamingCopyThreshold) {
+        auto* d = static_cast<std::uint8_t*>(dst);
+        const auto* s = static_cast<const std::uint8_t*>(src);
+
+        // Align the destination so every stream store is a full 16 bytes.
+        std::size_t head = (16 - (reinterpret_cast<std::uintptr_t>(d) & 15)) & 15;
+        std::memcpy(d, s, head);
+        d += head;
+        s += head;
+        bytes -= head;
+
+        // 64 bytes per iteration: one write-combining buffer per burst.
+        for (; bytes >= 64; bytes -= 64, d += 64, s += 64) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 16));
+            __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 32));
+            __m128i e = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 48));
+            _mm_stream_si128(reinterpret_cast<__m128i*>(d), a);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(d + 16), b);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(d + 32), c);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(d + 48), e);
+        }
+        std::memcpy(d, s, bytes);
+        _mm_sfence();
+        return;
+    }
+#endif
+    std::memcpy(dst, src, bytes);
+}
+
+MappedWrites::MappedWrites(const Allocator& allocator) : allocator_(allocator.vmaAllocator()) {}
+
+void MappedWrites::write(const Buffer& dst, VkDeviceSize offset, const void* src,
+                         VkDeviceSize size) {
+    assert(dst.mappedData() != nullptr && "MappedWrites::write needs a mapped buffer");
+    assert(offset + size <= dst.size());
+    streamingCopy(static_cast<std::uint8_t*>(dst.mappedData()) + offset, src,
+                  static_cast<std::size_t>(size));
+    markWritten(dst, offset, size);
+}
+
+void MappedWrites::markWritten(const Buffer& dst, VkDeviceSize offset, VkDeviceSize size) {
+    assert(offset + size <= dst.size());
+    if (size == 0 || dst.hostCoherent())
+        return;
+    ranges_.push_back({dst.allocation_, offset, size});
+}
+
+Result<void> MappedWrites::flush() {
+    lastFlushRanges_ = 0;
+    if (ranges_.empty())
+        return {};
+
+    std::sort(ranges_.begin(), ranges_.end(), [](const Range& a, const Range& b) {
+        return a.allocation != b.allocation ? a.allocation < b.allocation : a.offset < b.offset;
+    });
+
+    flushAllocations_.clear();
+    flushOffsets_.clear();
+    flushSizes_.clear();
+    for (const Range& r : ranges_) {
+        if (!flushAllocations_.empty() && flushAllocations_.back() == r.allocation &&
+            r.offset <= flushOffsets_.back() + flushSizes_.back()) {
+            VkDeviceSize end = std::max(flushOffsets_.back() + flushSizes_.back(),
+                                        r.offset + r.size);
+            flushSizes_.back() = end - flushOffsets_.back();
+            continue;
+        }
+        flushAllocations_.push_back(r.allocation);
+        flushOffsets_.push_back(r.offset);
+        flushSizes_.push_back(r.size);
+    }
+    ranges_.clear();
+    lastFlushRanges_ = flushAllocations_.size();
+
+    // VMA rounds each range out to nonCoherentAtomSize.
+    VkResult vr = vmaFlushAllocations(allocator_, static_cast<std::uint32_t>(lastFlushRanges_),
+                                      flushAllocations_.data(), flushOffsets_.data(),
+                                      flushSizes_.data());
+    if (vr != VK_SUCCESS) {
+        return Error{"flush mapped writes", static_cast<std::int32_t>(vr),
+                     "vmaFlushAllocations failed"};
+    }
+    return {};
+}
+
+} // namespace vksdl
@@ -0,0 +1,144 @@
+#include <vksdl/allocator.hpp>
+#include <vksdl/bindless_table.hpp>
+#include <vksdl/device.hpp>
+#include <vksdl/material_table.hpp>
+#include <vksdl/texture.hpp>
+
+#include <utility>
+
+namespace vksdl {
+
+Result<MaterialTable> MaterialTable::create(const Allocator& allocator, const Device& device,
+                                            BindlessTable& textures, VkSampler sampler,
+                                            std::uint32_t capacity,
+                                            std::uint32_t firstTextureSlot,
+                                            std::uint32_t framesInFlight) {
+    if (textures.descriptorType() != VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER) {
+        return Error{"create material table", 0,
+                     "BindlessTable must hold VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER"};
+    }
+    if (sampler == VK_NULL_HANDLE) {
+        return Error{"create material table", 0, "sampler must not be null"};
+    }
+    if (firstTextureSlot > textures.capacity()) {
+        return Error{"create material table", 0,
+                     "firstTextureSlot " + std::to_string(firstTextureSlot) +
+                         " is past the BindlessTable capacity " +
+                         std::to_string(textures.capacity())};
+    }
+
+    auto params = GpuSceneBuffer<GpuMaterial>::create(allocator, capacity, framesInFlight);
+    if (!params.ok())
+        return std::move(params).error();
+
+    MaterialTable table(std::move(params).value());
+    table.allocator_ = &allocator;
+    table.device_ = &device;
+    table.textures_ = &textures;
+    table.sampler_ = sampler;
+    table.firstSlot_ = firstTextureSlot;
+    table.nextSlot_ = firstTextureSlot;
+    return table;
+}
+
+Result<std::uint32_t> MaterialTable::add(const Material& material) {
+    if (count_ >= capacity()) {
+        return Error{"add material", 0,
+                     "material table is full (capacity " + std::to_string(capacity()) + ")"};
+    }
+    auto packed = pack(material);
+    if (!packed.ok())
+        return std::move(packed).error();
+    params_.set(count_, packed.value());
+    return count_++;
+}
+
+Result<void> MaterialTable::set(std::uint32_t id, const Material& material) {
+    if (id >= count_) {
+        return Error{"set material", 0,
+                     "material id " + std::to_string(id) + " is not registered (count " +
+                         std::to_string(count_) + ")",
+                     ErrorCode::InvalidArgument};
+    }
+    auto packed = pack(material);
+    if (!packed.ok())
+        return std::move(packed).error();
+    // Keep the application's flags: they are not part of Material.
+    packed.value().flags = params_[id].flags;
+    params_.set(id, packed.value());
+    return {};
+}
+
+Result<GpuMaterial> MaterialTable::pack(const Material& material) {
+    GpuMaterial gpu;
+    for (int i = 0; i < 4; ++i)
+        gpu.baseColor[i] = material.baseColor[i];
+    gpu.metallic = material.metallic;
+    gpu.roughness = material.roughness;
+
+    if (!material.diffuseTexture.empty()) {
+#if VKSDL_HAS_LOADERS
+        auto slot = loadTexture(material.diffuseTexture);
+        if (!slot.ok())
+            return std::move(slot).error();
+        gpu.diffuseTexture = slot.value();
+#else
+        return Error{"pack material", 0,
+                     "material '" + material.name + "' has a diffuse texture, but vksdl was "
+                     "built without loaders (VKSDL_HAS_LOADERS=0)"};
+#endif
+    }
+    return gpu;
+}
+
+#if VKSDL_HAS_LOADERS
+Result<std::uint32_t> MaterialTable::loadTexture(const std::filesystem::path& path) {
+    std::string key = path.lexically_normal().generic_string();
+    if (auto it = pathSlots_.find(key); it != pathSlots_.end())
+        return it->second;
+
+    // Fail before the load and upload rather than after them.
+    if (nextSlot_ >= textures_->capacity()) {
+        return Error{"load material texture", 0,
+                     "BindlessTable is full (capacity " + std::to_string(textures_->capacity()) +
+                         ")"};
+    }
+
+    auto pixels = loadImage(path);
+    if (!pixels.ok())
+        return std::move(pixels).error();
+
+    auto image = ImageBuilder(*allocator_)
+                     .size(pixels.value().width, pixels.value().height)
+                     .format(VK_FORMAT_R8G8B8A8_SRGB)
+                     .sampled()
+                     .build();
+    if (!image.ok())
+        return std::move(image).error();
+
+    auto uploaded = uploadToImage(*allocator_, *device_, image.value(), pixels.value().pixels,
+                                  pixels.value().sizeBytes());
+    if (!uploaded.ok())
+        return std::move(uploaded).error();
+
+    auto slot = addTexture(image.value().vkImageView(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    if (!slot.ok())
+        return std::move(slot).error();
+
+    images_.push_back(std::move(image).value());
+    pathSlots_.emplace(std::move(key), slot.value());
+    return slot.value();
+}
+#endif
+
+Result<std::uint32_t> MaterialTable::addTexture(VkImageView view, VkImageLayout layout) {
+    if (nextSlot_ >= textures_->capacity()) {
+        return Error{"add material texture", 0,
+                     "BindlessTable is full (capacity " + std::to_string(textures_->capacity()) +
+                         ")"};
+    }
+    textures_->writeImage(nextSlot_, view, layout, sampler_);
+    return nextSlot_++;
+}
+
+} // namespace vksdl
@@ -1,5 +1,6 @@
 #include <vksdl/allocator.hpp>
 #include <vksdl/device.hpp>
+#include <vksdl/mapped_writes.hpp>
 #include <vksdl/mesh.hpp>
 
 #if VKSDL_HAS_LOADERS
@@ -25,7 +26,6 @@
 #pragma GCC diagnostic pop
 #endif
 
-#include <cstring>
 
 namespace vksdl {
 
@@ -136,14 +136,22 @@ Result<Mesh> uploadMesh(const Allocator& allocator, const Device& device,
 
     VmaAllocationCreateInfo deviceAllocCI{};
     deviceAllocCI.usage = VMA_MEMORY_USAGE_AUTO;
+    if (allocator.preferDirectUpload(totalSize)) {
+        // Host-writable device-local memory when the BAR is large enough;
+        // VMA falls back to unmapped device-local memory otherwise.
+        deviceAllocCI.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+                              VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT |
+                              VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    }
 
     Mesh mesh;
     mesh.allocator_ = vma;
     mesh.vertexCount_ = static_cast<std::uint32_t>(meshData.vertices.size());
     mesh.indexCount_ = static_cast<std::uint32_t>(meshData.indices.size());
 
+    VmaAllocationInfo vertexInfo{};
     VkResult vr = vmaCreateBuffer(vma, &vertexCI, &deviceAllocCI, &mesh.vertexBuffer_,
-                                  &mesh.vertexAlloc_, nullptr);
+                                  &mesh.vertexAlloc_, &vertexInfo);
     if (vr != VK_SUCCESS) {
         return Error{"upload mesh", static_cast<std::int32_t>(vr),
                      "failed to create vertex buffer"};
@@ -155,12 +163,28 @@ Result<Mesh> uploadMesh(const Allocator& allocator, const Device& device,
     indexCI.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
                     VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
 
+    VmaAllocationInfo indexInfo{};
     vr = vmaCreateBuffer(vma, &indexCI, &deviceAllocCI, &mesh.indexBuffer_, &mesh.indexAlloc_,
-                         nullptr);
+                         &indexInfo);
     if (vr != VK_SUCCESS) {
         return Error{"upload mesh", static_cast<std::int32_t>(vr), "failed to create index buffer"};
     }
 
+    // Both landed in host-visible memory: write them directly, no GPU copy.
+    if (vertexInfo.pMappedData != nullptr && indexInfo.pMappedData != nullptr) {
+        streamingCopy(vertexInfo.pMappedData, meshData.vertices.data(),
+                      static_cast<std::size_t>(vertexSize));
+        streamingCopy(indexInfo.pMappedData, meshData.indices.data(),
+                      static_cast<std::size_t>(indexSize));
+        VmaAllocation allocs[] = {mesh.vertexAlloc_, mesh.indexAlloc_};
+        vr = vmaFlushAllocations(vma, 2, allocs, nullptr, nullptr);
+        if (vr != VK_SUCCESS) {
+            return Error{"upload mesh", static_cast<std::int32_t>(vr),
+                         "failed to flush mesh buffers"};
+        }
+        return mesh;
+    }
+
     VkBufferCreateInfo stagingCI{};
     stagingCI.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
     stagingCI.size = totalSize;
@@ -183,8 +207,8 @@ Result<Mesh> uploadMesh(const Allocator& allocator, const Device& device,
     }
 
     auto* dst = static_cast<unsigned char*>(stagingInfo.pMappedData);
-    std::memcpy(dst, meshData.vertices.data(), static_cast<std::size_t>(vertexSize));
-    std::memcpy(dst + vertexSize, meshData.indices.data(), static_cast<std::size_t>(indexSize));
+    streamingCopy(dst, meshData.vertices.data(), static_cast<std::size_t>(vertexSize));
+    streamingCopy(dst + vertexSize, meshData.indices.data(), static_cast<std::size_t>(indexSize));
 
     VkCommandPoolCreateInfo poolCI{};
     poolCI.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -1,10 +1,13 @@
 #include <vksdl/descriptor_set.hpp>
 #include <vksdl/device.hpp>
 #include <vksdl/pipeline.hpp>
+#include <vksdl/pipeline_binary_store.hpp>
 #include <vksdl/pipeline_cache.hpp>
 #include <vksdl/shader_reflect.hpp>
 #include <vksdl/swapchain.hpp>
 
+#include "graphics_state.hpp"
+
 #include <vulkan/vulkan.h>
 
 #include <algorithm>
@@ -19,6 +22,35 @@
 
 namespace vksdl {
 
+namespace {
+
+// Everything Vulkan 1.3 core can set dynamically for a single-viewport,
+// single-attachment pipeline (extended dynamic state 1 and 2 are core).
+// Vertex input stride is left static: it changes vkCmdBindVertexBuffers.
+constexpr VkDynamicState kMaximalCoreStates[] = {
+    VK_DYNAMIC_STATE_LINE_WIDTH,
+    VK_DYNAMIC_STATE_DEPTH_BIAS,
+    VK_DYNAMIC_STATE_BLEND_CONSTANTS,
+    VK_DYNAMIC_STATE_DEPTH_BOUNDS,
+    VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK,
+    VK_DYNAMIC_STATE_STENCIL_WRITE_MASK,
+    VK_DYNAMIC_STATE_STENCIL_REFERENCE,
+    VK_DYNAMIC_STATE_CULL_MODE,
+    VK_DYNAMIC_STATE_FRONT_FACE,
+    VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY,
+    VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE,
+    VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE,
+    VK_DYNAMIC_STATE_DEPTH_COMPARE_OP,
+    VK_DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE,
+    VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE,
+    VK_DYNAMIC_STATE_STENCIL_OP,
+    VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE,
+    VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE,
+    VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE,
+};
+
+} // namespace
+
 Result<std::vector<std::uint32_t>> readSpv(const std::filesystem::path& path) {
     std::ifstream file(path, std::ios::binary | std::ios::ate);
     if (!file.is_open()) {
@@ -112,7 +144,23 @@ void Pipeline::pushConstants(VkCommandBuffer cmd, const void* data, std::uint32_
     vkCmdPushConstants(cmd, layout_, pcStages_, 0, size, data);
 }
 
-PipelineBuilder::PipelineBuilder(const Device& device) : device_(device.vkDevice()) {}
+PipelineBuilder::PipelineBuilder(const Device& device) : device_(device.vkDevice()) {
+    const auto& eds3 = device.extendedDynamicState3();
+    if (eds3.polygonMode)
+        eds3States_.push_back(VK_DYNAMIC_STATE_POLYGON_MODE_EXT);
+    if (eds3.sampleMask)
+        eds3States_.push_back(VK_DYNAMIC_STATE_SAMPLE_MASK_EXT);
+    if (eds3.alphaToCoverageEnable)
+        eds3States_.push_back(VK_DYNAMIC_STATE_ALPHA_TO_COVERAGE_ENABLE_EXT);
+    if (eds3.depthClampEnable)
+        eds3States_.push_back(VK_DYNAMIC_STATE_DEPTH_CLAMP_ENABLE_EXT);
+    if (eds3.colorBlendEnable)
+        eds3States_.push_back(VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT);
+    if (eds3.colorBlendEquation)
+        eds3States_.push_back(VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT);
+    if (eds3.colorWriteMask)
+        eds3States_.push_back(VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT);
+}
 
 PipelineBuilder& PipelineBuilder::vertexShader(const std::filesystem::path& spvPath) {
     vertPath_ = spvPath;
@@ -155,6 +203,11 @@ PipelineBuilder& PipelineBuilder::depthFormat(VkFormat format) {
     return *this;
 }
 
+PipelineBuilder& PipelineBuilder::viewMask(std::uint32_t mask) {
+    viewMask_ = mask;
+    return *this;
+}
+
 PipelineBuilder& PipelineBuilder::vertexBinding(std::uint32_t binding, std::uint32_t stride,
                                                 VkVertexInputRate inputRate) {
     vertexBindings_.push_back({binding, stride, inputRate});
@@ -263,6 +316,52 @@ PipelineBuilder& PipelineBuilder::dynamicFrontFace() {
     return dynamicState(VK_DYNAMIC_STATE_FRONT_FACE);
 }
 
+PipelineBuilder& PipelineBuilder::maximalDynamicState() {
+    maximalDynamic_ = true;
+    return *this;
+}
+
+std::vector<VkDynamicState> PipelineBuilder::dynamicStates() const {
+    std::vector<VkDynamicState> states = {
+        VK_DYNAMIC_STATE_VIEWPORT,
+        VK_DYNAMIC_STATE_SCISSOR,
+    };
+    auto add = [&](VkDynamicState s) {
+        if (std::find(states.begin(), states.end(), s) == states.end())
+            states.push_back(s);
+    };
+    for (auto s : extraDynamicStates_)
+        add(s);
+    if (maximalDynamic_) {
+        for (auto s : kMaximalCoreStates)
+            add(s);
+        for (auto s : eds3States_)
+            add(s);
+    }
+    return states;
+}
+
+DynamicStateValues PipelineBuilder::dynamicValues() const {
+    DynamicStateValues v;
+    v.topology = topology_;
+    v.polygonMode = polygonMode_;
+    v.cullMode = cullMode_;
+    v.frontFace = frontFace_;
+    v.samples = samples_;
+    if (depthFormat_ != VK_FORMAT_UNDEFINED) {
+        v.depthTest = true;
+        v.depthWrite = true;
+    }
+    v.depthCompareOp = depthCompareOp_;
+    if (enableBlending_) {
+        v.blendEnable = true;
+        v.blendEquation = {VK_BLEND_FACTOR_SRC_ALPHA, VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+                           VK_BLEND_OP_ADD,           VK_BLEND_FACTOR_ONE,
+                           VK_BLEND_FACTOR_ZERO,      VK_BLEND_OP_ADD};
+    }
+    return v;
+}
+
 PipelineBuilder& PipelineBuilder::specialize(const VkSpecializationInfo& info) {
     externalSpecInfo_ = info;
     return *this;
@@ -278,6 +377,11 @@ PipelineBuilder& PipelineBuilder::cache(VkPipelineCache c) {
     return *this;
 }
 
+PipelineBuilder& PipelineBuilder::binaryStore(PipelineBinaryStore& store) {
+    binaryStore_ = &store;
+    return *this;
+}
+
 PipelineBuilder& PipelineBuilder::pushConstantRange(VkPushConstantRange range) {
 #ifndef NDEBUG
     if (range.offset + range.size > 128) {
@@ -322,11 +426,112 @@ Result<VkShaderModule> PipelineBuilder::createModule(const std::vector<std::uint
     return module;
 }
 
+Result<void> PipelineBuilder::serialize(PipelineKeyWriter& w) const {
+    // Bump when the encoding below changes.
+    constexpr std::uint32_t kVersion = 3;
+    w.u32(kVersion);
+
+    auto writeShader = [&](const std::filesystem::path& path,
+                           VkShaderModule module) -> Result<void> {
+        if (module != VK_NULL_HANDLE) {
+            w.u8(1).u64(reinterpret_cast<std::uint64_t>(module));
+            return {};
+        }
+        if (path.empty()) {
+            w.u8(0);
+            return {};
+        }
+        auto code = readSpv(path);
+        if (!code.ok())
+            return code.error();
+        w.u8(2).blob(code.value().data(), code.value().size() * sizeof(std::uint32_t));
+        return {};
+    };
+    auto vert = writeShader(vertPath_, vertModule_);
+    if (!vert.ok())
+        return vert;
+    auto frag = writeShader(fragPath_, fragModule_);
+    if (!frag.ok())
+        return frag;
+
+    w.e32(colorFormat_).e32(depthFormat_).u32(viewMask_);
+
+    w.u32(static_cast<std::uint32_t>(vertexBindings_.size()));
+    for (const auto& b : vertexBindings_)
+        w.u32(b.binding).u32(b.stride).e32(b.inputRate);
+    w.u32(static_cast<std::uint32_t>(vertexAttributes_.size()));
+    for (const auto& a : vertexAttributes_)
+        w.u32(a.location).u32(a.binding).e32(a.format).u32(a.offset);
+
+    // Values of dynamic states are not part of the pipeline (the create info
+    // carries them in canonical form); a placeholder keeps the field layout.
+    auto dyn = dynamicStates();
+    auto isDyn = [&](VkDynamicState s) {
+        return std::find(dyn.begin(), dyn.end(), s) != dyn.end();
+    };
+    auto fixedValue = [&](VkDynamicState s, std::uint32_t value) {
+        w.u32(isDyn(s) ? 0xFFFFFFFFu : value);
+    };
+    w.e32(isDyn(VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY) ? detail::topologyClass(topology_)
+                                                     : topology_);
+    fixedValue(VK_DYNAMIC_STATE_POLYGON_MODE_EXT, polygonMode_);
+    fixedValue(VK_DYNAMIC_STATE_CULL_MODE, cullMode_);
+    fixedValue(VK_DYNAMIC_STATE_FRONT_FACE, frontFace_);
+    w.e32(samples_);
+    bool dynamicBlend = isDyn(VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT) &&
+                        isDyn(VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT);
+    w.boolean(enableBlending_ && !dynamicBlend);
+    fixedValue(VK_DYNAMIC_STATE_DEPTH_COMPARE_OP, depthCompareOp_);
+
+    w.u32(static_cast<std::uint32_t>(dyn.size()));
+    for (auto ds : dyn)
+        w.e32(ds);
+
+    w.u32(static_cast<std::uint32_t>(pushConstantRanges_.size()));
+    for (const auto& r : pushConstantRanges_)
+        w.e32(r.stageFlags).u32(r.offset).u32(r.size);
+    w.u32(static_cast<std::uint32_t>(descriptorSetLayouts_.size()));
+    for (auto dsl : descriptorSetLayouts_)
+        w.u64(reinterpret_cast<std::uint64_t>(dsl));
+    w.u64(reinterpret_cast<std::uint64_t>(externalLayout_)).boolean(reflect_);
+
+    const VkSpecializationMapEntry* entries = specEntries_.data();
+    std::uint32_t entryCount = static_cast<std::uint32_t>(specEntries_.size());
+    const void* specData = specData_.data();
+    std::size_t specSize = specData_.size();
+    if (externalSpecInfo_) {
+        entries = externalSpecInfo_->pMapEntries;
+        entryCount = externalSpecInfo_->mapEntryCount;
+        specData = externalSpecInfo_->pData;
+        specSize = externalSpecInfo_->dataSize;
+    }
+    w.u32(entryCount);
+    for (std::uint32_t i = 0; i < entryCount; ++i)
+        w.u32(entries[i].constantID).u32(entries[i].offset).u64(entries[i].size);
+    w.bytes(specData, specSize);
+
+    return {};
+}
+
+Result<PipelineKey> PipelineBuilder::key() const {
+    PipelineKeyWriter w;
+    auto r = serialize(w);
+    if (!r.ok())
+        return r.error();
+    return w.finish();
+}
+
 Result<Pipeline> PipelineBuilder::build() {
     return buildWithFlags(0);
 }
 
 Result<Pipeline> PipelineBuilder::buildWithFlags(VkPipelineCreateFlags flags) const {
+    return buildImpl(flags, binaryStore_, cache_);
+}
+
+Result<Pipeline> PipelineBuilder::buildImpl(VkPipelineCreateFlags flags,
+                                            PipelineBinaryStore* store,
+                                            VkPipelineCache cache) const {
     bool hasVertShader = !vertPath_.empty() || vertModule_ != VK_NULL_HANDLE;
     bool hasFragShader = !fragPath_.empty() || fragModule_ != VK_NULL_HANDLE;
 
@@ -516,126 +721,97 @@ Result<Pipeline> PipelineBuilder::buildWithFlags(VkPipelineCreateFlags flags) co
         pSpecInfo = &builtSpecInfo;
     }
 
-    VkPipelineShaderStageCreateInfo stages[2]{};
-    stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
-    stages[0].module = vertMod;
-    stages[0].pName = "main";
-    stages[0].pSpecializationInfo = pSpecInfo;
-    stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    stages[1].module = fragMod;
-    stages[1].pName = "main";
-    stages[1].pSpecializationInfo = pSpecInfo;
-
-    VkPipelineVertexInputStateCreateInfo vertexInput{};
-    vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInput.vertexBindingDescriptionCount = static_cast<std::uint32_t>(vertexBindings_.size());
-    vertexInput.pVertexBindingDescriptions =
-        vertexBindings_.empty() ? nullptr : vertexBindings_.data();
-    vertexInput.vertexAttributeDescriptionCount =
-        static_cast<std::uint32_t>(vertexAttributes_.size());
-    vertexInput.pVertexAttributeDescriptions =
-        vertexAttributes_.empty() ? nullptr : vertexAttributes_.data();
-
-    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
-    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssembly.topology = topology_;
-
-    VkPipelineViewportStateCreateInfo viewportState{};
-    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-    viewportState.viewportCount = 1;
-    viewportState.scissorCount = 1;
-
-    VkPipelineRasterizationStateCreateInfo rasterizer{};
-    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-    rasterizer.polygonMode = polygonMode_;
-    rasterizer.lineWidth = 1.0f;
-    rasterizer.cullMode = cullMode_;
-    rasterizer.frontFace = frontFace_;
-
-    VkPipelineMultisampleStateCreateInfo multisampling{};
-    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    multisampling.rasterizationSamples = samples_;
-
-    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
-                                          VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    if (enableBlending_) {
-        colorBlendAttachment.blendEnable = VK_TRUE;
-        colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-        colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-        colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
-        colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-        colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-        colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
-    }
-
-    VkPipelineColorBlendStateCreateInfo colorBlend{};
-    colorBlend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-    colorBlend.attachmentCount = 1;
-    colorBlend.pAttachments = &colorBlendAttachment;
-
-    VkPipelineDepthStencilStateCreateInfo depthStencil{};
-    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-    if (depthFormat_ != VK_FORMAT_UNDEFINED) {
-        depthStencil.depthTestEnable = VK_TRUE;
-        depthStencil.depthWriteEnable = VK_TRUE;
-        depthStencil.depthCompareOp = depthCompareOp_;
-    }
-
-    std::vector<VkDynamicState> dynamicStates = {
-        VK_DYNAMIC_STATE_VIEWPORT,
-        VK_DYNAMIC_STATE_SCISSOR,
-    };
-    for (auto s : extraDynamicStates_) {
-        if (s != VK_DYNAMIC_STATE_VIEWPORT && s != VK_DYNAMIC_STATE_SCISSOR) {
-            dynamicStates.push_back(s);
-        }
-    }
-
-    VkPipelineDynamicStateCreateInfo dynamicState{};
-    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-    dynamicState.dynamicStateCount = static_cast<std::uint32_t>(dynamicStates.size());
-    dynamicState.pDynamicStates = dynamicStates.data();
-
-    // Dynamic rendering (Vulkan 1.3 core): no VkRenderPass, formats declared here instead.
-    VkPipelineRenderingCreateInfo renderingInfo{};
-    renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
-    renderingInfo.colorAttachmentCount = 1;
-    renderingInfo.pColorAttachmentFormats = &colorFormat_;
-    if (depthFormat_ != VK_FORMAT_UNDEFINED) {
-        renderingInfo.depthAttachmentFormat = depthFormat_;
-    }
+    std::vector<VkDynamicState> dynamicStates = this->dynamicStates();
+    detail::GraphicsState state;
+    state.bindings = vertexBindings_.data();
+    state.bindingCount = static_cast<std::uint32_t>(vertexBindings_.size());
+    state.attributes = vertexAttributes_.data();
+    state.attributeCount = static_cast<std::uint32_t>(vertexAttributes_.size());
+    state.colorFormat = colorFormat_;
+    state.depthFormat = depthFormat_;
+    state.viewMask = viewMask_;
+    state.topology = topology_;
+    state.polygonMode = polygonMode_;
+    state.cullMode = cullMode_;
+    state.frontFace = frontFace_;
+    state.samples = samples_;
+    state.depthCompareOp = depthCompareOp_;
+    state.enableBlending = enableBlending_;
+    state.dynamicStates = dynamicStates.data();
+    state.dynamicStateCount = static_cast<std::uint32_t>(dynamicStates.size());
+
+    PipelineDescCreateInfo info;
+    detail::fillGraphicsCreateInfo(info, state, vertMod, fragMod, pSpecInfo, p.layout_);
 
     VkPipelineCreationFeedback pipelineFeedback{};
     VkPipelineCreationFeedback stageFeedbacks[2]{};
 
     VkPipelineCreationFeedbackCreateInfo feedbackCI{};
     feedbackCI.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO;
-    feedbackCI.pNext = &renderingInfo;
+    feedbackCI.pNext = info.pipeline.pNext;
     feedbackCI.pPipelineCreationFeedback = &pipelineFeedback;
-    feedbackCI.pipelineStageCreationFeedbackCount = 2;
+    feedbackCI.pipelineStageCreationFeedbackCount = info.pipeline.stageCount;
     feedbackCI.pPipelineStageCreationFeedbacks = stageFeedbacks;
 
-    VkGraphicsPipelineCreateInfo pipelineCI{};
-    pipelineCI.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    VkGraphicsPipelineCreateInfo& pipelineCI = info.pipeline;
     pipelineCI.pNext = &feedbackCI;
     pipelineCI.flags = flags;
-    pipelineCI.stageCount = 2;
-    pipelineCI.pStages = stages;
-    pipelineCI.pVertexInputState = &vertexInput;
-    pipelineCI.pInputAssemblyState = &inputAssembly;
-    pipelineCI.pViewportState = &viewportState;
-    pipelineCI.pRasterizationState = &rasterizer;
-    pipelineCI.pMultisampleState = &multisampling;
-    pipelineCI.pDepthStencilState = &depthStencil;
-    pipelineCI.pColorBlendState = &colorBlend;
-    pipelineCI.pDynamicState = &dynamicState;
-    pipelineCI.layout = p.layout_;
-    pipelineCI.renderPass = VK_NULL_HANDLE;
-
-    VkResult vr = vkCreateGraphicsPipelines(device_, cache_, 1, &pipelineCI, nullptr, &p.pipeline_);
+
+    // Pipeline binaries: the key covers the full create info above. A hit
+    // skips compilation; a miss (outside cache-only probes) compiles with
+    // CAPTURE_DATA so the result can be stored. Both require a null
+    // VkPipelineCache.
+    VkPipelineBinaryKeyKHR binaryKey{};
+    bool haveBinaryKey = store && store->supported() &&
+                         (flags & VK_PIPELINE_CREATE_LIBRARY_BIT_KHR) == 0 &&
+                         store->pipelineKey(&pipelineCI, binaryKey);
+    std::vector<VkPipelineBinaryKHR> binaries;
+    if (haveBinaryKey)
+        binaries = store->loadBinaries(binaryKey);
+
+    VkPipelineBinaryInfoKHR binaryInfo{};
+    VkPipelineCreateFlags2CreateInfoKHR flags2CI{};
+    VkPipelineCache createCache = cache;
+    bool captureBinaries = false;
+    // Flags2 replaces pipelineCI.flags, so carry the caller's flags over.
+    auto enableCapture = [&]() {
+        flags2CI.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATE_FLAGS_2_CREATE_INFO_KHR;
+        flags2CI.pNext = pipelineCI.pNext;
+        flags2CI.flags = static_cast<VkPipelineCreateFlags2KHR>(flags) |
+                         VK_PIPELINE_CREATE_2_CAPTURE_DATA_BIT_KHR;
+        pipelineCI.pNext = &flags2CI;
+        createCache = VK_NULL_HANDLE;
+        captureBinaries = true;
+    };
+    bool mayCompile = (flags & VK_PIPELINE_CREATE_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT) == 0;
+    if (!binaries.empty()) {
+        binaryInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_INFO_KHR;
+        binaryInfo.pNext = pipelineCI.pNext;
+        binaryInfo.binaryCount = static_cast<std::uint32_t>(binaries.size());
+        binaryInfo.pPipelineBinaries = binaries.data();
+        pipelineCI.pNext = &binaryInfo;
+        createCache = VK_NULL_HANDLE;
+    } else if (haveBinaryKey && mayCompile) {
+        enableCapture();
+    }
+
+    VkResult vr =
+        vkCreateGraphicsPipelines(device_, createCache, 1, &pipelineCI, nullptr, &p.pipeline_);
+
+    if (!binaries.empty()) {
+        store->destroyBinaries(binaries);
+        if (vr != VK_SUCCESS) {
+            // Stale or rejected binaries: tombstone them and compile with
+            // CAPTURE_DATA so a replacement record is appended below.
+            store->invalidate(binaryKey);
+            pipelineCI.pNext = binaryInfo.pNext;
+            createCache = cache;
+            if (mayCompile)
+                enableCapture();
+            vr = vkCreateGraphicsPipelines(device_, createCache, 1, &pipelineCI, nullptr,
+                                           &p.pipeline_);
+        }
+    }
 
     // Always destroy internally-created shader modules.
     destroyModules();
@@ -652,6 +828,18 @@ Result<Pipeline> PipelineBuilder::buildWithFlags(VkPipelineCreateFlags flags) co
                      "vkCreateGraphicsPipelines failed"};
     }
 
+    if (captureBinaries) {
+        // Non-fatal: the pipeline is valid, the next build captures again.
+        auto captured = store->capture(p.pipeline_, binaryKey);
+        (void) captured;
+#ifndef NDEBUG
+        if (!captured.ok()) {
+            std::fprintf(stderr, "[vksdl] pipeline binary capture failed: %s\n",
+                         captured.error().message.c_str());
+        }
+#endif
+    }
+
     p.bindPoint_ = VK_PIPELINE_BIND_POINT_GRAPHICS;
     p.ownedSetLayouts_ = std::move(reflectedSetLayouts);
     p.reflectedLayout_ = std::move(localReflectedLayout);
@@ -0,0 +1,608 @@
+#include <vksdl/device.hpp>
+#include <vksdl/pipeline_binary_store.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+namespace vksdl {
+
+namespace {
+
+constexpr char kDataMagic[8] = {'V', 'K', 'S', 'D', 'L', 'P', 'B', 'D'};
+constexpr char kIndexMagic[8] = {'V', 'K', 'S', 'D', 'L', 'P', 'B', 'I'};
+constexpr std::uint32_t kFormatVersion = 1;
+constexpr std::uint32_t kRecordMagic = 0x43524250; // "PBRC"
+
+// Shared by the data and index files. A different driver global key means
+// every stored binary is stale.
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t globalKeySize;
+    std::uint8_t globalKey[VK_MAX_PIPELINE_BINARY_KEY_SIZE_KHR];
+};
+
+// Precedes every payload in the data file. An empty payload is a tombstone:
+// it shadows earlier records for the key like any later record would.
+struct RecordHeader {
+    std::uint32_t magic;
+    std::uint32_t keySize;
+    std::uint8_t key[VK_MAX_PIPELINE_BINARY_KEY_SIZE_KHR];
+    std::uint64_t payloadSize;
+    std::uint64_t checksum; // FNV-1a of the payload
+};
+
+struct IndexEntry {
+    std::uint32_t keySize;
+    std::uint8_t key[VK_MAX_PIPELINE_BINARY_KEY_SIZE_KHR];
+    std::uint32_t reserved;
+    std::uint64_t offset; // of the RecordHeader in the data file
+};
+
+static_assert(sizeof(FileHeader) == 48);
+static_assert(sizeof(RecordHeader) == 56);
+static_assert(sizeof(IndexEntry) == 48);
+
+std::uint64_t fnv1a(const std::uint8_t* data, std::size_t size) {
+    std::uint64_t h = 0xcbf29ce484222325ULL;
+    for (std::size_t i = 0; i < size; ++i) {
+        h ^= data[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+std::string keyString(const std::uint8_t* key, std::uint32_t size) {
+    return std::string(reinterpret_cast<const char*>(key), size);
+}
+
+std::string keyString(const VkPipelineBinaryKeyKHR& key) {
+    return keyString(key.key, key.keySize);
+}
+
+bool readFile(const std::filesystem::path& path, std::vector<std::uint8_t>& out) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+        return false;
+    auto pos = file.tellg();
+    if (pos <= 0)
+        return false;
+    out.resize(static_cast<std::size_t>(pos));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(out.size()));
+    return file.good();
+}
+
+template <typename T> void appendPod(std::vector<std::uint8_t>& out, const T& value) {
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T> bool readPod(const std::vector<std::uint8_t>& in, std::size_t& pos, T& out) {
+    if (in.size() < sizeof(T) || pos > in.size() - sizeof(T))
+        return false;
+    std::memcpy(&out, in.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+} // namespace
+
+struct PipelineBinaryStore::Impl {
+    struct Entry {
+        std::size_t recordOffset = 0;
+        std::size_t payloadOffset = 0;
+        std::size_t payloadSize = 0; // 0 = tombstone
+    };
+
+    VkDevice device = VK_NULL_HANDLE;
+    bool supported = false;
+    std::filesystem::path path;
+    std::filesystem::path indexPath;
+    VkPipelineBinaryKeyKHR globalKey{};
+
+    PFN_vkGetPipelineKeyKHR pfnGetPipelineKey = nullptr;
+    PFN_vkCreatePipelineBinariesKHR pfnCreateBinaries = nullptr;
+    PFN_vkGetPipelineBinaryDataKHR pfnGetBinaryData = nullptr;
+    PFN_vkReleaseCapturedPipelineDataKHR pfnReleaseCaptured = nullptr;
+    PFN_vkDestroyPipelineBinaryKHR pfnDestroyBinary = nullptr;
+
+    // Mirror of the data file; entries point into it. Tombstones stay in
+    // `entries` so the index keeps shadowing the records they replace.
+    std::mutex mutex;
+    std::vector<std::uint8_t> data;
+    std::unordered_map<std::string, Entry> entries;
+    bool rewrite = false; // files missing, stale or corrupt: recreate on append
+
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> misses{0};
+    std::atomic<std::uint64_t> captures{0};
+
+    [[nodiscard]] FileHeader makeHeader(const char (&magic)[8]) const {
+        FileHeader h{};
+        std::memcpy(h.magic, magic, sizeof(h.magic));
+        h.version = kFormatVersion;
+        h.globalKeySize = globalKey.keySize;
+        std::memcpy(h.globalKey, globalKey.key, globalKey.keySize);
+        return h;
+    }
+
+    [[nodiscard]] bool headerMatches(const std::vector<std::uint8_t>& bytes,
+                                     const char (&magic)[8]) const {
+        FileHeader h{};
+        std::size_t pos = 0;
+        if (!readPod(bytes, pos, h))
+            return false;
+        FileHeader expected = makeHeader(magic);
+        return std::memcmp(&h, &expected, sizeof(FileHeader)) == 0;
+    }
+
+    // Validates the header of a record at `offset` in `data` (not the
+    // payload checksum); fills `rh` and the end offset.
+    [[nodiscard]] bool readRecordHeader(std::size_t offset, RecordHeader& rh,
+                                        std::size_t& end) const {
+        std::size_t pos = offset;
+        if (!readPod(data, pos, rh))
+            return false;
+        if (rh.magic != kRecordMagic || rh.keySize == 0 ||
+            rh.keySize > VK_MAX_PIPELINE_BINARY_KEY_SIZE_KHR)
+            return false;
+        if (rh.payloadSize > data.size() - pos)
+            return false;
+        end = pos + static_cast<std::size_t>(rh.payloadSize);
+        return true;
+    }
+
+    // readRecordHeader() plus the payload checksum.
+    [[nodiscard]] bool readRecord(std::size_t offset, RecordHeader& rh, std::size_t& end) const {
+        if (!readRecordHeader(offset, rh, end))
+            return false;
+        std::size_t payload = offset + sizeof(RecordHeader);
+        return fnv1a(data.data() + payload, end - payload) == rh.checksum;
+    }
+
+    void addEntry(std::size_t offset, const RecordHeader& rh) {
+        // Later records shadow earlier ones with the same key, whatever
+        // order the index lists them in.
+        Entry e{offset, offset + sizeof(RecordHeader), static_cast<std::size_t>(rh.payloadSize)};
+        auto [it, inserted] = entries.try_emplace(keyString(rh.key, rh.keySize), e);
+        if (!inserted && it->second.recordOffset < offset)
+            it->second = e;
+    }
+
+    // Mutex must be held.
+    [[nodiscard]] const Entry* find(const std::string& key) const {
+        auto it = entries.find(key);
+        return it == entries.end() || it->second.payloadSize == 0 ? nullptr : &it->second;
+    }
+
+    [[nodiscard]] IndexEntry indexEntryFor(const std::string& key, std::size_t offset) const {
+        IndexEntry ie{};
+        ie.keySize = static_cast<std::uint32_t>(key.size());
+        std::memcpy(ie.key, key.data(), key.size());
+        ie.offset = offset;
+        return ie;
+    }
+
+    void rewriteIndex() {
+        std::vector<std::uint8_t> bytes;
+        appendPod(bytes, makeHeader(kIndexMagic));
+        for (const auto& [key, e] : entries)
+            appendPod(bytes, indexEntryFor(key, e.recordOffset));
+        std::ofstream file(indexPath, std::ios::binary | std::ios::trunc);
+        if (file.is_open())
+            file.write(reinterpret_cast<const char*>(bytes.data()),
+                       static_cast<std::streamsize>(bytes.size()));
+    }
+
+    // Index first (fast path), then walk the data file record by record and
+    // validate every record the index does not cover: a crash or failed
+    // write between the data append and the index append leaves records,
+    // anywhere in the file, that are only discoverable this way. Records a
+    // later indexed record shadows are skipped without reading the payload.
+    void loadFiles() {
+        if (!readFile(path, data) || !headerMatches(data, kDataMagic)) {
+            data.clear();
+            rewrite = true;
+            return;
+        }
+
+        bool indexComplete = true;
+        std::map<std::size_t, std::size_t> indexed; // record offset -> end
+
+        std::vector<std::uint8_t> index;
+        if (readFile(indexPath, index) && headerMatches(index, kIndexMagic)) {
+            std::size_t pos = sizeof(FileHeader);
+            IndexEntry ie{};
+            while (readPod(index, pos, ie)) {
+                RecordHeader rh{};
+                std::size_t end = 0;
+                auto offset = static_cast<std::size_t>(ie.offset);
+                if (offset < sizeof(FileHeader) || !readRecord(offset, rh, end) ||
+                    rh.keySize != ie.keySize || std::memcmp(rh.key, ie.key, ie.keySize) != 0) {
+                    indexComplete = false;
+                    continue;
+                }
+                addEntry(offset, rh);
+                indexed[offset] = end;
+            }
+        } else {
+            indexComplete = false;
+        }
+
+        std::size_t pos = sizeof(FileHeader);
+        while (pos < data.size()) {
+            if (auto it = indexed.find(pos); it != indexed.end()) {
+                pos = it->second;
+                continue;
+            }
+            RecordHeader rh{};
+            std::size_t end = 0;
+            bool header = readRecordHeader(pos, rh, end);
+            if (header) {
+                auto it = entries.find(keyString(rh.key, rh.keySize));
+                if (it != entries.end() && it->second.recordOffset > pos) {
+                    pos = end;
+                    continue;
+                }
+            }
+            if (header && readRecord(pos, rh, end)) {
+                addEntry(pos, rh);
+                indexComplete = false;
+                pos = end;
+                continue;
+            }
+            // Corrupt record: resume at the next indexed one, if any.
+            auto next = indexed.upper_bound(pos);
+            if (next == indexed.end())
+                break;
+            indexComplete = false;
+            pos = next->first;
+        }
+        std::size_t validEnd = pos;
+
+        // Torn tail from an interrupted append: drop it so new records
+        // land on a record boundary.
+        if (validEnd < data.size()) {
+            data.resize(validEnd);
+            std::error_code ec;
+            std::filesystem::resize_file(path, validEnd, ec);
+            if (ec) {
+                rewrite = true;
+                entries.clear();
+                data.clear();
+                return;
+            }
+        }
+
+        if (!indexComplete)
+            rewriteIndex();
+    }
+
+    // Mutex must be held.
+    [[nodiscard]] Result<void> appendRecord(const std::string& key,
+                                            const std::vector<std::uint8_t>& payload) {
+        if (rewrite) {
+            std::vector<std::uint8_t> header;
+            appendPod(header, makeHeader(kDataMagic));
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                return Error{"append pipeline binary", 0,
+                             "could not open file for writing: " + path.string()};
+            }
+            file.write(reinterpret_cast<const char*>(header.data()),
+                       static_cast<std::streamsize>(header.size()));
+            if (!file.good())
+                return Error{"append pipeline binary", 0, "write failed: " + path.string()};
+            data = std::move(header);
+            entries.clear();
+            rewriteIndex();
+            rewrite = false;
+        }
+
+        RecordHeader rh{};
+        rh.magic = kRecordMagic;
+        rh.keySize = static_cast<std::uint32_t>(key.size());
+        std::memcpy(rh.key, key.data(), key.size());
+        rh.payloadSize = payload.size();
+        rh.checksum = fnv1a(payload.data(), payload.size());
+
+        std::vector<std::uint8_t> record;
+        record.reserve(sizeof(RecordHeader) + payload.size());
+        appendPod(record, rh);
+        record.insert(record.end(), payload.begin(), payload.end());
+
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        if (!file.is_open()) {
+            return Error{"append pipeline binary", 0,
+                         "could not open file for writing: " + path.string()};
+        }
+        file.write(reinterpret_cast<const char*>(record.data()),
+                   static_cast<std::streamsize>(record.size()));
+        file.flush();
+        if (!file.good())
+            return Error{"append pipeline binary", 0, "write failed: " + path.string()};
+
+        std::size_t offset = data.size();
+        data.insert(data.end(), record.begin(), record.end());
+        addEntry(offset, rh);
+
+        // A lost index append is recovered by the walk on the next load.
+        std::ofstream index(indexPath, std::ios::binary | std::ios::app);
+        if (index.is_open()) {
+            IndexEntry ie = indexEntryFor(key, offset);
+            index.write(reinterpret_cast<const char*>(&ie), sizeof(ie));
+        }
+        return {};
+    }
+};
+
+PipelineBinaryStore::~PipelineBinaryStore() = default;
+PipelineBinaryStore::PipelineBinaryStore(PipelineBinaryStore&&) noexcept = default;
+PipelineBinaryStore& PipelineBinaryStore::operator=(PipelineBinaryStore&&) noexcept = default;
+
+Result<PipelineBinaryStore> PipelineBinaryStore::open(const Device& device,
+                                                      const std::filesystem::path& path) {
+    PipelineBinaryStore store;
+    store.impl_ = std::make_unique<Impl>();
+    auto& impl = *store.impl_;
+    impl.device = device.vkDevice();
+    impl.path = path;
+    impl.indexPath = path;
+    impl.indexPath += ".idx";
+
+    if (!device.hasPipelineBinary())
+        return store;
+
+    impl.pfnGetPipelineKey = reinterpret_cast<PFN_vkGetPipelineKeyKHR>(
+        vkGetDeviceProcAddr(impl.device, "vkGetPipelineKeyKHR"));
+    impl.pfnCreateBinaries = reinterpret_cast<PFN_vkCreatePipelineBinariesKHR>(
+        vkGetDeviceProcAddr(impl.device, "vkCreatePipelineBinariesKHR"));
+    impl.pfnGetBinaryData = reinterpret_cast<PFN_vkGetPipelineBinaryDataKHR>(
+        vkGetDeviceProcAddr(impl.device, "vkGetPipelineBinaryDataKHR"));
+    impl.pfnReleaseCaptured = reinterpret_cast<PFN_vkReleaseCapturedPipelineDataKHR>(
+        vkGetDeviceProcAddr(impl.device, "vkReleaseCapturedPipelineDataKHR"));
+    impl.pfnDestroyBinary = reinterpret_cast<PFN_vkDestroyPipelineBinaryKHR>(
+        vkGetDeviceProcAddr(impl.device, "vkDestroyPipelineBinaryKHR"));
+    if (!impl.pfnGetPipelineKey || !impl.pfnCreateBinaries || !impl.pfnGetBinaryData ||
+        !impl.pfnReleaseCaptured || !impl.pfnDestroyBinary)
+        return store;
+
+    // The global key changes with the driver build; it stamps both files.
+    impl.globalKey.sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_KEY_KHR;
+    VkResult vr = impl.pfnGetPipelineKey(impl.device, nullptr, &impl.globalKey);
+    if (vr != VK_SUCCESS) {
+        return Error{"open pipeline binary store", static_cast<std::int32_t>(vr),
+                     "vkGetPipelineKeyKHR (global key) failed"};
+    }
+
+    impl.supported = true;
+    impl.loadFiles();
+
+#ifndef NDEBUG
+    std::fprintf(stderr, "[vksdl] pipeline binary store: %zu entries from %s\n",
+                 store.entryCount(), path.string().c_str());
+#endif
+    return store;
+}
+
+bool PipelineBinaryStore::supported() const {
+    return impl_ && impl_->supported;
+}
+
+std::size_t PipelineBinaryStore::entryCount() const {
+    if (!impl_)
+        return 0;
+    std::lock_guard lock(impl_->mutex);
+    std::size_t count = 0;
+    for (const auto& [key, e] : impl_->entries)
+        count += e.payloadSize != 0 ? 1 : 0;
+    return count;
+}
+
+std::uint64_t PipelineBinaryStore::hits() const {
+    return impl_ ? impl_->hits.load(std::memory_order_relaxed) : 0;
+}
+
+std::uint64_t PipelineBinaryStore::misses() const {
+    return impl_ ? impl_->misses.load(std::memory_order_relaxed) : 0;
+}
+
+std::uint64_t PipelineBinaryStore::captures() const {
+    return impl_ ? impl_->captures.load(std::memory_order_relaxed) : 0;
+}
+
+bool PipelineBinaryStore::pipelineKey(const void* pipelineCreateInfo,
+                                      VkPipelineBinaryKeyKHR& key) const {
+    if (!supported())
+        return false;
+    VkPipelineCreateInfoKHR info{};
+    info.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATE_INFO_KHR;
+    info.pNext = const_cast<void*>(pipelineCreateInfo);
+    key = {};
+    key.sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_KEY_KHR;
+    return impl_->pfnGetPipelineKey(impl_->device, &info, &key) == VK_SUCCESS && key.keySize > 0;
+}
+
+std::vector<VkPipelineBinaryKHR>
+PipelineBinaryStore::loadBinaries(const VkPipelineBinaryKeyKHR& key) {
+    if (!supported())
+        return {};
+
+    // Copy the payload out so the driver call runs without the lock.
+    std::vector<std::uint8_t> payload;
+    {
+        std::lock_guard lock(impl_->mutex);
+        const Impl::Entry* e = impl_->find(keyString(key));
+        if (!e) {
+            impl_->misses.fetch_add(1, std::memory_order_relaxed);
+            return {};
+        }
+        const auto* begin = impl_->data.data() + e->payloadOffset;
+        payload.assign(begin, begin + e->payloadSize);
+    }
+
+    // Payload: u32 count, then per binary u32 keySize, key[32], u64 size, data.
+    std::size_t pos = 0;
+    std::uint32_t count = 0;
+    bool valid = readPod(payload, pos, count) && count > 0;
+    std::vector<VkPipelineBinaryKeyKHR> keys(valid ? count : 0);
+    std::vector<VkPipelineBinaryDataKHR> blobs(valid ? count : 0);
+    for (std::uint32_t i = 0; valid && i < count; ++i) {
+        std::uint64_t size = 0;
+        keys[i].sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_KEY_KHR;
+        valid = readPod(payload, pos, keys[i].keySize) && readPod(payload, pos, keys[i].key) &&
+                readPod(payload, pos, size) && size <= payload.size() - pos;
+        if (!valid)
+            break;
+        blobs[i].dataSize = static_cast<std::size_t>(size);
+        blobs[i].pData = payload.data() + pos;
+        pos += static_cast<std::size_t>(size);
+    }
+
+    std::vector<VkPipelineBinaryKHR> binaries;
+    if (valid) {
+        VkPipelineBinaryKeysAndDataKHR keysAndData{};
+        keysAndData.binaryCount = count;
+        keysAndData.pPipelineBinaryKeys = keys.data();
+        keysAndData.pPipelineBinaryData = blobs.data();
+
+        VkPipelineBinaryCreateInfoKHR ci{};
+        ci.sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_CREATE_INFO_KHR;
+        ci.pKeysAndDataInfo = &keysAndData;
+
+        binaries.resize(count, VK_NULL_HANDLE);
+        VkPipelineBinaryHandlesInfoKHR handles{};
+        handles.sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_HANDLES_INFO_KHR;
+        handles.pipelineBinaryCount = count;
+        handles.pPipelineBinaries = binaries.data();
+
+        VkResult vr = impl_->pfnCreateBinaries(impl_->device, &ci, nullptr, &handles);
+        valid = vr == VK_SUCCESS;
+        if (!valid)
+            destroyBinaries(binaries);
+    }
+
+    if (!valid) {
+        invalidate(key);
+        impl_->misses.fetch_add(1, std::memory_order_relaxed);
+        return {};
+    }
+    impl_->hits.fetch_add(1, std::memory_order_relaxed);
+    return binaries;
+}
+
+void PipelineBinaryStore::destroyBinaries(std::vector<VkPipelineBinaryKHR>& binaries) const {
+    if (impl_ && impl_->pfnDestroyBinary) {
+        for (auto b : binaries) {
+            if (b != VK_NULL_HANDLE)
+                impl_->pfnDestroyBinary(impl_->device, b, nullptr);
+        }
+    }
+    binaries.clear();
+}
+
+Result<void> PipelineBinaryStore::capture(VkPipeline pipeline, const VkPipelineBinaryKeyKHR& key) {
+    if (!supported())
+        return {};
+
+    // Captured data is held by the driver until released, on every path.
+    auto releaseCaptured = [&]() {
+        VkReleaseCapturedPipelineDataInfoKHR info{};
+        info.sType = VK_STRUCTURE_TYPE_RELEASE_CAPTURED_PIPELINE_DATA_INFO_KHR;
+        info.pipeline = pipeline;
+        impl_->pfnReleaseCaptured(impl_->device, &info, nullptr);
+    };
+
+    std::string k = keyString(key);
+    {
+        std::lock_guard lock(impl_->mutex);
+        if (impl_->find(k)) {
+            releaseCaptured();
+            return {};
+        }
+    }
+
+    VkPipelineBinaryCreateInfoKHR ci{};
+    ci.sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_CREATE_INFO_KHR;
+    ci.pipeline = pipeline;
+
+    VkPipelineBinaryHandlesInfoKHR handles{};
+    handles.sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_HANDLES_INFO_KHR;
+    VkResult vr = impl_->pfnCreateBinaries(impl_->device, &ci, nullptr, &handles);
+    if (vr != VK_SUCCESS || handles.pipelineBinaryCount == 0) {
+        releaseCaptured();
+        return Error{"capture pipeline binary", static_cast<std::int32_t>(vr),
+                     "vkCreatePipelineBinariesKHR (count) failed"};
+    }
+
+    std::vector<VkPipelineBinaryKHR> binaries(handles.pipelineBinaryCount, VK_NULL_HANDLE);
+    handles.pPipelineBinaries = binaries.data();
+    vr = impl_->pfnCreateBinaries(impl_->device, &ci, nullptr, &handles);
+    releaseCaptured();
+    if (vr != VK_SUCCESS) {
+        destroyBinaries(binaries);
+        return Error{"capture pipeline binary", static_cast<std::int32_t>(vr),
+                     "vkCreatePipelineBinariesKHR failed"};
+    }
+
+    std::vector<std::uint8_t> payload;
+    appendPod(payload, static_cast<std::uint32_t>(binaries.size()));
+    for (auto binary : binaries) {
+        VkPipelineBinaryDataInfoKHR di{};
+        di.sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_DATA_INFO_KHR;
+        di.pipelineBinary = binary;
+        VkPipelineBinaryKeyKHR binaryKey{};
+        binaryKey.sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_KEY_KHR;
+        std::size_t size = 0;
+        vr = impl_->pfnGetBinaryData(impl_->device, &di, &binaryKey, &size, nullptr);
+        std::vector<std::uint8_t> blob(size);
+        if (vr == VK_SUCCESS)
+            vr = impl_->pfnGetBinaryData(impl_->device, &di, &binaryKey, &size, blob.data());
+        if (vr != VK_SUCCESS) {
+            destroyBinaries(binaries);
+            return Error{"capture pipeline binary", static_cast<std::int32_t>(vr),
+                         "vkGetPipelineBinaryDataKHR failed"};
+        }
+        appendPod(payload, binaryKey.keySize);
+        appendPod(payload, binaryKey.key);
+        appendPod(payload, static_cast<std::uint64_t>(size));
+        payload.insert(payload.end(), blob.begin(), blob.begin() + static_cast<std::ptrdiff_t>(size));
+    }
+    destroyBinaries(binaries);
+
+    std::lock_guard lock(impl_->mutex);
+    if (impl_->find(k))
+        return {};
+    auto appended = impl_->appendRecord(k, payload);
+    if (!appended.ok())
+        return appended;
+    impl_->captures.fetch_add(1, std::memory_order_relaxed);
+    return {};
+}
+
+void PipelineBinaryStore::invalidate(const VkPipelineBinaryKeyKHR& key) {
+    if (!supported())
+        return;
+    std::string k = keyString(key);
+    std::lock_guard lock(impl_->mutex);
+    if (!impl_->find(k))
+        return;
+    // Persist a tombstone so a reload does not resurrect the rejected record.
+    // If the append fails, drop the entry in memory only.
+    if (!impl_->appendRecord(k, {}).ok())
+        impl_->entries.erase(k);
+}
+
+} // namespace vksdl
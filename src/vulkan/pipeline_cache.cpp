@@ -1,11 +1,14 @@
 #include <vksdl/device.hpp>
 #include <vksdl/pipeline_cache.hpp>
 
+#include "file_io.hpp"
+
 #include <vulkan/vulkan.h>
 
 #include <cstddef>
 #include <cstdint>
-#include <fstream>
+#include <cstdio>
+#include <cstring>
 #include <vector>
 
 namespace vksdl {
@@ -52,37 +55,61 @@ Result<PipelineCache> PipelineCache::create(const Device& device) {
 
 // Falls back to empty cache when the file is missing or incompatible with the current driver.
 Result<PipelineCache> PipelineCache::load(const Device& device, const std::filesystem::path& path) {
-    std::vector<std::uint8_t> blob;
-
-    std::ifstream file(path, std::ios::binary | std::ios::ate);
-    if (file.is_open()) {
-        auto size = static_cast<std::size_t>(file.tellg());
-        if (size > 0) {
-            blob.resize(size);
-            file.seekg(0);
-            file.read(reinterpret_cast<char*>(blob.data()), static_cast<std::streamsize>(size));
-        }
+    // Mapped rather than read: the driver copies what it keeps, so the blob
+    // never needs a heap copy of its own.
+    detail::MappedFile file(path);
+
+    auto pc = fromData(device, file.data(), file.size());
+    if (!pc.ok()) {
+        return Error{"load pipeline cache", pc.error().vkResult,
+                     "vkCreatePipelineCache failed with cached data from: " + path.string()};
     }
-    // If the file doesn't exist or is empty, we create an empty cache.
-    // The driver validates the blob and ignores it if it's incompatible.
+    return pc;
+}
+
+Result<PipelineCache> PipelineCache::fromData(const Device& device, const void* data,
+                                              std::size_t size) {
+    bool usable = data != nullptr && size > 0 && isCompatible(device, data, size);
+#ifndef NDEBUG
+    if (data != nullptr && size > 0 && !usable)
+        std::fprintf(stderr, "[vksdl] pipeline cache: discarding blob from another device "
+                             "or driver (%zu bytes)\n",
+                     size);
+#endif
 
     VkPipelineCacheCreateInfo ci{};
     ci.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-    ci.initialDataSize = blob.size();
-    ci.pInitialData = blob.empty() ? nullptr : blob.data();
+    ci.initialDataSize = usable ? size : 0;
+    ci.pInitialData = usable ? data : nullptr;
 
     PipelineCache pc;
     pc.device_ = device.vkDevice();
 
     VkResult vr = vkCreatePipelineCache(pc.device_, &ci, nullptr, &pc.cache_);
     if (vr != VK_SUCCESS) {
-        return Error{"load pipeline cache", static_cast<std::int32_t>(vr),
-                     "vkCreatePipelineCache failed with cached data from: " + path.string()};
+        return Error{"create pipeline cache", static_cast<std::int32_t>(vr),
+                     "vkCreatePipelineCache failed"};
     }
 
     return pc;
 }
 
+bool PipelineCache::isCompatible(const Device& device, const void* data, std::size_t size) {
+    VkPipelineCacheHeaderVersionOne header{};
+    if (data == nullptr || size < sizeof(header))
+        return false;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+        header.headerSize < sizeof(header) || header.headerSize > size)
+        return false;
+
+    VkPhysicalDeviceProperties props{};
+    vkGetPhysicalDeviceProperties(device.vkPhysicalDevice(), &props);
+    return header.vendorID == props.vendorID && header.deviceID == props.deviceID &&
+           std::memcmp(header.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
 Result<void> PipelineCache::save(const std::filesystem::path& path) const {
     std::size_t dataSize = 0;
     VkResult vr = vkGetPipelineCacheData(device_, cache_, &dataSize, nullptr);
@@ -93,18 +120,12 @@ Result<void> PipelineCache::save(const std::filesystem::path& path) const {
 
     std::vector<std::uint8_t> blob(dataSize);
     vr = vkGetPipelineCacheData(device_, cache_, &dataSize, blob.data());
-    if (vr != VK_SUCCESS) {
+    if (vr != VK_SUCCESS && vr != VK_INCOMPLETE) {
         return Error{"save pipeline cache", static_cast<std::int32_t>(vr),
                      "vkGetPipelineCacheData (retrieve data) failed"};
     }
 
-    std::ofstream file(path, std::ios::binary | std::ios::trunc);
-    if (!file.is_open()) {
-        return Error{"save pipeline cache", 0, "could not open file for writing: " + path.string()};
-    }
-
-    file.write(reinterpret_cast<const char*>(blob.data()), static_cast<std::streamsize>(dataSize));
-    if (!file.good()) {
+    if (!detail::writeFileAtomic(path, blob.data(), dataSize)) {
         return Error{"save pipeline cache", 0, "write failed: " + path.string()};
     }
 
@@ -0,0 +1,167 @@
+#include <vksdl/device.hpp>
+#include <vksdl/pipeline_cache_pool.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace vksdl {
+
+struct PipelineCachePool::Impl {
+    struct Entry {
+        VkPipelineCache cache = VK_NULL_HANDLE; // null while being created
+        bool leased = false;
+        bool dirty = false; // holds compiles the main cache has not seen
+    };
+
+    VkDevice device = VK_NULL_HANDLE;
+    VkPipelineCache main = VK_NULL_HANDLE;
+    std::uint32_t capacity = 0;
+    std::vector<std::uint8_t> seed;
+
+    mutable std::mutex mutex;
+    std::condition_variable released;
+    std::vector<Entry> entries;
+    std::uint32_t leased = 0;
+    std::uint64_t merges = 0;
+
+    ~Impl() {
+        assert(leased == 0 && "PipelineCachePool destroyed with caches still leased");
+        for (const auto& e : entries)
+            vkDestroyPipelineCache(device, e.cache, nullptr);
+    }
+
+    Entry* find(VkPipelineCache cache) {
+        for (auto& e : entries) {
+            if (e.cache == cache)
+                return &e;
+        }
+        return nullptr;
+    }
+};
+
+PipelineCachePool::~PipelineCachePool() = default;
+PipelineCachePool::PipelineCachePool(PipelineCachePool&&) noexcept = default;
+PipelineCachePool& PipelineCachePool::operator=(PipelineCachePool&&) noexcept = default;
+
+Result<PipelineCachePool> PipelineCachePool::create(const Device& device, VkPipelineCache main,
+                                                    std::uint32_t capacity,
+                                                    std::vector<std::uint8_t> seed) {
+    if (capacity == 0)
+        return Error{"create pipeline cache pool", 0, "capacity must be at least 1"};
+
+    PipelineCachePool pool;
+    pool.impl_ = std::make_unique<Impl>();
+    pool.impl_->device = device.vkDevice();
+    pool.impl_->main = main;
+    pool.impl_->capacity = capacity;
+    pool.impl_->seed = std::move(seed);
+    pool.impl_->entries.reserve(capacity);
+    return pool;
+}
+
+Result<VkPipelineCache> PipelineCachePool::acquire() {
+    auto& impl = *impl_;
+    std::unique_lock lock(impl.mutex);
+    impl.released.wait(lock, [&] { return impl.leased < impl.capacity; });
+    ++impl.leased;
+
+    // Most recently created first; any idle cache will do.
+    for (auto it = impl.entries.rbegin(); it != impl.entries.rend(); ++it) {
+        if (!it->leased && it->cache != VK_NULL_HANDLE) {
+            it->leased = true;
+            return it->cache;
+        }
+    }
+
+    // Fewer than `capacity` exist: reserve an entry, create outside the lock.
+    impl.entries.push_back({VK_NULL_HANDLE, true, false});
+    lock.unlock();
+
+    VkPipelineCacheCreateInfo ci{};
+    ci.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    ci.initialDataSize = impl.seed.size();
+    ci.pInitialData = impl.seed.empty() ? nullptr : impl.seed.data();
+    VkPipelineCache created = VK_NULL_HANDLE;
+    VkResult vr = vkCreatePipelineCache(impl.device, &ci, nullptr, &created);
+
+    lock.lock();
+    auto* reserved = impl.find(VK_NULL_HANDLE);
+    assert(reserved);
+    if (vr != VK_SUCCESS) {
+        impl.entries.erase(impl.entries.begin() + (reserved - impl.entries.data()));
+        --impl.leased;
+        lock.unlock();
+        impl.released.notify_one();
+        return Error{"acquire pipeline cache", static_cast<std::int32_t>(vr),
+                     "vkCreatePipelineCache failed"};
+    }
+    reserved->cache = created;
+    return created;
+}
+
+void PipelineCachePool::release(VkPipelineCache cache, bool dirty) {
+    auto& impl = *impl_;
+    {
+        std::lock_guard lock(impl.mutex);
+        auto* e = impl.find(cache);
+        assert(e && e->leased && "release() of a cache this pool did not lease");
+        e->leased = false;
+        e->dirty = e->dirty || dirty;
+        --impl.leased;
+    }
+    impl.released.notify_one();
+}
+
+Result<void> PipelineCachePool::merge() {
+    auto& impl = *impl_;
+    std::vector<VkPipelineCache> sources;
+    {
+        std::lock_guard lock(impl.mutex);
+        for (auto& e : impl.entries) {
+            if (e.dirty && !e.leased) {
+                sources.push_back(e.cache);
+                e.dirty = false;
+            }
+        }
+    }
+    if (sources.empty())
+        return {};
+
+    // One call for all sources; the driver dedups entries across them. Only
+    // the destination needs external synchronization, so the sources may be
+    // leased again meanwhile.
+    VkResult vr = vkMergePipelineCaches(impl.device, impl.main,
+                                        static_cast<std::uint32_t>(sources.size()),
+                                        sources.data());
+    std::lock_guard lock(impl.mutex);
+    if (vr != VK_SUCCESS) {
+        for (auto c : sources)
+            impl.find(c)->dirty = true;
+        return Error{"merge pipeline cache", static_cast<std::int32_t>(vr),
+                     "vkMergePipelineCaches failed"};
+    }
+    ++impl.merges;
+    return {};
+}
+
+std::uint32_t PipelineCachePool::size() const {
+    std::lock_guard lock(impl_->mutex);
+    return static_cast<std::uint32_t>(impl_->entries.size());
+}
+
+std::uint32_t PipelineCachePool::capacity() const {
+    return impl_->capacity;
+}
+
+std::uint64_t PipelineCachePool::merges() const {
+    std::lock_guard lock(impl_->mutex);
+    return impl_->merges;
+}
+
+} // namespace vksdl
@@ -0,0 +1,153 @@
+#include <vksdl/device.hpp>
+#include <vksdl/pipeline_cache_store.hpp>
+
+#include "file_io.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace vksdl {
+
+namespace {
+
+std::string hex(const std::uint8_t* bytes, std::size_t count) {
+    static constexpr char kDigits[] = "0123456789abcdef";
+    std::string out;
+    out.reserve(count * 2);
+    for (std::size_t i = 0; i < count; ++i) {
+        out += kDigits[bytes[i] >> 4];
+        out += kDigits[bytes[i] & 0xF];
+    }
+    return out;
+}
+
+std::string hex32(std::uint32_t v, int digits) {
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "%0*x", digits, v);
+    return buf;
+}
+
+} // namespace
+
+struct PipelineCacheStore::Impl {
+    explicit Impl(PipelineCache c) : main(std::move(c)) {}
+
+    std::filesystem::path deviceDir;
+    std::filesystem::path driverDir;
+    std::filesystem::path path;
+    bool warm = false;
+
+    PipelineCache main;
+    std::optional<PipelineCachePool> threadCaches;
+};
+
+PipelineCacheStore::~PipelineCacheStore() = default;
+PipelineCacheStore::PipelineCacheStore(PipelineCacheStore&&) noexcept = default;
+PipelineCacheStore& PipelineCacheStore::operator=(PipelineCacheStore&&) noexcept = default;
+
+Result<PipelineCacheStore> PipelineCacheStore::open(const Device& device,
+                                                    const std::filesystem::path& root) {
+    VkPhysicalDeviceProperties props{};
+    vkGetPhysicalDeviceProperties(device.vkPhysicalDevice(), &props);
+
+    std::filesystem::path deviceDir =
+        root / (hex32(props.vendorID, 4) + "-" + hex32(props.deviceID, 4));
+    std::filesystem::path driverDir =
+        deviceDir / (hex32(props.driverVersion, 8) + "-" +
+                     hex(props.pipelineCacheUUID, VK_UUID_SIZE));
+    std::filesystem::path path = driverDir / "pipeline.cache";
+
+    // The directory already encodes the UUID; the header check still guards
+    // against hand-copied or truncated files.
+    detail::MappedFile file(path);
+    bool warm = !file.empty() && PipelineCache::isCompatible(device, file.data(), file.size());
+
+    auto cache = PipelineCache::fromData(device, file.data(), file.size());
+    if (!cache.ok()) {
+        return Error{"open pipeline cache store", cache.error().vkResult,
+                     "vkCreatePipelineCache failed with cached data from: " + path.string()};
+    }
+
+    // Thread caches start empty rather than seeded from the main cache: the
+    // main cache may be in use on another thread, and vkGetPipelineCacheData
+    // on it would race.
+    auto pool = PipelineCachePool::create(device, cache.value().vkPipelineCache(),
+                                          std::max(2u, std::thread::hardware_concurrency()));
+    if (!pool.ok())
+        return std::move(pool).error();
+
+    PipelineCacheStore store;
+    store.impl_ = std::make_unique<Impl>(std::move(cache).value());
+    store.impl_->threadCaches.emplace(std::move(pool).value());
+    store.impl_->deviceDir = std::move(deviceDir);
+    store.impl_->driverDir = std::move(driverDir);
+    store.impl_->path = std::move(path);
+    store.impl_->warm = warm;
+    return store;
+}
+
+PipelineCache& PipelineCacheStore::cache() {
+    return impl_->main;
+}
+
+const PipelineCache& PipelineCacheStore::cache() const {
+    return impl_->main;
+}
+
+const std::filesystem::path& PipelineCacheStore::path() const {
+    return impl_->path;
+}
+
+bool PipelineCacheStore::warm() const {
+    return impl_->warm;
+}
+
+Result<VkPipelineCache> PipelineCacheStore::acquireThreadCache() {
+    return impl_->threadCaches->acquire();
+}
+
+void PipelineCacheStore::releaseThreadCache(VkPipelineCache cache) {
+    impl_->threadCaches->release(cache);
+}
+
+std::size_t PipelineCacheStore::threadCacheCount() const {
+    return impl_->threadCaches->size();
+}
+
+Result<void> PipelineCacheStore::mergeThreadCaches() {
+    return impl_->threadCaches->merge();
+}
+
+Result<void> PipelineCacheStore::save() {
+    auto merged = mergeThreadCaches();
+    if (!merged.ok())
+        return merged;
+    return impl_->main.save(impl_->path);
+}
+
+std::size_t PipelineCacheStore::removeStaleDrivers() {
+    std::error_code ec;
+    std::vector<std::filesystem::path> stale;
+    for (const auto& entry : std::filesystem::directory_iterator(impl_->deviceDir, ec)) {
+        if (entry.is_directory(ec) && entry.path() != impl_->driverDir)
+            stale.push_back(entry.path());
+    }
+
+    std::size_t removed = 0;
+    for (const auto& dir : stale) {
+        if (std::filesystem::remove_all(dir, ec) != static_cast<std::uintmax_t>(-1) && !ec)
+            ++removed;
+    }
+    return removed;
+}
+
+} // namespace vksdl
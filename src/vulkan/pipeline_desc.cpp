@@ -0,0 +1,212 @@
+#include <vksdl/device.hpp>
+#include <vksdl/pipeline_desc.hpp>
+
+#include "graphics_state.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+
+namespace vksdl {
+
+void PipelineDesc::invalidDescription() {}
+
+namespace detail {
+
+VkPrimitiveTopology topologyClass(VkPrimitiveTopology t) {
+    switch (t) {
+    case VK_PRIMITIVE_TOPOLOGY_POINT_LIST:
+        return VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+    case VK_PRIMITIVE_TOPOLOGY_LINE_LIST:
+    case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP:
+    case VK_PRIMITIVE_TOPOLOGY_LINE_LIST_WITH_ADJACENCY:
+    case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP_WITH_ADJACENCY:
+        return VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+    case VK_PRIMITIVE_TOPOLOGY_PATCH_LIST:
+        return VK_PRIMITIVE_TOPOLOGY_PATCH_LIST;
+    default:
+        return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    }
+}
+
+void fillGraphicsCreateInfo(PipelineDescCreateInfo& out, const GraphicsState& state,
+                            VkShaderModule vert, VkShaderModule frag,
+                            const VkSpecializationInfo* spec, VkPipelineLayout layout) {
+    std::uint32_t stageCount = 0;
+    auto addStage = [&](VkShaderStageFlagBits stage, VkShaderModule module) {
+        VkPipelineShaderStageCreateInfo& s = out.stages[stageCount++];
+        s = {};
+        s.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        s.stage = stage;
+        s.module = module;
+        s.pName = "main";
+        s.pSpecializationInfo = spec;
+    };
+    addStage(VK_SHADER_STAGE_VERTEX_BIT, vert);
+    if (frag != VK_NULL_HANDLE)
+        addStage(VK_SHADER_STAGE_FRAGMENT_BIT, frag);
+
+    out.vertexInput = {};
+    out.vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    out.vertexInput.vertexBindingDescriptionCount = state.bindingCount;
+    out.vertexInput.pVertexBindingDescriptions = state.bindingCount ? state.bindings : nullptr;
+    out.vertexInput.vertexAttributeDescriptionCount = state.attributeCount;
+    out.vertexInput.pVertexAttributeDescriptions =
+        state.attributeCount ? state.attributes : nullptr;
+
+    // Values the driver ignores for dynamic states are written in canonical
+    // form, so such pipelines share pipeline cache and binary store entries.
+    auto isDyn = [&](VkDynamicState s) {
+        for (std::uint32_t i = 0; i < state.dynamicStateCount; ++i) {
+            if (state.dynamicStates[i] == s)
+                return true;
+        }
+        return false;
+    };
+
+    out.inputAssembly = {};
+    out.inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    out.inputAssembly.topology =
+        isDyn(VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY) ? topologyClass(state.topology) : state.topology;
+
+    out.viewport = {};
+    out.viewport.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    out.viewport.viewportCount = 1;
+    out.viewport.scissorCount = 1;
+
+    out.rasterization = {};
+    out.rasterization.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    out.rasterization.polygonMode =
+        isDyn(VK_DYNAMIC_STATE_POLYGON_MODE_EXT) ? VK_POLYGON_MODE_FILL : state.polygonMode;
+    out.rasterization.lineWidth = 1.0f;
+    out.rasterization.cullMode =
+        isDyn(VK_DYNAMIC_STATE_CULL_MODE) ? VK_CULL_MODE_NONE : state.cullMode;
+    out.rasterization.frontFace =
+        isDyn(VK_DYNAMIC_STATE_FRONT_FACE) ? VK_FRONT_FACE_COUNTER_CLOCKWISE : state.frontFace;
+
+    out.multisample = {};
+    out.multisample.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    out.multisample.rasterizationSamples = state.samples;
+
+    out.blendAttachment = {};
+    out.blendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                         VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    bool dynamicBlend = isDyn(VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT) &&
+                        isDyn(VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT);
+    if (state.enableBlending && !dynamicBlend) {
+        out.blendAttachment.blendEnable = VK_TRUE;
+        out.blendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        out.blendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        out.blendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+        out.blendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        out.blendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+        out.blendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+    }
+
+    out.colorBlend = {};
+    out.colorBlend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    out.colorBlend.attachmentCount = 1;
+    out.colorBlend.pAttachments = &out.blendAttachment;
+
+    out.depthStencil = {};
+    out.depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    if (state.depthFormat != VK_FORMAT_UNDEFINED) {
+        out.depthStencil.depthTestEnable =
+            isDyn(VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE) ? VK_FALSE : VK_TRUE;
+        out.depthStencil.depthWriteEnable =
+            isDyn(VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE) ? VK_FALSE : VK_TRUE;
+        out.depthStencil.depthCompareOp =
+            isDyn(VK_DYNAMIC_STATE_DEPTH_COMPARE_OP) ? VK_COMPARE_OP_NEVER : state.depthCompareOp;
+    }
+
+    out.dynamic = {};
+    out.dynamic.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    out.dynamic.dynamicStateCount = state.dynamicStateCount;
+    out.dynamic.pDynamicStates = state.dynamicStates;
+
+    // Dynamic rendering (Vulkan 1.3 core): no VkRenderPass.
+    out.colorFormat = state.colorFormat;
+    out.rendering = {};
+    out.rendering.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+    out.rendering.viewMask = state.viewMask;
+    out.rendering.colorAttachmentCount = 1;
+    out.rendering.pColorAttachmentFormats = &out.colorFormat;
+    out.rendering.depthAttachmentFormat = state.depthFormat;
+
+    out.pipeline = {};
+    out.pipeline.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    out.pipeline.pNext = &out.rendering;
+    out.pipeline.stageCount = stageCount;
+    out.pipeline.pStages = out.stages;
+    out.pipeline.pVertexInputState = &out.vertexInput;
+    out.pipeline.pInputAssemblyState = &out.inputAssembly;
+    out.pipeline.pViewportState = &out.viewport;
+    out.pipeline.pRasterizationState = &out.rasterization;
+    out.pipeline.pMultisampleState = &out.multisample;
+    out.pipeline.pDepthStencilState = &out.depthStencil;
+    out.pipeline.pColorBlendState = &out.colorBlend;
+    out.pipeline.pDynamicState = &out.dynamic;
+    out.pipeline.layout = layout;
+}
+
+} // namespace detail
+
+void PipelineDesc::fill(PipelineDescCreateInfo& out, VkShaderModule vertModule,
+                        VkShaderModule fragModule, VkPipelineLayout layout) const {
+    std::uint32_t dynamicCount = 0;
+    out.dynamicStates[dynamicCount++] = VK_DYNAMIC_STATE_VIEWPORT;
+    out.dynamicStates[dynamicCount++] = VK_DYNAMIC_STATE_SCISSOR;
+    for (std::uint32_t i = 0; i < dynamicCount_; ++i)
+        out.dynamicStates[dynamicCount++] = dynamic_[i];
+
+    detail::GraphicsState state;
+    state.bindings = bindings_.data();
+    state.bindingCount = bindingCount_;
+    state.attributes = attributes_.data();
+    state.attributeCount = attributeCount_;
+    state.colorFormat = colorFormat_;
+    state.depthFormat = depthFormat_;
+    state.viewMask = viewMask_;
+    state.topology = topology_;
+    state.polygonMode = polygonMode_;
+    state.cullMode = cullMode_;
+    state.frontFace = frontFace_;
+    state.samples = samples_;
+    state.depthCompareOp = depthCompareOp_;
+    state.enableBlending = enableBlending_;
+    state.dynamicStates = out.dynamicStates;
+    state.dynamicStateCount = dynamicCount;
+    detail::fillGraphicsCreateInfo(out, state, vertModule, fragModule, nullptr, layout);
+}
+
+PipelineBuilder PipelineDesc::builder(const Device& device,
+                                      const std::filesystem::path& shaderDir) const {
+    PipelineBuilder b(device);
+    b.vertexShader(shaderDir / vertPath_);
+    if (!fragPath_.empty())
+        b.fragmentShader(shaderDir / fragPath_);
+    b.colorFormat(colorFormat_);
+    if (depthFormat_ != VK_FORMAT_UNDEFINED)
+        b.depthFormat(depthFormat_);
+    if (viewMask_ != 0)
+        b.viewMask(viewMask_);
+    for (std::uint32_t i = 0; i < bindingCount_; ++i)
+        b.vertexBinding(bindings_[i].binding, bindings_[i].stride, bindings_[i].inputRate);
+    for (std::uint32_t i = 0; i < attributeCount_; ++i) {
+        const auto& a = attributes_[i];
+        b.vertexAttribute(a.location, a.binding, a.format, a.offset);
+    }
+    b.topology(topology_)
+        .polygonMode(polygonMode_)
+        .cullMode(cullMode_)
+        .frontFace(frontFace_)
+        .samples(samples_)
+        .depthCompareOp(depthCompareOp_);
+    if (enableBlending_)
+        b.enableBlending();
+    for (std::uint32_t i = 0; i < dynamicCount_; ++i)
+        b.dynamicState(dynamic_[i]);
+    return b;
+}
+
+} // namespace vksdl
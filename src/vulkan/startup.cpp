@@ -0,0 +1,247 @@
+#include <vksdl/startup.hpp>
+
+#include "file_io.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+namespace vksdl {
+
+namespace {
+
+// Reads one byte per page so the whole file is resident in the page cache.
+void touchFile(const std::filesystem::path& path) {
+    detail::MappedFile file(path);
+    constexpr std::size_t kPage = 4096;
+    volatile std::uint8_t sink = 0;
+    for (std::size_t off = 0; off < file.size(); off += kPage)
+        sink = static_cast<std::uint8_t>(sink + file.data()[off]);
+}
+
+void appendEscaped(std::string& out, std::string_view s) {
+    for (char c : s) {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20)
+            out += c;
+    }
+}
+
+} // namespace
+
+std::string StartupTimeline::format() const {
+    std::vector<const StartupStageTiming*> order;
+    for (const auto& s : stages)
+        order.push_back(&s);
+    std::stable_sort(order.begin(), order.end(),
+                     [](const StartupStageTiming* a, const StartupStageTiming* b) {
+                         return a->startMs < b->startMs;
+                     });
+
+    std::string out;
+    char buf[256];
+    std::snprintf(buf, sizeof(buf), "startup: %.2f ms (%.2f ms of stage work, %.2fx overlap)\n",
+                  totalMs, serialMs, totalMs > 0.0 ? serialMs / totalMs : 0.0);
+    out += buf;
+    for (const auto* s : order) {
+        if (!s->ran) {
+            std::snprintf(buf, sizeof(buf), "  %-32s skipped\n", s->name.c_str());
+        } else {
+            std::snprintf(buf, sizeof(buf), "  %-32s %9.2f .. %9.2f ms  %8.2f ms  thread %u%s\n",
+                          s->name.c_str(), s->startMs, s->endMs, s->endMs - s->startMs,
+                          s->thread, s->ok ? "" : "  FAILED");
+        }
+        out += buf;
+    }
+    return out;
+}
+
+std::string StartupTimeline::toJson() const {
+    std::string out = "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto& s : stages) {
+        if (!s.ran)
+            continue;
+        out += first ? "\n  {\"name\":\"" : ",\n  {\"name\":\"";
+        first = false;
+        appendEscaped(out, s.name);
+        char buf[160];
+        // Trace events are in microseconds.
+        std::snprintf(buf, sizeof(buf),
+                      "\",\"cat\":\"startup\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,"
+                      "\"ts\":%.1f,\"dur\":%.1f,\"args\":{\"ok\":%s}}",
+                      s.thread, s.startMs * 1000.0, (s.endMs - s.startMs) * 1000.0,
+                      s.ok ? "true" : "false");
+        out += buf;
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+Startup::Startup(std::uint32_t workers) : workers_(workers) {
+    if (workers_ == 0)
+        workers_ = std::max(1u, std::thread::hardware_concurrency()) - 1;
+    workers_ = std::max(1u, workers_);
+}
+
+Startup::StageId Startup::add(std::string name, StageFn fn, std::initializer_list<StageId> after) {
+    return addStage(std::move(name), std::move(fn), after, false);
+}
+
+Startup::StageId Startup::addMainThread(std::string name, StageFn fn,
+                                        std::initializer_list<StageId> after) {
+    return addStage(std::move(name), std::move(fn), after, true);
+}
+
+Startup::StageId Startup::prefetch(std::string name, std::vector<std::filesystem::path> paths,
+                                   std::initializer_list<StageId> after) {
+    return add(
+        std::move(name),
+        [paths = std::move(paths)]() -> Result<void> {
+            for (const auto& p : paths) {
+                std::error_code ec;
+                if (!std::filesystem::is_directory(p, ec)) {
+                    touchFile(p);
+                    continue;
+                }
+                auto it = std::filesystem::recursive_directory_iterator(p, ec);
+                for (; !ec && it != std::filesystem::recursive_directory_iterator();
+                     it.increment(ec)) {
+                    if (it->is_regular_file(ec))
+                        touchFile(it->path());
+                }
+            }
+            return {};
+        },
+        after);
+}
+
+Startup::StageId Startup::addStage(std::string name, StageFn fn,
+                                   std::initializer_list<StageId> after, bool mainThread) {
+    Stage s;
+    s.name = std::move(name);
+    s.fn = std::move(fn);
+    s.after.assign(after.begin(), after.end());
+    s.mainThread = mainThread;
+    stages_.push_back(std::move(s));
+    return static_cast<StageId>(stages_.size() - 1);
+}
+
+Result<void> Startup::run() {
+    const auto count = static_cast<StageId>(stages_.size());
+    std::vector<std::vector<StageId>> dependents(count);
+    std::vector<std::uint32_t> remaining(count, 0);
+    std::uint32_t workerStages = 0;
+    for (StageId id = 0; id < count; ++id) {
+        for (StageId dep : stages_[id].after) {
+            if (dep >= id) {
+                return Error{"run startup", 0,
+                             "stage '" + stages_[id].name +
+                                 "' depends on a stage that was not added before it"};
+            }
+            dependents[dep].push_back(id);
+            ++remaining[id];
+        }
+        if (!stages_[id].mainThread)
+            ++workerStages;
+    }
+
+    timeline_ = {};
+    timeline_.stages.resize(count);
+    for (StageId id = 0; id < count; ++id)
+        timeline_.stages[id].name = stages_[id].name;
+
+    // All scheduling state is guarded by `mutex`; stage functions run
+    // without it.
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<StageId> workerReady;
+    std::deque<StageId> mainReady;
+    std::uint32_t succeeded = 0;
+    std::uint32_t running = 0;
+    std::optional<Error> failure;
+
+    auto enqueue = [&](StageId id) {
+        (stages_[id].mainThread ? mainReady : workerReady).push_back(id);
+    };
+    for (StageId id = 0; id < count; ++id) {
+        if (remaining[id] == 0)
+            enqueue(id);
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    auto sinceStart = [t0] {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0)
+            .count();
+    };
+
+    auto loop = [&](std::deque<StageId>& ready, std::uint32_t thread) {
+        std::unique_lock lock(mutex);
+        while (true) {
+            cv.wait(lock, [&] {
+                return !ready.empty() || succeeded == count || (failure && running == 0);
+            });
+            if (ready.empty())
+                return;
+            StageId id = ready.front();
+            ready.pop_front();
+            if (failure)
+                continue; // skipped: ran stays false
+
+            ++running;
+            lock.unlock();
+            StartupStageTiming& t = timeline_.stages[id];
+            t.thread = thread;
+            t.startMs = sinceStart();
+            auto result = stages_[id].fn();
+            t.endMs = sinceStart();
+            t.ran = true;
+            t.ok = result.ok();
+            lock.lock();
+            --running;
+
+            if (t.ok) {
+                ++succeeded;
+                for (StageId next : dependents[id]) {
+                    if (--remaining[next] == 0)
+                        enqueue(next);
+                }
+            } else if (!failure) {
+                failure = std::move(result).error();
+                failure->message += " (startup stage '" + stages_[id].name + "')";
+            }
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    std::uint32_t threadCount = std::min(workers_, workerStages);
+    threads.reserve(threadCount);
+    for (std::uint32_t i = 0; i < threadCount; ++i)
+        threads.emplace_back(loop, std::ref(workerReady), i + 1);
+    loop(mainReady, 0);
+    for (auto& th : threads)
+        th.join();
+
+    timeline_.totalMs = sinceStart();
+    for (const auto& t : timeline_.stages) {
+        if (t.ran)
+            timeline_.serialMs += t.endMs - t.startMs;
+    }
+
+    if (failure)
+        return std::move(*failure);
+    return {};
+}
+
+} // namespace vksdl
@@ -2,11 +2,12 @@
 #include <vksdl/allocator.hpp>
 #include <vksdl/buffer.hpp>
 #include <vksdl/device.hpp>
+#include <vksdl/mapped_writes.hpp>
 #include <vksdl/transfer_queue.hpp>
 
 #include <vk_mem_alloc.h>
 
-#include <cstring>
+#include <utility>
 
 namespace vksdl {
 
@@ -111,6 +112,23 @@ Result<TransferQueue> TransferQueue::create(const Device& device, const Allocato
 
 Result<PendingTransfer> TransferQueue::uploadAsync(const Buffer& dst, const void* data,
                                                    VkDeviceSize size) {
+    // Host-mapped destination (ReBAR, UMA): the host write is the transfer.
+    // Nothing is submitted, so there is no queue ownership to hand over and
+    // the returned timeline value is already complete.
+    if (dst.mappedData() != nullptr) {
+        streamingCopy(dst.mappedData(), data, static_cast<std::size_t>(size));
+        auto flushed = dst.flush(0, size);
+        if (!flushed.ok())
+            return std::move(flushed).error();
+
+        PendingTransfer result;
+        result.timelineValue = counter_;
+        result.buffer = dst.vkBuffer();
+        result.srcFamily = dstFamily_;
+        result.dstFamily = dstFamily_;
+        return result;
+    }
+
     VkBufferCreateInfo stagingCI{};
     stagingCI.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
     stagingCI.size = size;
@@ -132,7 +150,14 @@ Result<PendingTransfer> TransferQueue::uploadAsync(const Buffer& dst, const void
                      "failed to create staging buffer"};
     }
 
-    std::memcpy(stagingInfo.pMappedData, data, static_cast<std::size_t>(size));
+    streamingCopy(stagingInfo.pMappedData, data, static_cast<std::size_t>(size));
+    // No-op for HOST_COHERENT memory.
+    vr = vmaFlushAllocation(toVma(allocator_), stagingAlloc, 0, VK_WHOLE_SIZE);
+    if (vr != VK_SUCCESS) {
+        vmaDestroyBuffer(toVma(allocator_), stagingBuf, stagingAlloc);
+        return Error{"async upload", static_cast<std::int32_t>(vr),
+                     "failed to flush staging buffer"};
+    }
 
     VkCommandBufferAllocateInfo cmdAI{};
     cmdAI.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -229,6 +254,46 @@ Result<PendingTransfer> TransferQueue::uploadAsync(const Buffer& dst, const void
     return result;
 }
 
+Result<std::uint64_t> TransferQueue::submit(VkCommandBuffer cmd) {
+    return submit(cmd, VK_NULL_HANDLE, 0, 0);
+}
+
+Result<std::uint64_t> TransferQueue::submit(VkCommandBuffer cmd, VkSemaphore wait,
+                                            std::uint64_t waitValue,
+                                            VkPipelineStageFlags waitStage) {
+    std::uint64_t signalValue = counter_ + 1;
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &cmd;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &timeline_;
+    if (wait != VK_NULL_HANDLE) {
+        timelineInfo.waitSemaphoreValueCount = 1;
+        timelineInfo.pWaitSemaphoreValues = &waitValue;
+        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.pWaitSemaphores = &wait;
+        submitInfo.pWaitDstStageMask = &waitStage;
+    }
+
+    VkResult vr = vkQueueSubmit(queue_, 1, &submitInfo, VK_NULL_HANDLE);
+    if (vr != VK_SUCCESS) {
+        if (devicePtr_)
+            detail::checkDeviceLost(*devicePtr_, vr);
+        return Error{"transfer submit", static_cast<std::int32_t>(vr), "vkQueueSubmit failed"};
+    }
+
+    counter_ = signalValue;
+    return signalValue;
+}
+
 void TransferQueue::waitIdle() {
     if (counter_ == 0)
         return;
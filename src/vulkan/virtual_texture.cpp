@@ -0,0 +1,830 @@
+#include "device_lost.hpp"
+#include <vksdl/allocator.hpp>
+#include <vksdl/barriers.hpp>
+#include <vksdl/device.hpp>
+#include <vksdl/transfer_queue.hpp>
+#include <vksdl/virtual_texture.hpp>
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable : 4100) // unreferenced formal parameter
+#pragma warning(disable : 4189) // local variable initialized but not referenced
+#pragma warning(disable : 4244) // conversion, possible loss of data
+#elif defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+#include <vk_mem_alloc.h>
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#elif defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <functional>
+
+namespace vksdl {
+
+namespace {
+
+constexpr std::uint32_t kNoFeedback = 0xFFFFFFFFu;
+constexpr std::uint32_t kTailPage = UINT32_MAX; // StagingBatch::pages marker
+
+std::uint32_t texelSize(VkFormat format) {
+    switch (format) {
+    case VK_FORMAT_R8_UNORM:
+        return 1;
+    case VK_FORMAT_R8G8_UNORM:
+        return 2;
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SRGB:
+    case VK_FORMAT_B8G8R8A8_UNORM:
+    case VK_FORMAT_B8G8R8A8_SRGB:
+    case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+    case VK_FORMAT_R32_SFLOAT:
+    case VK_FORMAT_R32_UINT:
+        return 4;
+    case VK_FORMAT_R16G16B16A16_SFLOAT:
+    case VK_FORMAT_R32G32_SFLOAT:
+        return 8;
+    case VK_FORMAT_R32G32B32A32_SFLOAT:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+std::uint32_t mipSize(std::uint32_t base, std::uint32_t mip) {
+    return std::max(base >> mip, 1u);
+}
+
+} // namespace
+
+void VirtualTexture::destroy() {
+    if (device_ == VK_NULL_HANDLE)
+        return;
+
+    // Binds and copies reference the image and the page memory.
+    if (bindValue_ > 0) {
+        VkSemaphoreWaitInfo waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &bindTimeline_;
+        waitInfo.pValues = &bindValue_;
+        // VKSDL_BLOCKING_WAIT: teardown only.
+        vkWaitSemaphores(device_, &waitInfo, UINT64_MAX);
+    }
+    if (pool_ != VK_NULL_HANDLE)
+        vkDestroyCommandPool(device_, pool_, nullptr);
+    if (view_ != VK_NULL_HANDLE)
+        vkDestroyImageView(device_, view_, nullptr);
+    if (image_ != VK_NULL_HANDLE)
+        vkDestroyImage(device_, image_, nullptr);
+    if (bindTimeline_ != VK_NULL_HANDLE)
+        vkDestroySemaphore(device_, bindTimeline_, nullptr);
+
+    for (const Slot& s : slots_) {
+        if (s.memory != nullptr)
+            vmaFreeMemory(allocator_, s.memory);
+    }
+    if (tailMemory_ != nullptr)
+        vmaFreeMemory(allocator_, tailMemory_);
+
+    device_ = VK_NULL_HANDLE;
+}
+
+VirtualTexture::~VirtualTexture() {
+    destroy();
+}
+
+void VirtualTexture::moveFrom(VirtualTexture& o) noexcept {
+    device_ = o.device_;
+    allocator_ = o.allocator_;
+    bindQueue_ = o.bindQueue_;
+    image_ = o.image_;
+    view_ = o.view_;
+    bindTimeline_ = o.bindTimeline_;
+    bindValue_ = o.bindValue_;
+    pool_ = o.pool_;
+    loader_ = std::move(o.loader_);
+    extent_ = o.extent_;
+    pageExtent_ = o.pageExtent_;
+    texelBytes_ = o.texelBytes_;
+    pageBytes_ = o.pageBytes_;
+    mipLevels_ = o.mipLevels_;
+    tailMip_ = o.tailMip_;
+    framesInFlight_ = o.framesInFlight_;
+    maxUploads_ = o.maxUploads_;
+    pagesX_ = std::move(o.pagesX_);
+    pagesY_ = std::move(o.pagesY_);
+    mipOffset_ = std::move(o.mipOffset_);
+    pages_ = std::move(o.pages_);
+    slots_ = std::move(o.slots_);
+    freeSlots_ = std::move(o.freeSlots_);
+    retiring_ = std::move(o.retiring_);
+    lruHead_ = o.lruHead_;
+    lruTail_ = o.lruTail_;
+    frame_ = o.frame_;
+    requests_ = std::move(o.requests_);
+    tailMemory_ = o.tailMemory_;
+    tailStagingOffset_ = o.tailStagingOffset_;
+    tailStaged_ = o.tailStaged_;
+    ready_ = o.ready_;
+    publishedTransferValue_ = o.publishedTransferValue_;
+    pageTableDirty_ = o.pageTableDirty_;
+    feedback_ = std::move(o.feedback_);
+    batches_ = std::move(o.batches_);
+    nextBatch_ = o.nextBatch_;
+    imageBinds_ = std::move(o.imageBinds_);
+    copies_ = std::move(o.copies_);
+    stats_ = o.stats_;
+    o.device_ = VK_NULL_HANDLE;
+    o.image_ = VK_NULL_HANDLE;
+    o.view_ = VK_NULL_HANDLE;
+    o.bindTimeline_ = VK_NULL_HANDLE;
+    o.pool_ = VK_NULL_HANDLE;
+    o.tailMemory_ = nullptr;
+    o.slots_.clear();
+}
+
+VirtualTexture::VirtualTexture(VirtualTexture&& o) noexcept
+    : pageTable_(std::move(o.pageTable_)), staging_(std::move(o.staging_)) {
+    moveFrom(o);
+}
+
+VirtualTexture& VirtualTexture::operator=(VirtualTexture&& o) noexcept {
+    if (this != &o) {
+        destroy();
+        pageTable_ = std::move(o.pageTable_);
+        staging_ = std::move(o.staging_);
+        moveFrom(o);
+    }
+    return *this;
+}
+
+Result<VirtualTexture> VirtualTexture::create(const Device& device, const Allocator& allocator,
+                                              const VirtualTextureDesc& desc, PageLoader loader) {
+    if (!device.hasSparseResidency()) {
+        return Error{"create virtual texture", 0,
+                     "sparse residency not enabled -- call DeviceBuilder::needSparseResidency()"};
+    }
+    if (desc.extent.width == 0 || desc.extent.height == 0) {
+        return Error{"create virtual texture", 0, "extent must be non-zero"};
+    }
+    if (desc.physicalPages == 0 || desc.framesInFlight == 0 || desc.maxUploadsPerUpdate == 0) {
+        return Error{"create virtual texture", 0,
+                     "physicalPages, framesInFlight and maxUploadsPerUpdate must be non-zero"};
+    }
+    if (!loader) {
+        return Error{"create virtual texture", 0, "a page loader is required"};
+    }
+    std::uint32_t texelBytes = texelSize(desc.format);
+    if (texelBytes == 0) {
+        return Error{"create virtual texture", 0, "unsupported format (uncompressed only)"};
+    }
+
+    VkDevice dev = device.vkDevice();
+    VmaAllocator vma = allocator.vmaAllocator();
+    std::uint32_t mipLevels =
+        static_cast<std::uint32_t>(std::bit_width(std::max(desc.extent.width,
+                                                           desc.extent.height)));
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+    std::uint32_t formatCount = 0;
+    vkGetPhysicalDeviceSparseImageFormatProperties(device.vkPhysicalDevice(), desc.format,
+                                                   VK_IMAGE_TYPE_2D, VK_SAMPLE_COUNT_1_BIT, usage,
+                                                   VK_IMAGE_TILING_OPTIMAL, &formatCount, nullptr);
+    if (formatCount == 0) {
+        return Error{"create virtual texture", 0, "format does not support sparse residency"};
+    }
+
+    // Sampled on the graphics queue, written on the transfer queue: concurrent
+    // sharing avoids an ownership transfer per page.
+    QueueFamilies families = device.queueFamilies();
+    std::uint32_t familyIndices[2] = {families.graphics, families.transfer};
+    bool concurrent = device.hasDedicatedTransfer();
+
+    VkImageCreateInfo imageCI{};
+    imageCI.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageCI.flags = VK_IMAGE_CREATE_SPARSE_BINDING_BIT | VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT;
+    imageCI.imageType = VK_IMAGE_TYPE_2D;
+    imageCI.format = desc.format;
+    imageCI.extent = {desc.extent.width, desc.extent.height, 1};
+    imageCI.mipLevels = mipLevels;
+    imageCI.arrayLayers = 1;
+    imageCI.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageCI.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageCI.usage = usage;
+    imageCI.sharingMode = concurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+    imageCI.queueFamilyIndexCount = concurrent ? 2u : 0u;
+    imageCI.pQueueFamilyIndices = concurrent ? familyIndices : nullptr;
+    imageCI.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    VkImage image = VK_NULL_HANDLE;
+    VkResult vr = vkCreateImage(dev, &imageCI, nullptr, &image);
+    if (vr != VK_SUCCESS) {
+        return Error{"create virtual texture", static_cast<std::int32_t>(vr),
+                     "vkCreateImage failed for sparse image"};
+    }
+
+    VkMemoryRequirements memReq{};
+    vkGetImageMemoryRequirements(dev, image, &memReq);
+
+    std::uint32_t sparseCount = 0;
+    vkGetImageSparseMemoryRequirements(dev, image, &sparseCount, nullptr);
+    std::vector<VkSparseImageMemoryRequirements> sparseReqs(sparseCount);
+    vkGetImageSparseMemoryRequirements(dev, image, &sparseCount, sparseReqs.data());
+
+    const VkSparseImageMemoryRequirements* colorReq = nullptr;
+    for (const auto& r : sparseReqs) {
+        if (r.formatProperties.aspectMask & VK_IMAGE_ASPECT_METADATA_BIT) {
+            vkDestroyImage(dev, image, nullptr);
+            return Error{"create virtual texture", 0, "metadata aspect is not supported"};
+        }
+        if (r.formatProperties.aspectMask & VK_IMAGE_ASPECT_COLOR_BIT)
+            colorReq = &r;
+    }
+    if (colorReq == nullptr || colorReq->imageMipTailFirstLod == 0 ||
+        colorReq->imageMipTailFirstLod >= mipLevels) {
+        vkDestroyImage(dev, image, nullptr);
+        return Error{"create virtual texture", 0,
+                     "need at least one sparse mip level and a mip tail -- extent too small?"};
+    }
+
+    VkExtent3D granularity = colorReq->formatProperties.imageGranularity;
+    VkDeviceSize pageBytes =
+        static_cast<VkDeviceSize>(granularity.width) * granularity.height * texelBytes;
+    std::uint32_t tailMip = colorReq->imageMipTailFirstLod;
+
+    VkDeviceSize tailBytes = 0;
+    for (std::uint32_t m = tailMip; m < mipLevels; ++m) {
+        tailBytes += static_cast<VkDeviceSize>(mipSize(desc.extent.width, m)) *
+                     mipSize(desc.extent.height, m) * texelBytes;
+    }
+    std::uint32_t batchCount = desc.framesInFlight;
+    VkDeviceSize tailStagingOffset = pageBytes * desc.maxUploadsPerUpdate * batchCount;
+
+    std::vector<std::uint32_t> pagesX(tailMip), pagesY(tailMip), mipOffset(tailMip);
+    std::uint32_t pageCount = 0;
+    for (std::uint32_t m = 0; m < tailMip; ++m) {
+        pagesX[m] = (mipSize(desc.extent.width, m) + granularity.width - 1) / granularity.width;
+        pagesY[m] = (mipSize(desc.extent.height, m) + granularity.height - 1) / granularity.height;
+        mipOffset[m] = pageCount;
+        pageCount += pagesX[m] * pagesY[m];
+    }
+
+    auto pageTable = BufferBuilder(allocator)
+                         .storageBuffer()
+                         .mapped()
+                         .size(static_cast<VkDeviceSize>(pagesX[0]) * pagesY[0] *
+                               sizeof(std::uint32_t))
+                         .build();
+    auto staging =
+        BufferBuilder(allocator).stagingBuffer().size(tailStagingOffset + tailBytes).build();
+    if (!pageTable.ok() || !staging.ok()) {
+        vkDestroyImage(dev, image, nullptr);
+        return !pageTable.ok() ? std::move(pageTable).error() : std::move(staging).error();
+    }
+
+    VirtualTexture vt(std::move(pageTable).value(), std::move(staging).value());
+    vt.device_ = dev;
+    vt.allocator_ = vma;
+    vt.bindQueue_ = device.graphicsQueue();
+    vt.image_ = image;
+    vt.loader_ = std::move(loader);
+    vt.extent_ = desc.extent;
+    vt.pageExtent_ = {granularity.width, granularity.height};
+    vt.texelBytes_ = texelBytes;
+    vt.pageBytes_ = pageBytes;
+    vt.mipLevels_ = mipLevels;
+    vt.tailMip_ = tailMip;
+    vt.framesInFlight_ = desc.framesInFlight;
+    vt.maxUploads_ = desc.maxUploadsPerUpdate;
+    vt.pagesX_ = std::move(pagesX);
+    vt.pagesY_ = std::move(pagesY);
+    vt.mipOffset_ = std::move(mipOffset);
+    vt.pages_.resize(pageCount);
+    vt.tailStagingOffset_ = tailStagingOffset;
+
+    if (vt.pageTable_.mappedData() == nullptr || vt.staging_.mappedData() == nullptr) {
+        return Error{"create virtual texture", 0, "page table or staging buffer is not mapped"};
+    }
+    // Until a page is resident every region falls back to the mip tail.
+    auto* table = static_cast<std::uint32_t*>(vt.pageTable_.mappedData());
+    std::fill_n(table, static_cast<std::size_t>(vt.pagesX_[0]) * vt.pagesY_[0], tailMip);
+    vt.pageTableDirty_ = true;
+
+    VkDeviceSize feedbackBytes =
+        static_cast<VkDeviceSize>(vt.pagesX_[0]) * vt.pagesY_[0] * sizeof(std::uint32_t);
+    for (std::uint32_t i = 0; i < desc.framesInFlight; ++i) {
+        auto fb = BufferBuilder(allocator).storageBuffer().readback().size(feedbackBytes).build();
+        if (!fb.ok())
+            return std::move(fb).error();
+        if (fb.value().mappedData() == nullptr) {
+            return Error{"create virtual texture", 0, "feedback buffer is not host-mapped"};
+        }
+        std::memset(fb.value().mappedData(), 0xFF, static_cast<std::size_t>(feedbackBytes));
+        auto flushed = fb.value().flush();
+        if (!flushed.ok())
+            return std::move(flushed).error();
+        vt.feedback_.push_back(std::move(fb).value());
+    }
+
+    // Physical page pool: one sparse block per allocation, any offset the
+    // allocator picks (blocks are aligned to memReq.alignment).
+    VkMemoryRequirements pageReq = memReq;
+    pageReq.size = memReq.alignment;
+    VmaAllocationCreateInfo pageCI{};
+    pageCI.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+    std::vector<VmaAllocation> pageAllocs(desc.physicalPages);
+    std::vector<VmaAllocationInfo> pageInfos(desc.physicalPages);
+    vr = vmaAllocateMemoryPages(vma, &pageReq, &pageCI, desc.physicalPages, pageAllocs.data(),
+                                pageInfos.data());
+    if (vr != VK_SUCCESS) {
+        return Error{"create virtual texture", static_cast<std::int32_t>(vr),
+                     "vmaAllocateMemoryPages failed for the physical page pool"};
+    }
+    vt.slots_.resize(desc.physicalPages);
+    vt.freeSlots_.reserve(desc.physicalPages);
+    for (std::uint32_t i = 0; i < desc.physicalPages; ++i) {
+        vt.slots_[i].memory = pageAllocs[i];
+        vt.slots_[i].deviceMemory = pageInfos[i].deviceMemory;
+        vt.slots_[i].memoryOffset = pageInfos[i].offset;
+        vt.freeSlots_.push_back(desc.physicalPages - 1 - i);
+    }
+
+    VkMemoryRequirements tailReq = memReq;
+    tailReq.size = colorReq->imageMipTailSize;
+    VmaAllocationInfo tailInfo{};
+    vr = vmaAllocateMemory(vma, &tailReq, &pageCI, &vt.tailMemory_, &tailInfo);
+    if (vr != VK_SUCCESS) {
+        return Error{"create virtual texture", static_cast<std::int32_t>(vr),
+                     "vmaAllocateMemory failed for the mip tail"};
+    }
+
+    VkSemaphoreTypeCreateInfo typeCI{};
+    typeCI.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeCI.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeCI.initialValue = 0;
+    VkSemaphoreCreateInfo semCI{};
+    semCI.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semCI.pNext = &typeCI;
+    vr = vkCreateSemaphore(dev, &semCI, nullptr, &vt.bindTimeline_);
+    if (vr != VK_SUCCESS) {
+        return Error{"create virtual texture", static_cast<std::int32_t>(vr),
+                     "vkCreateSemaphore failed"};
+    }
+
+    // The mip tail is bound once, as an opaque range, and never evicted.
+    VkSparseMemoryBind tailBind{};
+    tailBind.resourceOffset = colorReq->imageMipTailOffset;
+    tailBind.size = colorReq->imageMipTailSize;
+    tailBind.memory = tailInfo.deviceMemory;
+    tailBind.memoryOffset = tailInfo.offset;
+    VkSparseImageOpaqueMemoryBindInfo opaqueInfo{};
+    opaqueInfo.image = image;
+    opaqueInfo.bindCount = 1;
+    opaqueInfo.pBinds = &tailBind;
+
+    std::uint64_t signalValue = 1;
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &signalValue;
+    VkBindSparseInfo bindInfo{};
+    bindInfo.sType = VK_STRUCTURE_TYPE_BIND_SPARSE_INFO;
+    bindInfo.pNext = &timelineInfo;
+    bindInfo.imageOpaqueBindCount = 1;
+    bindInfo.pImageOpaqueBinds = &opaqueInfo;
+    bindInfo.signalSemaphoreCount = 1;
+    bindInfo.pSignalSemaphores = &vt.bindTimeline_;
+    vr = vkQueueBindSparse(vt.bindQueue_, 1, &bindInfo, VK_NULL_HANDLE);
+    if (vr != VK_SUCCESS) {
+        detail::checkDeviceLost(device, vr);
+        return Error{"create virtual texture", static_cast<std::int32_t>(vr),
+                     "vkQueueBindSparse failed for the mip tail"};
+    }
+    vt.bindValue_ = signalValue;
+
+    VkImageViewCreateInfo viewCI{};
+    viewCI.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewCI.image = image;
+    viewCI.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewCI.format = desc.format;
+    viewCI.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels, 0, 1};
+    vr = vkCreateImageView(dev, &viewCI, nullptr, &vt.view_);
+    if (vr != VK_SUCCESS) {
+        return Error{"create virtual texture", static_cast<std::int32_t>(vr),
+                     "vkCreateImageView failed"};
+    }
+
+    // Uploads are recorded for the queue TransferQueue submits to.
+    VkCommandPoolCreateInfo poolCI{};
+    poolCI.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolCI.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolCI.queueFamilyIndex = concurrent ? families.transfer : families.graphics;
+    vr = vkCreateCommandPool(dev, &poolCI, nullptr, &vt.pool_);
+    if (vr != VK_SUCCESS) {
+        return Error{"create virtual texture", static_cast<std::int32_t>(vr),
+                     "vkCreateCommandPool failed"};
+    }
+
+    vt.batches_.resize(batchCount);
+    for (auto& batch : vt.batches_) {
+        VkCommandBufferAllocateInfo cmdAI{};
+        cmdAI.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        cmdAI.commandPool = vt.pool_;
+        cmdAI.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        cmdAI.commandBufferCount = 1;
+        vr = vkAllocateCommandBuffers(dev, &cmdAI, &batch.cmd);
+        if (vr != VK_SUCCESS) {
+            return Error{"create virtual texture", static_cast<std::int32_t>(vr),
+                         "vkAllocateCommandBuffers failed"};
+        }
+        batch.pages.reserve(desc.maxUploadsPerUpdate + 1);
+    }
+
+    vt.imageBinds_.reserve(desc.maxUploadsPerUpdate * 2);
+    vt.copies_.reserve(desc.maxUploadsPerUpdate + (mipLevels - tailMip));
+    // frame_ starts past every Page::touched so nothing looks requested yet.
+    vt.frame_ = 1;
+    return vt;
+}
+
+void VirtualTexture::decodePage(std::uint32_t page, std::uint32_t& mip, std::uint32_t& x,
+                                std::uint32_t& y) const {
+    auto next = std::upper_bound(mipOffset_.begin(), mipOffset_.end(), page);
+    mip = static_cast<std::uint32_t>(next - mipOffset_.begin()) - 1;
+    std::uint32_t local = page - mipOffset_[mip];
+    x = local % pagesX_[mip];
+    y = local / pagesX_[mip];
+}
+
+VkExtent3D VirtualTexture::pageTexels(std::uint32_t mip, std::uint32_t x, std::uint32_t y) const {
+    std::uint32_t w = mipSize(extent_.width, mip);
+    std::uint32_t h = mipSize(extent_.height, mip);
+    return {std::min(pageExtent_.width, w - x * pageExtent_.width),
+            std::min(pageExtent_.height, h - y * pageExtent_.height), 1};
+}
+
+void VirtualTexture::lruUnlink(std::uint32_t slot) {
+    Slot& s = slots_[slot];
+    if (s.prev != UINT32_MAX)
+        slots_[s.prev].next = s.next;
+    else
+        lruHead_ = s.next;
+    if (s.next != UINT32_MAX)
+        slots_[s.next].prev = s.prev;
+    else
+        lruTail_ = s.prev;
+    s.prev = s.next = UINT32_MAX;
+}
+
+void VirtualTexture::lruPushFront(std::uint32_t slot) {
+    Slot& s = slots_[slot];
+    s.prev = UINT32_MAX;
+    s.next = lruHead_;
+    if (lruHead_ != UINT32_MAX)
+        slots_[lruHead_].prev = slot;
+    lruHead_ = slot;
+    if (lruTail_ == UINT32_MAX)
+        lruTail_ = slot;
+}
+
+void VirtualTexture::touch(std::uint32_t page) {
+    Page& p = pages_[page];
+    p.touched = frame_;
+    if (p.state == PageState::Resident) {
+        lruUnlink(p.slot);
+        lruPushFront(p.slot);
+    } else if (p.state == PageState::Absent) {
+        p.state = PageState::Requested;
+        requests_.push_back(page);
+        ++stats_.requested;
+    }
+}
+
+void VirtualTexture::request(std::uint32_t mip, std::uint32_t pageX, std::uint32_t pageY) {
+    if (mip >= tailMip_)
+        return; // the mip tail is always resident
+    assert(pageX < pagesX_[mip] && pageY < pagesY_[mip]);
+    // Finest first, so each ancestor lands ahead of its children in the LRU
+    // list and is evicted after them. The whole chain is touched every time:
+    // an ancestor touched earlier this frame may have been evicted since,
+    // and must be requested again before its children can be sampled.
+    for (std::uint32_t m = mip; m < tailMip_; ++m)
+        touch(coveringPage(m, pageX << mip, pageY << mip));
+}
+
+void VirtualTexture::processFeedback(std::uint32_t frameIndex) {
+    stats_.requested = 0;
+    const Buffer& fb = feedback_[frameIndex % feedback_.size()];
+    if (!fb.invalidate().ok())
+        return;
+
+    auto* entries = static_cast<std::uint32_t*>(fb.mappedData());
+    std::uint32_t width = pagesX_[0];
+    std::uint32_t count = width * pagesY_[0];
+    for (std::uint32_t i = 0; i < count; ++i) {
+        std::uint32_t mip = entries[i];
+        if (mip == kNoFeedback)
+            continue;
+        entries[i] = kNoFeedback;
+        if (mip < tailMip_) {
+            std::uint32_t page = coveringPage(mip, i % width, i / width);
+            std::uint32_t m = 0, x = 0, y = 0;
+            decodePage(page, m, x, y);
+            request(mip, x, y);
+        }
+    }
+    (void) fb.flush();
+}
+
+// Finest mip for every mip-0 page under `page` whose whole coarser chain is
+// resident. A resident page under an absent ancestor is never exposed.
+void VirtualTexture::refreshPageTable(std::uint32_t page) {
+    std::uint32_t mip = 0, px = 0, py = 0;
+    decodePage(page, mip, px, py);
+    std::uint32_t x0 = px << mip;
+    std::uint32_t y0 = py << mip;
+    std::uint32_t x1 = px + 1 == pagesX_[mip] ? pagesX_[0] : std::min((px + 1) << mip, pagesX_[0]);
+    std::uint32_t y1 = py + 1 == pagesY_[mip] ? pagesY_[0] : std::min((py + 1) << mip, pagesY_[0]);
+
+    auto* table = static_cast<std::uint32_t*>(pageTable_.mappedData());
+    for (std::uint32_t y = y0; y < y1; ++y) {
+        for (std::uint32_t x = x0; x < x1; ++x) {
+            std::uint32_t best = tailMip_;
+            while (best > 0 &&
+                   pages_[coveringPage(best - 1, x, y)].state == PageState::Resident)
+                --best;
+            table[y * pagesX_[0] + x] = best;
+        }
+    }
+    pageTableDirty_ = true;
+}
+
+// True if a page one mip finer under `page` is resident or uploading. Its
+// own descendants imply it, since every resident page has resident ancestors.
+bool VirtualTexture::hasResidentChildren(std::uint32_t page) const {
+    std::uint32_t mip = 0, px = 0, py = 0;
+    decodePage(page, mip, px, py);
+    if (mip == 0)
+        return false;
+    std::uint32_t m = mip - 1;
+    std::uint32_t x1 = px + 1 == pagesX_[mip] ? pagesX_[m] : std::min(2 * px + 2, pagesX_[m]);
+    std::uint32_t y1 = py + 1 == pagesY_[mip] ? pagesY_[m] : std::min(2 * py + 2, pagesY_[m]);
+    for (std::uint32_t y = 2 * py; y < y1; ++y) {
+        for (std::uint32_t x = 2 * px; x < x1; ++x) {
+            PageState state = pages_[pageIndex(m, x, y)].state;
+            if (state == PageState::Resident || state == PageState::Uploading)
+                return true;
+        }
+    }
+    return false;
+}
+
+// A free slot, or UINT32_MAX. Without a free slot, evicts the least
+// recently used page that has no resident children, unless it was requested
+// since the last update(); its slot frees up framesInFlight updates later.
+// Descendants always go before their ancestors.
+std::uint32_t VirtualTexture::acquireSlot() {
+    if (!freeSlots_.empty()) {
+        std::uint32_t slot = freeSlots_.back();
+        freeSlots_.pop_back();
+        return slot;
+    }
+
+    std::uint32_t victim = lruTail_;
+    while (victim != UINT32_MAX) {
+        const Page& candidate = pages_[slots_[victim].page];
+        if (candidate.touched + 1 >= frame_)
+            return UINT32_MAX;
+        if (!hasResidentChildren(slots_[victim].page))
+            break;
+        victim = slots_[victim].prev;
+    }
+    if (victim == UINT32_MAX)
+        return UINT32_MAX;
+    Page& p = pages_[slots_[victim].page];
+
+    // Leaves the page table now; keeps its binding until frames that may
+    // still sample it have retired.
+    lruUnlink(victim);
+    p.state = PageState::Absent;
+    p.slot = UINT32_MAX;
+    refreshPageTable(slots_[victim].page);
+    slots_[victim].retireAt = frame_ + framesInFlight_;
+    retiring_.push_back(victim);
+    ++stats_.evicted;
+    --stats_.residentPages;
+    return UINT32_MAX;
+}
+
+bool VirtualTexture::isResident(std::uint32_t mip, std::uint32_t pageX,
+                                std::uint32_t pageY) const {
+    if (mip >= tailMip_)
+        return ready_;
+    assert(pageX < pagesX_[mip] && pageY < pagesY_[mip]);
+    return pages_[pageIndex(mip, pageX, pageY)].state == PageState::Resident;
+}
+
+Result<void> VirtualTexture::update(TransferQueue& transfer) {
+    ++frame_;
+    stats_.uploaded = 0;
+    stats_.evicted = 0;
+    stats_.bindCalls = 0;
+
+    // Publish finished uploads.
+    for (StagingBatch& batch : batches_) {
+        if (batch.timelineValue == 0 || !transfer.isComplete(batch.timelineValue))
+            continue;
+        publishedTransferValue_ = std::max(publishedTransferValue_, batch.timelineValue);
+        for (std::uint32_t page : batch.pages) {
+            if (page == kTailPage) {
+                ready_ = true;
+                continue;
+            }
+            pages_[page].state = PageState::Resident;
+            lruPushFront(pages_[page].slot);
+            refreshPageTable(page);
+            ++stats_.residentPages;
+        }
+        batch.timelineValue = 0;
+        batch.pages.clear();
+    }
+
+    StagingBatch& batch = batches_[nextBatch_];
+    if (batch.timelineValue == 0) {
+        imageBinds_.clear();
+        copies_.clear();
+
+        // Unbind slots whose eviction has outlived the frames in flight.
+        for (std::size_t i = 0; i < retiring_.size();) {
+            Slot& s = slots_[retiring_[i]];
+            if (s.retireAt > frame_) {
+                ++i;
+                continue;
+            }
+            // A page requested again since has been bound to another slot,
+            // which already replaced this binding.
+            if (pages_[s.page].state == PageState::Absent ||
+                pages_[s.page].state == PageState::Requested) {
+                std::uint32_t mip = 0, x = 0, y = 0;
+                decodePage(s.page, mip, x, y);
+                VkSparseImageMemoryBind unbind{};
+                unbind.subresource = {VK_IMAGE_ASPECT_COLOR_BIT, mip, 0};
+                unbind.offset = {static_cast<std::int32_t>(x * pageExtent_.width),
+                                 static_cast<std::int32_t>(y * pageExtent_.height), 0};
+                unbind.extent = pageTexels(mip, x, y);
+                imageBinds_.push_back(unbind);
+            }
+            s.page = UINT32_MAX;
+            freeSlots_.push_back(retiring_[i]);
+            retiring_[i] = retiring_.back();
+            retiring_.pop_back();
+        }
+
+        // Coarse mips first: they unblock the most texels per page. Page
+        // indices grow with the mip level.
+        std::sort(requests_.begin(), requests_.end(), std::greater<>());
+
+        auto* staged = static_cast<std::uint8_t*>(staging_.mappedData());
+        VkDeviceSize batchOffset = static_cast<VkDeviceSize>(nextBatch_) * maxUploads_ * pageBytes_;
+        // Each upload or eviction claims one of this update's maxUploads_.
+        // Requests without a slot stay queued, in order.
+        std::size_t kept = 0;
+        bool poolFull = false;
+        for (std::uint32_t page : requests_) {
+            std::uint32_t slot = UINT32_MAX;
+            if (!poolFull && batch.pages.size() + stats_.evicted < maxUploads_) {
+                std::uint32_t evicted = stats_.evicted;
+                slot = acquireSlot();
+                poolFull = slot == UINT32_MAX && stats_.evicted == evicted;
+            }
+            if (slot == UINT32_MAX) {
+                requests_[kept++] = page;
+                continue;
+            }
+
+            std::uint32_t mip = 0, x = 0, y = 0;
+            decodePage(page, mip, x, y);
+            VkExtent3D texels = pageTexels(mip, x, y);
+            VkDeviceSize offset = batchOffset + batch.pages.size() * pageBytes_;
+            loader_(mip, x, y, texels.width, texels.height, staged + offset);
+
+            VkOffset3D origin = {static_cast<std::int32_t>(x * pageExtent_.width),
+                                 static_cast<std::int32_t>(y * pageExtent_.height), 0};
+            VkSparseImageMemoryBind bind{};
+            bind.subresource = {VK_IMAGE_ASPECT_COLOR_BIT, mip, 0};
+            bind.offset = origin;
+            bind.extent = texels;
+            bind.memory = slots_[slot].deviceMemory;
+            bind.memoryOffset = slots_[slot].memoryOffset;
+            imageBinds_.push_back(bind);
+
+            VkBufferImageCopy copy{};
+            copy.bufferOffset = offset;
+            copy.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, mip, 0, 1};
+            copy.imageOffset = origin;
+            copy.imageExtent = texels;
+            copies_.push_back(copy);
+
+            slots_[slot].page = page;
+            pages_[page].slot = slot;
+            pages_[page].state = PageState::Uploading;
+            batch.pages.push_back(page);
+        }
+        requests_.resize(kept);
+        stats_.uploaded = static_cast<std::uint32_t>(batch.pages.size());
+
+        bool firstUpload = !tailStaged_;
+        if (firstUpload) {
+            VkDeviceSize offset = tailStagingOffset_;
+            for (std::uint32_t m = tailMip_; m < mipLevels_; ++m) {
+                std::uint32_t w = mipSize(extent_.width, m);
+                std::uint32_t h = mipSize(extent_.height, m);
+                loader_(m, 0, 0, w, h, staged + offset);
+                VkBufferImageCopy copy{};
+                copy.bufferOffset = offset;
+                copy.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, m, 0, 1};
+                copy.imageExtent = {w, h, 1};
+                copies_.push_back(copy);
+                offset += static_cast<VkDeviceSize>(w) * h * texelBytes_;
+            }
+            batch.pages.push_back(kTailPage);
+            tailStaged_ = true;
+        }
+
+        if (!imageBinds_.empty()) {
+            VkSparseImageMemoryBindInfo imageInfo{};
+            imageInfo.image = image_;
+            imageInfo.bindCount = static_cast<std::uint32_t>(imageBinds_.size());
+            imageInfo.pBinds = imageBinds_.data();
+
+            std::uint64_t signalValue = bindValue_ + 1;
+            VkTimelineSemaphoreSubmitInfo timelineInfo{};
+            timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+            timelineInfo.signalSemaphoreValueCount = 1;
+            timelineInfo.pSignalSemaphoreValues = &signalValue;
+            VkBindSparseInfo bindInfo{};
+            bindInfo.sType = VK_STRUCTURE_TYPE_BIND_SPARSE_INFO;
+            bindInfo.pNext = &timelineInfo;
+            bindInfo.imageBindCount = 1;
+            bindInfo.pImageBinds = &imageInfo;
+            bindInfo.signalSemaphoreCount = 1;
+            bindInfo.pSignalSemaphores = &bindTimeline_;
+
+            VkResult vr = vkQueueBindSparse(bindQueue_, 1, &bindInfo, VK_NULL_HANDLE);
+            if (vr != VK_SUCCESS) {
+                return Error{"update virtual texture", static_cast<std::int32_t>(vr),
+                             "vkQueueBindSparse failed"};
+            }
+            bindValue_ = signalValue;
+            stats_.bindCalls = 1;
+        }
+
+        if (!copies_.empty()) {
+            auto flushed = staging_.flush();
+            if (!flushed.ok())
+                return flushed;
+
+            vkResetCommandBuffer(batch.cmd, 0);
+            VkCommandBufferBeginInfo beginInfo{};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            vkBeginCommandBuffer(batch.cmd, &beginInfo);
+            if (firstUpload) {
+                // Every level, bound or not, moves to GENERAL for good.
+                transitionImage(batch.cmd, image_, VK_IMAGE_LAYOUT_UNDEFINED,
+                                VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_2_NONE,
+                                VK_ACCESS_2_NONE, VK_PIPELINE_STAGE_2_COPY_BIT,
+                                VK_ACCESS_2_TRANSFER_WRITE_BIT);
+            }
+            vkCmdCopyBufferToImage(batch.cmd, staging_.vkBuffer(), image_, VK_IMAGE_LAYOUT_GENERAL,
+                                   static_cast<std::uint32_t>(copies_.size()), copies_.data());
+            vkEndCommandBuffer(batch.cmd);
+
+            auto submitted = transfer.submit(batch.cmd, bindTimeline_, bindValue_);
+            if (!submitted.ok())
+                return std::move(submitted).error();
+            batch.timelineValue = submitted.value();
+            nextBatch_ = (nextBatch_ + 1) % static_cast<std::uint32_t>(batches_.size());
+        }
+    }
+    stats_.pending = static_cast<std::uint32_t>(requests_.size());
+
+    if (pageTableDirty_) {
+        pageTableDirty_ = false;
+        return pageTable_.flush();
+    }
+    return {};
+}
+
+} // namespace vksdl
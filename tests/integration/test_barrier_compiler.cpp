@@ -1,6 +1,7 @@
 #include <vksdl/graph/barrier_compiler.hpp>
 
 #include <cassert>
+#include <cstdint>
 #include <cstdio>
 
 using namespace vksdl::graph;
@@ -315,6 +316,106 @@ int main() {
         std::printf("  write-after-read: ok\n");
     }
 
+    // 9. Coalescing: a mip-by-mip producer's per-level barriers merge into
+    // one range; a gap or a different aspect keeps barriers apart.
+    {
+        BarrierBatch batch;
+        ResourceState src{};
+        src.lastWriteStage = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        src.lastWriteAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        src.currentLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+
+        ResourceState dst{};
+        dst.lastWriteStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+        dst.readAccessSinceWrite = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
+        dst.currentLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        auto append = [&](std::uint32_t mip, std::uint32_t layer, VkImageAspectFlags aspect) {
+            appendImageBarrier(batch, ImageBarrierRequest{
+                                          .image = VK_NULL_HANDLE,
+                                          .range = {mip, 1, layer, 1},
+                                          .aspect = aspect,
+                                          .src = src,
+                                          .dst = dst,
+                                          .isRead = true,
+                                      });
+        };
+        // Out of order on purpose: 3 and 5 only join once 4 has merged.
+        for (std::uint32_t mip : {0u, 1u, 3u, 5u, 2u, 4u, 6u, 7u, 8u, 9u, 10u, 11u})
+            append(mip, 0, VK_IMAGE_ASPECT_COLOR_BIT);
+        append(5, 0, VK_IMAGE_ASPECT_COLOR_BIT); // duplicate
+        assert(batch.imageBarriers.size() == 13);
+
+        std::uint32_t removed = coalesceBarriers(batch);
+        assert(removed == 12);
+        assert(batch.imageBarriers.size() == 1);
+        const auto& r = batch.imageBarriers[0].subresourceRange;
+        assert(r.baseMipLevel == 0 && r.levelCount == 12);
+        assert(r.baseArrayLayer == 0 && r.layerCount == 1);
+        assert(batch.imageBarriers[0].oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+        // Layers of one mip merge too; a gap or another aspect does not.
+        batch.clear();
+        append(0, 0, VK_IMAGE_ASPECT_COLOR_BIT);
+        append(0, 1, VK_IMAGE_ASPECT_COLOR_BIT);
+        append(0, 3, VK_IMAGE_ASPECT_COLOR_BIT);
+        append(0, 0, VK_IMAGE_ASPECT_DEPTH_BIT);
+        assert(coalesceBarriers(batch) == 1);
+        assert(batch.imageBarriers.size() == 3);
+        assert(batch.imageBarriers[0].subresourceRange.layerCount == 2);
+        std::printf("  coalesce image sub-ranges: ok\n");
+    }
+
+    // 10. Coalescing: buffer barriers fold into deduplicated global memory
+    // barriers; ownership transfers stay buffer barriers.
+    {
+        BarrierBatch batch;
+        ResourceState src{};
+        src.lastWriteStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        src.lastWriteAccess = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+
+        ResourceState dst{};
+        dst.lastWriteStage = VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT;
+        dst.readAccessSinceWrite = VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT;
+
+        BufferBarrierRequest req{
+            .buffer = VK_NULL_HANDLE,
+            .offset = 0,
+            .size = VK_WHOLE_SIZE,
+            .src = src,
+            .dst = dst,
+            .isRead = true,
+        };
+        for (int i = 0; i < 30; ++i)
+            appendBufferBarrier(batch, req);
+
+        ResourceState indirect = dst;
+        indirect.lastWriteStage = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT;
+        indirect.readAccessSinceWrite = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT;
+        req.dst = indirect;
+        appendBufferBarrier(batch, req);
+
+        BarrierBatch release;
+        appendBufferOwnershipTransfer(release, batch, req, 1, 0);
+        assert(batch.bufferBarriers.size() == 32);
+
+        assert(coalesceBarriers(batch) == 29); // 31 buffer barriers -> 2 memory barriers
+        assert(batch.memoryBarriers.size() == 2);
+        assert(batch.bufferBarriers.size() == 1);
+        assert(batch.bufferBarriers[0].srcQueueFamilyIndex == 1);
+        const auto& m = batch.memoryBarriers[0];
+        assert(m.sType == VK_STRUCTURE_TYPE_MEMORY_BARRIER_2);
+        assert(m.srcStageMask == VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+        assert(m.srcAccessMask == VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+        assert(m.dstStageMask == VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT);
+        assert(m.dstAccessMask == VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT);
+        assert(batch.memoryBarriers[1].dstStageMask == VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT);
+
+        // Already coalesced: nothing left to remove.
+        assert(coalesceBarriers(batch) == 0);
+        std::printf("  coalesce buffer barriers: ok\n");
+    }
+
     std::printf("barrier compiler test passed\n");
     return 0;
 }
@@ -6,6 +6,9 @@
 
 #include <cassert>
 #include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
 
 int main() {
     auto appResult = vksdl::App::create();
@@ -87,6 +90,29 @@ int main() {
         std::printf("  device with requireFeatures escape hatch: ok\n");
     }
 
+    // Chained 1.1 feature structs: the builder must not add
+    // VkPhysicalDeviceVulkan11Features next to them, and still enables
+    // multiview (on the caller's multiview struct when there is one).
+    {
+        VkPhysicalDeviceShaderDrawParametersFeatures drawParams{};
+        drawParams.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_DRAW_PARAMETERS_FEATURES;
+        auto result = vksdl::DeviceBuilder(instance, surface)
+                          .needSwapchain()
+                          .chainFeatures(&drawParams)
+                          .build();
+        assert(result.ok() && "device with a chained 1.1 feature struct failed");
+
+        VkPhysicalDeviceMultiviewFeatures multiview{};
+        multiview.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES;
+        auto withMultiview = vksdl::DeviceBuilder(instance, surface)
+                                 .needSwapchain()
+                                 .chainFeatures(&multiview)
+                                 .build();
+        assert(withMultiview.ok() && "device with chained multiview features failed");
+        assert((multiview.multiview == VK_TRUE) == withMultiview.value().hasMultiview());
+        std::printf("  device with chained 1.1 feature structs: ok\n");
+    }
+
     // Bogus extension should fail
     {
         auto result = vksdl::DeviceBuilder(instance, surface)
@@ -99,6 +125,50 @@ int main() {
         std::printf("  bogus device extension rejected: ok\n");
     }
 
+    // Capability cache: the first build probes and writes the file, the
+    // second reuses it and selects the same GPU with the same features.
+    {
+        auto path = std::filesystem::temp_directory_path() / "vksdl_test_device_caps.bin";
+        std::filesystem::remove(path);
+
+        auto first = vksdl::DeviceBuilder(instance, surface)
+                         .graphicsDefaults()
+                         .capabilityCache(path)
+                         .build();
+        assert(first.ok());
+        assert(!first.value().capabilitiesCached());
+        assert(std::filesystem::exists(path));
+
+        auto second = vksdl::DeviceBuilder(instance, surface)
+                          .graphicsDefaults()
+                          .capabilityCache(path)
+                          .build();
+        assert(second.ok());
+        assert(second.value().capabilitiesCached());
+        assert(std::string(first.value().gpuName()) == second.value().gpuName());
+        assert(first.value().queueFamilies().graphics == second.value().queueFamilies().graphics);
+        assert(first.value().hasGPL() == second.value().hasGPL());
+        assert(first.value().hasBindless() == second.value().hasBindless());
+        assert(first.value().minUniformBufferOffsetAlignment() ==
+               second.value().minUniformBufferOffsetAlignment());
+        assert(first.value().maxMsaaSamples() == second.value().maxMsaaSamples());
+
+        // A corrupt file is ignored and rewritten.
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out << "not a capability cache";
+        }
+        auto third = vksdl::DeviceBuilder(instance, surface)
+                         .graphicsDefaults()
+                         .capabilityCache(path)
+                         .build();
+        assert(third.ok());
+        assert(!third.value().capabilitiesCached());
+
+        std::filesystem::remove(path);
+        std::printf("  capability cache reuse + refresh: ok\n");
+    }
+
     std::printf("device builder test passed\n");
     return 0;
 }
@@ -4,6 +4,7 @@
 #include <SDL3/SDL.h>
 
 #include <cassert>
+#include <cstdint>
 #include <cstdio>
 #include <filesystem>
 
@@ -143,6 +144,107 @@ int main() {
         std::printf("  dynamic state setters in cmd buffer: ok\n");
     }
 
+    {
+        auto maximal = [&]() {
+            vksdl::PipelineBuilder b(device.value());
+            b.vertexShader(shaderDir / "triangle.vert.spv")
+                .fragmentShader(shaderDir / "triangle.frag.spv")
+                .colorFormat(swapchain.value())
+                .maximalDynamicState();
+            return b;
+        };
+
+        // Variants that differ only in dynamic state share one key.
+        auto base = maximal();
+        auto variant = maximal();
+        variant.cullBack()
+            .clockwise()
+            .depthCompareOp(VK_COMPARE_OP_GREATER)
+            .topology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP);
+        auto baseKey = base.key();
+        auto variantKey = variant.key();
+        assert(baseKey.ok() && variantKey.ok());
+        assert(baseKey.value() == variantKey.value());
+
+        // Topology class and non-dynamic state still separate pipelines.
+        auto lines = maximal();
+        lines.topology(VK_PRIMITIVE_TOPOLOGY_LINE_LIST);
+        assert(lines.key().value() != baseKey.value());
+        auto plain = vksdl::PipelineBuilder(device.value())
+                         .vertexShader(shaderDir / "triangle.vert.spv")
+                         .fragmentShader(shaderDir / "triangle.frag.spv")
+                         .colorFormat(swapchain.value());
+        auto culled = plain;
+        culled.cullBack();
+        assert(plain.key().value() != culled.key().value());
+
+        auto pipeline = variant.build();
+        assert(pipeline.ok() && "maximal dynamic state pipeline failed");
+
+        auto [frame, img] =
+            vksdl::acquireFrame(swapchain.value(), frames.value(), device.value(), window.value())
+                .value();
+
+        vksdl::beginOneTimeCommands(frame.cmd);
+        vksdl::transitionToColorAttachment(frame.cmd, img.image);
+
+        VkRenderingAttachmentInfo colorAttachment{};
+        colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+        colorAttachment.imageView = img.view;
+        colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        colorAttachment.clearValue.color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+
+        VkRenderingInfo renderInfo{};
+        renderInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+        renderInfo.renderArea = {{0, 0}, swapchain.value().extent()};
+        renderInfo.layerCount = 1;
+        renderInfo.colorAttachmentCount = 1;
+        renderInfo.pColorAttachments = &colorAttachment;
+
+        vkCmdBeginRendering(frame.cmd, &renderInfo);
+
+        vksdl::DynamicStateTracker tracker(device.value());
+        tracker.begin(frame.cmd);
+
+        VkViewport viewport{};
+        viewport.width = static_cast<float>(swapchain.value().extent().width);
+        viewport.height = static_cast<float>(swapchain.value().extent().height);
+        viewport.maxDepth = 1.0f;
+        tracker.setViewport(viewport);
+        tracker.setScissor({{0, 0}, swapchain.value().extent()});
+
+        // First apply writes every state; repeating it writes none.
+        tracker.bindPipeline(pipeline.value().vkPipeline());
+        tracker.apply(base.dynamicValues());
+        std::uint32_t firstIssued = tracker.issuedCount();
+        assert(firstIssued > 2 && tracker.skippedCount() == 0);
+        vkCmdDraw(frame.cmd, 3, 1, 0, 0);
+
+        tracker.bindPipeline(pipeline.value().vkPipeline());
+        tracker.setViewport(viewport);
+        tracker.apply(base.dynamicValues());
+        assert(tracker.issuedCount() == firstIssued);
+        vkCmdDraw(frame.cmd, 3, 1, 0, 0);
+
+        // The variant differs in cull mode, front face, compare op and
+        // topology: only those four are written.
+        std::uint32_t before = tracker.issuedCount();
+        tracker.apply(variant.dynamicValues());
+        assert(tracker.issuedCount() == before + 4);
+        vkCmdDraw(frame.cmd, 3, 1, 0, 0);
+
+        vkCmdEndRendering(frame.cmd);
+        vksdl::transitionToPresent(frame.cmd, img.image);
+        vksdl::endCommands(frame.cmd);
+
+        vksdl::presentFrame(device.value(), swapchain.value(), window.value(), frame, img,
+                            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+
+        std::printf("  maximal dynamic state + tracker: ok\n");
+    }
+
     device.value().waitIdle();
     std::printf("dynamic state test passed\n");
     return 0;
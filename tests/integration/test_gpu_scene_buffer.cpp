@@ -0,0 +1,195 @@
+#include <vksdl/vksdl.hpp>
+#include <vulkan/vulkan.h>
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+struct Object {
+    float position[3];
+    std::uint32_t material;
+};
+
+int main() {
+    auto app = vksdl::App::create();
+    assert(app.ok());
+
+    auto window = app.value().createWindow("gpu scene buffer test", 640, 480);
+    assert(window.ok());
+
+    auto instance = vksdl::InstanceBuilder{}
+                        .appName("test_gpu_scene_buffer")
+                        .requireVulkan(1, 3)
+                        .enableWindowSupport()
+                        .build();
+    assert(instance.ok());
+
+    auto surface = vksdl::Surface::create(instance.value(), window.value());
+    assert(surface.ok());
+
+    auto device = vksdl::DeviceBuilder(instance.value(), surface.value())
+                      .needSwapchain()
+                      .needDynamicRendering()
+                      .needSync2()
+                      .preferDiscreteGpu()
+                      .build();
+    assert(device.ok());
+
+    auto allocator = vksdl::Allocator::create(instance.value(), device.value());
+    assert(allocator.ok());
+
+    VkDevice dev = device.value().vkDevice();
+
+    VkCommandPoolCreateInfo poolCI{};
+    poolCI.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolCI.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolCI.queueFamilyIndex = device.value().queueFamilies().graphics;
+    VkCommandPool cmdPool = VK_NULL_HANDLE;
+    VkResult vr = vkCreateCommandPool(dev, &poolCI, nullptr, &cmdPool);
+    assert(vr == VK_SUCCESS);
+
+    VkCommandBufferAllocateInfo cmdAI{};
+    cmdAI.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    cmdAI.commandPool = cmdPool;
+    cmdAI.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    cmdAI.commandBufferCount = 1;
+    VkCommandBuffer cmd = VK_NULL_HANDLE;
+    vr = vkAllocateCommandBuffers(dev, &cmdAI, &cmd);
+    assert(vr == VK_SUCCESS);
+
+    constexpr std::uint32_t kCount = 1000;
+
+    auto readback = vksdl::BufferBuilder(allocator.value())
+                        .usage(VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+                        .mapped()
+                        .size(sizeof(Object) * kCount)
+                        .build();
+    assert(readback.ok());
+
+    // Records `record`, copies the scene buffer to `readback`, waits.
+    auto submit = [&](auto&& record, VkBuffer scene) {
+        vkResetCommandBuffer(cmd, 0);
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(cmd, &beginInfo);
+        record();
+        VkBufferCopy all{0, 0, sizeof(Object) * kCount};
+        vkCmdCopyBuffer(cmd, scene, readback.value().vkBuffer(), 1, &all);
+        vkEndCommandBuffer(cmd);
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &cmd;
+        VkResult r = vkQueueSubmit(device.value().graphicsQueue(), 1, &submitInfo,
+                                   VK_NULL_HANDLE);
+        assert(r == VK_SUCCESS);
+        (void) r;
+        vkQueueWaitIdle(device.value().graphicsQueue());
+    };
+    auto gpu = [&](std::uint32_t i) {
+        Object o;
+        std::memcpy(&o, static_cast<const Object*>(readback.value().mappedData()) + i, sizeof(o));
+        return o;
+    };
+
+    // Create: every element starts dirty, the first upload copies it all.
+    {
+        auto scene = vksdl::GpuSceneBuffer<Object>::create(allocator.value(), kCount);
+        assert(scene.ok());
+        auto& s = scene.value();
+        assert(s.count() == kCount);
+        assert(s.sizeBytes() == sizeof(Object) * kCount);
+        assert(s.deviceAddress() != 0);
+        assert(s.dirtyCount() == kCount);
+
+        for (std::uint32_t i = 0; i < kCount; ++i)
+            s.set(i, Object{{float(i), 0.0f, 0.0f}, i});
+
+        vksdl::SceneUploadStats stats;
+        submit([&] { stats = s.upload(cmd, 0).value(); }, s.vkBuffer());
+        assert(stats.dirtyElements == kCount);
+        assert(stats.copiedElements == kCount);
+        assert(stats.regions == 1);
+        assert(stats.deferredElements == 0);
+        assert(s.dirtyCount() == 0);
+        assert(gpu(999).material == 999);
+        std::printf("  initial upload: ok\n");
+
+        // Sparse edits: only the dirty runs are copied, one region each.
+        s.edit(10).material = 7;
+        s.set(11, Object{{1.0f, 2.0f, 3.0f}, 8});
+        s.edit(500, 3)[2].material = 9;
+        s.edit(998).position[1] = 4.0f;
+        assert(s.dirtyCount() == 6);
+
+        submit([&] { stats = s.upload(cmd, 1).value(); }, s.vkBuffer());
+        assert(stats.dirtyElements == 6);
+        assert(stats.copiedElements == 6);
+        assert(stats.regions == 3);
+        assert(stats.bytes == 6 * sizeof(Object));
+        assert(gpu(10).material == 7);
+        assert(gpu(11).material == 8);
+        assert(gpu(502).material == 9);
+        assert(gpu(998).position[1] == 4.0f);
+        assert(gpu(12).material == 12);
+        std::printf("  dirty-run coalescing: ok\n");
+
+        // Nothing dirty: nothing recorded.
+        submit([&] { stats = s.upload(cmd, 0).value(); }, s.vkBuffer());
+        assert(stats.regions == 0 && stats.bytes == 0);
+        std::printf("  clean upload is a no-op: ok\n");
+
+        // Merge gap: runs separated by <= gap clean elements share a region.
+        s.setMergeGap(4);
+        s.markDirty(100);
+        s.markDirty(103);
+        s.markDirty(200);
+        submit([&] { stats = s.upload(cmd, 1).value(); }, s.vkBuffer());
+        assert(stats.regions == 2);
+        assert(stats.copiedElements == 5);
+        std::printf("  merge gap: ok\n");
+    }
+
+    // Small staging slice: overflow stays dirty for the next upload.
+    {
+        auto scene = vksdl::GpuSceneBuffer<Object>::create(allocator.value(), kCount, 2,
+                                                           sizeof(Object) * 600);
+        assert(scene.ok());
+        auto& s = scene.value();
+        assert(s.stagingBytesPerFrame() == sizeof(Object) * 600);
+        for (std::uint32_t i = 0; i < kCount; ++i)
+            s.set(i, Object{{0.0f, 0.0f, 0.0f}, i + 1});
+
+        vksdl::SceneUploadStats stats;
+        submit([&] { stats = s.upload(cmd, 0).value(); }, s.vkBuffer());
+        assert(stats.copiedElements == 600);
+        assert(stats.deferredElements == 400);
+        assert(s.isDirty(600) && !s.isDirty(599));
+
+        submit([&] { stats = s.upload(cmd, 1).value(); }, s.vkBuffer());
+        assert(stats.copiedElements == 400);
+        assert(stats.deferredElements == 0);
+        assert(gpu(0).material == 1);
+        assert(gpu(999).material == 1000);
+        std::printf("  staging overflow defers: ok\n");
+    }
+
+    // Invalid arguments.
+    {
+        auto empty = vksdl::GpuSceneBuffer<Object>::create(allocator.value(), 0);
+        assert(!empty.ok());
+        auto noFrames = vksdl::GpuSceneBuffer<Object>::create(allocator.value(), 16, 0);
+        assert(!noFrames.ok());
+        auto tiny = vksdl::GpuSceneBuffer<Object>::create(allocator.value(), 16, 2, 1);
+        assert(!tiny.ok());
+        std::printf("  invalid arguments rejected: ok\n");
+    }
+
+    vkDestroyCommandPool(dev, cmdPool, nullptr);
+    device.value().waitIdle();
+    std::printf("gpu scene buffer test passed\n");
+    return 0;
+}
@@ -0,0 +1,209 @@
+#include <vksdl/vksdl.hpp>
+#include <vulkan/vulkan.h>
+
+#include <SDL3/SDL.h>
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+int main() {
+    auto app = vksdl::App::create();
+    assert(app.ok());
+
+    auto window = app.value().createWindow("material table test", 640, 480);
+    assert(window.ok());
+
+    auto instance = vksdl::InstanceBuilder{}
+                        .appName("test_material_table")
+                        .requireVulkan(1, 3)
+                        .validation(vksdl::Validation::Off)
+                        .enableWindowSupport()
+                        .build();
+    assert(instance.ok());
+
+    auto surface = vksdl::Surface::create(instance.value(), window.value());
+    assert(surface.ok());
+
+    auto device = vksdl::DeviceBuilder(instance.value(), surface.value())
+                      .needSwapchain()
+                      .needDynamicRendering()
+                      .needSync2()
+                      .preferDiscreteGpu()
+                      .build();
+    assert(device.ok());
+
+    auto allocator = vksdl::Allocator::create(instance.value(), device.value());
+    assert(allocator.ok());
+
+    if (!device.value().hasBindless()) {
+        std::printf("all material_table tests skipped (no bindless support)\n");
+        return 0;
+    }
+
+    auto textures = vksdl::BindlessTable::create(device.value(), 8);
+    assert(textures.ok());
+    auto sampler = vksdl::SamplerBuilder(device.value()).linear().repeat().build();
+    assert(sampler.ok());
+    VkSampler vkSampler = sampler.value().vkSampler();
+
+    // Only combined image sampler tables can hold material textures.
+    {
+        auto buffers =
+            vksdl::BindlessTable::create(device.value(), 8, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+        assert(buffers.ok());
+        auto bad = vksdl::MaterialTable::create(allocator.value(), device.value(), buffers.value(),
+                                                vkSampler, 16);
+        assert(!bad.ok());
+        std::printf("  rejects non-sampler table: ok\n");
+    }
+
+    auto tableResult = vksdl::MaterialTable::create(allocator.value(), device.value(),
+                                                    textures.value(), vkSampler, 4, 2);
+    assert(tableResult.ok());
+    auto& materials = tableResult.value();
+    assert(materials.count() == 0);
+    assert(materials.capacity() == 4);
+    assert(materials.deviceAddress() != 0);
+
+    // Parameters are packed into GpuMaterial records.
+    {
+        vksdl::Material red;
+        red.name = "red";
+        red.baseColor[0] = 1.0f;
+        red.baseColor[1] = 0.0f;
+        red.baseColor[2] = 0.0f;
+        red.metallic = 0.5f;
+        red.roughness = 0.25f;
+        auto id = materials.add(red);
+        assert(id.ok());
+        assert(id.value() == 0);
+        assert(materials[0].baseColor[1] == 0.0f);
+        assert(materials[0].metallic == 0.5f);
+        assert(materials[0].roughness == 0.25f);
+        assert(materials[0].diffuseTexture == vksdl::kNoMaterialTexture);
+
+        materials.edit(0).flags = 7;
+        red.metallic = 1.0f;
+        assert(materials.set(0, red).ok());
+        assert(materials[0].metallic == 1.0f);
+        assert(materials[0].flags == 7);
+
+        auto unknown = materials.set(1, red);
+        assert(!unknown.ok());
+        assert(unknown.error().is(vksdl::ErrorCode::InvalidArgument));
+        std::printf("  pack parameters: ok\n");
+    }
+
+    // Caller-owned views take the next slot after firstTextureSlot.
+    auto img = vksdl::ImageBuilder(allocator.value())
+                   .size(16, 16)
+                   .format(VK_FORMAT_R8G8B8A8_UNORM)
+                   .sampled()
+                   .build();
+    assert(img.ok());
+    {
+        auto slot = materials.addTexture(img.value().vkImageView(),
+                                         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        assert(slot.ok());
+        assert(slot.value() == 2);
+        assert(materials.textureCount() == 1);
+        std::printf("  addTexture: ok\n");
+    }
+
+#if VKSDL_HAS_LOADERS
+    // Materials naming the same file share one texture slot.
+    {
+        std::filesystem::path assets = std::filesystem::path(SDL_GetBasePath()) / "assets";
+        vksdl::Material a;
+        a.diffuseTexture = assets / "test_2x2.png";
+        vksdl::Material b;
+        b.diffuseTexture = assets / "." / "test_2x2.png";
+
+        auto idA = materials.add(a);
+        assert(idA.ok());
+        auto idB = materials.add(b);
+        assert(idB.ok());
+        assert(materials[idA.value()].diffuseTexture == 3);
+        assert(materials[idB.value()].diffuseTexture == 3);
+        assert(materials.textureCount() == 2);
+
+        vksdl::Material missing;
+        missing.diffuseTexture = assets / "does_not_exist.png";
+        assert(!materials.add(missing).ok());
+        assert(materials.count() == 3);
+        std::printf("  texture load + dedupe: ok\n");
+    }
+#endif
+
+    // Fill to capacity; one more add fails.
+    while (materials.count() < materials.capacity()) {
+        auto id = materials.add(vksdl::Material{});
+        assert(id.ok());
+        (void) id;
+    }
+    assert(!materials.add(vksdl::Material{}).ok());
+    std::printf("  capacity limit: ok\n");
+
+    // upload() copies the records the shader will index.
+    {
+        VkDevice dev = device.value().vkDevice();
+        VkCommandPoolCreateInfo poolCI{};
+        poolCI.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolCI.queueFamilyIndex = device.value().queueFamilies().graphics;
+        VkCommandPool cmdPool = VK_NULL_HANDLE;
+        VkResult vr = vkCreateCommandPool(dev, &poolCI, nullptr, &cmdPool);
+        assert(vr == VK_SUCCESS);
+
+        VkCommandBufferAllocateInfo cmdAI{};
+        cmdAI.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        cmdAI.commandPool = cmdPool;
+        cmdAI.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        cmdAI.commandBufferCount = 1;
+        VkCommandBuffer cmd = VK_NULL_HANDLE;
+        vr = vkAllocateCommandBuffers(dev, &cmdAI, &cmd);
+        assert(vr == VK_SUCCESS);
+
+        VkDeviceSize bytes = sizeof(vksdl::GpuMaterial) * materials.capacity();
+        auto readback = vksdl::BufferBuilder(allocator.value()).readback().size(bytes).build();
+        assert(readback.ok());
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(cmd, &beginInfo);
+        auto stats = materials.upload(cmd, 0, VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                                      VK_ACCESS_2_TRANSFER_READ_BIT);
+        assert(stats.ok());
+        assert(stats.value().dirtyElements == materials.capacity());
+        VkBufferCopy all{0, 0, bytes};
+        vkCmdCopyBuffer(cmd, materials.vkBuffer(), readback.value().vkBuffer(), 1, &all);
+        vkEndCommandBuffer(cmd);
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &cmd;
+        vr = vkQueueSubmit(device.value().graphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
+        assert(vr == VK_SUCCESS);
+        vkQueueWaitIdle(device.value().graphicsQueue());
+        assert(readback.value().invalidate().ok());
+
+        vksdl::GpuMaterial gpu;
+        std::memcpy(&gpu, readback.value().mappedData(), sizeof(gpu));
+        assert(gpu.metallic == 1.0f);
+        assert(gpu.roughness == 0.25f);
+        assert(gpu.flags == 7);
+        std::printf("  upload: ok\n");
+
+        vkDestroyCommandPool(dev, cmdPool, nullptr);
+        (void) vr;
+        (void) stats;
+    }
+
+    device.value().waitIdle();
+    std::printf("material table test passed\n");
+    return 0;
+}
@@ -89,6 +89,44 @@ int main() {
         assert(pct >= 0.0f);
     }
 
+    // Direct (ReBAR) uploads: the policy gates them, and the upload helpers
+    // produce the same contents on either path.
+    {
+        auto& alloc = allocator.value();
+        std::printf("  large BAR: %s (%llu MiB)\n", alloc.hasLargeBar() ? "yes" : "no",
+                    static_cast<unsigned long long>(alloc.largeBarHeapSize() >> 20));
+        assert(alloc.hasLargeBar() == (alloc.largeBarHeapSize() > (256ull << 20)));
+
+        vksdl::DirectUploadPolicy policy = alloc.directUploadPolicy();
+        assert(policy.enabled);
+        assert(!alloc.preferDirectUpload(policy.maxBytes + 1));
+        if (!alloc.hasLargeBar())
+            assert(!alloc.preferDirectUpload(4096));
+
+        policy.enabled = false;
+        alloc.setDirectUploadPolicy(policy);
+        assert(!alloc.preferDirectUpload(4096));
+        policy.enabled = true;
+        alloc.setDirectUploadPolicy(policy);
+
+        std::vector<std::uint32_t> values(4096);
+        for (std::size_t i = 0; i < values.size(); ++i)
+            values[i] = static_cast<std::uint32_t>(i * 7);
+        auto buf = vksdl::uploadStorageBuffer(alloc, device.value(), values.data(),
+                                              values.size() * sizeof(std::uint32_t));
+        assert(buf.ok());
+        if (buf.value().mappedData() != nullptr) {
+            const auto* mapped = static_cast<const std::uint32_t*>(buf.value().mappedData());
+            assert(mapped[4095] == 4095u * 7);
+        }
+
+        auto direct = vksdl::BufferBuilder(alloc).storageBuffer().directUpload().size(4096).build();
+        assert(direct.ok());
+        std::printf("  directUpload() buffer mapped: %s\n",
+                    direct.value().mappedData() != nullptr ? "yes" : "no");
+        std::printf("  direct upload policy: ok\n");
+    }
+
     device.value().waitIdle();
     std::printf("memory budget test passed\n");
     return 0;
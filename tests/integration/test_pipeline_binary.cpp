@@ -1,7 +1,13 @@
 #include <vksdl/vksdl.hpp>
 
+#include <SDL3/SDL.h>
+
 #include <cassert>
 #include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
 
 int main() {
     auto app = vksdl::App::create();
@@ -36,6 +42,115 @@ int main() {
     // Accessor must be idempotent.
     assert(device.value().hasPipelineBinary() == hasBinary);
 
+    std::filesystem::path shaderDir = std::filesystem::path(SDL_GetBasePath()) / "shaders";
+    std::filesystem::path storePath =
+        std::filesystem::temp_directory_path() / "vksdl_test_pipeline_binaries.bin";
+    std::filesystem::remove(storePath);
+    std::filesystem::remove(std::filesystem::path(storePath) += ".idx");
+
+    auto makeBuilder = [&](vksdl::PipelineBinaryStore& store) {
+        return vksdl::PipelineBuilder(device.value())
+            .vertexShader(shaderDir / "triangle.vert.spv")
+            .fragmentShader(shaderDir / "triangle.frag.spv")
+            .colorFormat(VK_FORMAT_B8G8R8A8_UNORM)
+            .binaryStore(store);
+    };
+
+    {
+        // Cold run: miss, compile with capture, append to the store.
+        auto store = vksdl::PipelineBinaryStore::open(device.value(), storePath);
+        assert(store.ok());
+        assert(store.value().supported() == hasBinary);
+        assert(store.value().entryCount() == 0);
+
+        auto pipeline = makeBuilder(store.value()).build();
+        assert(pipeline.ok());
+        if (hasBinary) {
+            assert(store.value().misses() == 1);
+            assert(store.value().captures() == 1);
+            assert(store.value().entryCount() == 1);
+        }
+
+        // Same create info again in-process: served from the store.
+        auto again = makeBuilder(store.value()).build();
+        assert(again.ok());
+        if (hasBinary)
+            assert(store.value().hits() == 1);
+        std::printf("  binary store capture: ok (captures=%llu)\n",
+                    static_cast<unsigned long long>(store.value().captures()));
+    }
+
+    {
+        // Warm run: the index is reloaded from disk and the pipeline is
+        // created from the stored binaries without a capture.
+        auto store = vksdl::PipelineBinaryStore::open(device.value(), storePath);
+        assert(store.ok());
+        if (hasBinary)
+            assert(store.value().entryCount() == 1);
+
+        auto pipeline = makeBuilder(store.value()).build();
+        assert(pipeline.ok());
+        if (hasBinary) {
+            assert(store.value().hits() == 1);
+            assert(store.value().captures() == 0);
+        }
+        std::printf("  binary store reload: ok (hits=%llu)\n",
+                    static_cast<unsigned long long>(store.value().hits()));
+    }
+
+    {
+        // Lost index: records are recovered by scanning the data file.
+        std::filesystem::remove(std::filesystem::path(storePath) += ".idx");
+        auto store = vksdl::PipelineBinaryStore::open(device.value(), storePath);
+        assert(store.ok());
+        if (hasBinary)
+            assert(store.value().entryCount() == 1);
+        std::printf("  binary store index recovery: ok\n");
+    }
+
+    {
+        // Lost middle index entry: a record the index skips is found even
+        // though records after it are indexed.
+        {
+            auto store = vksdl::PipelineBinaryStore::open(device.value(), storePath);
+            assert(store.ok());
+            assert(makeBuilder(store.value()).cullBack().build().ok());
+            assert(makeBuilder(store.value()).clockwise().build().ok());
+            if (hasBinary)
+                assert(store.value().entryCount() == 3);
+        }
+
+        // Header and entries are 48 bytes each; drop the second entry.
+        constexpr std::size_t kEntry = 48;
+        auto indexPath = std::filesystem::path(storePath) += ".idx";
+        std::vector<char> index;
+        {
+            std::ifstream in(indexPath, std::ios::binary);
+            index.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        if (hasBinary) {
+            assert(index.size() == 4 * kEntry);
+            index.erase(index.begin() + 2 * kEntry, index.begin() + 3 * kEntry);
+            std::ofstream out(indexPath, std::ios::binary | std::ios::trunc);
+            out.write(index.data(), static_cast<std::streamsize>(index.size()));
+        }
+
+        auto store = vksdl::PipelineBinaryStore::open(device.value(), storePath);
+        assert(store.ok());
+        if (hasBinary) {
+            assert(store.value().entryCount() == 3);
+            // The index was rewritten with the recovered record.
+            assert(std::filesystem::file_size(indexPath) == 4 * kEntry);
+            auto pipeline = makeBuilder(store.value()).cullBack().build();
+            assert(pipeline.ok());
+            assert(store.value().hits() == 1);
+        }
+        std::printf("  binary store middle index entry recovery: ok\n");
+    }
+
+    std::filesystem::remove(storePath);
+    std::filesystem::remove(std::filesystem::path(storePath) += ".idx");
+
     device.value().waitIdle();
     std::printf("pipeline binary detection test passed\n");
     return 0;
@@ -4,8 +4,11 @@
 #include <SDL3/SDL.h>
 
 #include <cassert>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <filesystem>
+#include <vector>
 
 int main() {
     auto app = vksdl::App::create();
@@ -172,6 +175,86 @@ int main() {
         std::printf("  move semantics: ok\n");
     }
 
+    {
+        // A blob from another device/driver is discarded before the driver sees it.
+        std::vector<std::uint8_t> foreign(64, 0);
+        VkPipelineCacheHeaderVersionOne header{};
+        header.headerSize = sizeof(header);
+        header.headerVersion = VK_PIPELINE_CACHE_HEADER_VERSION_ONE;
+        header.vendorID = 0xFFFFu;
+        std::memcpy(foreign.data(), &header, sizeof(header));
+        assert(!vksdl::PipelineCache::isCompatible(device.value(), foreign.data(),
+                                                   foreign.size()));
+        assert(!vksdl::PipelineCache::isCompatible(device.value(), foreign.data(), 8));
+
+        auto cache = vksdl::PipelineCache::fromData(device.value(), foreign.data(),
+                                                    foreign.size());
+        assert(cache.ok());
+        std::printf("  header validation: ok\n");
+    }
+
+    {
+        std::filesystem::path root =
+            std::filesystem::path(SDL_GetBasePath()) / "test_pipeline_cache_store";
+        std::filesystem::remove_all(root);
+
+        auto store = vksdl::PipelineCacheStore::open(device.value(), root);
+        assert(store.ok());
+        assert(!store.value().warm());
+        assert(store.value().path().filename() == "pipeline.cache");
+
+        // Two leased worker caches, each compiled into independently, merged
+        // on save once released.
+        auto t0 = store.value().acquireThreadCache();
+        auto t1 = store.value().acquireThreadCache();
+        assert(t0.ok() && t1.ok());
+        assert(t0.value() != t1.value());
+        assert(store.value().threadCacheCount() == 2);
+
+        auto p0 = vksdl::PipelineBuilder(device.value())
+                      .vertexShader(shaderDir / "triangle.vert.spv")
+                      .fragmentShader(shaderDir / "triangle.frag.spv")
+                      .colorFormat(swapchain.value())
+                      .cache(t0.value())
+                      .build();
+        auto p1 = vksdl::PipelineBuilder(device.value())
+                      .vertexShader(shaderDir / "triangle.vert.spv")
+                      .fragmentShader(shaderDir / "triangle.frag.spv")
+                      .colorFormat(swapchain.value())
+                      .cullBack()
+                      .cache(t1.value())
+                      .build();
+        assert(p0.ok() && p1.ok());
+        store.value().releaseThreadCache(t0.value());
+        store.value().releaseThreadCache(t1.value());
+
+        // A released cache is reused rather than a new one created.
+        auto t2 = store.value().acquireThreadCache();
+        assert(t2.ok());
+        assert(store.value().threadCacheCount() == 2);
+        store.value().releaseThreadCache(t2.value());
+
+        auto saved = store.value().save();
+        assert(saved.ok());
+        assert(std::filesystem::exists(store.value().path()));
+        assert(!std::filesystem::exists(std::filesystem::path(store.value().path()) += ".tmp"));
+
+        // A stale driver directory next to ours is pruned.
+        std::filesystem::path deviceDir = store.value().path().parent_path().parent_path();
+        std::filesystem::create_directories(deviceDir / "00000000-stale");
+        assert(store.value().removeStaleDrivers() == 1);
+        assert(std::filesystem::exists(store.value().path()));
+
+        auto reopened = vksdl::PipelineCacheStore::open(device.value(), root);
+        assert(reopened.ok());
+        assert(reopened.value().warm());
+        assert(reopened.value().cache().dataSize() > 0);
+        std::printf("  cache store round-trip: ok (%s)\n",
+                    reopened.value().path().parent_path().filename().string().c_str());
+
+        std::filesystem::remove_all(root);
+    }
+
     device.value().waitIdle();
     std::printf("pipeline cache test passed\n");
     return 0;
@@ -3,9 +3,16 @@
 
 #include <SDL3/SDL.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <cstdio>
 #include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
 
 int main() {
     auto app = vksdl::App::create();
@@ -187,6 +194,118 @@ int main() {
 
         compiler.value().waitIdle();
         std::printf("  GPL different builder: ok\n");
+
+        // Contention: 8 threads compile the same 8 variants in rotated order
+        // on a cold compiler. Every compile resolves to a ready pipeline, and
+        // the compiler never leases more caches than its pool holds.
+        auto cold = vksdl::PipelineCompiler::create(device.value(), cache,
+                                                    vksdl::PipelinePolicy::PreferGPL);
+        assert(cold.ok());
+
+        constexpr int kThreads = 8;
+        constexpr std::array<VkCullModeFlags, 4> kCull = {
+            VK_CULL_MODE_NONE, VK_CULL_MODE_BACK_BIT, VK_CULL_MODE_FRONT_BIT,
+            VK_CULL_MODE_FRONT_AND_BACK};
+        constexpr std::array<VkFrontFace, 2> kFace = {VK_FRONT_FACE_COUNTER_CLOCKWISE,
+                                                      VK_FRONT_FACE_CLOCKWISE};
+        constexpr int kVariants = static_cast<int>(kCull.size() * kFace.size());
+
+        std::vector<std::vector<vksdl::PipelineHandle>> perThread(kThreads);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < kVariants; ++i) {
+                    int v = (i + t) % kVariants;
+                    auto b = vksdl::PipelineBuilder(device.value())
+                                 .vertexShader(shaderDir / "triangle.vert.spv")
+                                 .fragmentShader(shaderDir / "triangle.frag.spv")
+                                 .colorFormat(swapchain.value())
+                                 .cullMode(kCull[static_cast<std::size_t>(v) % kCull.size()])
+                                 .frontFace(kFace[static_cast<std::size_t>(v) / kCull.size()]);
+                    auto h = cold.value().compile(b);
+                    assert(h.ok());
+                    assert(h.value().isReady());
+                    perThread[static_cast<std::size_t>(t)].push_back(std::move(h).value());
+                }
+            });
+        }
+        for (auto& th : threads)
+            th.join();
+        cold.value().waitIdle();
+
+        for (auto& handles : perThread)
+            assert(handles.size() == static_cast<std::size_t>(kVariants));
+        // Workers plus callers never need more than one cache per hardware
+        // thread, however many threads compile at once.
+        std::uint32_t hw = std::max(2u, std::thread::hardware_concurrency());
+        assert(cold.value().stats().threadCaches <= hw);
+        std::printf("  GPL contention (%d threads x %d variants): ok\n", kThreads, kVariants);
+
+        // Baseline retirement + library LRU: retire 2 frames after the
+        // optimized bind, keep at most 4 parts cached. A fresh pipeline cache
+        // keeps the PCCC probe from short-circuiting the GPL path.
+        auto freshCache = vksdl::PipelineCache::create(device.value());
+        assert(freshCache.ok());
+        auto retiring = vksdl::PipelineCompiler::create(device.value(), freshCache.value(),
+                                                        vksdl::PipelinePolicy::PreferGPL);
+        assert(retiring.ok());
+        retiring.value().setBaselineRetirement(2);
+        retiring.value().setLibraryCacheLimit(4);
+
+        auto hr = retiring.value().compile(builder2);
+        assert(hr.ok());
+        retiring.value().waitIdle();
+        assert(hr.value().isOptimized());
+
+        // A driver-side cache hit still returns a monolithic handle with
+        // nothing to retire.
+        auto before = retiring.value().stats();
+        bool fastLinked = before.pendingRetirement == 1;
+        assert(before.liveHandles == 1);
+        assert(before.livePipelines == (fastLinked ? 2u : 1u));
+
+        auto pool = vksdl::CommandPool::create(device.value(),
+                                               device.value().queueFamilies().graphics);
+        assert(pool.ok());
+        auto cmd = pool.value().allocate();
+        assert(cmd.ok());
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        vkBeginCommandBuffer(cmd.value(), &beginInfo);
+        hr.value().bind(cmd.value());
+        vkEndCommandBuffer(cmd.value());
+
+        // Frame 1 observes the optimized bind, frame 3 retires the baseline.
+        for (int f = 0; f < 3; ++f)
+            retiring.value().advanceFrame();
+
+        auto after = retiring.value().stats();
+        assert(after.retiredBaselines == (fastLinked ? 1u : 0u));
+        assert(after.livePipelines == 1);
+        assert(after.pendingRetirement == 0);
+        assert(hr.value().isReady());
+        assert(hr.value().vkPipeline() != VK_NULL_HANDLE);
+
+        // A second variant pushes the cache past the cap; the first variant's
+        // unshared parts are least recently used and get evicted.
+        auto hr2 = retiring.value().compile(builder);
+        assert(hr2.ok());
+        retiring.value().waitIdle();
+        retiring.value().advanceFrame();
+        auto trimmed = retiring.value().stats();
+        assert(trimmed.liveLibraries <= 4);
+
+        {
+            auto drop1 = std::move(hr).value();
+            auto drop2 = std::move(hr2).value();
+        }
+        auto empty = retiring.value().stats();
+        assert(empty.liveHandles == 0);
+        assert(empty.livePipelines == 0);
+        std::printf("  GPL baseline retirement + library eviction: ok (retired=%llu "
+                    "evicted=%llu)\n",
+                    static_cast<unsigned long long>(after.retiredBaselines),
+                    static_cast<unsigned long long>(trimmed.evictedLibraries));
     } else {
         std::printf("  GPL tests: skipped (not available)\n");
     }
@@ -219,6 +338,160 @@ int main() {
         std::printf("  multiple concurrent compiles: ok\n");
     }
 
+    {
+        // Pooled caches: four threads compile distinct variants into leased
+        // caches; everything lands in the main cache after a merge.
+        auto mainCache = vksdl::PipelineCache::create(device.value());
+        assert(mainCache.ok());
+        auto compiler = vksdl::PipelineCompiler::create(device.value(), mainCache.value(),
+                                                        vksdl::PipelinePolicy::ForceMonolithic);
+        assert(compiler.ok());
+        compiler.value().setCacheMergeInterval(2);
+
+        constexpr std::array<VkCullModeFlags, 4> kCull = {
+            VK_CULL_MODE_NONE, VK_CULL_MODE_BACK_BIT, VK_CULL_MODE_FRONT_BIT,
+            VK_CULL_MODE_FRONT_AND_BACK};
+        std::vector<std::vector<vksdl::PipelineHandle>> handles(kCull.size());
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < kCull.size(); ++t) {
+            threads.emplace_back([&, t] {
+                auto b = vksdl::PipelineBuilder(device.value())
+                             .vertexShader(shaderDir / "triangle.vert.spv")
+                             .fragmentShader(shaderDir / "triangle.frag.spv")
+                             .colorFormat(swapchain.value())
+                             .cullMode(kCull[t])
+                             .cache(mainCache.value());
+                auto h = compiler.value().compile(b);
+                assert(h.ok());
+                handles[t].push_back(std::move(h).value());
+            });
+        }
+        for (auto& th : threads)
+            th.join();
+        compiler.value().waitIdle();
+
+        auto merged = compiler.value().mergeCaches();
+        assert(merged.ok());
+
+        // Driver-internal caches can satisfy the probe, so a thread may never
+        // have needed a cache of its own.
+        auto s = compiler.value().stats();
+        assert(s.threadCaches <= kCull.size());
+        if (s.threadCaches > 0)
+            assert(s.cacheMerges >= 1);
+        for (auto& perThread : handles)
+            assert(perThread.size() == 1 && perThread[0].vkPipeline() != VK_NULL_HANDLE);
+        std::printf("  pooled caches: ok (caches=%u merges=%llu main=%zu bytes)\n",
+                    s.threadCaches, static_cast<unsigned long long>(s.cacheMerges),
+                    mainCache.value().dataSize());
+    }
+
+    {
+        // PipelineCachePool directly: leases stay within the capacity under
+        // contention, and released dirty caches are merged once.
+        auto mainCache = vksdl::PipelineCache::create(device.value());
+        assert(mainCache.ok());
+        constexpr std::uint32_t kCapacity = 2;
+        auto pool = vksdl::PipelineCachePool::create(
+            device.value(), mainCache.value().vkPipelineCache(), kCapacity);
+        assert(pool.ok());
+
+        std::atomic<std::uint32_t> live{0};
+        std::atomic<std::uint32_t> peak{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < 16; ++i) {
+                    auto leased = pool.value().acquire();
+                    assert(leased.ok());
+                    std::uint32_t now = live.fetch_add(1) + 1;
+                    assert(now <= kCapacity);
+                    std::uint32_t prev = peak.load();
+                    while (now > prev && !peak.compare_exchange_weak(prev, now)) {
+                    }
+                    live.fetch_sub(1);
+                    pool.value().release(leased.value(), true);
+                }
+            });
+        }
+        for (auto& th : threads)
+            th.join();
+        assert(peak.load() >= 1 && peak.load() <= kCapacity);
+        assert(pool.value().size() >= 1 && pool.value().size() <= kCapacity);
+
+        assert(pool.value().merges() == 0);
+        auto merged = pool.value().merge();
+        assert(merged.ok());
+        assert(pool.value().merges() == 1);
+
+        // Nothing dirty since: no merge. A clean release stays out too.
+        auto again = pool.value().merge();
+        assert(again.ok());
+        auto clean = pool.value().acquire();
+        assert(clean.ok());
+        pool.value().release(clean.value(), false);
+        auto still = pool.value().merge();
+        assert(still.ok());
+        assert(pool.value().merges() == 1);
+
+        // A dirty cache still leased waits for the merge after its release.
+        auto held = pool.value().acquire();
+        assert(held.ok());
+        auto early = pool.value().merge();
+        assert(early.ok());
+        assert(pool.value().merges() == 1);
+        pool.value().release(held.value(), true);
+        auto late = pool.value().merge();
+        assert(late.ok());
+        assert(pool.value().merges() == 2);
+        std::printf("  cache pool bound and merges: ok (caches=%u peak=%u)\n",
+                    pool.value().size(), peak.load());
+    }
+
+    {
+        // Creation telemetry: one miss-then-build and one probe hit (or a
+        // second build where the probe is unavailable), plus a failure.
+        auto compiler = vksdl::PipelineCompiler::create(device.value(), cache,
+                                                        vksdl::PipelinePolicy::ForceMonolithic);
+        assert(compiler.ok());
+
+        auto builder = vksdl::PipelineBuilder(device.value())
+                           .vertexShader(shaderDir / "triangle.vert.spv")
+                           .fragmentShader(shaderDir / "triangle.frag.spv")
+                           .colorFormat(swapchain.value())
+                           .cullMode(VK_CULL_MODE_FRONT_BIT);
+        auto first = compiler.value().compile(builder);
+        assert(first.ok());
+        assert(compiler.value().mergeCaches().ok());
+        auto second = compiler.value().compile(builder);
+        assert(second.ok());
+        auto missing = compiler.value().compile(
+            vksdl::PipelineBuilder(device.value())
+                .vertexShader(shaderDir / "does_not_exist.vert.spv")
+                .fragmentShader(shaderDir / "triangle.frag.spv")
+                .colorFormat(swapchain.value()));
+        assert(!missing.ok());
+
+        auto s = compiler.value().stats();
+        const auto& t = s.telemetry;
+        assert(t.requests == 3);
+        assert(t.failures == 1);
+        assert(t.requestToUsable.count == 2);
+        assert(t.monolithicBuilds + t.probeHits == 2);
+        assert(t.monolithicBuild.count == t.monolithicBuilds);
+        assert(t.probe.count == t.probeHits + t.probeMisses);
+        assert(t.fastLinks == 0 && t.optimizedLinks == 0);
+        assert(t.requestToUsable.maxMs >= t.requestToUsable.percentileMs(50.0));
+
+        std::string json = s.toJson();
+        assert(json.find("\"telemetry\"") != std::string::npos);
+        assert(json.find("\"requestToUsable\"") != std::string::npos);
+        std::printf("  creation telemetry: ok (builds=%llu probeHits=%llu p50=%.3f ms)\n",
+                    static_cast<unsigned long long>(t.monolithicBuilds),
+                    static_cast<unsigned long long>(t.probeHits),
+                    t.requestToUsable.percentileMs(50.0));
+    }
+
     device.value().waitIdle();
     std::printf("test_pipeline_compiler: all tests passed\n");
     return 0;
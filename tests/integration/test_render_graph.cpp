@@ -7,6 +7,7 @@
 #include <cassert>
 #include <cstdio>
 #include <cstring>
+#include <string>
 
 using namespace vksdl::graph;
 
@@ -386,6 +387,61 @@ int main() {
         std::printf("  PassContext resolution: ok\n");
     }
 
+    {
+        // Per-subresource views: created on first request, then cached.
+        RenderGraph graph(device.value(), allocator.value());
+
+        ResourceState initState{};
+        initState.currentLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        auto img = graph.importImage(testImage.value(), initState);
+
+        ImageDesc desc{};
+        desc.width = 64;
+        desc.height = 64;
+        desc.format = VK_FORMAT_R8G8B8A8_UNORM;
+        desc.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        desc.mipLevels = 4;
+        desc.arrayLayers = 2;
+        auto transient = graph.createImage(desc);
+
+        VkImageView firstMip1 = VK_NULL_HANDLE;
+        graph.addPass(
+            "views", PassType::Graphics,
+            [&](PassBuilder& b) {
+                b.writeColorAttachment(img);
+                b.writeColorAttachment(transient);
+            },
+            [&](PassContext& ctx, VkCommandBuffer) {
+                VkImageView mip1 = ctx.imageView(transient, vksdl::ImageViewDesc::mip(1));
+                assert(mip1 != VK_NULL_HANDLE);
+                assert(mip1 != ctx.vkImageView(transient));
+                assert(ctx.imageView(transient, vksdl::ImageViewDesc::mip(1)) == mip1);
+
+                VkImageView layer1 = ctx.imageView(transient, vksdl::ImageViewDesc::layer(1));
+                assert(layer1 != VK_NULL_HANDLE && layer1 != mip1);
+
+                // Defaults resolve before lookup: explicit full range == {}.
+                vksdl::ImageViewDesc full;
+                full.levelCount = 4;
+                full.layerCount = 2;
+                full.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+                assert(ctx.imageView(transient, full) == ctx.imageView(transient, {}));
+
+                assert(ctx.imageView(transient, vksdl::ImageViewDesc::mip(4)) == VK_NULL_HANDLE);
+                assert(ctx.imageView(img, {}) != VK_NULL_HANDLE);
+                firstMip1 = mip1;
+            });
+
+        auto r = graph.compile();
+        assert(r.ok());
+        auto oneShot = OneShotCmd::begin(vkDev, queueFamily);
+        graph.execute(oneShot.cmd);
+        oneShot.submitAndWait(queue);
+        assert(firstMip1 != VK_NULL_HANDLE);
+
+        std::printf("  PassContext per-subresource views: ok\n");
+    }
+
     {
         RenderGraph graph(device.value(), allocator.value());
 
@@ -834,6 +890,67 @@ int main() {
         std::printf("  Layer 1 transient with render targets: ok\n");
     }
 
+    // Layer 1 multiview: a view mask over a 4-layer depth array renders all
+    // cascades in one pass, and barriers cover the four layers.
+    {
+        RenderGraph graph(device.value(), allocator.value());
+
+        ImageDesc desc{};
+        desc.width = 64;
+        desc.height = 64;
+        desc.format = VK_FORMAT_D32_SFLOAT;
+        desc.arrayLayers = 4;
+        auto cascades = graph.createImage(desc, "cascades");
+
+        bool recorded = false;
+        graph.addPass(
+            "shadowCascades", PassType::Graphics,
+            [&](PassBuilder& b) {
+                b.setViewMask(0xF);
+                b.setDepthTarget(cascades);
+            },
+            [&](PassContext& ctx, VkCommandBuffer cmd) {
+                ctx.beginRendering(cmd);
+                ctx.endRendering(cmd);
+                recorded = true;
+            });
+        graph.addPass(
+            "shade", PassType::Graphics, [&](PassBuilder& b) { b.sampleImage(cascades); },
+            [](PassContext&, VkCommandBuffer) {});
+
+        auto r = graph.compile();
+        if (!device.value().hasMultiview()) {
+            assert(!r.ok());
+            std::printf("  Layer 1 multiview: skipped (no multiview support)\n");
+        } else {
+            assert(r.ok());
+            std::string json = graph.exportJson();
+            assert(json.find("\"viewMask\":15") != std::string::npos);
+            assert(json.find("\"layerCount\":4") != std::string::npos);
+            assert(json.find("\"layerCount\":1") == std::string::npos);
+
+            auto oneShot = OneShotCmd::begin(vkDev, queueFamily);
+            graph.execute(oneShot.cmd);
+            oneShot.submitAndWait(queue);
+            assert(recorded);
+
+            // A mask needing more layers than the target has fails to compile.
+            RenderGraph narrow(device.value(), allocator.value());
+            desc.arrayLayers = 2;
+            auto twoLayers = narrow.createImage(desc);
+            narrow.addPass(
+                "tooWide", PassType::Graphics,
+                [&](PassBuilder& b) {
+                    b.setViewMask(0xF);
+                    b.setDepthTarget(twoLayers);
+                },
+                [](PassContext&, VkCommandBuffer) {});
+            assert(!narrow.compile().ok());
+            std::printf("  Layer 1 multiview: ok\n");
+        }
+        (void) recorded;
+    }
+
     // Helper: create a simple pipeline layout (empty).
     auto makeEmptyLayout = [&]() {
         VkPipelineLayoutCreateInfo ci{};
@@ -1344,10 +1461,219 @@ int main() {
         const auto& s = graph.stats();
         assert(s.passCount == 1);
         assert(s.imageBarrierCount >= 1);
+        assert(s.barriersAfterCoalescing ==
+               s.imageBarrierCount + s.bufferBarrierCount + s.memoryBarrierCount);
+        assert(s.barriersBeforeCoalescing >= s.barriersAfterCoalescing);
         assert(s.compileTimeUs > 0.0);
         std::printf("  stats: ok\n");
     }
 
+    // Incremental recompile: toggling one pass re-barriers only the passes
+    // sharing resources with it; the rest reuse last frame's barriers.
+    {
+        RenderGraph graph(device.value(), allocator.value());
+
+        auto declare = [&](bool withExtra) {
+            ImageDesc desc{32, 32, VK_FORMAT_R8G8B8A8_UNORM};
+            ResourceHandle imgs[6];
+            for (auto& img : imgs)
+                img = graph.createImage(desc);
+
+            for (auto img : imgs) {
+                graph.addPass(
+                    "write", PassType::Compute,
+                    [&](PassBuilder& b) { b.writeStorageImage(img); },
+                    [](PassContext&, VkCommandBuffer) {});
+            }
+            if (withExtra) {
+                graph.addPass(
+                    "extra", PassType::Compute,
+                    [&](PassBuilder& b) {
+                        b.readStorageImage(imgs[0]);
+                        b.writeStorageImage(imgs[5]);
+                    },
+                    [](PassContext&, VkCommandBuffer) {});
+            }
+        };
+
+        declare(false);
+        auto r1 = graph.compile();
+        assert(r1.ok());
+        assert(!graph.stats().incremental);
+        std::uint32_t fullBarriers = graph.stats().imageBarrierCount;
+
+        // Add a pass: only the writers of imgs[0]/imgs[5] and "extra" are affected.
+        graph.reset();
+        declare(true);
+        auto r2 = graph.compile();
+        assert(r2.ok());
+        assert(graph.stats().incremental);
+        assert(graph.stats().recompiledPassCount == 3);
+        assert(graph.stats().passCount == 7);
+        assert(graph.stats().imageBarrierCount == fullBarriers + 2);
+        assert(graph.stats().lastFullCompileUs > 0.0);
+
+        auto oneShot = OneShotCmd::begin(vkDev, queueFamily);
+        graph.execute(oneShot.cmd);
+        oneShot.submitAndWait(queue);
+
+        // Remove it again.
+        graph.reset();
+        declare(false);
+        auto r3 = graph.compile();
+        assert(r3.ok());
+        assert(graph.stats().incremental);
+        assert(graph.stats().imageBarrierCount == fullBarriers);
+        assert(graph.stats().lastIncrementalCompileUs > 0.0);
+
+        std::printf("  incremental recompile: ok\n");
+    }
+
+    // Test: exportJson / exportDot.
+    // Named passes and resources appear in the export with their barriers,
+    // lifetimes and stage/access/layout strings.
+    {
+        RenderGraph graph(device.value(), allocator.value());
+        assert(graph.exportJson().empty()); // not compiled yet
+
+        ImageDesc desc{16, 16, VK_FORMAT_R8G8B8A8_UNORM};
+        auto img = graph.createImage(desc, "hdr");
+        graph.addPass(
+            "produce", PassType::Compute, [&](PassBuilder& b) { b.writeStorageImage(img); },
+            [](PassContext&, VkCommandBuffer) {});
+        graph.addPass(
+            "consume", PassType::Compute, [&](PassBuilder& b) { b.readStorageImage(img); },
+            [](PassContext&, VkCommandBuffer) {});
+        auto r = graph.compile();
+        assert(r.ok());
+
+        std::string json = graph.exportJson();
+        assert(json.find("\"name\":\"produce\"") != std::string::npos);
+        assert(json.find("\"name\":\"consume\"") != std::string::npos);
+        assert(json.find("\"resource\":\"hdr\"") != std::string::npos);
+        assert(json.find("\"newLayout\":\"GENERAL\"") != std::string::npos);
+        assert(json.find("\"dstAccess\":\"SHADER_STORAGE_READ\"") != std::string::npos);
+        assert(json.find("\"firstPass\":0,\"lastPass\":1") != std::string::npos);
+        assert(json.find("\"timingsUs\"") != std::string::npos);
+
+        std::string dot = graph.exportDot();
+        assert(dot.rfind("digraph render_graph {", 0) == 0);
+        assert(dot.find("label=\"hdr\"") != std::string::npos);
+
+        std::printf("  export json/dot: ok\n");
+    }
+
+    // Test: async transfer scheduling.
+    // An upload with no graphics producers moves to the transfer family and
+    // hands its buffer over with a release/acquire pair; a Transfer pass that
+    // depends on graphics work stays inline.
+    {
+        RenderGraph graph(device.value(), allocator.value());
+        const std::uint32_t fakeTransferFamily = queueFamily + 1; // compile-only
+        graph.enableAsyncTransfer(fakeTransferFamily, queueFamily);
+
+        auto streamed = graph.createBuffer(BufferDesc{4096, 0}, "streamed");
+        auto result = graph.createBuffer(BufferDesc{4096, 0}, "result");
+        graph.addPass(
+            "upload", PassType::Transfer,
+            [&](PassBuilder& b) { b.writeTransferDstBuffer(streamed); },
+            [](PassContext&, VkCommandBuffer) {});
+        graph.addPass(
+            "consume", PassType::Compute,
+            [&](PassBuilder& b) {
+                b.readStorageBuffer(streamed);
+                b.writeStorageBuffer(result);
+            },
+            [](PassContext&, VkCommandBuffer) {});
+        graph.addPass(
+            "readback", PassType::Transfer,
+            [&](PassBuilder& b) { b.readTransferSrcBuffer(result); },
+            [](PassContext&, VkCommandBuffer) {});
+        auto r = graph.compile();
+        assert(r.ok());
+        assert(graph.hasAsyncTransferWork());
+        assert(graph.stats().asyncTransferPassCount == 1);
+        assert(graph.stats().ownershipTransferCount == 1);
+        auto wait = graph.asyncTransferWait(VK_NULL_HANDLE, 1);
+        assert((wait.stageMask & VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT) != 0);
+
+        // An imported buffer the transfer family still owns gets its
+        // release/acquire pair even though no pass goes async this frame.
+        graph.reset();
+        ResourceState uploaded{};
+        uploaded.lastWriteStage = VK_PIPELINE_STAGE_2_COPY_BIT;
+        uploaded.lastWriteAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        uploaded.queueFamily = fakeTransferFamily;
+        auto ownedBuffer =
+            vksdl::BufferBuilder(allocator.value()).storageBuffer().size(4096).build();
+        assert(ownedBuffer.ok());
+        auto owned = graph.importBuffer(ownedBuffer.value(), uploaded, "owned");
+        graph.addPass(
+            "read owned", PassType::Compute, [&](PassBuilder& b) { b.readStorageBuffer(owned); },
+            [](PassContext&, VkCommandBuffer) {});
+        auto ro = graph.compile();
+        assert(ro.ok());
+        assert(graph.stats().asyncTransferPassCount == 0);
+        assert(graph.stats().ownershipTransferCount == 1);
+        assert(graph.hasAsyncTransferWork()); // the release runs on the transfer queue
+        wait = graph.asyncTransferWait(VK_NULL_HANDLE, 1);
+        assert((wait.stageMask & VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT) != 0);
+
+        graph.disableAsyncTransfer();
+        graph.reset();
+        auto buf = graph.createBuffer(BufferDesc{4096, 0}, "streamed");
+        graph.addPass(
+            "upload", PassType::Transfer, [&](PassBuilder& b) { b.writeTransferDstBuffer(buf); },
+            [](PassContext&, VkCommandBuffer) {});
+        auto r2 = graph.compile();
+        assert(r2.ok());
+        assert(!graph.hasAsyncTransferWork());
+
+        std::printf("  async transfer scheduling: ok\n");
+    }
+
+    // Test: async transfer end-to-end on a dedicated transfer family.
+    if (device.value().hasDedicatedTransfer()) {
+        auto tq = vksdl::TransferQueue::create(device.value(), allocator.value());
+        assert(tq.ok());
+
+        RenderGraph graph(device.value(), allocator.value());
+        graph.enableAsyncTransfer(tq.value());
+
+        auto streamed = graph.createBuffer(BufferDesc{4096, 0}, "streamed");
+        graph.addPass(
+            "upload", PassType::Transfer,
+            [&](PassBuilder& b) { b.writeTransferDstBuffer(streamed); },
+            [&](PassContext& ctx, VkCommandBuffer cmd) {
+                vkCmdFillBuffer(cmd, ctx.vkBuffer(streamed), 0, VK_WHOLE_SIZE, 0x12345678u);
+            });
+        graph.addPass(
+            "consume", PassType::Compute, [&](PassBuilder& b) { b.readStorageBuffer(streamed); },
+            [](PassContext&, VkCommandBuffer) {});
+        auto r = graph.compile();
+        assert(r.ok());
+        assert(graph.hasAsyncTransferWork());
+
+        auto transferCmd = OneShotCmd::begin(vkDev, tq.value().queueFamily());
+        graph.executeAsyncTransfer(transferCmd.cmd);
+        auto vr = vkEndCommandBuffer(transferCmd.cmd);
+        assert(vr == VK_SUCCESS);
+        auto value = tq.value().submit(transferCmd.cmd);
+        assert(value.ok());
+        assert(graph.asyncTransferWait(tq.value().vkTimelineSemaphore(), value.value()).value ==
+               value.value());
+        tq.value().waitIdle();
+        vkDestroyCommandPool(vkDev, transferCmd.pool, nullptr);
+
+        auto oneShot = OneShotCmd::begin(vkDev, queueFamily);
+        graph.execute(oneShot.cmd);
+        oneShot.submitAndWait(queue);
+
+        std::printf("  async transfer execute: ok\n");
+    } else {
+        std::printf("  async transfer execute: skipped (no dedicated transfer family)\n");
+    }
+
     std::printf("render graph test passed\n");
     return 0;
 }
@@ -4,6 +4,7 @@
 #include <cassert>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 
 int main() {
     auto app = vksdl::App::create();
@@ -79,6 +80,64 @@ int main() {
         std::printf("  graphics spec constants: ok\n");
     }
 
+    // Permutation precompile: 4 workgroup sizes x 3 scales, one pruned.
+    {
+        auto cache = vksdl::PipelineCache::create(device.value());
+        assert(cache.ok());
+        auto compiler = vksdl::PipelineCompiler::create(device.value(), cache.value());
+        assert(compiler.ok());
+
+        auto floatBits = [](float f) {
+            std::uint32_t bits = 0;
+            std::memcpy(&bits, &f, sizeof(bits));
+            return bits;
+        };
+
+        vksdl::SpecPermutations perms;
+        perms.values(0, {8, 16, 32, 64}).values(1, {floatBits(1.0f), floatBits(2.0f),
+                                                     floatBits(4.0f)});
+        // Largest group size with the largest scale is never used.
+        perms.filter([&](std::uint32_t key) {
+            return !(perms.choice(key, 0) == 3 && perms.choice(key, 1) == 2);
+        });
+        assert(perms.keyBits() == 4);
+        assert(perms.tableSize() == 16);
+        assert(perms.shift(1) == 2);
+        assert(perms.permutationCount() == 11);
+        assert(perms.key({1, 2}) == (1u | (2u << 2)));
+
+        vksdl::ComputePipelineBuilder base(device.value());
+        base.shader("shaders/spec_const.comp.spv");
+        auto table = compiler.value().compilePermutations(base, perms);
+        assert(table.ok());
+        assert(table.value().compiledCount() == 11);
+        assert(table.value().size() == 16);
+
+        for (std::uint32_t k = 0; k < table.value().size(); ++k) {
+            const vksdl::PipelineHandle* h = table.value()[k];
+            assert((h != nullptr) == perms.valid(k));
+            if (h)
+                assert(h->vkPipeline() != VK_NULL_HANDLE);
+        }
+        assert(table.value()[perms.key({3, 2})] == nullptr); // pruned
+        assert(table.value()[perms.key({0, 3})] == nullptr); // out of domain
+        assert(table.value()[1000] == nullptr);
+
+        // Graphics permutations go through the same worker pool.
+        vksdl::SpecPermutations flags;
+        flags.boolean(0).boolean(1);
+        auto gfx = compiler.value().compilePermutations(
+            vksdl::PipelineBuilder(device.value())
+                .vertexShader("shaders/triangle.vert.spv")
+                .fragmentShader("shaders/triangle.frag.spv")
+                .colorFormat(VK_FORMAT_B8G8R8A8_SRGB),
+            flags);
+        assert(gfx.ok());
+        assert(gfx.value().compiledCount() == 4);
+        std::printf("  spec constant permutations: ok (%u compute, %u graphics)\n",
+                    table.value().compiledCount(), gfx.value().compiledCount());
+    }
+
     device.value().waitIdle();
     std::printf("spec constants test passed\n");
     return 0;
@@ -0,0 +1,165 @@
+#include <vksdl/vksdl.hpp>
+#include <vulkan/vulkan.h>
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// Fills every texel with (mip, pageX, pageY, 255).
+static void fillPage(std::uint32_t mip, std::uint32_t pageX, std::uint32_t pageY,
+                     std::uint32_t width, std::uint32_t height, void* dst) {
+    auto* texels = static_cast<std::uint8_t*>(dst);
+    for (std::uint32_t i = 0; i < width * height; ++i) {
+        texels[i * 4 + 0] = static_cast<std::uint8_t>(mip);
+        texels[i * 4 + 1] = static_cast<std::uint8_t>(pageX);
+        texels[i * 4 + 2] = static_cast<std::uint8_t>(pageY);
+        texels[i * 4 + 3] = 255;
+    }
+}
+
+int main() {
+    auto app = vksdl::App::create();
+    assert(app.ok());
+
+    auto window = app.value().createWindow("virtual texture test", 640, 480);
+    assert(window.ok());
+
+    auto instance = vksdl::InstanceBuilder{}
+                        .appName("test_virtual_texture")
+                        .requireVulkan(1, 3)
+                        .validation(vksdl::Validation::Off)
+                        .enableWindowSupport()
+                        .build();
+    assert(instance.ok());
+
+    auto surface = vksdl::Surface::create(instance.value(), window.value());
+    assert(surface.ok());
+
+    // Without needSparseResidency() creation fails cleanly.
+    {
+        auto plain = vksdl::DeviceBuilder(instance.value(), surface.value())
+                         .graphicsDefaults()
+                         .build();
+        assert(plain.ok());
+        assert(!plain.value().hasSparseResidency());
+        auto alloc = vksdl::Allocator::create(instance.value(), plain.value());
+        assert(alloc.ok());
+        vksdl::VirtualTextureDesc desc;
+        desc.extent = {4096, 4096};
+        auto vt = vksdl::VirtualTexture::create(plain.value(), alloc.value(), desc, fillPage);
+        assert(!vt.ok());
+        std::printf("  create without sparse residency fails: ok\n");
+    }
+
+    auto device = vksdl::DeviceBuilder(instance.value(), surface.value())
+                      .graphicsDefaults()
+                      .needSparseResidency()
+                      .build();
+    if (!device.ok()) {
+        std::printf("SKIP: sparse residency not available on this GPU\n");
+        return 0;
+    }
+    assert(device.value().hasSparseResidency());
+
+    auto allocator = vksdl::Allocator::create(instance.value(), device.value());
+    assert(allocator.ok());
+    auto transfer = vksdl::TransferQueue::create(device.value(), allocator.value());
+    assert(transfer.ok());
+
+    // Request one page: it and its ancestors become resident after the
+    // upload completes and a later update() publishes them.
+    {
+        vksdl::VirtualTextureDesc desc;
+        desc.extent = {4096, 4096};
+        desc.physicalPages = 64;
+        auto vtResult =
+            vksdl::VirtualTexture::create(device.value(), allocator.value(), desc, fillPage);
+        if (!vtResult.ok()) {
+            std::printf("SKIP: %s\n", vtResult.error().format().c_str());
+            return 0;
+        }
+        auto& vt = vtResult.value();
+        VkExtent2D page = vt.pageExtent();
+        VkExtent2D grid = vt.pageTableExtent();
+        std::printf("  page %ux%u, grid %ux%u, %u mips, tail from mip %u\n", page.width,
+                    page.height, grid.width, grid.height, vt.mipLevels(), vt.mipTailFirstLevel());
+        assert(vt.mipLevels() == 13);
+        assert(vt.mipTailFirstLevel() > 0 && vt.mipTailFirstLevel() < vt.mipLevels());
+        assert(grid.width == (4096 + page.width - 1) / page.width);
+        assert(!vt.ready());
+        assert(vt.publishedTransferValue() == 0);
+
+        const auto* table = static_cast<const std::uint32_t*>(vt.pageTable().mappedData());
+        assert(table[0] == vt.mipTailFirstLevel());
+
+        vt.request(0, 0, 0);
+        assert(vt.stats().requested == vt.mipTailFirstLevel());
+        auto r = vt.update(transfer.value());
+        assert(r.ok());
+        assert(vt.stats().bindCalls == 1);
+        assert(vt.stats().uploaded == vt.mipTailFirstLevel());
+        assert(!vt.isResident(0, 0, 0));
+
+        transfer.value().waitIdle();
+        r = vt.update(transfer.value());
+        assert(r.ok());
+        assert(vt.ready());
+        // The sampling submit waits on this value of the transfer timeline.
+        assert(vt.publishedTransferValue() != 0);
+        assert(transfer.value().isComplete(vt.publishedTransferValue()));
+        for (std::uint32_t m = 0; m < vt.mipTailFirstLevel(); ++m)
+            assert(vt.isResident(m, 0, 0));
+        assert(vt.stats().residentPages == vt.mipTailFirstLevel());
+        assert(table[0] == 0);
+        assert(table[grid.width - 1] != 0);
+
+        // Feedback: the shader asks for mip 1 at the far corner.
+        auto* feedback = static_cast<std::uint32_t*>(vt.feedbackBuffer(0).mappedData());
+        std::uint32_t last = grid.width * grid.height - 1;
+        feedback[last] = 1;
+        assert(vt.feedbackBuffer(0).flush().ok());
+        vt.processFeedback(0);
+        assert(feedback[last] == 0xFFFFFFFFu);
+        assert(vt.stats().requested >= 1);
+        r = vt.update(transfer.value());
+        assert(r.ok());
+        transfer.value().waitIdle();
+        r = vt.update(transfer.value());
+        assert(r.ok());
+        assert(vt.isResident(1, (grid.width - 1) >> 1, (grid.height - 1) >> 1));
+        assert(table[last] == 1);
+        std::printf("  request + feedback residency: ok\n");
+        device.value().waitIdle();
+    }
+
+    // A small pool: requests beyond it evict least recently used pages.
+    {
+        vksdl::VirtualTextureDesc desc;
+        desc.extent = {4096, 4096};
+        desc.physicalPages = 16;
+        desc.maxUploadsPerUpdate = 8;
+        auto vtResult =
+            vksdl::VirtualTexture::create(device.value(), allocator.value(), desc, fillPage);
+        assert(vtResult.ok());
+        auto& vt = vtResult.value();
+        VkExtent2D grid = vt.pageTableExtent();
+
+        std::uint32_t evicted = 0;
+        for (std::uint32_t frame = 0; frame < 32; ++frame) {
+            vt.request(0, frame % grid.width, (frame / grid.width) % grid.height);
+            auto r = vt.update(transfer.value());
+            assert(r.ok());
+            evicted += vt.stats().evicted;
+            transfer.value().waitIdle();
+            assert(vt.stats().residentPages <= vt.physicalPages());
+        }
+        assert(evicted > 0);
+        std::printf("  LRU eviction: %u pages evicted, %u resident\n", evicted,
+                    vt.stats().residentPages);
+        device.value().waitIdle();
+    }
+
+    std::printf("virtual texture test passed\n");
+    return 0;
+}
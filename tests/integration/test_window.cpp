@@ -6,6 +6,7 @@
 #include <cassert>
 #include <cstdio>
 #include <string>
+#include <thread>
 
 int main() {
     auto appResult = vksdl::App::create();
@@ -44,6 +45,40 @@ int main() {
         // consume any startup events
     }
 
+    // Threaded input: this thread pumps, a consumer thread drains the ring.
+    {
+        app.enableThreadedInput(64);
+        assert(app.threadedInput());
+
+        SDL_Event key{};
+        key.type = SDL_EVENT_KEY_DOWN;
+        key.key.windowID = window.windowId();
+        key.key.scancode = SDL_SCANCODE_ESCAPE;
+        bool pushed = SDL_PushEvent(&key);
+        assert(pushed);
+        (void) pushed;
+        app.waitEvents(100);
+
+        vksdl::Event got{};
+        std::thread consumer([&] {
+            vksdl::Event e{};
+            while (window.pollEvent(e)) {
+                if (e.type == vksdl::EventType::KeyDown)
+                    got = e;
+            }
+            auto s = window.pixelSize();
+            assert(s.width == 640 && s.height == 480);
+            (void) s;
+        });
+        consumer.join();
+
+        assert(got.keyCode == vksdl::Key::Escape);
+        assert(got.timestampNs != 0);
+        assert(got.timestampNs <= vksdl::eventClockNs());
+        assert(window.droppedEvents() == 0);
+        std::printf("  threaded input: ok\n");
+    }
+
     std::printf("window test passed\n");
     return 0;
 }
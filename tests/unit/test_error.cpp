@@ -1,7 +1,44 @@
 #include <vksdl/error.hpp>
 
+#include <vksdl/result.hpp>
+
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
 #include <string>
+#include <string_view>
+#include <type_traits>
+
+// Counts heap allocations so the literal and lazy paths can be checked.
+static std::size_t gAllocations = 0;
+
+void* operator new(std::size_t size) {
+    ++gAllocations;
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// Operations are kept by pointer, so runtime strings must not convert.
+static_assert(!std::is_constructible_v<vksdl::ErrorOperation, std::string>);
+static_assert(!std::is_constructible_v<vksdl::ErrorOperation, std::string_view>);
+static_assert(!std::is_constructible_v<vksdl::ErrorOperation, const char*>);
+
+static vksdl::Result<int> allocateOrFail(int i) {
+    if (i < 0)
+        return i;
+    return vksdl::Error{"allocate descriptor set", -1000069000, "pool exhausted"};
+}
 
 int main() {
     // Vulkan error with message
@@ -30,5 +67,79 @@ int main() {
         assert(s.find("VkResult -1") != std::string::npos);
     }
 
+    // Literal operation and message: kept by pointer, no allocation.
+    {
+        std::size_t before = gAllocations;
+        int exhausted = 0;
+        for (int i = 0; i < 1000; ++i) {
+            auto r = allocateOrFail(i);
+            if (!r.ok() && r.error().is(vksdl::ErrorCode::PoolExhausted))
+                ++exhausted;
+        }
+        assert(exhausted == 1000);
+        assert(gAllocations == before);
+
+        vksdl::Error e{"probe pipeline cache", 1000297000, "cache miss"};
+        assert(e.message.isStatic());
+        assert(e.message == "cache miss");
+        assert(e.kind() == vksdl::ErrorCode::CompileRequired);
+        assert(gAllocations == before);
+    }
+
+    // Lazy message: formatted on first read, once.
+    {
+        static int formatted = 0;
+        std::size_t before = gAllocations;
+        vksdl::Error e{"allocate descriptor set", 0,
+                       vksdl::ErrorMessage::lazy(
+                           [](std::uint64_t pools, std::uint64_t sets) {
+                               ++formatted;
+                               return std::to_string(pools) + " pools, " + std::to_string(sets) +
+                                      " sets";
+                           },
+                           4, 512)};
+        assert(gAllocations == before);
+        assert(formatted == 0 && e.message.isStatic());
+        assert(e.message == "4 pools, 512 sets");
+        assert(e.format().find("4 pools, 512 sets") != std::string::npos);
+        assert(formatted == 1 && !e.message.isStatic());
+    }
+
+    // Runtime text is copied; appending turns a literal into owned text.
+    {
+        std::string detail = "file.spv";
+        const char* cstr = detail.c_str();
+        vksdl::Error a{"read SPIR-V", 0, "could not open " + detail};
+        vksdl::Error b{"read SPIR-V", 0, cstr};
+        detail = "changed";
+        assert(a.message == "could not open file.spv");
+        assert(b.message == "file.spv");
+
+        vksdl::Error c{"run startup", 0, "stage failed"};
+        c.message += " (startup stage 'x')";
+        assert(c.message == "stage failed (startup stage 'x')");
+
+        vksdl::Error copy = c;
+        assert(copy.message == c.message.view());
+
+        // A writable buffer is copied, not kept by pointer.
+        char buffer[16] = "stage";
+        vksdl::Error d{"run startup", 0, buffer};
+        buffer[0] = 'X';
+        assert(d.message == "stage");
+        assert(d.operation == "run startup");
+    }
+
+    // kind(): explicit code wins, otherwise derived from vkResult.
+    {
+        assert((vksdl::Error{"op", 0, ""}.kind() == vksdl::ErrorCode::Failed));
+        assert((vksdl::Error{"op", -2, ""}.kind() == vksdl::ErrorCode::OutOfMemory));
+        assert((vksdl::Error{"op", -4, ""}.kind() == vksdl::ErrorCode::DeviceLost));
+        assert((vksdl::Error{"op", -12, ""}.kind() == vksdl::ErrorCode::PoolExhausted));
+        assert((vksdl::Error{"op", -13, ""}.kind() == vksdl::ErrorCode::Vulkan));
+        assert((vksdl::Error{"op", 0, "", vksdl::ErrorCode::InvalidArgument}.kind() ==
+                vksdl::ErrorCode::InvalidArgument));
+    }
+
     return 0;
 }
@@ -0,0 +1,96 @@
+#include <vksdl/pipeline_desc.hpp>
+
+#include <cassert>
+#include <cstdio>
+#include <unordered_map>
+
+namespace {
+
+constexpr auto kOpaque = vksdl::PipelineDesc{}
+                             .vertexShader("mesh.vert.spv")
+                             .fragmentShader("mesh.frag.spv")
+                             .colorFormat(VK_FORMAT_B8G8R8A8_SRGB)
+                             .depthFormat(VK_FORMAT_D32_SFLOAT)
+                             .vertexBinding(0, 32)
+                             .vertexAttribute(0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0)
+                             .vertexAttribute(1, 0, VK_FORMAT_R32G32B32_SFLOAT, 12)
+                             .cullBack();
+
+constexpr auto kBlended = kOpaque.enableBlending();
+
+// Validation and identity are decided during compilation.
+static_assert(kOpaque.valid());
+static_assert(kOpaque.key() == kOpaque.key());
+static_assert(kOpaque.key() != kBlended.key());
+static_assert(kOpaque.key() != kOpaque.fragmentShader("other.frag.spv").key());
+static_assert(kOpaque.dynamicState(VK_DYNAMIC_STATE_CULL_MODE).key() !=
+              kOpaque.dynamicState(VK_DYNAMIC_STATE_FRONT_FACE).key());
+static_assert(kOpaque.key() != kOpaque.viewMask(0b11).key());
+
+// Repeated and always-dynamic states do not change the identity.
+static_assert(kOpaque.dynamicState(VK_DYNAMIC_STATE_VIEWPORT).key() == kOpaque.key());
+static_assert(kOpaque.dynamicState(VK_DYNAMIC_STATE_CULL_MODE)
+                  .dynamicState(VK_DYNAMIC_STATE_CULL_MODE)
+                  .key() == kOpaque.dynamicState(VK_DYNAMIC_STATE_CULL_MODE).key());
+
+static_assert(vksdl::PipelineDesc{}.colorFormat(VK_FORMAT_R8G8B8A8_UNORM).validate() ==
+              "vertexShader() is required");
+static_assert(vksdl::PipelineDesc{}.vertexShader("a.spv").validate() ==
+              "colorFormat() is required");
+static_assert(!kOpaque.vertexAttribute(2, 1, VK_FORMAT_R32_SFLOAT, 0).valid());
+static_assert(!kOpaque.vertexAttribute(1, 0, VK_FORMAT_R32_SFLOAT, 24).valid());
+static_assert(!kOpaque.vertexBinding(0, 16).valid());
+static_assert(!kOpaque.samples(static_cast<VkSampleCountFlagBits>(3)).valid());
+
+} // namespace
+
+static void testConstantKeyLookup() {
+    // Hot-path lookup: the key is a constant, only the map probe runs.
+    std::unordered_map<vksdl::PipelineKey, int, vksdl::PipelineKeyHash> table;
+    constexpr vksdl::PipelineKey kOpaqueKey = kOpaque.key();
+    constexpr vksdl::PipelineKey kBlendedKey = kBlended.key();
+    table.emplace(kOpaqueKey, 1);
+    table.emplace(kBlendedKey, 2);
+    assert(table.at(kOpaqueKey) == 1);
+    assert(table.at(kBlendedKey) == 2);
+}
+
+static void testFill() {
+    vksdl::PipelineDescCreateInfo ci;
+    kBlended.fill(ci, VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE);
+
+    const VkGraphicsPipelineCreateInfo& p = ci.pipeline;
+    assert(p.sType == VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO);
+    assert(p.pNext == &ci.rendering);
+    assert(p.stageCount == 1); // null fragment module: vertex only
+    assert(p.pVertexInputState->vertexBindingDescriptionCount == 1);
+    assert(p.pVertexInputState->vertexAttributeDescriptionCount == 2);
+    assert(p.pVertexInputState->pVertexAttributeDescriptions[1].offset == 12);
+    assert(p.pRasterizationState->cullMode == VK_CULL_MODE_BACK_BIT);
+    assert(p.pColorBlendState->pAttachments->blendEnable == VK_TRUE);
+    assert(p.pDepthStencilState->depthTestEnable == VK_TRUE);
+    assert(p.pDynamicState->dynamicStateCount == 2);
+    assert(ci.rendering.colorAttachmentCount == 1);
+    assert(ci.rendering.pColorAttachmentFormats[0] == VK_FORMAT_B8G8R8A8_SRGB);
+    assert(ci.rendering.depthAttachmentFormat == VK_FORMAT_D32_SFLOAT);
+
+    auto withDynamic = kOpaque.dynamicState(VK_DYNAMIC_STATE_CULL_MODE);
+    vksdl::PipelineDescCreateInfo ci2;
+    withDynamic.fill(ci2, VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE);
+    assert(ci2.pipeline.pDynamicState->dynamicStateCount == 3);
+    assert(ci2.dynamicStates[2] == VK_DYNAMIC_STATE_CULL_MODE);
+    // Dynamic values are written in canonical form, as PipelineBuilder does.
+    assert(ci2.pipeline.pRasterizationState->cullMode == VK_CULL_MODE_NONE);
+
+    vksdl::PipelineDescCreateInfo ci3;
+    kOpaque.viewMask(0b11).fill(ci3, VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE);
+    assert(ci3.rendering.viewMask == 0b11);
+}
+
+int main() {
+    testConstantKeyLookup();
+    testFill();
+
+    std::printf("all pipeline desc tests passed\n");
+    return 0;
+}
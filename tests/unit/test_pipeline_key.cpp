@@ -0,0 +1,109 @@
+#include <vksdl/pipeline_key.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <unordered_set>
+#include <vector>
+
+static void testKnownValues() {
+    // Pinned outputs: keys index on-disk stores, so the algorithm must not
+    // drift between releases, compilers or platforms.
+    auto empty = vksdl::hash128("", 0);
+    assert(empty.lo == 0x7021da1e58ad384cULL && empty.hi == 0x6fe3fce12e041ca7ULL);
+
+    auto text = vksdl::hash128("vksdl pipeline key", 18);
+    assert(text.lo == 0x3b54a889d48330caULL && text.hi == 0x61ce5dc7c7c1a7a7ULL);
+
+    std::uint8_t big[200];
+    for (int i = 0; i < 200; ++i)
+        big[i] = static_cast<std::uint8_t>(i);
+    auto seeded = vksdl::hash128(big, sizeof(big), 42);
+    assert(seeded.lo == 0xd5539ea7b26a5f78ULL && seeded.hi == 0xf4d8a59b767584ecULL);
+}
+
+static void testSensitivity() {
+    std::vector<std::uint8_t> data(300, 0xAB);
+    auto base = vksdl::hash128(data.data(), data.size());
+
+    // Every single-bit flip changes both halves.
+    for (std::size_t i = 0; i < data.size(); i += 7) {
+        data[i] ^= 0x10;
+        auto k = vksdl::hash128(data.data(), data.size());
+        assert(k.lo != base.lo && k.hi != base.hi);
+        data[i] ^= 0x10;
+    }
+
+    // Zero padding of the tail must not alias a longer input.
+    std::uint8_t a[2] = {1, 0};
+    assert(vksdl::hash128(a, 1) != vksdl::hash128(a, 2));
+
+    // Stripe order matters.
+    std::vector<std::uint8_t> swapped(128);
+    for (std::size_t i = 0; i < 64; ++i) {
+        swapped[i] = static_cast<std::uint8_t>(i);
+        swapped[i + 64] = static_cast<std::uint8_t>(i + 64);
+    }
+    auto k1 = vksdl::hash128(swapped.data(), swapped.size());
+    for (std::size_t i = 0; i < 64; ++i)
+        std::swap(swapped[i], swapped[i + 64]);
+    assert(k1 != vksdl::hash128(swapped.data(), swapped.size()));
+
+    assert(vksdl::hash128(a, 1, 1) != vksdl::hash128(a, 1, 2));
+
+    // A first word equal to its lane key zeroes the multiply; the second
+    // word must still reach the hash.
+    std::uint8_t lane[64] = {};
+    for (int i = 0; i < 8; ++i)
+        lane[i] = static_cast<std::uint8_t>(vksdl::detail::kPrime1 >> (8 * i));
+    auto zeroed = vksdl::hash128(lane, sizeof(lane));
+    lane[8] ^= 1;
+    assert(zeroed != vksdl::hash128(lane, sizeof(lane)));
+}
+
+static void testNoCollisions() {
+    std::unordered_set<vksdl::PipelineKey, vksdl::PipelineKeyHash> keys;
+    std::unordered_set<std::uint64_t> los;
+    for (std::uint32_t i = 0; i < 100000; ++i) {
+        vksdl::PipelineKeyWriter w;
+        w.u32(i).e32(i % 7).boolean((i & 1) != 0);
+        auto k = w.finish();
+        assert(keys.insert(k).second);
+        assert(los.insert(k.lo).second);
+    }
+}
+
+static void testWriterEncoding() {
+    vksdl::PipelineKeyWriter w;
+    w.u32(0x04030201u).u8(5).u64(0x0D0C0B0A09080706ULL).boolean(true);
+    const auto& d = w.data();
+    assert(d.size() == 4 + 1 + 8 + 1);
+    for (std::size_t i = 0; i < 13; ++i)
+        assert(d[i] == i + 1);
+    assert(d[13] == 1);
+
+    // Length prefixes keep adjacent variable-length fields unambiguous.
+    vksdl::PipelineKeyWriter ab, a_b;
+    ab.str("ab").str("");
+    a_b.str("a").str("b");
+    assert(ab.finish() != a_b.finish());
+
+    // blob() keys by content, not by address.
+    std::vector<std::uint32_t> code1 = {0x07230203u, 1, 2, 3};
+    std::vector<std::uint32_t> code2 = code1;
+    vksdl::PipelineKeyWriter b1, b2;
+    b1.blob(code1.data(), code1.size() * 4);
+    b2.blob(code2.data(), code2.size() * 4);
+    assert(b1.finish() == b2.finish());
+    assert(b1.data().size() == 24);
+}
+
+int main() {
+    testKnownValues();
+    testSensitivity();
+    testNoCollisions();
+    testWriterEncoding();
+
+    std::printf("all pipeline key tests passed\n");
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include <vksdl/startup.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+static void sleepMs(int ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+static void testOverlap() {
+    // Two independent 30 ms stages overlap; the dependent stage waits for both.
+    vksdl::Startup startup(2);
+    std::atomic<int> done{0};
+    auto a = startup.add("read shaders", [&]() -> vksdl::Result<void> {
+        sleepMs(30);
+        done.fetch_add(1);
+        return {};
+    });
+    auto b = startup.add("create device", [&]() -> vksdl::Result<void> {
+        sleepMs(30);
+        done.fetch_add(1);
+        return {};
+    });
+    int seenByPipelines = 0;
+    startup.add(
+        "pipelines",
+        [&]() -> vksdl::Result<void> {
+            seenByPipelines = done.load();
+            return {};
+        },
+        {a, b});
+
+    auto r = startup.run();
+    assert(r.ok());
+    assert(seenByPipelines == 2);
+
+    const auto& t = startup.timeline();
+    assert(t.stages.size() == 3);
+    assert(t.stages[2].startMs >= t.stages[0].endMs);
+    assert(t.stages[2].startMs >= t.stages[1].endMs);
+    assert(t.totalMs < t.serialMs); // the two 30 ms stages ran side by side
+    assert(t.format().find("pipelines") != std::string::npos);
+    assert(t.toJson().find("\"ph\":\"X\"") != std::string::npos);
+}
+
+static void testMainThreadStage() {
+    vksdl::Startup startup(1);
+    auto caller = std::this_thread::get_id();
+    std::thread::id ranOn;
+    auto io = startup.add("io", []() -> vksdl::Result<void> { return {}; });
+    startup.addMainThread(
+        "window",
+        [&]() -> vksdl::Result<void> {
+            ranOn = std::this_thread::get_id();
+            return {};
+        },
+        {io});
+
+    assert(startup.run().ok());
+    assert(ranOn == caller);
+    assert(startup.timeline().stages[1].thread == 0);
+}
+
+static void testFailureSkipsDependents() {
+    vksdl::Startup startup(2);
+    bool ranDependent = false;
+    auto bad = startup.add("load cache", []() -> vksdl::Result<void> {
+        return vksdl::Error{"load", 0, "corrupt"};
+    });
+    startup.add(
+        "compile",
+        [&]() -> vksdl::Result<void> {
+            ranDependent = true;
+            return {};
+        },
+        {bad});
+
+    auto r = startup.run();
+    assert(!r.ok());
+    assert(r.error().message.find("load cache") != std::string::npos);
+    assert(!ranDependent);
+    assert(!startup.timeline().stages[0].ok);
+    assert(!startup.timeline().stages[1].ran);
+}
+
+static void testPrefetch() {
+    // Missing paths are ignored; directories are walked.
+    auto dir = std::filesystem::temp_directory_path() / "vksdl_test_startup";
+    std::filesystem::create_directories(dir / "nested");
+    {
+        std::ofstream f(dir / "nested" / "blob.bin", std::ios::binary);
+        std::string bytes(10000, 'x');
+        f.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    vksdl::Startup startup(1);
+    startup.prefetch("prefetch", {dir, dir / "does_not_exist.spv"});
+    assert(startup.run().ok());
+    assert(startup.timeline().stages[0].ok);
+    std::filesystem::remove_all(dir);
+}
+
+static void testForwardDependencyRejected() {
+    vksdl::Startup startup(1);
+    startup.add("a", []() -> vksdl::Result<void> { return {}; }, {1});
+    startup.add("b", []() -> vksdl::Result<void> { return {}; });
+    assert(!startup.run().ok());
+}
+
+int main() {
+    testOverlap();
+    testMainThreadStage();
+    testFailureSkipsDependents();
+    testPrefetch();
+    testForwardDependencyRejected();
+
+    std::printf("all startup tests passed\n");
+    return 0;
+}
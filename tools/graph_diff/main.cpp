@@ -0,0 +1,420 @@
+// graph_diff: compare two RenderGraph::exportJson() dumps.
+//
+// Usage: graph_diff <before.json> <after.json>
+//
+// Reports passes added/removed, barriers added/removed, changed transitions
+// (same pass + resource + subresource, different layout/stage/access) and
+// aliasing groups that no longer alias. Exit code 1 when the "after" graph
+// regressed (added barriers, changed transitions or lost aliasing), 2 on
+// usage/parse errors, 0 otherwise. Intended for CI and code review.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Minimal JSON DOM -- enough for the export format (no unicode escapes beyond
+// pass-through, numbers kept as double).
+struct Value {
+    enum class Type : std::uint8_t { Null, Bool, Number, String, Array, Object };
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<Value> array;
+    std::vector<std::pair<std::string, Value>> object;
+
+    [[nodiscard]] const Value* find(const std::string& key) const {
+        for (const auto& [k, v] : object) {
+            if (k == key)
+                return &v;
+        }
+        return nullptr;
+    }
+    [[nodiscard]] std::string str(const std::string& key) const {
+        const Value* v = find(key);
+        return v && v->type == Type::String ? v->string : std::string{};
+    }
+    [[nodiscard]] double num(const std::string& key, double fallback = 0.0) const {
+        const Value* v = find(key);
+        return v && v->type == Type::Number ? v->number : fallback;
+    }
+};
+
+class Parser {
+  public:
+    explicit Parser(const std::string& text) : s_(text) {}
+
+    bool parse(Value& out) {
+        if (!parseValue(out))
+            return false;
+        skipWs();
+        return pos_ == s_.size();
+    }
+
+    [[nodiscard]] std::size_t position() const {
+        return pos_;
+    }
+
+  private:
+    void skipWs() {
+        while (pos_ < s_.size() &&
+               (s_[pos_] == ' ' || s_[pos_] == '\n' || s_[pos_] == '\r' || s_[pos_] == '\t'))
+            ++pos_;
+    }
+
+    bool consume(char c) {
+        skipWs();
+        if (pos_ < s_.size() && s_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    bool literal(const char* lit) {
+        std::size_t n = std::char_traits<char>::length(lit);
+        if (s_.compare(pos_, n, lit) != 0)
+            return false;
+        pos_ += n;
+        return true;
+    }
+
+    bool parseString(std::string& out) {
+        if (!consume('"'))
+            return false;
+        while (pos_ < s_.size()) {
+            char c = s_[pos_++];
+            if (c == '"')
+                return true;
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos_ >= s_.size())
+                return false;
+            char e = s_[pos_++];
+            switch (e) {
+            case 'n':
+                out += '\n';
+                break;
+            case 't':
+                out += '\t';
+                break;
+            case 'u':
+                // Export only escapes control characters; keep them verbatim.
+                if (pos_ + 4 > s_.size())
+                    return false;
+                out += "\\u";
+                out.append(s_, pos_, 4);
+                pos_ += 4;
+                break;
+            default:
+                out += e;
+                break;
+            }
+        }
+        return false;
+    }
+
+    bool parseValue(Value& out) {
+        skipWs();
+        if (pos_ >= s_.size())
+            return false;
+        char c = s_[pos_];
+        if (c == '{') {
+            ++pos_;
+            out.type = Value::Type::Object;
+            if (consume('}'))
+                return true;
+            do {
+                std::string key;
+                Value v;
+                if (!parseString(key) || !consume(':') || !parseValue(v))
+                    return false;
+                out.object.emplace_back(std::move(key), std::move(v));
+            } while (consume(','));
+            return consume('}');
+        }
+        if (c == '[') {
+            ++pos_;
+            out.type = Value::Type::Array;
+            if (consume(']'))
+                return true;
+            do {
+                Value v;
+                if (!parseValue(v))
+                    return false;
+                out.array.push_back(std::move(v));
+            } while (consume(','));
+            return consume(']');
+        }
+        if (c == '"') {
+            out.type = Value::Type::String;
+            return parseString(out.string);
+        }
+        if (literal("true")) {
+            out.type = Value::Type::Bool;
+            out.boolean = true;
+            return true;
+        }
+        if (literal("false")) {
+            out.type = Value::Type::Bool;
+            return true;
+        }
+        if (literal("null"))
+            return true;
+
+        const char* begin = s_.c_str() + pos_;
+        char* end = nullptr;
+        out.number = std::strtod(begin, &end);
+        if (end == begin)
+            return false;
+        out.type = Value::Type::Number;
+        pos_ += static_cast<std::size_t>(end - begin);
+        return true;
+    }
+
+    const std::string& s_;
+    std::size_t pos_ = 0;
+};
+
+bool loadJson(const char* path, Value& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::fprintf(stderr, "graph_diff: cannot open '%s'\n", path);
+        return false;
+    }
+    std::stringstream ss;
+    ss << file.rdbuf();
+    std::string text = ss.str();
+
+    Parser parser(text);
+    if (!parser.parse(out) || out.type != Value::Type::Object) {
+        std::fprintf(stderr, "graph_diff: '%s' is not a valid graph export (offset %zu)\n", path,
+                     parser.position());
+        return false;
+    }
+    return true;
+}
+
+// Barrier identity: which pass, which resource, which subresource range.
+// Everything else (layouts, stages, accesses) is the transition.
+struct BarrierKey {
+    std::string pass;
+    std::string kind;
+    std::string resource;
+    std::string range;
+
+    bool operator<(const BarrierKey& o) const {
+        return std::tie(pass, kind, resource, range) <
+               std::tie(o.pass, o.kind, o.resource, o.range);
+    }
+};
+
+std::string rangeOf(const Value& b, const std::string& kind) {
+    char buf[96];
+    if (kind == "img")
+        std::snprintf(buf, sizeof(buf), "mip %.0f+%.0f layer %.0f+%.0f", b.num("baseMip"),
+                      b.num("mipCount"), b.num("baseLayer"), b.num("layerCount"));
+    else if (kind == "buf")
+        std::snprintf(buf, sizeof(buf), "bytes %.0f+%.0f", b.num("offset"), b.num("size"));
+    else
+        buf[0] = '\0';
+    return buf;
+}
+
+std::string transitionOf(const Value& b, const std::string& kind) {
+    std::string t;
+    if (kind == "img")
+        t += b.str("oldLayout") + " -> " + b.str("newLayout") + "  ";
+    t += "src " + b.str("srcStage") + " / " + b.str("srcAccess");
+    t += "  dst " + b.str("dstStage") + " / " + b.str("dstAccess");
+    if (b.find("srcQueueFamily"))
+        t += "  (queue ownership transfer)";
+    return t;
+}
+
+using BarrierMap = std::multimap<BarrierKey, std::string>;
+
+BarrierMap collectBarriers(const Value& root) {
+    BarrierMap out;
+    const Value* passes = root.find("passes");
+    if (!passes)
+        return out;
+    static const std::pair<const char*, const char*> kLists[] = {
+        {"imageBarriers", "img"}, {"bufferBarriers", "buf"}, {"memoryBarriers", "mem"}};
+    for (const auto& pass : passes->array) {
+        std::string passName = pass.str("name");
+        for (const auto& [listName, kind] : kLists) {
+            const Value* list = pass.find(listName);
+            if (!list)
+                continue;
+            for (const auto& b : list->array) {
+                BarrierKey key{passName, kind, b.str("resource"), rangeOf(b, kind)};
+                out.emplace(std::move(key), transitionOf(b, kind));
+            }
+        }
+    }
+    return out;
+}
+
+std::set<std::string> collectPassNames(const Value& root) {
+    std::set<std::string> out;
+    if (const Value* passes = root.find("passes")) {
+        for (const auto& p : passes->array)
+            out.insert(p.str("name"));
+    }
+    return out;
+}
+
+std::vector<std::set<std::string>> collectAliasGroups(const Value& root) {
+    std::vector<std::set<std::string>> out;
+    if (const Value* groups = root.find("aliasing")) {
+        for (const auto& g : groups->array) {
+            std::set<std::string> members;
+            for (const auto& m : g.array)
+                members.insert(m.string);
+            out.push_back(std::move(members));
+        }
+    }
+    return out;
+}
+
+// True if every resource in `group` shares one alias group in `groups`.
+bool stillAliased(const std::set<std::string>& group,
+                  const std::vector<std::set<std::string>>& groups) {
+    for (const auto& g : groups) {
+        bool all = true;
+        for (const auto& name : group) {
+            if (!g.count(name)) {
+                all = false;
+                break;
+            }
+        }
+        if (all)
+            return true;
+    }
+    return false;
+}
+
+std::string joinNames(const std::set<std::string>& names) {
+    std::string out;
+    for (const auto& n : names) {
+        if (!out.empty())
+            out += ", ";
+        out += n;
+    }
+    return out;
+}
+
+void printKey(const char* tag, const BarrierKey& k) {
+    std::printf("%s %s barrier in '%s' on '%s'", tag, k.kind.c_str(), k.pass.c_str(),
+                k.resource.c_str());
+    if (!k.range.empty())
+        std::printf(" [%s]", k.range.c_str());
+    std::printf("\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::fprintf(stderr, "usage: graph_diff <before.json> <after.json>\n");
+        return 2;
+    }
+
+    Value before;
+    Value after;
+    if (!loadJson(argv[1], before) || !loadJson(argv[2], after))
+        return 2;
+
+    std::uint32_t added = 0;
+    std::uint32_t removed = 0;
+    std::uint32_t changed = 0;
+    std::uint32_t lostAliasing = 0;
+
+    // Passes.
+    auto passesA = collectPassNames(before);
+    auto passesB = collectPassNames(after);
+    for (const auto& p : passesB) {
+        if (!passesA.count(p))
+            std::printf("+ pass '%s'\n", p.c_str());
+    }
+    for (const auto& p : passesA) {
+        if (!passesB.count(p))
+            std::printf("- pass '%s'\n", p.c_str());
+    }
+
+    // Barriers. Keys with multiple barriers (rare) are paired in order.
+    BarrierMap barriersA = collectBarriers(before);
+    BarrierMap barriersB = collectBarriers(after);
+    std::set<BarrierKey> keys;
+    for (const auto& [k, v] : barriersA)
+        keys.insert(k);
+    for (const auto& [k, v] : barriersB)
+        keys.insert(k);
+
+    for (const auto& key : keys) {
+        auto [aBegin, aEnd] = barriersA.equal_range(key);
+        auto [bBegin, bEnd] = barriersB.equal_range(key);
+        auto a = aBegin;
+        auto b = bBegin;
+        for (; a != aEnd && b != bEnd; ++a, ++b) {
+            if (a->second == b->second)
+                continue;
+            ++changed;
+            printKey("~", key);
+            std::printf("    was: %s\n    now: %s\n", a->second.c_str(), b->second.c_str());
+        }
+        for (; b != bEnd; ++b) {
+            ++added;
+            printKey("+", key);
+            std::printf("    %s\n", b->second.c_str());
+        }
+        for (; a != aEnd; ++a) {
+            ++removed;
+            printKey("-", key);
+            std::printf("    %s\n", a->second.c_str());
+        }
+    }
+
+    // Aliasing.
+    auto groupsA = collectAliasGroups(before);
+    auto groupsB = collectAliasGroups(after);
+    for (const auto& g : groupsA) {
+        if (stillAliased(g, groupsB))
+            continue;
+        ++lostAliasing;
+        std::printf("! lost aliasing: {%s}\n", joinNames(g).c_str());
+    }
+    for (const auto& g : groupsB) {
+        if (!stillAliased(g, groupsA))
+            std::printf("+ new aliasing: {%s}\n", joinNames(g).c_str());
+    }
+
+    // Timings are informational only (noisy across runs).
+    const Value* statsA = before.find("stats");
+    const Value* statsB = after.find("stats");
+    if (statsA && statsB) {
+        const Value* tA = statsA->find("timingsUs");
+        const Value* tB = statsB->find("timingsUs");
+        if (tA && tB)
+            std::printf("compile: %.0fus -> %.0fus\n", tA->num("compile"), tB->num("compile"));
+    }
+
+    std::printf("barriers: %zu -> %zu (+%u added, -%u removed, %u changed), "
+                "%u lost aliasing group(s)\n",
+                barriersA.size(), barriersB.size(), added, removed, changed, lostAliasing);
+
+    return (added > 0 || changed > 0 || lostAliasing > 0) ? 1 : 0;
+}